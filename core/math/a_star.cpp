@@ -50,80 +50,106 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 	ERR_FAIL_COND_MSG(p_id < 0, vformat("Can't add a point with negative id: %d.", p_id));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't add a point with weight scale less than 0.0: %f.", p_weight_scale));
 
-	Point *found_pt;
+	uint32_t found_pt;
 	bool p_exists = points.lookup(p_id, found_pt);
 
 	if (!p_exists) {
-		Point *pt = memnew(Point);
-		pt->id = p_id;
-		pt->pos = p_pos;
-		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
-		pt->enabled = true;
+		uint32_t pt;
+		if (free_slots.is_empty()) {
+			pt = point_ids.size();
+			point_ids.push_back(p_id);
+			point_positions.push_back(p_pos);
+			point_weight_scales.push_back(p_weight_scale);
+			point_enabled.push_back(true);
+			point_neighbors.push_back(LocalVector<uint32_t>());
+			point_unlinked_neighbors.push_back(LocalVector<uint32_t>());
+		} else {
+			pt = free_slots[free_slots.size() - 1];
+			free_slots.remove_at(free_slots.size() - 1);
+			point_ids[pt] = p_id;
+			point_positions[pt] = p_pos;
+			point_weight_scales[pt] = p_weight_scale;
+			point_enabled[pt] = true;
+		}
 		points.set(p_id, pt);
 	} else {
-		found_pt->pos = p_pos;
-		found_pt->weight_scale = p_weight_scale;
+		point_positions[found_pt] = p_pos;
+		point_weight_scales[found_pt] = p_weight_scale;
 	}
 }
 
 Vector3 AStar3D::get_point_position(int64_t p_id) const {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_V_MSG(!p_exists, Vector3(), vformat("Can't get point's position. Point with id: %d doesn't exist.", p_id));
 
-	return p->pos;
+	return point_positions[p];
 }
 
 void AStar3D::set_point_position(int64_t p_id, const Vector3 &p_pos) {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
-	p->pos = p_pos;
+	point_positions[p] = p_pos;
 }
 
 real_t AStar3D::get_point_weight_scale(int64_t p_id) const {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_V_MSG(!p_exists, 0, vformat("Can't get point's weight scale. Point with id: %d doesn't exist.", p_id));
 
-	return p->weight_scale;
+	return point_weight_scales[p];
 }
 
 void AStar3D::set_point_weight_scale(int64_t p_id, real_t p_weight_scale) {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's weight scale. Point with id: %d doesn't exist.", p_id));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 
-	p->weight_scale = p_weight_scale;
+	point_weight_scales[p] = p_weight_scale;
+}
+
+// Neighbors are kept in small arrays, which are faster to traverse than hash maps for the usual point degrees.
+static _FORCE_INLINE_ void _add_neighbor(LocalVector<uint32_t> &r_neighbors, uint32_t p_neighbor) {
+	if (r_neighbors.find(p_neighbor) == -1) {
+		r_neighbors.push_back(p_neighbor);
+	}
+}
+
+static _FORCE_INLINE_ void _remove_neighbor(LocalVector<uint32_t> &r_neighbors, uint32_t p_neighbor) {
+	int64_t index = r_neighbors.find(p_neighbor);
+	if (index != -1) {
+		r_neighbors.remove_at_unordered(index);
+	}
 }
 
 void AStar3D::remove_point(int64_t p_id) {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't remove point. Point with id: %d doesn't exist.", p_id));
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-		Segment s(p_id, (*it.key));
+	for (const uint32_t neighbor : point_neighbors[p]) {
+		Segment s(p_id, point_ids[neighbor]);
 		segments.erase(s);
 
-		(*it.value)->neighbors.remove(p->id);
-		(*it.value)->unlinked_neighbours.remove(p->id);
+		_remove_neighbor(point_neighbors[neighbor], p);
+		_remove_neighbor(point_unlinked_neighbors[neighbor], p);
 	}
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = p->unlinked_neighbours.iter(); it.valid; it = p->unlinked_neighbours.next_iter(it)) {
-		Segment s(p_id, (*it.key));
+	for (const uint32_t neighbor : point_unlinked_neighbors[p]) {
+		Segment s(p_id, point_ids[neighbor]);
 		segments.erase(s);
 
-		(*it.value)->neighbors.remove(p->id);
-		(*it.value)->unlinked_neighbours.remove(p->id);
+		_remove_neighbor(point_neighbors[neighbor], p);
+		_remove_neighbor(point_unlinked_neighbors[neighbor], p);
 	}
 
-	memdelete(p);
+	point_ids[p] = -1;
+	point_neighbors[p].clear();
+	point_unlinked_neighbors[p].clear();
+	free_slots.push_back(p);
 	points.remove(p_id);
 	last_free_id = p_id;
 }
@@ -131,20 +157,20 @@ void AStar3D::remove_point(int64_t p_id) {
 void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
 	ERR_FAIL_COND_MSG(p_id == p_with_id, vformat("Can't connect point with id: %d to itself.", p_id));
 
-	Point *a = nullptr;
+	uint32_t a = 0;
 	bool from_exists = points.lookup(p_id, a);
 	ERR_FAIL_COND_MSG(!from_exists, vformat("Can't connect points. Point with id: %d doesn't exist.", p_id));
 
-	Point *b = nullptr;
+	uint32_t b = 0;
 	bool to_exists = points.lookup(p_with_id, b);
 	ERR_FAIL_COND_MSG(!to_exists, vformat("Can't connect points. Point with id: %d doesn't exist.", p_with_id));
 
-	a->neighbors.set(b->id, b);
+	_add_neighbor(point_neighbors[a], b);
 
 	if (bidirectional) {
-		b->neighbors.set(a->id, a);
+		_add_neighbor(point_neighbors[b], a);
 	} else {
-		b->unlinked_neighbours.set(a->id, a);
+		_add_neighbor(point_unlinked_neighbors[b], a);
 	}
 
 	Segment s(p_id, p_with_id);
@@ -157,8 +183,8 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 		s.direction |= element->direction;
 		if (s.direction == Segment::BIDIRECTIONAL) {
 			// Both are neighbors of each other now
-			a->unlinked_neighbours.remove(b->id);
-			b->unlinked_neighbours.remove(a->id);
+			_remove_neighbor(point_unlinked_neighbors[a], b);
+			_remove_neighbor(point_unlinked_neighbors[b], a);
 		}
 		segments.remove(element);
 	}
@@ -167,11 +193,11 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 }
 
 void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
-	Point *a = nullptr;
+	uint32_t a = 0;
 	bool a_exists = points.lookup(p_id, a);
 	ERR_FAIL_COND_MSG(!a_exists, vformat("Can't disconnect points. Point with id: %d doesn't exist.", p_id));
 
-	Point *b = nullptr;
+	uint32_t b = 0;
 	bool b_exists = points.lookup(p_with_id, b);
 	ERR_FAIL_COND_MSG(!b_exists, vformat("Can't disconnect points. Point with id: %d doesn't exist.", p_with_id));
 
@@ -184,18 +210,18 @@ void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectio
 		// Erase the directions to be removed
 		s.direction = (element->direction & ~remove_direction);
 
-		a->neighbors.remove(b->id);
+		_remove_neighbor(point_neighbors[a], b);
 		if (bidirectional) {
-			b->neighbors.remove(a->id);
+			_remove_neighbor(point_neighbors[b], a);
 			if (element->direction != Segment::BIDIRECTIONAL) {
-				a->unlinked_neighbours.remove(b->id);
-				b->unlinked_neighbours.remove(a->id);
+				_remove_neighbor(point_unlinked_neighbors[a], b);
+				_remove_neighbor(point_unlinked_neighbors[b], a);
 			}
 		} else {
 			if (s.direction == Segment::NONE) {
-				b->unlinked_neighbours.remove(a->id);
+				_remove_neighbor(point_unlinked_neighbors[b], a);
 			} else {
-				a->unlinked_neighbours.set(b->id, b);
+				_add_neighbor(point_unlinked_neighbors[a], b);
 			}
 		}
 
@@ -213,7 +239,7 @@ bool AStar3D::has_point(int64_t p_id) const {
 PackedInt64Array AStar3D::get_point_ids() {
 	PackedInt64Array point_list;
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+	for (OAHashMap<int64_t, uint32_t>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 		point_list.push_back(*(it.key));
 	}
 
@@ -221,14 +247,14 @@ PackedInt64Array AStar3D::get_point_ids() {
 }
 
 Vector<int64_t> AStar3D::get_point_connections(int64_t p_id) {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_V_MSG(!p_exists, Vector<int64_t>(), vformat("Can't get point's connections. Point with id: %d doesn't exist.", p_id));
 
 	Vector<int64_t> point_list;
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-		point_list.push_back((*it.key));
+	for (const uint32_t neighbor : point_neighbors[p]) {
+		point_list.push_back(point_ids[neighbor]);
 	}
 
 	return point_list;
@@ -244,9 +270,13 @@ bool AStar3D::are_points_connected(int64_t p_id, int64_t p_with_id, bool bidirec
 
 void AStar3D::clear() {
 	last_free_id = 0;
-	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		memdelete(*(it.value));
-	}
+	point_ids.clear();
+	point_positions.clear();
+	point_weight_scales.clear();
+	point_enabled.clear();
+	point_neighbors.clear();
+	point_unlinked_neighbors.clear();
+	free_slots.clear();
 	segments.clear();
 	points.clear();
 }
@@ -263,21 +293,30 @@ void AStar3D::reserve_space(int64_t p_num_nodes) {
 	ERR_FAIL_COND_MSG(p_num_nodes <= 0, vformat("New capacity must be greater than 0, new was: %d.", p_num_nodes));
 	ERR_FAIL_COND_MSG((uint32_t)p_num_nodes < points.get_capacity(), vformat("New capacity must be greater than current capacity: %d, new was: %d.", points.get_capacity(), p_num_nodes));
 	points.reserve(p_num_nodes);
+	point_ids.reserve(p_num_nodes);
+	point_positions.reserve(p_num_nodes);
+	point_weight_scales.reserve(p_num_nodes);
+	point_enabled.reserve(p_num_nodes);
+	point_neighbors.reserve(p_num_nodes);
+	point_unlinked_neighbors.reserve(p_num_nodes);
 }
 
 int64_t AStar3D::get_closest_point(const Vector3 &p_point, bool p_include_disabled) const {
 	int64_t closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		if (!p_include_disabled && !(*it.value)->enabled) {
+	for (uint32_t i = 0; i < point_ids.size(); i++) {
+		int64_t id = point_ids[i];
+		if (id < 0) {
+			continue; // Free slot.
+		}
+		if (!p_include_disabled && !point_enabled[i]) {
 			continue; // Disabled points should not be considered.
 		}
 
 		// Keep the closest point's ID, and in case of multiple closest IDs,
 		// the smallest one (makes it deterministic).
-		real_t d = p_point.distance_squared_to((*it.value)->pos);
-		int64_t id = *(it.key);
+		real_t d = p_point.distance_squared_to(point_positions[i]);
 		if (d <= closest_dist) {
 			if (d == closest_dist && id > closest_id) { // Keep lowest ID.
 				continue;
@@ -295,17 +334,17 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	Vector3 closest_point;
 
 	for (const Segment &E : segments) {
-		Point *from_point = nullptr, *to_point = nullptr;
+		uint32_t from_point = 0, to_point = 0;
 		points.lookup(E.key.first, from_point);
 		points.lookup(E.key.second, to_point);
 
-		if (!(from_point->enabled && to_point->enabled)) {
+		if (!(point_enabled[from_point] && point_enabled[to_point])) {
 			continue;
 		}
 
 		Vector3 segment[2] = {
-			from_point->pos,
-			to_point->pos,
+			point_positions[from_point],
+			point_positions[to_point],
 		};
 
 		Vector3 p = Geometry3D::get_closest_point_to_segment(p_point, segment);
@@ -319,66 +358,101 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar3D::_solve(Point *begin_point, Point *end_point, bool p_allow_partial_path) {
-	last_closest_point = nullptr;
-	pass++;
+AStar3D::SearchContext *AStar3D::_acquire_search_context() {
+	SearchContext *context = nullptr;
+	{
+		MutexLock lock(search_contexts_mutex);
+		if (!search_contexts.is_empty()) {
+			context = search_contexts[search_contexts.size() - 1];
+			search_contexts.remove_at(search_contexts.size() - 1);
+		}
+	}
+	if (!context) {
+		context = memnew(SearchContext);
+	}
+	// Slots added since the context was last used start with an old pass, so they aren't considered open or closed.
+	if (context->search_points.size() < point_ids.size()) {
+		context->search_points.resize(point_ids.size());
+	}
+	return context;
+}
+
+void AStar3D::_release_search_context(SearchContext *p_context) {
+	MutexLock lock(search_contexts_mutex);
+	search_contexts.push_back(p_context);
+}
+
+template <typename T>
+bool AStar3D::_solve(T *p_costs, SearchContext &p_context, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path) {
+	p_context.last_closest_point = UINT32_MAX;
+	p_context.pass++;
+	const uint64_t pass = p_context.pass;
 
-	if (!end_point->enabled && !p_allow_partial_path) {
+	if (!point_enabled[p_end_point] && !p_allow_partial_path) {
 		return false;
 	}
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	SearchPoint *search_points = p_context.search_points.ptr();
+	LocalVector<uint32_t> &open_list = p_context.open_list;
+	open_list.clear();
+	SortArray<uint32_t, SortPoints> sorter;
+	sorter.compare.search_points = search_points;
+
+	const int64_t end_id = point_ids[p_end_point];
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	begin_point->abs_g_score = 0;
-	begin_point->abs_f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	SearchPoint &begin_point = search_points[p_begin_point];
+	begin_point.g_score = 0;
+	begin_point.f_score = p_costs->_estimate_cost(point_ids[p_begin_point], end_id);
+	begin_point.abs_g_score = 0;
+	begin_point.abs_f_score = begin_point.f_score;
+	open_list.push_back(p_begin_point);
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		const uint32_t p = open_list[0]; // The currently processed point.
+		SearchPoint &sp = search_points[p];
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		if (p_context.last_closest_point == UINT32_MAX || search_points[p_context.last_closest_point].abs_f_score > sp.abs_f_score || (search_points[p_context.last_closest_point].abs_f_score >= sp.abs_f_score && search_points[p_context.last_closest_point].abs_g_score > sp.abs_g_score)) {
+			p_context.last_closest_point = p;
 		}
 
-		if (p == end_point) {
+		if (p == p_end_point) {
 			found_route = true;
 			break;
 		}
 
 		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		sp.closed_pass = pass; // Mark the point as closed.
 
-		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-			Point *e = *(it.value); // The neighbor point.
+		const int64_t p_id = point_ids[p];
+		for (const uint32_t e : point_neighbors[p]) { // The neighbor point.
+			SearchPoint &se = search_points[e];
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!point_enabled[e] || se.closed_pass == pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			const int64_t e_id = point_ids[e];
+			real_t tentative_g_score = sp.g_score + p_costs->_compute_cost(p_id, e_id) * point_weight_scales[e];
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
+			if (se.open_pass != pass) { // The point wasn't inside the open list.
+				se.open_pass = pass;
 				open_list.push_back(e);
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= se.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			se.prev_point = p;
+			se.g_score = tentative_g_score;
+			se.f_score = se.g_score + p_costs->_estimate_cost(e_id, end_id);
+			se.abs_g_score = tentative_g_score;
+			se.abs_f_score = se.f_score - se.g_score;
 
 			if (new_point) { // The position of the new points is already known.
 				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
@@ -391,21 +465,61 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point, bool p_allow_partial_
 	return found_route;
 }
 
+template <typename T>
+bool AStar3D::_find_path(T *p_costs, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path, LocalVector<uint32_t> &r_path) {
+	SearchContext *context = _acquire_search_context();
+
+	uint32_t end_point = p_end_point;
+	bool found_route = _solve(p_costs, *context, p_begin_point, p_end_point, p_allow_partial_path);
+	if (!found_route) {
+		if (!p_allow_partial_path || context->last_closest_point == UINT32_MAX) {
+			_release_search_context(context);
+			return false;
+		}
+
+		// Use closest point instead.
+		end_point = context->last_closest_point;
+	}
+
+	const SearchPoint *search_points = context->search_points.ptr();
+
+	uint32_t p = end_point;
+	uint32_t pc = 1; // Begin point
+	while (p != p_begin_point) {
+		pc++;
+		p = search_points[p].prev_point;
+	}
+
+	r_path.resize(pc);
+
+	p = end_point;
+	uint32_t idx = pc - 1;
+	while (p != p_begin_point) {
+		r_path[idx--] = p;
+		p = search_points[p].prev_point;
+	}
+
+	r_path[0] = p; // Assign first
+
+	_release_search_context(context);
+	return true;
+}
+
 real_t AStar3D::_estimate_cost(int64_t p_from_id, int64_t p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
 		return scost;
 	}
 
-	Point *from_point = nullptr;
+	uint32_t from_point = 0;
 	bool from_exists = points.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *end_point = nullptr;
+	uint32_t end_point = 0;
 	bool end_exists = points.lookup(p_end_id, end_point);
 	ERR_FAIL_COND_V_MSG(!end_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_end_id));
 
-	return from_point->pos.distance_to(end_point->pos);
+	return point_positions[from_point].distance_to(point_positions[end_point]);
 }
 
 real_t AStar3D::_compute_cost(int64_t p_from_id, int64_t p_to_id) {
@@ -414,139 +528,91 @@ real_t AStar3D::_compute_cost(int64_t p_from_id, int64_t p_to_id) {
 		return scost;
 	}
 
-	Point *from_point = nullptr;
+	uint32_t from_point = 0;
 	bool from_exists = points.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *to_point = nullptr;
+	uint32_t to_point = 0;
 	bool to_exists = points.lookup(p_to_id, to_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_to_id));
 
-	return from_point->pos.distance_to(to_point->pos);
+	return point_positions[from_point].distance_to(point_positions[to_point]);
 }
 
 Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path) {
-	Point *a = nullptr;
+	uint32_t a = 0;
 	bool from_exists = points.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<Vector3>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *b = nullptr;
+	uint32_t b = 0;
 	bool to_exists = points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<Vector3>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 
 	if (a == b) {
 		Vector<Vector3> ret;
-		ret.push_back(a->pos);
+		ret.push_back(point_positions[a]);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector3>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> point_path;
+	if (!_find_path(this, a, b, p_allow_partial_path, point_path)) {
+		return Vector<Vector3>();
 	}
 
 	Vector<Vector3> path;
-	path.resize(pc);
-
-	{
-		Vector3 *w = path.ptrw();
-
-		Point *p2 = end_point;
-		int64_t idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
-		}
-
-		w[0] = p2->pos; // Assign first
+	path.resize(point_path.size());
+	Vector3 *w = path.ptrw();
+	for (uint32_t i = 0; i < point_path.size(); i++) {
+		w[i] = point_positions[point_path[i]];
 	}
 
 	return path;
 }
 
 Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path) {
-	Point *a = nullptr;
+	uint32_t a = 0;
 	bool from_exists = points.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *b = nullptr;
+	uint32_t b = 0;
 	bool to_exists = points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 
 	if (a == b) {
 		Vector<int64_t> ret;
-		ret.push_back(a->id);
+		ret.push_back(p_from_id);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<int64_t>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> point_path;
+	if (!_find_path(this, a, b, p_allow_partial_path, point_path)) {
+		return Vector<int64_t>();
 	}
 
 	Vector<int64_t> path;
-	path.resize(pc);
-
-	{
-		int64_t *w = path.ptrw();
-
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
-		}
-
-		w[0] = p->id; // Assign first
+	path.resize(point_path.size());
+	int64_t *w = path.ptrw();
+	for (uint32_t i = 0; i < point_path.size(); i++) {
+		w[i] = point_ids[point_path[i]];
 	}
 
 	return path;
 }
 
 void AStar3D::set_point_disabled(int64_t p_id, bool p_disabled) {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 
-	p->enabled = !p_disabled;
+	point_enabled[p] = !p_disabled;
 }
 
 bool AStar3D::is_point_disabled(int64_t p_id) const {
-	Point *p = nullptr;
+	uint32_t p = 0;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_V_MSG(!p_exists, false, vformat("Can't get if point is disabled. Point with id: %d doesn't exist.", p_id));
 
-	return !p->enabled;
+	return !point_enabled[p];
 }
 
 void AStar3D::_bind_methods() {
@@ -585,6 +651,9 @@ void AStar3D::_bind_methods() {
 
 AStar3D::~AStar3D() {
 	clear();
+	for (SearchContext *context : search_contexts) {
+		memdelete(context);
+	}
 }
 
 /////////////////////////////////////////////////////////////
@@ -681,15 +750,15 @@ real_t AStar2D::_estimate_cost(int64_t p_from_id, int64_t p_end_id) {
 		return scost;
 	}
 
-	AStar3D::Point *from_point = nullptr;
+	uint32_t from_point = 0;
 	bool from_exists = astar.points.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar3D::Point *end_point = nullptr;
+	uint32_t end_point = 0;
 	bool to_exists = astar.points.lookup(p_end_id, end_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_end_id));
 
-	return from_point->pos.distance_to(end_point->pos);
+	return astar.point_positions[from_point].distance_to(astar.point_positions[end_point]);
 }
 
 real_t AStar2D::_compute_cost(int64_t p_from_id, int64_t p_to_id) {
@@ -698,196 +767,78 @@ real_t AStar2D::_compute_cost(int64_t p_from_id, int64_t p_to_id) {
 		return scost;
 	}
 
-	AStar3D::Point *from_point = nullptr;
+	uint32_t from_point = 0;
 	bool from_exists = astar.points.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar3D::Point *to_point = nullptr;
+	uint32_t to_point = 0;
 	bool to_exists = astar.points.lookup(p_to_id, to_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_to_id));
 
-	return from_point->pos.distance_to(to_point->pos);
+	return astar.point_positions[from_point].distance_to(astar.point_positions[to_point]);
 }
 
 Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path) {
-	AStar3D::Point *a = nullptr;
+	uint32_t a = 0;
 	bool from_exists = astar.points.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<Vector2>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar3D::Point *b = nullptr;
+	uint32_t b = 0;
 	bool to_exists = astar.points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<Vector2>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 
 	if (a == b) {
-		Vector<Vector2> ret = { Vector2(a->pos.x, a->pos.y) };
+		const Vector3 &pos = astar.point_positions[a];
+		Vector<Vector2> ret = { Vector2(pos.x, pos.y) };
 		return ret;
 	}
 
-	AStar3D::Point *begin_point = a;
-	AStar3D::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
-
-		// Use closest point instead.
-		end_point = astar.last_closest_point;
-	}
-
-	AStar3D::Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> point_path;
+	if (!astar._find_path(this, a, b, p_allow_partial_path, point_path)) {
+		return Vector<Vector2>();
 	}
 
 	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		AStar3D::Point *p2 = end_point;
-		int64_t idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
-		}
-
-		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
+	path.resize(point_path.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < point_path.size(); i++) {
+		const Vector3 &pos = astar.point_positions[point_path[i]];
+		w[i] = Vector2(pos.x, pos.y);
 	}
 
 	return path;
 }
 
 Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path) {
-	AStar3D::Point *a = nullptr;
+	uint32_t a = 0;
 	bool from_exists = astar.points.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar3D::Point *b = nullptr;
+	uint32_t b = 0;
 	bool to_exists = astar.points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 
 	if (a == b) {
 		Vector<int64_t> ret;
-		ret.push_back(a->id);
+		ret.push_back(p_from_id);
 		return ret;
 	}
 
-	AStar3D::Point *begin_point = a;
-	AStar3D::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
-			return Vector<int64_t>();
-		}
-
-		// Use closest point instead.
-		end_point = astar.last_closest_point;
-	}
-
-	AStar3D::Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> point_path;
+	if (!astar._find_path(this, a, b, p_allow_partial_path, point_path)) {
+		return Vector<int64_t>();
 	}
 
 	Vector<int64_t> path;
-	path.resize(pc);
-
-	{
-		int64_t *w = path.ptrw();
-
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
-		}
-
-		w[0] = p->id; // Assign first
+	path.resize(point_path.size());
+	int64_t *w = path.ptrw();
+	for (uint32_t i = 0; i < point_path.size(); i++) {
+		w[i] = astar.point_ids[point_path[i]];
 	}
 
 	return path;
 }
 
-bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point, bool p_allow_partial_path) {
-	astar.last_closest_point = nullptr;
-	astar.pass++;
-
-	if (!end_point->enabled && !p_allow_partial_path) {
-		return false;
-	}
-
-	bool found_route = false;
-
-	LocalVector<AStar3D::Point *> open_list;
-	SortArray<AStar3D::Point *, AStar3D::SortPoints> sorter;
-
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	begin_point->abs_g_score = 0;
-	begin_point->abs_f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
-
-	while (!open_list.is_empty()) {
-		AStar3D::Point *p = open_list[0]; // The currently processed point.
-
-		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (astar.last_closest_point == nullptr || astar.last_closest_point->abs_f_score > p->abs_f_score || (astar.last_closest_point->abs_f_score >= p->abs_f_score && astar.last_closest_point->abs_g_score > p->abs_g_score)) {
-			astar.last_closest_point = p;
-		}
-
-		if (p == end_point) {
-			found_route = true;
-			break;
-		}
-
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed.
-
-		for (OAHashMap<int64_t, AStar3D::Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-			AStar3D::Point *e = *(it.value); // The neighbor point.
-
-			if (!e->enabled || e->closed_pass == astar.pass) {
-				continue;
-			}
-
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
-
-			bool new_point = false;
-
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
-				continue;
-			}
-
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
-
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
-			}
-		}
-	}
-
-	return found_route;
-}
-
 void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar2D::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar2D::add_point, DEFVAL(1.0));
@@ -33,29 +33,24 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 
 /**
 	A* pathfinding algorithm.
+
+	Path queries keep their search state outside of the graph, so they can run on several threads at once,
+	as long as the graph isn't modified at the same time.
 */
 
 class AStar3D : public RefCounted {
 	GDCLASS(AStar3D, RefCounted);
 	friend class AStar2D;
 
-	struct Point {
-		Point() {}
-
-		int64_t id = 0;
-		Vector3 pos;
-		real_t weight_scale = 0;
-		bool enabled = false;
-
-		OAHashMap<int64_t, Point *> neighbors = 4u;
-		OAHashMap<int64_t, Point *> unlinked_neighbours = 4u;
-
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
+	// Search state of a point, kept per query so the same graph can be searched from several threads.
+	struct SearchPoint {
+		uint32_t prev_point = UINT32_MAX;
 		real_t g_score = 0;
 		real_t f_score = 0;
 		uint64_t open_pass = 0;
@@ -66,14 +61,25 @@ class AStar3D : public RefCounted {
 		real_t abs_f_score = 0;
 	};
 
+	struct SearchContext {
+		LocalVector<SearchPoint> search_points;
+		LocalVector<uint32_t> open_list;
+		uint64_t pass = 0;
+		uint32_t last_closest_point = UINT32_MAX;
+	};
+
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		const SearchPoint *search_points = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const { // Returns true when the point A is worse than point B.
+			const SearchPoint &A = search_points[p_a];
+			const SearchPoint &B = search_points[p_b];
+			if (A.f_score > B.f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (A.f_score < B.f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
@@ -109,13 +115,29 @@ class AStar3D : public RefCounted {
 	};
 
 	int64_t last_free_id = 0;
-	uint64_t pass = 1;
 
-	OAHashMap<int64_t, Point *> points;
+	// Points are stored in slots, `points` maps their ids to the slots. The slots of removed points are reused.
+	OAHashMap<int64_t, uint32_t> points;
+	LocalVector<int64_t> point_ids;
+	LocalVector<Vector3> point_positions;
+	LocalVector<real_t> point_weight_scales;
+	LocalVector<bool> point_enabled;
+	LocalVector<LocalVector<uint32_t>> point_neighbors;
+	LocalVector<LocalVector<uint32_t>> point_unlinked_neighbors;
+	LocalVector<uint32_t> free_slots;
+
 	HashSet<Segment, Segment> segments;
-	Point *last_closest_point = nullptr;
 
-	bool _solve(Point *begin_point, Point *end_point, bool p_allow_partial_path);
+	Mutex search_contexts_mutex;
+	LocalVector<SearchContext *> search_contexts;
+
+	SearchContext *_acquire_search_context();
+	void _release_search_context(SearchContext *p_context);
+
+	template <typename T>
+	bool _solve(T *p_costs, SearchContext &p_context, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path);
+	template <typename T>
+	bool _find_path(T *p_costs, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path, LocalVector<uint32_t> &r_path);
 
 protected:
 	static void _bind_methods();
@@ -169,9 +191,9 @@ public:
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
-	AStar3D astar;
+	friend class AStar3D;
 
-	bool _solve(AStar3D::Point *begin_point, AStar3D::Point *end_point, bool p_allow_partial_path);
+	AStar3D astar;
 
 protected:
 	static void _bind_methods();
@@ -576,6 +576,111 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 	return found_route;
 }
 
+PackedFloat32Array AStarGrid2D::_get_cost_map(const TypedArray<Vector2i> &p_ids, real_t p_max_cost, bool p_to_ids) {
+	const int32_t width = region.size.x;
+	const int32_t mask_width = width + 2;
+
+	PackedFloat32Array cost_map;
+	cost_map.resize(region.size.x * region.size.y);
+	float *costs = cost_map.ptrw();
+	for (int64_t i = 0; i < cost_map.size(); i++) {
+		costs[i] = INFINITY;
+	}
+
+	LocalVector<CostMapEntry> open_list;
+	SortArray<CostMapEntry, SortCostMapEntries> sorter;
+
+	for (int i = 0; i < p_ids.size(); i++) {
+		const Vector2i id = p_ids[i];
+		ERR_CONTINUE_MSG(!is_in_boundsv(id), vformat("Can't get cost map. Point %s out of bounds %s.", id, region));
+		if (p_to_ids && _get_solid_unchecked(id)) {
+			continue; // Solid points can't be entered.
+		}
+		const uint32_t index = (id.y - region.position.y) * width + id.x - region.position.x;
+		if (costs[index] == 0) {
+			continue;
+		}
+		costs[index] = 0;
+		open_list.push_back({ 0, index });
+		sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+	}
+
+	// Steps to the neighbors: top, right, bottom, left, then the diagonal between each of them and the next one.
+	static const int32_t step_x[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+	static const int32_t step_y[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+	// Without a custom cost, the cost of a step only depends on its direction.
+	const bool custom_cost = GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+	real_t step_costs[8];
+	int64_t mask_offsets[8];
+	int64_t cell_offsets[8];
+	for (int i = 0; i < 8; i++) {
+		step_costs[i] = heuristics[default_compute_heuristic](Vector2i(), Vector2i(step_x[i], step_y[i]));
+		mask_offsets[i] = step_y[i] * mask_width + step_x[i];
+		cell_offsets[i] = step_y[i] * width + step_x[i];
+	}
+
+	while (!open_list.is_empty()) {
+		const CostMapEntry entry = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+		if (entry.cost > costs[entry.index]) {
+			continue; // The point was reached with a lower cost since this entry was added.
+		}
+
+		const int32_t x = entry.index % width;
+		const int32_t y = entry.index / width;
+		const Vector2i id(x + region.position.x, y + region.position.y);
+		const int64_t mask_index = (int64_t)(y + 1) * mask_width + x + 1;
+		const real_t weight_scale = points[y][x].weight_scale;
+
+		// The solid mask has a solid border, so the neighbors don't need bounds checks.
+		bool walkable[8];
+		for (int i = 0; i < 8; i++) {
+			walkable[i] = !solid_mask[mask_index + mask_offsets[i]];
+		}
+		for (int i = 4; i < 8; i++) {
+			switch (diagonal_mode) {
+				case DIAGONAL_MODE_NEVER: {
+					walkable[i] = false;
+				} break;
+				case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+					walkable[i] = walkable[i] && (walkable[i - 4] || walkable[(i - 3) % 4]);
+				} break;
+				case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+					walkable[i] = walkable[i] && walkable[i - 4] && walkable[(i - 3) % 4];
+				} break;
+				default:
+					break;
+			}
+		}
+
+		for (int i = 0; i < 8; i++) {
+			if (!walkable[i]) {
+				continue;
+			}
+
+			const uint32_t neighbor_index = entry.index + cell_offsets[i];
+			real_t step_cost = step_costs[i];
+			if (custom_cost) {
+				const Vector2i neighbor_id(id.x + step_x[i], id.y + step_y[i]);
+				step_cost = p_to_ids ? _compute_cost(neighbor_id, id) : _compute_cost(id, neighbor_id);
+			}
+			// The weight scale of the point that is entered applies, which is this point when walking towards the targets.
+			const real_t cost = entry.cost + step_cost * (p_to_ids ? weight_scale : points[y + step_y[i]][x + step_x[i]].weight_scale);
+			if (cost > p_max_cost || cost >= costs[neighbor_index]) {
+				continue;
+			}
+
+			costs[neighbor_index] = cost;
+			open_list.push_back({ cost, neighbor_index });
+			sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+		}
+	}
+
+	return cost_map;
+}
+
 real_t AStarGrid2D::_estimate_cost(const Vector2i &p_from_id, const Vector2i &p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -734,6 +839,16 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	return path;
 }
 
+PackedFloat32Array AStarGrid2D::get_cost_map_from(const TypedArray<Vector2i> &p_from_ids, real_t p_max_cost) {
+	ERR_FAIL_COND_V_MSG(dirty, PackedFloat32Array(), "Grid is not initialized. Call the update method.");
+	return _get_cost_map(p_from_ids, p_max_cost, false);
+}
+
+PackedFloat32Array AStarGrid2D::get_cost_map_to(const TypedArray<Vector2i> &p_to_ids, real_t p_max_cost) {
+	ERR_FAIL_COND_V_MSG(dirty, PackedFloat32Array(), "Grid is not initialized. Call the update method.");
+	return _get_cost_map(p_to_ids, p_max_cost, true);
+}
+
 void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_region", "region"), &AStarGrid2D::set_region);
 	ClassDB::bind_method(D_METHOD("get_region"), &AStarGrid2D::get_region);
@@ -769,6 +884,8 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_data_in_region", "region"), &AStarGrid2D::get_point_data_in_region);
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_cost_map_from", "from_ids", "max_cost"), &AStarGrid2D::get_cost_map_from, DEFVAL(INFINITY));
+	ClassDB::bind_method(D_METHOD("get_cost_map_to", "to_ids", "max_cost"), &AStarGrid2D::get_cost_map_to, DEFVAL(INFINITY));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
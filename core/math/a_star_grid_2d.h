@@ -110,6 +110,17 @@ private:
 		}
 	};
 
+	struct CostMapEntry {
+		real_t cost = 0;
+		uint32_t index = 0;
+	};
+
+	struct SortCostMapEntries {
+		_FORCE_INLINE_ bool operator()(const CostMapEntry &A, const CostMapEntry &B) const { // Returns true when the entry A is worse than entry B.
+			return A.cost > B.cost;
+		}
+	};
+
 	LocalVector<bool> solid_mask;
 	LocalVector<LocalVector<Point>> points;
 	Point *end = nullptr;
@@ -160,6 +171,7 @@ private: // Internal routines.
 	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
 	Point *_jump(Point *p_from, Point *p_to);
 	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
+	PackedFloat32Array _get_cost_map(const TypedArray<Vector2i> &p_ids, real_t p_max_cost, bool p_to_ids);
 	Point *_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive = false);
 
 protected:
@@ -226,6 +238,8 @@ public:
 	TypedArray<Dictionary> get_point_data_in_region(const Rect2i &p_region) const;
 	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
 	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
+	PackedFloat32Array get_cost_map_from(const TypedArray<Vector2i> &p_from_ids, real_t p_max_cost = INFINITY);
+	PackedFloat32Array get_cost_map_to(const TypedArray<Vector2i> &p_to_ids, real_t p_max_cost = INFINITY);
 };
 
 VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
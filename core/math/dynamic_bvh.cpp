@@ -386,6 +386,77 @@ bool DynamicBVH::update(const ID &p_id, const AABB &p_box) {
 	return true;
 }
 
+void DynamicBVH::update_multiple(const ID *p_ids, const AABB *p_boxes, uint32_t p_count) {
+	// Removing and inserting each leaf costs a walk from the root, refitting the whole tree is linear in its size.
+	// So when a large part of the leaves moves, they are moved in place and the tree is refitted once.
+	// Only the leaves moving far from where they were are reinserted.
+	if (p_count * 16 < (uint32_t)total_leaves) {
+		for (uint32_t i = 0; i < p_count; i++) {
+			update(p_ids[i], p_boxes[i]);
+		}
+		return;
+	}
+
+	bool moved = false;
+	LocalVector<Node *> far_leaves;
+	for (uint32_t i = 0; i < p_count; i++) {
+		ERR_CONTINUE(!p_ids[i].is_valid());
+		Node *leaf = p_ids[i].node;
+
+		Volume volume;
+		volume.min = p_boxes[i].position;
+		volume.max = p_boxes[i].position + p_boxes[i].size;
+
+		if (leaf->volume.min.is_equal_approx(volume.min) && leaf->volume.max.is_equal_approx(volume.max)) {
+			continue;
+		}
+
+		// A leaf leaving its old box would stretch its ancestors over the space in between, so it's reinserted instead.
+		if (!volume.intersects(leaf->volume)) {
+			_remove_leaf(leaf);
+			far_leaves.push_back(leaf);
+		}
+		leaf->volume = volume;
+		moved = true;
+	}
+
+	if (moved) {
+		_refit();
+	}
+	for (Node *leaf : far_leaves) {
+		_insert_leaf(bvh_root, leaf);
+	}
+}
+
+void DynamicBVH::_refit() {
+	if (!bvh_root) {
+		return;
+	}
+
+	// Parents are fetched before their children, so going backwards refits the children first.
+	LocalVector<Node *> internal_nodes;
+	internal_nodes.reserve(total_leaves);
+	internal_nodes.push_back(bvh_root);
+	for (uint32_t i = 0; i < internal_nodes.size(); i++) {
+		Node *node = internal_nodes[i];
+		if (node->is_leaf()) {
+			continue;
+		}
+		for (int j = 0; j < 2; j++) {
+			if (node->children[j]->is_internal()) {
+				internal_nodes.push_back(node->children[j]);
+			}
+		}
+	}
+
+	for (int64_t i = (int64_t)internal_nodes.size() - 1; i >= 0; i--) {
+		Node *node = internal_nodes[i];
+		if (node->is_internal()) {
+			node->volume = node->children[0]->volume.merge(node->children[1]->volume);
+		}
+	}
+}
+
 void DynamicBVH::remove(const ID &p_id) {
 	ERR_FAIL_COND(!p_id.is_valid());
 	Node *leaf = p_id.node;
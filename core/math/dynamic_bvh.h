@@ -247,6 +247,7 @@ private:
 	Node *_node_sort(Node *n, Node *&r);
 
 	_FORCE_INLINE_ void _update(Node *leaf, int lookahead = -1);
+	void _refit();
 
 	void _extract_leaves(Node *p_node, List<ID> *r_elements);
 
@@ -293,6 +294,7 @@ public:
 	void optimize_incremental(int passes);
 	ID insert(const AABB &p_box, void *p_userdata);
 	bool update(const ID &p_id, const AABB &p_box);
+	void update_multiple(const ID *p_ids, const AABB *p_boxes, uint32_t p_count);
 	void remove(const ID &p_id);
 	void get_elements(List<ID> *r_elements);
 
@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*  radix_sort.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+
+#include <string.h>
+
+// Stable LSD radix sort of values by unsigned integer keys made of `KeyWords` 64-bit words,
+// the last word being the most significant one.
+//
+// Keys are gathered once into a contiguous buffer along with the values, so sorting pointers
+// by members of the objects they point to only touches each object once. Bytes that are the
+// same for every key are skipped, and an array that is already sorted (e.g. the order of the
+// previous frame) is detected while gathering and left untouched.
+//
+// The sorter keeps its buffers between calls, keep it around to avoid reallocating every frame.
+template <typename T, uint32_t KeyWords = 1>
+class RadixSort {
+	static_assert(KeyWords > 0);
+
+	enum {
+		DIGIT_BITS = 8,
+		DIGIT_COUNT = 1 << DIGIT_BITS,
+		DIGITS_PER_WORD = 64 / DIGIT_BITS,
+		PASS_COUNT = KeyWords * DIGITS_PER_WORD,
+		INSERTION_SORT_THRESHOLD = 64,
+	};
+
+	struct Element {
+		uint64_t key[KeyWords];
+		T value;
+	};
+
+	LocalVector<Element> elements;
+	LocalVector<Element> scratch;
+	uint32_t histograms[PASS_COUNT][DIGIT_COUNT];
+
+	static _FORCE_INLINE_ bool _key_less(const uint64_t *p_a, const uint64_t *p_b) {
+		for (int32_t i = KeyWords - 1; i >= 0; i--) {
+			if (p_a[i] != p_b[i]) {
+				return p_a[i] < p_b[i];
+			}
+		}
+		return false;
+	}
+
+	static _FORCE_INLINE_ uint32_t _get_digit(const Element &p_element, uint32_t p_pass) {
+		return (p_element.key[p_pass / DIGITS_PER_WORD] >> ((p_pass % DIGITS_PER_WORD) * DIGIT_BITS)) & (DIGIT_COUNT - 1);
+	}
+
+	void _insertion_sort(Element *p_elements, uint32_t p_size) {
+		for (uint32_t i = 1; i < p_size; i++) {
+			Element element = p_elements[i];
+			uint32_t j = i;
+			while (j > 0 && _key_less(element.key, p_elements[j - 1].key)) {
+				p_elements[j] = p_elements[j - 1];
+				j--;
+			}
+			p_elements[j] = element;
+		}
+	}
+
+public:
+	// Maps a float to a key which sorts in the same order, negative values included.
+	static _FORCE_INLINE_ uint32_t float_to_key(float p_value) {
+		uint32_t bits;
+		memcpy(&bits, &p_value, sizeof(uint32_t));
+		return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+	}
+
+	// Sorts `p_array` in ascending key order. `p_get_key(const T &, uint64_t *r_key)` must write
+	// the `KeyWords` words of the key of an element.
+	template <typename KeyGetter>
+	void sort(T *p_array, uint32_t p_size, const KeyGetter &p_get_key) {
+		if (p_size < 2) {
+			return;
+		}
+
+		elements.resize(p_size);
+		Element *src = elements.ptr();
+
+		// Gather the keys, find which of their bytes change and whether they are sorted already.
+		uint64_t changed_bits[KeyWords] = {};
+		bool sorted = true;
+		for (uint32_t i = 0; i < p_size; i++) {
+			Element &element = src[i];
+			p_get_key(p_array[i], element.key);
+			element.value = p_array[i];
+			if (i > 0) {
+				for (uint32_t j = 0; j < KeyWords; j++) {
+					changed_bits[j] |= element.key[j] ^ src[0].key[j];
+				}
+				if (sorted && _key_less(element.key, src[i - 1].key)) {
+					sorted = false;
+				}
+			}
+		}
+
+		if (sorted) {
+			return;
+		}
+
+		if (p_size <= INSERTION_SORT_THRESHOLD) {
+			_insertion_sort(src, p_size);
+		} else {
+			uint32_t passes[PASS_COUNT];
+			uint32_t pass_count = 0;
+			for (uint32_t i = 0; i < PASS_COUNT; i++) {
+				if (((changed_bits[i / DIGITS_PER_WORD] >> ((i % DIGITS_PER_WORD) * DIGIT_BITS)) & (DIGIT_COUNT - 1)) != 0) {
+					passes[pass_count++] = i;
+				}
+			}
+
+			for (uint32_t i = 0; i < pass_count; i++) {
+				memset(histograms[i], 0, sizeof(histograms[i]));
+			}
+			for (uint32_t i = 0; i < p_size; i++) {
+				for (uint32_t j = 0; j < pass_count; j++) {
+					histograms[j][_get_digit(src[i], passes[j])]++;
+				}
+			}
+
+			scratch.resize(p_size);
+			Element *dst = scratch.ptr();
+
+			for (uint32_t i = 0; i < pass_count; i++) {
+				uint32_t *histogram = histograms[i];
+				uint32_t offset = 0;
+				for (uint32_t j = 0; j < DIGIT_COUNT; j++) {
+					uint32_t count = histogram[j];
+					histogram[j] = offset;
+					offset += count;
+				}
+
+				const uint32_t pass = passes[i];
+				for (uint32_t j = 0; j < p_size; j++) {
+					dst[histogram[_get_digit(src[j], pass)]++] = src[j];
+				}
+				SWAP(src, dst);
+			}
+		}
+
+		for (uint32_t i = 0; i < p_size; i++) {
+			p_array[i] = src[i].value;
+		}
+	}
+};
+
+#endif // RADIX_SORT_H
@@ -829,6 +829,7 @@ void MaterialData::update_textures(const HashMap<StringName, Variant> &p_paramet
 
 	bool uses_global_textures = false;
 	global_textures_pass++;
+	streamed_textures.clear();
 
 	for (int i = 0, k = 0; i < p_texture_uniforms.size(); i++) {
 		const StringName &uniform_name = p_texture_uniforms[i].name;
@@ -991,6 +992,9 @@ void MaterialData::update_textures(const HashMap<StringName, Variant> &p_paramet
 
 				if (tex) {
 					gl_texture = textures[j];
+					if (tex->streaming && !streamed_textures.has(textures[j])) {
+						streamed_textures.push_back(textures[j]);
+					}
 #ifdef TOOLS_ENABLED
 					if (tex->detect_3d_callback && p_is_3d_shader_type) {
 						tex->detect_3d_callback(tex->detect_3d_callback_ud);
@@ -2339,13 +2343,22 @@ void MaterialStorage::_update_queued_materials() {
 	while (material_update_list.first()) {
 		Material *material = material_update_list.first()->self();
 
+		bool streamed_textures_changed = false;
+
 		if (material->data) {
+			Vector<RID> streamed_textures = material->data->streamed_textures;
 			material->data->update_parameters(material->params, material->uniform_dirty, material->texture_dirty);
+			streamed_textures_changed = material->data->streamed_textures != streamed_textures;
 		}
 		material->texture_dirty = false;
 		material->uniform_dirty = false;
 
 		material_update_list.remove(&material->update_element);
+
+		if (streamed_textures_changed) {
+			// Instances keep the list of streamed textures they use.
+			material->dependency.changed_notify(Dependency::DEPENDENCY_CHANGED_MATERIAL);
+		}
 	}
 }
 
@@ -2516,6 +2529,21 @@ void MaterialStorage::material_get_instance_shader_parameters(RID p_material, Li
 	}
 }
 
+void MaterialStorage::material_get_streamed_textures(RID p_material, LocalVector<RID> *r_textures) {
+	GLES3::Material *material = material_owner.get_or_null(p_material);
+	ERR_FAIL_NULL(material);
+	if (material->data) {
+		for (const RID &texture : material->data->streamed_textures) {
+			if (!r_textures->has(texture)) {
+				r_textures->push_back(texture);
+			}
+		}
+	}
+	if (material->next_pass.is_valid()) {
+		material_get_streamed_textures(material->next_pass, r_textures);
+	}
+}
+
 void MaterialStorage::material_update_dependency(RID p_material, DependencyTracker *p_instance) {
 	Material *material = material_owner.get_or_null(p_material);
 	ERR_FAIL_NULL(material);
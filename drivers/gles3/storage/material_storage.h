@@ -103,6 +103,7 @@ protected:
 	Vector<uint8_t> ubo_data;
 	GLuint uniform_buffer = GLuint(0);
 	Vector<RID> texture_cache;
+	Vector<RID> streamed_textures;
 
 private:
 	friend class MaterialStorage;
@@ -621,6 +622,8 @@ public:
 
 	virtual void material_get_instance_shader_parameters(RID p_material, List<InstanceShaderParam> *r_parameters) override;
 
+	virtual void material_get_streamed_textures(RID p_material, LocalVector<RID> *r_textures) override;
+
 	virtual void material_update_dependency(RID p_material, DependencyTracker *p_instance) override;
 
 	_FORCE_INLINE_ uint32_t material_get_shader_id(RID p_material) {
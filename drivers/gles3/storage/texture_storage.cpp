@@ -1476,6 +1476,13 @@ void TextureStorage::texture_set_force_redraw_if_visible(RID p_texture, bool p_e
 	texture->redraw_if_visible = p_enable;
 }
 
+void TextureStorage::texture_set_streaming(RID p_texture, bool p_enable) {
+	Texture *texture = texture_owner.get_or_null(p_texture);
+	ERR_FAIL_NULL(texture);
+
+	texture->streaming = p_enable;
+}
+
 Size2 TextureStorage::texture_size_with_proxy(RID p_texture) {
 	const Texture *texture = texture_owner.get_or_null(p_texture);
 	ERR_FAIL_NULL_V(texture, Size2());
@@ -195,6 +195,7 @@ struct Texture {
 	Vector<Ref<Image>> image_cache_3d;
 
 	bool redraw_if_visible = false;
+	bool streaming = false;
 
 	RS::TextureDetectCallback detect_3d_callback = nullptr;
 	void *detect_3d_callback_ud = nullptr;
@@ -229,6 +230,7 @@ struct Texture {
 		render_target = o.render_target;
 		is_render_target = o.is_render_target;
 		redraw_if_visible = o.redraw_if_visible;
+		streaming = o.streaming;
 		detect_3d_callback = o.detect_3d_callback;
 		detect_3d_callback_ud = o.detect_3d_callback_ud;
 		detect_normal_callback = o.detect_normal_callback;
@@ -544,6 +546,7 @@ public:
 	virtual void texture_debug_usage(List<RS::TextureInfo> *r_info) override;
 
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) override;
+	virtual void texture_set_streaming(RID p_texture, bool p_enable) override;
 
 	virtual Size2 texture_size_with_proxy(RID p_proxy) override;
 
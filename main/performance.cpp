@@ -34,6 +34,7 @@
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
+#include "scene/resources/texture_streamer.h"
 #include "servers/audio_server.h"
 #include "servers/navigation_server_3d.h"
 #include "servers/rendering_server.h"
@@ -97,6 +98,15 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_SURFACE);
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_DRAW);
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_SPECIALIZATION);
+	BIND_ENUM_CONSTANT(NAVIGATION_MAP_SYNC_TIME);
+	BIND_ENUM_CONSTANT(NAVIGATION_AVOIDANCE_TIME);
+	BIND_ENUM_CONSTANT(TEXTURE_STREAMING_TEXTURE_COUNT);
+	BIND_ENUM_CONSTANT(TEXTURE_STREAMING_MEMORY_USED);
+	BIND_ENUM_CONSTANT(TEXTURE_STREAMING_MEMORY_REQUESTED);
+	BIND_ENUM_CONSTANT(TEXTURE_STREAMING_PENDING_LOADS);
+	BIND_ENUM_CONSTANT(SHADER_CODE_CACHE_HITS);
+	BIND_ENUM_CONSTANT(SHADER_CODE_CACHE_MISSES);
+	BIND_ENUM_CONSTANT(SHADER_CODE_COMPILE_TIME);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -153,6 +163,15 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("pipeline/compilations_surface"),
 		PNAME("pipeline/compilations_draw"),
 		PNAME("pipeline/compilations_specialization"),
+		PNAME("navigation/map_sync_time"),
+		PNAME("navigation/avoidance_time"),
+		PNAME("texture_streaming/textures"),
+		PNAME("texture_streaming/memory_used"),
+		PNAME("texture_streaming/memory_requested"),
+		PNAME("texture_streaming/pending_loads"),
+		PNAME("shader_code/cache_hits"),
+		PNAME("shader_code/cache_misses"),
+		PNAME("shader_code/compile_time"),
 	};
 
 	return names[p_monitor];
@@ -248,6 +267,24 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
 		case NAVIGATION_OBSTACLE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_OBSTACLE_COUNT);
+		case NAVIGATION_MAP_SYNC_TIME:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_MAP_SYNC_TIME) / 1000000.0;
+		case NAVIGATION_AVOIDANCE_TIME:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_AVOIDANCE_TIME) / 1000000.0;
+		case TEXTURE_STREAMING_TEXTURE_COUNT:
+			return TextureStreamer::get_singleton() ? TextureStreamer::get_singleton()->get_texture_count() : 0;
+		case TEXTURE_STREAMING_MEMORY_USED:
+			return TextureStreamer::get_singleton() ? TextureStreamer::get_singleton()->get_memory_used() : 0;
+		case TEXTURE_STREAMING_MEMORY_REQUESTED:
+			return TextureStreamer::get_singleton() ? TextureStreamer::get_singleton()->get_memory_requested() : 0;
+		case TEXTURE_STREAMING_PENDING_LOADS:
+			return TextureStreamer::get_singleton() ? TextureStreamer::get_singleton()->get_pending_load_count() : 0;
+		case SHADER_CODE_CACHE_HITS:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_SHADER_CODE_CACHE_HITS);
+		case SHADER_CODE_CACHE_MISSES:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_SHADER_CODE_CACHE_MISSES);
+		case SHADER_CODE_COMPILE_TIME:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_SHADER_CODE_COMPILE_TIME) / 1000000.0;
 
 		default: {
 		}
@@ -296,6 +333,20 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
 
 	};
 
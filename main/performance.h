@@ -106,6 +106,15 @@ public:
 		PIPELINE_COMPILATIONS_SURFACE,
 		PIPELINE_COMPILATIONS_DRAW,
 		PIPELINE_COMPILATIONS_SPECIALIZATION,
+		NAVIGATION_MAP_SYNC_TIME,
+		NAVIGATION_AVOIDANCE_TIME,
+		TEXTURE_STREAMING_TEXTURE_COUNT,
+		TEXTURE_STREAMING_MEMORY_USED,
+		TEXTURE_STREAMING_MEMORY_REQUESTED,
+		TEXTURE_STREAMING_PENDING_LOADS,
+		SHADER_CODE_CACHE_HITS,
+		SHADER_CODE_CACHE_MISSES,
+		SHADER_CODE_COMPILE_TIME,
 		MONITOR_MAX
 	};
 
@@ -148,6 +148,38 @@ void GodotBody2D::set_active(bool p_active) {
 	}
 }
 
+void GodotBody2D::get_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody2D::restore_snapshot(const Snapshot &p_snapshot) {
+	// The inverse is restored as saved rather than recomputed, so the next step starts from bit-identical state.
+	_set_transform(p_snapshot.transform);
+	_set_inv_transform(p_snapshot.inv_transform);
+	new_transform = p_snapshot.transform;
+	_update_transform_dependent();
+
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	biased_linear_velocity = Vector2();
+	biased_angular_velocity = 0.0;
+	applied_force = p_snapshot.applied_force;
+	applied_torque = p_snapshot.applied_torque;
+	still_time = p_snapshot.still_time;
+	set_active(p_snapshot.active);
+}
+
 void GodotBody2D::set_param(PhysicsServer2D::BodyParameter p_param, const Variant &p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::BODY_PARAM_BOUNCE: {
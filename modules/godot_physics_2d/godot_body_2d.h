@@ -284,6 +284,23 @@ public:
 	void set_active(bool p_active);
 	_FORCE_INLINE_ bool is_active() const { return active; }
 
+	// Simulation state saved in space snapshots, parameters set by the user are not included.
+	struct Snapshot {
+		Transform2D transform;
+		Transform2D inv_transform;
+		Vector2 linear_velocity;
+		real_t angular_velocity = 0.0;
+		Vector2 prev_linear_velocity;
+		real_t prev_angular_velocity = 0.0;
+		Vector2 applied_force;
+		real_t applied_torque = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void get_snapshot(Snapshot &r_snapshot) const;
+	void restore_snapshot(const Snapshot &p_snapshot);
+
 	_FORCE_INLINE_ void wakeup() {
 		if ((!get_space()) || mode == PhysicsServer2D::BODY_MODE_STATIC || mode == PhysicsServer2D::BODY_MODE_KINEMATIC) {
 			return;
@@ -593,6 +593,39 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+void GodotBodyPair2D::get_snapshot(uint8_t *r_data) const {
+	Snapshot snapshot;
+	snapshot.shape_A = shape_A;
+	snapshot.shape_B = shape_B;
+	snapshot.sep_axis = sep_axis;
+	snapshot.contact_count = contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		snapshot.contacts[i] = contacts[i];
+	}
+	memcpy(r_data, &snapshot, sizeof(Snapshot));
+}
+
+bool GodotBodyPair2D::restore_snapshot(const uint8_t *p_data) {
+	if (!p_data) {
+		sep_axis = Vector2();
+		contact_count = 0;
+		return true;
+	}
+
+	Snapshot snapshot;
+	memcpy(&snapshot, p_data, sizeof(Snapshot));
+	if (snapshot.shape_A != shape_A || snapshot.shape_B != shape_B || snapshot.contact_count < 0 || snapshot.contact_count > MAX_CONTACTS) {
+		return false;
+	}
+
+	sep_axis = snapshot.sep_axis;
+	contact_count = snapshot.contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		contacts[i] = snapshot.contacts[i];
+	}
+	return true;
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
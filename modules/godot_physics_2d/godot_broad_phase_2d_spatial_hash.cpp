@@ -0,0 +1,429 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_spatial_hash.cpp                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_broad_phase_2d_spatial_hash.h"
+#include "godot_collision_object_2d.h"
+
+#include "core/config/project_settings.h"
+
+// Same as the BVH broad phase: objects pair when their AABB, grown by this margin, overlaps another one.
+#define PAIRING_EXPANSION 0.1
+
+void GodotBroadPhase2DSpatialHash::_erase_id(LocalVector<ID> &p_ids, ID p_id) {
+	int64_t index = p_ids.find(p_id);
+	ERR_FAIL_COND(index < 0);
+	p_ids.remove_at_unordered(index);
+}
+
+void GodotBroadPhase2DSpatialHash::_insert(ID p_id) {
+	Element &e = elements[p_id - 1];
+	Rect2i element_cells = _get_cells(e.expanded_aabb);
+
+	e.large = _get_cell_count(element_cells) > large_object_cells;
+	if (e.large) {
+		large_elements.push_back(p_id);
+		return;
+	}
+
+	e.cells = element_cells;
+	const Vector2i end = element_cells.get_end();
+	for (int y = element_cells.position.y; y < end.y; y++) {
+		for (int x = element_cells.position.x; x < end.x; x++) {
+			cells[Vector2i(x, y)].push_back(p_id);
+		}
+	}
+}
+
+void GodotBroadPhase2DSpatialHash::_erase(ID p_id) {
+	Element &e = elements[p_id - 1];
+	if (e.large) {
+		_erase_id(large_elements, p_id);
+		return;
+	}
+
+	const Vector2i end = e.cells.get_end();
+	for (int y = e.cells.position.y; y < end.y; y++) {
+		for (int x = e.cells.position.x; x < end.x; x++) {
+			HashMap<Vector2i, LocalVector<ID>>::Iterator cell = cells.find(Vector2i(x, y));
+			ERR_CONTINUE(!cell);
+			_erase_id(cell->value, p_id);
+			if (cell->value.is_empty()) {
+				cells.remove(cell);
+			}
+		}
+	}
+}
+
+void GodotBroadPhase2DSpatialHash::_add_changed(ID p_id, bool p_full_check) {
+	Element &e = elements[p_id - 1];
+	e.full_check = e.full_check || p_full_check;
+	if (!e.changed) {
+		e.changed = true;
+		changed_elements.push_back(p_id);
+	}
+}
+
+bool GodotBroadPhase2DSpatialHash::_pair_allowed(const Element &p_a, const Element &p_b) const {
+	if (p_a._static && p_b._static) {
+		return false;
+	}
+	if (p_a.owner == p_b.owner) {
+		return false;
+	}
+	return p_a.owner->interacts_with(p_b.owner);
+}
+
+void GodotBroadPhase2DSpatialHash::_pair(ID p_a, ID p_b) {
+	if (p_a > p_b) {
+		SWAP(p_a, p_b);
+	}
+
+	Element &a = elements[p_a - 1];
+	Element &b = elements[p_b - 1];
+	a.pairs.push_back(p_b);
+	b.pairs.push_back(p_a);
+
+	void *data = nullptr;
+	if (pair_callback) {
+		data = pair_callback(a.owner, a.subindex, b.owner, b.subindex, pair_userdata);
+	}
+	pairs.insert(_get_pair_key(p_a, p_b), data);
+}
+
+void GodotBroadPhase2DSpatialHash::_unpair(ID p_a, ID p_b) {
+	if (p_a > p_b) {
+		SWAP(p_a, p_b);
+	}
+
+	HashMap<uint64_t, void *>::Iterator pair = pairs.find(_get_pair_key(p_a, p_b));
+	ERR_FAIL_COND(!pair);
+	void *data = pair->value;
+	pairs.remove(pair);
+
+	Element &a = elements[p_a - 1];
+	Element &b = elements[p_b - 1];
+	_erase_id(a.pairs, p_b);
+	_erase_id(b.pairs, p_a);
+
+	if (unpair_callback) {
+		unpair_callback(a.owner, a.subindex, b.owner, b.subindex, data, unpair_userdata);
+	}
+}
+
+void GodotBroadPhase2DSpatialHash::_query_cell(const Vector2i &p_cell) {
+	HashMap<Vector2i, LocalVector<ID>>::ConstIterator cell = cells.find(p_cell);
+	if (!cell) {
+		return;
+	}
+
+	for (ID id : cell->value) {
+		Element &e = elements[id - 1];
+		if (e.pass != pass) {
+			e.pass = pass;
+			query_results.push_back(id);
+		}
+	}
+}
+
+void GodotBroadPhase2DSpatialHash::_query_aabb(const Rect2 &p_aabb) {
+	pass++;
+	query_results.clear();
+
+	Rect2i query_cells = _get_cells(p_aabb);
+	if (_get_cell_count(query_cells) > element_count) {
+		// Cheaper to go through every element than to look up that many cells.
+		for (uint32_t i = 0; i < elements.size(); i++) {
+			if (elements[i].owner) {
+				query_results.push_back(i + 1);
+			}
+		}
+		return;
+	}
+
+	for (ID id : large_elements) {
+		query_results.push_back(id);
+	}
+
+	const Vector2i end = query_cells.get_end();
+	for (int y = query_cells.position.y; y < end.y; y++) {
+		for (int x = query_cells.position.x; x < end.x; x++) {
+			_query_cell(Vector2i(x, y));
+		}
+	}
+}
+
+void GodotBroadPhase2DSpatialHash::_query_segment(const Vector2 &p_from, const Vector2 &p_to) {
+	Vector2i cell(_get_cell(p_from.x), _get_cell(p_from.y));
+	const Vector2i end_cell(_get_cell(p_to.x), _get_cell(p_to.y));
+	const uint64_t step_count = uint64_t(ABS(int64_t(end_cell.x) - cell.x)) + uint64_t(ABS(int64_t(end_cell.y) - cell.y));
+	if (step_count > element_count) {
+		_query_aabb(Rect2(p_from, Vector2()).expand(p_to));
+		return;
+	}
+
+	pass++;
+	query_results.clear();
+	for (ID id : large_elements) {
+		query_results.push_back(id);
+	}
+
+	// Walk the cells crossed by the segment, see "A Fast Voxel Traversal Algorithm for Ray Tracing" (Amanatides & Woo).
+	const Vector2 dir = p_to - p_from;
+	Vector2i step;
+	Vector2 t_max;
+	Vector2 t_delta;
+	for (int i = 0; i < 2; i++) {
+		if (dir[i] == 0.0) {
+			step[i] = 0;
+			t_max[i] = INFINITY;
+			t_delta[i] = INFINITY;
+		} else {
+			step[i] = dir[i] > 0.0 ? 1 : -1;
+			const real_t boundary = (cell[i] + (step[i] > 0 ? 1 : 0)) * cell_size;
+			t_max[i] = (boundary - p_from[i]) / dir[i];
+			t_delta[i] = cell_size / Math::abs(dir[i]);
+		}
+	}
+
+	for (uint64_t i = 0; i <= step_count; i++) {
+		_query_cell(cell);
+		if (cell == end_cell) {
+			break;
+		}
+		if (t_max.x < t_max.y) {
+			cell.x += step.x;
+			t_max.x += t_delta.x;
+		} else {
+			cell.y += step.y;
+			t_max.y += t_delta.y;
+		}
+	}
+}
+
+GodotBroadPhase2D::ID GodotBroadPhase2DSpatialHash::create(GodotCollisionObject2D *p_object, int p_subindex, const Rect2 &p_aabb, bool p_static) {
+	ID id;
+	if (free_ids.is_empty()) {
+		elements.push_back(Element());
+		id = elements.size();
+	} else {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	}
+
+	Element &e = elements[id - 1];
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e._static = p_static;
+	e.aabb = p_aabb;
+	e.expanded_aabb = p_aabb.grow(PAIRING_EXPANSION);
+	e.pass = 0;
+	element_count++;
+
+	_insert(id);
+	_add_changed(id, true);
+
+	return id;
+}
+
+void GodotBroadPhase2DSpatialHash::move(ID p_id, const Rect2 &p_aabb) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_NULL(e.owner);
+
+	e.aabb = p_aabb;
+
+	// Keep the expanded AABB, and thus pairs and cells, as long as it still fits the new AABB.
+	const Vector2 max_expanded_size = p_aabb.size + Vector2(PAIRING_EXPANSION, PAIRING_EXPANSION) * 4.0;
+	if (e.expanded_aabb.encloses(p_aabb) && e.expanded_aabb.size.x <= max_expanded_size.x && e.expanded_aabb.size.y <= max_expanded_size.y) {
+		return;
+	}
+
+	e.expanded_aabb = p_aabb.grow(PAIRING_EXPANSION);
+	Rect2i element_cells = _get_cells(e.expanded_aabb);
+	if (e.large || element_cells != e.cells) {
+		_erase(p_id);
+		_insert(p_id);
+	}
+	_add_changed(p_id, false);
+}
+
+void GodotBroadPhase2DSpatialHash::set_static(ID p_id, bool p_static) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_NULL(e.owner);
+
+	if (e._static == p_static) {
+		return;
+	}
+	e._static = p_static;
+	_add_changed(p_id, true);
+}
+
+void GodotBroadPhase2DSpatialHash::remove(ID p_id) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_NULL(e.owner);
+
+	// Pairs must go right away, they can't refer to a removed object.
+	while (!e.pairs.is_empty()) {
+		_unpair(p_id, e.pairs[e.pairs.size() - 1]);
+	}
+	_erase(p_id);
+
+	// Still in the changed list if it was, `update()` skips it.
+	e.owner = nullptr;
+	e.full_check = false;
+	e.pairs.reset();
+	free_ids.push_back(p_id);
+	element_count--;
+}
+
+GodotCollisionObject2D *GodotBroadPhase2DSpatialHash::get_object(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), nullptr);
+	GodotCollisionObject2D *it = elements[p_id - 1].owner;
+	ERR_FAIL_NULL_V(it, nullptr);
+	return it;
+}
+
+bool GodotBroadPhase2DSpatialHash::is_static(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), false);
+	return elements[p_id - 1]._static;
+}
+
+int GodotBroadPhase2DSpatialHash::get_subindex(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), 0);
+	return elements[p_id - 1].subindex;
+}
+
+int GodotBroadPhase2DSpatialHash::cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	_query_segment(p_from, p_to);
+
+	int count = 0;
+	for (ID id : query_results) {
+		if (count >= p_max_results) {
+			break;
+		}
+		const Element &e = elements[id - 1];
+		if (!e.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		p_results[count] = e.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = e.subindex;
+		}
+		count++;
+	}
+
+	return count;
+}
+
+int GodotBroadPhase2DSpatialHash::cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	_query_aabb(p_aabb);
+
+	int count = 0;
+	for (ID id : query_results) {
+		if (count >= p_max_results) {
+			break;
+		}
+		const Element &e = elements[id - 1];
+		if (!e.aabb.intersects(p_aabb, true)) {
+			continue;
+		}
+
+		p_results[count] = e.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = e.subindex;
+		}
+		count++;
+	}
+
+	return count;
+}
+
+void GodotBroadPhase2DSpatialHash::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DSpatialHash::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DSpatialHash::update() {
+	for (uint32_t i = 0; i < changed_elements.size(); i++) {
+		const ID id = changed_elements[i];
+		Element &e = elements[id - 1];
+		e.changed = false;
+		if (!e.owner) {
+			continue; // Removed since.
+		}
+
+		// Drop the pairs this element left. Expanded AABBs are compared on both sides, as the other
+		// element may have moved within its own expanded AABB without being updated.
+		for (uint32_t j = 0; j < e.pairs.size(); j++) {
+			const Element &other = elements[e.pairs[j] - 1];
+			if (!e.expanded_aabb.intersects(other.expanded_aabb, true) || (e.full_check && !_pair_allowed(e, other))) {
+				_unpair(id, e.pairs[j]);
+				j--; // Erased by swapping with the last pair.
+			}
+		}
+		e.full_check = false;
+
+		// Then add the new ones.
+		_query_aabb(e.expanded_aabb);
+		for (ID other_id : query_results) {
+			if (other_id == id) {
+				continue;
+			}
+			const Element &other = elements[other_id - 1];
+			if (!e.expanded_aabb.intersects(other.expanded_aabb, true) || !_pair_allowed(e, other)) {
+				continue;
+			}
+			if (pairs.has(_get_pair_key(id, other_id))) {
+				continue;
+			}
+			_pair(id, other_id);
+		}
+	}
+
+	changed_elements.clear();
+}
+
+GodotBroadPhase2D *GodotBroadPhase2DSpatialHash::_create() {
+	return memnew(GodotBroadPhase2DSpatialHash(GLOBAL_GET("physics/2d/spatial_hash/cell_size"), GLOBAL_GET("physics/2d/spatial_hash/large_object_surface_threshold_in_cells")));
+}
+
+GodotBroadPhase2DSpatialHash::GodotBroadPhase2DSpatialHash(real_t p_cell_size, uint32_t p_large_object_cells) {
+	ERR_FAIL_COND(p_cell_size <= 0.0);
+	cell_size = p_cell_size;
+	large_object_cells = MAX(p_large_object_cells, 1u);
+}
@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_spatial_hash.h                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_BROAD_PHASE_2D_SPATIAL_HASH_H
+#define GODOT_BROAD_PHASE_2D_SPATIAL_HASH_H
+
+#include "godot_broad_phase_2d.h"
+
+#include "core/math/rect2.h"
+#include "core/math/rect2i.h"
+#include "core/math/vector2.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Broad phase hashing objects into a uniform grid of cells.
+// Unlike a tree it has nothing to rebalance when objects move, which suits many small moving objects of similar size.
+// Objects covering too many cells are kept in a separate list and tested against everything.
+class GodotBroadPhase2DSpatialHash : public GodotBroadPhase2D {
+	struct Element {
+		GodotCollisionObject2D *owner = nullptr;
+		Rect2 aabb;
+		Rect2 expanded_aabb; // Pairing is only updated once the AABB leaves it.
+		Rect2i cells; // Cells the element is inserted in, unused for large elements.
+		int subindex = 0;
+		bool _static = false;
+		bool large = false;
+		bool changed = false; // Is in the changed list.
+		bool full_check = false; // Pairs must be checked again even if their AABBs still overlap.
+		uint64_t pass = 0;
+		LocalVector<ID> pairs;
+	};
+
+	LocalVector<Element> elements; // Indexed by ID - 1.
+	LocalVector<ID> free_ids;
+	uint32_t element_count = 0;
+
+	HashMap<Vector2i, LocalVector<ID>> cells;
+	LocalVector<ID> large_elements;
+	LocalVector<ID> changed_elements;
+
+	HashMap<uint64_t, void *> pairs; // Pair data, by lower ID in the high bits and higher ID in the low bits.
+
+	LocalVector<ID> query_results;
+	uint64_t pass = 1;
+
+	real_t cell_size = 128.0;
+	uint32_t large_object_cells = 512;
+
+	PairCallback pair_callback = nullptr;
+	void *pair_userdata = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *unpair_userdata = nullptr;
+
+	static const int CELL_LIMIT = 1 << 30;
+
+	_FORCE_INLINE_ int _get_cell(real_t p_coord) const {
+		return (int)CLAMP(Math::floor(p_coord / cell_size), (real_t)-CELL_LIMIT, (real_t)CELL_LIMIT);
+	}
+	_FORCE_INLINE_ Rect2i _get_cells(const Rect2 &p_aabb) const {
+		Vector2i from(_get_cell(p_aabb.position.x), _get_cell(p_aabb.position.y));
+		Vector2i to(_get_cell(p_aabb.position.x + p_aabb.size.x), _get_cell(p_aabb.position.y + p_aabb.size.y));
+		return Rect2i(from, to - from + Vector2i(1, 1));
+	}
+	_FORCE_INLINE_ static uint64_t _get_cell_count(const Rect2i &p_cells) {
+		return uint64_t(p_cells.size.x) * uint64_t(p_cells.size.y);
+	}
+	_FORCE_INLINE_ static uint64_t _get_pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? (uint64_t(p_a) << 32) | p_b : (uint64_t(p_b) << 32) | p_a;
+	}
+
+	static void _erase_id(LocalVector<ID> &p_ids, ID p_id);
+
+	void _insert(ID p_id);
+	void _erase(ID p_id);
+	void _add_changed(ID p_id, bool p_full_check);
+
+	bool _pair_allowed(const Element &p_a, const Element &p_b) const;
+	void _pair(ID p_a, ID p_b);
+	void _unpair(ID p_a, ID p_b);
+
+	void _query_cell(const Vector2i &p_cell);
+	void _query_aabb(const Rect2 &p_aabb);
+	void _query_segment(const Vector2 &p_from, const Vector2 &p_to);
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(GodotCollisionObject2D *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false) override;
+	virtual void move(ID p_id, const Rect2 &p_aabb) override;
+	virtual void set_static(ID p_id, bool p_static) override;
+	virtual void remove(ID p_id) override;
+
+	virtual GodotCollisionObject2D *get_object(ID p_id) const override;
+	virtual bool is_static(ID p_id) const override;
+	virtual int get_subindex(ID p_id) const override;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
+
+	virtual void update() override;
+
+	static GodotBroadPhase2D *_create();
+	GodotBroadPhase2DSpatialHash(real_t p_cell_size = 128.0, uint32_t p_large_object_cells = 512);
+};
+
+#endif // GODOT_BROAD_PHASE_2D_SPATIAL_HASH_H
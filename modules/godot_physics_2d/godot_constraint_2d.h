@@ -64,6 +64,12 @@ public:
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// Solver state carried between steps (such as accumulated contact impulses), saved in space snapshots.
+	virtual uint32_t get_snapshot_size() const { return 0; }
+	virtual void get_snapshot(uint8_t *r_data) const {}
+	// Resets the state when p_data is null. Returns false if the data doesn't match this constraint.
+	virtual bool restore_snapshot(const uint8_t *p_data) { return false; }
+
 	virtual ~GodotConstraint2D() {}
 };
 
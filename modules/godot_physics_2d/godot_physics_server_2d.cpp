@@ -32,6 +32,7 @@
 
 #include "godot_body_direct_state_2d.h"
 #include "godot_broad_phase_2d_bvh.h"
+#include "godot_broad_phase_2d_spatial_hash.h"
 #include "godot_collision_solver_2d.h"
 
 #include "core/config/project_settings.h"
@@ -276,6 +277,20 @@ int GodotPhysicsServer2D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PackedByteArray GodotPhysicsServer2D::space_get_snapshot(RID p_space) const {
+	const GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+	ERR_FAIL_COND_V_MSG(space->is_locked(), PackedByteArray(), "Space snapshots can't be taken while the space is being stepped.");
+	return space->get_snapshot();
+}
+
+bool GodotPhysicsServer2D::space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, false);
+	ERR_FAIL_COND_V_MSG(space->is_locked(), false, "Space snapshots can't be restored while the space is being stepped.");
+	return space->restore_snapshot(p_snapshot);
+}
+
 PhysicsDirectSpaceState2D *GodotPhysicsServer2D::space_get_direct_state(RID p_space) {
 	GodotSpace2D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_NULL_V(space, nullptr);
@@ -1329,6 +1344,7 @@ void GodotPhysicsServer2D::flush_queries() {
 		uint64_t total_time[GodotSpace2D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace2D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broad_phase",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
@@ -1394,7 +1410,11 @@ GodotPhysicsServer2D *GodotPhysicsServer2D::godot_singleton = nullptr;
 
 GodotPhysicsServer2D::GodotPhysicsServer2D(bool p_using_threads) {
 	godot_singleton = this;
-	GodotBroadPhase2D::create_func = GodotBroadPhase2DBVH::_create;
+	if (int(GLOBAL_GET("physics/2d/broad_phase")) == BROAD_PHASE_SPATIAL_HASH) {
+		GodotBroadPhase2D::create_func = GodotBroadPhase2DSpatialHash::_create;
+	} else {
+		GodotBroadPhase2D::create_func = GodotBroadPhase2DBVH::_create;
+	}
 
 	using_threads = p_using_threads;
 }
@@ -44,6 +44,14 @@ class GodotPhysicsServer2D : public PhysicsServer2D {
 
 	friend class GodotPhysicsDirectSpaceState2D;
 	friend class GodotPhysicsDirectBodyState2D;
+	friend class TestGodotPhysicsServer2DAccessor;
+
+	// Values of the "physics/2d/broad_phase" project setting.
+	enum BroadPhaseType {
+		BROAD_PHASE_BVH,
+		BROAD_PHASE_SPATIAL_HASH,
+	};
+
 	bool active = true;
 	bool doing_sync = false;
 
@@ -116,6 +124,9 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual PackedByteArray space_get_snapshot(RID p_space) const override;
+	virtual bool space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) override;
+
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) override;
 
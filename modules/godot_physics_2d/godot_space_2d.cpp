@@ -1211,6 +1211,169 @@ bool GodotSpace2D::is_locked() const {
 	return locked;
 }
 
+// Snapshots are raw memory dumps meant for rollback within the same build, they aren't portable between builds or platforms.
+#define SPACE_SNAPSHOT_MAGIC 0x32535047 // "GPS2"
+#define SPACE_SNAPSHOT_VERSION 1
+
+struct SpaceSnapshotHeader {
+	uint32_t magic = SPACE_SNAPSHOT_MAGIC;
+	uint32_t version = SPACE_SNAPSHOT_VERSION;
+	uint32_t real_size = sizeof(real_t);
+	uint32_t body_count = 0;
+	uint32_t pair_count = 0;
+};
+
+struct SpaceSnapshotBody {
+	uint64_t rid = 0;
+	GodotBody2D::Snapshot state;
+};
+
+struct SpaceSnapshotPair {
+	uint64_t rid_A = 0;
+	uint64_t rid_B = 0;
+	uint32_t size = 0;
+};
+
+PackedByteArray GodotSpace2D::get_snapshot() const {
+	LocalVector<const GodotBody2D *> bodies;
+	LocalVector<const GodotConstraint2D *> pairs;
+	uint32_t size = sizeof(SpaceSnapshotHeader);
+
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+		bodies.push_back(body);
+		size += sizeof(SpaceSnapshotBody);
+
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			// Pairs are registered in both bodies, only save them from the first one.
+			if (E.second != 0 || E.first->get_snapshot_size() == 0) {
+				continue;
+			}
+			pairs.push_back(E.first);
+			size += sizeof(SpaceSnapshotPair) + E.first->get_snapshot_size();
+		}
+	}
+
+	PackedByteArray snapshot;
+	snapshot.resize(size);
+	uint8_t *w = snapshot.ptrw();
+
+	SpaceSnapshotHeader header;
+	header.body_count = bodies.size();
+	header.pair_count = pairs.size();
+	memcpy(w, &header, sizeof(SpaceSnapshotHeader));
+	w += sizeof(SpaceSnapshotHeader);
+
+	for (const GodotBody2D *body : bodies) {
+		SpaceSnapshotBody record;
+		record.rid = body->get_self().get_id();
+		body->get_snapshot(record.state);
+		memcpy(w, &record, sizeof(SpaceSnapshotBody));
+		w += sizeof(SpaceSnapshotBody);
+	}
+
+	for (const GodotConstraint2D *pair : pairs) {
+		SpaceSnapshotPair record;
+		record.rid_A = pair->get_body_ptr()[0]->get_self().get_id();
+		record.rid_B = pair->get_body_ptr()[1]->get_self().get_id();
+		record.size = pair->get_snapshot_size();
+		memcpy(w, &record, sizeof(SpaceSnapshotPair));
+		w += sizeof(SpaceSnapshotPair);
+		pair->get_snapshot(w);
+		w += record.size;
+	}
+
+	return snapshot;
+}
+
+bool GodotSpace2D::restore_snapshot(const PackedByteArray &p_snapshot) {
+	ERR_FAIL_COND_V(locked, false);
+
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *end = r + p_snapshot.size();
+
+	ERR_FAIL_COND_V_MSG(p_snapshot.size() < (int64_t)sizeof(SpaceSnapshotHeader), false, "Invalid physics space snapshot.");
+	SpaceSnapshotHeader header;
+	memcpy(&header, r, sizeof(SpaceSnapshotHeader));
+	r += sizeof(SpaceSnapshotHeader);
+	ERR_FAIL_COND_V_MSG(header.magic != SPACE_SNAPSHOT_MAGIC || header.version != SPACE_SNAPSHOT_VERSION || header.real_size != sizeof(real_t), false, "Physics space snapshot was saved by an incompatible build.");
+	ERR_FAIL_COND_V_MSG(uint64_t(end - r) < uint64_t(header.body_count) * sizeof(SpaceSnapshotBody), false, "Invalid physics space snapshot.");
+
+	// Read the whole snapshot before changing anything, so an invalid one leaves the space as it is.
+	LocalVector<SpaceSnapshotBody> body_records;
+	body_records.resize(header.body_count);
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		memcpy(&body_records[i], r, sizeof(SpaceSnapshotBody));
+		r += sizeof(SpaceSnapshotBody);
+	}
+
+	struct PairRecord {
+		SpaceSnapshotPair record;
+		const uint8_t *data = nullptr;
+	};
+	LocalVector<PairRecord> pair_records;
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		PairRecord pair_record;
+		ERR_FAIL_COND_V_MSG(uint64_t(end - r) < sizeof(SpaceSnapshotPair), false, "Invalid physics space snapshot.");
+		memcpy(&pair_record.record, r, sizeof(SpaceSnapshotPair));
+		r += sizeof(SpaceSnapshotPair);
+		ERR_FAIL_COND_V_MSG(uint64_t(end - r) < pair_record.record.size, false, "Invalid physics space snapshot.");
+		pair_record.data = r;
+		r += pair_record.record.size;
+		pair_records.push_back(pair_record);
+	}
+
+	HashMap<RID, GodotBody2D *> bodies;
+	for (GodotCollisionObject2D *object : objects) {
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.insert(object->get_self(), static_cast<GodotBody2D *>(object));
+		}
+	}
+
+	// Bodies created after the snapshot was taken are left as they are.
+	for (const SpaceSnapshotBody &record : body_records) {
+		HashMap<RID, GodotBody2D *>::Iterator E = bodies.find(RID::from_uint64(record.rid));
+		if (E) {
+			E->value->restore_snapshot(record.state);
+		}
+	}
+
+	// Bring pairs up to date with the restored transforms, then reset the contacts of every pair so the ones
+	// that didn't exist when the snapshot was taken don't warm start from stale impulses.
+	broadphase->update();
+	for (const KeyValue<RID, GodotBody2D *> &E : bodies) {
+		for (const Pair<GodotConstraint2D *, int> &F : E.value->get_constraint_list()) {
+			if (F.second == 0 && F.first->get_snapshot_size() > 0) {
+				F.first->restore_snapshot(nullptr);
+			}
+		}
+	}
+
+	for (const PairRecord &pair_record : pair_records) {
+		const SpaceSnapshotPair &record = pair_record.record;
+		const uint8_t *data = pair_record.data;
+
+		HashMap<RID, GodotBody2D *>::Iterator A = bodies.find(RID::from_uint64(record.rid_A));
+		HashMap<RID, GodotBody2D *>::Iterator B = bodies.find(RID::from_uint64(record.rid_B));
+		if (!A || !B) {
+			continue;
+		}
+
+		// Bodies with several shapes have one pair per shape pair, the pair itself rejects data saved for other shapes.
+		for (const Pair<GodotConstraint2D *, int> &E : A->value->get_constraint_list()) {
+			GodotConstraint2D *pair = E.first;
+			if (E.second == 0 && pair->get_snapshot_size() == record.size && pair->get_body_ptr()[1] == B->value && pair->restore_snapshot(data)) {
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
 GodotPhysicsDirectSpaceState2D *GodotSpace2D::get_direct_state() {
 	return direct_access;
 }
@@ -0,0 +1,297 @@
+/**************************************************************************/
+/*  test_godot_broad_phase_2d.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_BROAD_PHASE_2D_H
+#define TEST_GODOT_BROAD_PHASE_2D_H
+
+#include "../godot_area_2d.h"
+#include "../godot_broad_phase_2d_bvh.h"
+#include "../godot_broad_phase_2d_spatial_hash.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotBroadPhase2D {
+
+struct World {
+	GodotArea2D *objects = nullptr;
+	int object_count = 0;
+	LocalVector<GodotBroadPhase2D::ID> ids;
+	LocalVector<Rect2> aabbs;
+	HashMap<uint64_t, int> pairs;
+	int pair_errors = 0;
+
+	uint64_t get_pair_key(GodotCollisionObject2D *p_a, GodotCollisionObject2D *p_b) const {
+		uint64_t a = static_cast<GodotArea2D *>(p_a) - objects;
+		uint64_t b = static_cast<GodotArea2D *>(p_b) - objects;
+		return a < b ? (a << 32) | b : (b << 32) | a;
+	}
+};
+
+void *pair_callback(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_userdata) {
+	World *world = static_cast<World *>(p_userdata);
+	uint64_t key = world->get_pair_key(p_a, p_b);
+	if (world->pairs.has(key)) {
+		world->pair_errors++;
+	}
+	world->pairs[key] = 1;
+	return world;
+}
+
+void unpair_callback(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_data, void *p_userdata) {
+	World *world = static_cast<World *>(p_userdata);
+	if (!world->pairs.erase(world->get_pair_key(p_a, p_b)) || p_data != world) {
+		world->pair_errors++;
+	}
+}
+
+Rect2 random_rect(RandomPCG &p_rng, real_t p_world_size, real_t p_size) {
+	return Rect2(p_rng.random(0.0f, p_world_size), p_rng.random(0.0f, p_world_size), p_rng.random(1.0f, p_size), p_rng.random(1.0f, p_size));
+}
+
+// Compares pairs and queries against brute force while objects move, appear and disappear.
+// The BVH culls against slightly grown leaf bounds, so it may return a few more objects than expected.
+void check_broad_phase(GodotBroadPhase2D *p_broad_phase, bool p_exact_culls) {
+	RandomPCG rng(7);
+	const real_t world_size = 1000.0;
+	World world;
+	world.object_count = 400;
+	world.objects = memnew_arr(GodotArea2D, world.object_count);
+	world.ids.resize(world.object_count);
+	world.aabbs.resize(world.object_count);
+	p_broad_phase->set_pair_callback(pair_callback, &world);
+	p_broad_phase->set_unpair_callback(unpair_callback, &world);
+
+	for (int i = 0; i < world.object_count; i++) {
+		// A few large objects, the rest of bullet size.
+		world.aabbs[i] = random_rect(rng, world_size, i % 50 == 0 ? 800.0 : 20.0);
+		world.ids[i] = p_broad_phase->create(&world.objects[i], 0, world.aabbs[i], i % 10 == 0);
+	}
+
+	int missing_pairs = 0;
+	int extra_pairs = 0;
+	int cull_errors = 0;
+	for (int step = 0; step < 20; step++) {
+		for (int i = 0; i < world.object_count; i++) {
+			if (i % 10 == 0) {
+				continue; // Static.
+			}
+			if (rng.rand() % 40 == 0) {
+				p_broad_phase->remove(world.ids[i]);
+				world.aabbs[i] = random_rect(rng, world_size, 20.0);
+				world.ids[i] = p_broad_phase->create(&world.objects[i], 0, world.aabbs[i], false);
+			} else {
+				world.aabbs[i].position += Vector2(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f));
+				p_broad_phase->move(world.ids[i], world.aabbs[i]);
+			}
+		}
+		p_broad_phase->update();
+
+		for (int i = 0; i < world.object_count; i++) {
+			for (int j = i + 1; j < world.object_count; j++) {
+				bool paired = world.pairs.has((uint64_t(i) << 32) | j);
+				bool can_pair = i % 10 != 0 || j % 10 != 0;
+				if (can_pair && world.aabbs[i].intersects(world.aabbs[j], true)) {
+					missing_pairs += !paired;
+				} else if (paired && !(can_pair && world.aabbs[i].grow(1.0).intersects(world.aabbs[j], true))) {
+					extra_pairs++;
+				}
+			}
+		}
+
+		GodotCollisionObject2D *results[512];
+		Rect2 query = random_rect(rng, world_size, 200.0);
+		int count = p_broad_phase->cull_aabb(query, results, 512);
+		int expected = 0;
+		for (int i = 0; i < world.object_count; i++) {
+			expected += world.aabbs[i].intersects(query, true);
+		}
+		cull_errors += p_exact_culls ? count != expected : count < expected;
+
+		Vector2 from(rng.random(0.0f, world_size), rng.random(0.0f, world_size));
+		Vector2 to(rng.random(0.0f, world_size), rng.random(0.0f, world_size));
+		count = p_broad_phase->cull_segment(from, to, results, 512);
+		expected = 0;
+		for (int i = 0; i < world.object_count; i++) {
+			expected += world.aabbs[i].intersects_segment(from, to);
+		}
+		cull_errors += p_exact_culls ? count != expected : count < expected;
+	}
+
+	CHECK(missing_pairs == 0);
+	CHECK(extra_pairs == 0);
+	CHECK(cull_errors == 0);
+	CHECK(world.pair_errors == 0);
+
+	for (int i = 0; i < world.object_count; i++) {
+		p_broad_phase->remove(world.ids[i]);
+	}
+	CHECK(world.pairs.is_empty());
+
+	memdelete_arr(world.objects);
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2D] BVH matches brute force") {
+	GodotBroadPhase2DBVH broad_phase;
+	check_broad_phase(&broad_phase, false);
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2D] Spatial hash matches brute force") {
+	GodotBroadPhase2DSpatialHash broad_phase(64.0, 64);
+	check_broad_phase(&broad_phase, true);
+
+	GodotBroadPhase2DSpatialHash small_cells(4.0, 64);
+	check_broad_phase(&small_cells, true);
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2D] Spatial hash pairs objects moving within their expanded AABB") {
+	GodotBroadPhase2DSpatialHash broad_phase;
+	World world;
+	world.object_count = 2;
+	world.objects = memnew_arr(GodotArea2D, world.object_count);
+	broad_phase.set_pair_callback(pair_callback, &world);
+	broad_phase.set_unpair_callback(unpair_callback, &world);
+
+	// Less than the pairing expansion apart, and moving toward each other by less than it,
+	// so neither leaves its expanded AABB.
+	Rect2 aabb_a(0, 0, 10, 10);
+	Rect2 aabb_b(10.12, 0, 10, 10);
+	GodotBroadPhase2D::ID a = broad_phase.create(&world.objects[0], 0, aabb_a, false);
+	GodotBroadPhase2D::ID b = broad_phase.create(&world.objects[1], 0, aabb_b, false);
+	broad_phase.update();
+
+	aabb_a.position.x += 0.08;
+	aabb_b.position.x -= 0.08;
+	broad_phase.move(a, aabb_a);
+	broad_phase.move(b, aabb_b);
+	broad_phase.update();
+	REQUIRE(aabb_a.intersects(aabb_b, true));
+	CHECK(world.pairs.size() == 1);
+
+	broad_phase.remove(a);
+	broad_phase.remove(b);
+	CHECK(world.pairs.is_empty());
+	CHECK(world.pair_errors == 0);
+	memdelete_arr(world.objects);
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2D] Spatial hash static objects") {
+	GodotBroadPhase2DSpatialHash broad_phase;
+	World world;
+	world.object_count = 2;
+	world.objects = memnew_arr(GodotArea2D, world.object_count);
+	broad_phase.set_pair_callback(pair_callback, &world);
+	broad_phase.set_unpair_callback(unpair_callback, &world);
+
+	GodotBroadPhase2D::ID a = broad_phase.create(&world.objects[0], 0, Rect2(0, 0, 10, 10), true);
+	GodotBroadPhase2D::ID b = broad_phase.create(&world.objects[1], 3, Rect2(5, 5, 10, 10), true);
+	broad_phase.update();
+	CHECK(world.pairs.is_empty());
+	CHECK(broad_phase.is_static(a));
+	CHECK(broad_phase.get_subindex(b) == 3);
+	CHECK(broad_phase.get_object(b) == &world.objects[1]);
+
+	broad_phase.set_static(b, false);
+	broad_phase.update();
+	CHECK(world.pairs.size() == 1);
+
+	broad_phase.set_static(b, true);
+	broad_phase.update();
+	CHECK(world.pairs.is_empty());
+
+	broad_phase.remove(a);
+	broad_phase.remove(b);
+	memdelete_arr(world.objects);
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotBroadPhase2D] Moving objects") {
+	for (int object_count : { 1000, 10000, 40000 }) {
+		for (int type = 0; type < 2; type++) {
+			GodotBroadPhase2D *broad_phase = type == 0 ? (GodotBroadPhase2D *)memnew(GodotBroadPhase2DBVH) : (GodotBroadPhase2D *)memnew(GodotBroadPhase2DSpatialHash);
+			RandomPCG rng(3);
+			// Keep the same density of 8x8 objects whatever their count.
+			const real_t world_size = Math::sqrt(real_t(object_count)) * 40.0;
+
+			World world;
+			world.object_count = object_count;
+			world.objects = memnew_arr(GodotArea2D, object_count);
+			world.ids.resize(object_count);
+			world.aabbs.resize(object_count);
+			LocalVector<Vector2> velocities;
+			velocities.resize(object_count);
+			broad_phase->set_pair_callback(pair_callback, &world);
+			broad_phase->set_unpair_callback(unpair_callback, &world);
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < object_count; i++) {
+				world.aabbs[i] = Rect2(rng.random(0.0f, world_size), rng.random(0.0f, world_size), 8, 8);
+				velocities[i] = Vector2(rng.random(-6.0f, 6.0f), rng.random(-6.0f, 6.0f));
+				world.ids[i] = broad_phase->create(&world.objects[i], 0, world.aabbs[i], false);
+			}
+			broad_phase->update();
+			uint64_t create_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			const int step_count = 60;
+			begin = OS::get_singleton()->get_ticks_usec();
+			for (int step = 0; step < step_count; step++) {
+				for (int i = 0; i < object_count; i++) {
+					world.aabbs[i].position += velocities[i];
+					broad_phase->move(world.ids[i], world.aabbs[i]);
+				}
+				broad_phase->update();
+			}
+			uint64_t step_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			const int query_count = 10000;
+			GodotCollisionObject2D *results[256];
+			int hits = 0;
+			begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < query_count; i++) {
+				hits += broad_phase->cull_aabb(Rect2(rng.random(0.0f, world_size), rng.random(0.0f, world_size), 64, 64), results, 256);
+			}
+			uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			print_line(vformat("GodotBroadPhase2D benchmark: %s, %d moving objects, %d pairs.", type == 0 ? "BVH" : "spatial hash", object_count, world.pairs.size()));
+			print_line(vformat("  create %.2f ms, step %.3f ms, AABB query %.3f us (%d hits).", create_usec / 1000.0, step_usec / 1000.0 / step_count, double(query_usec) / query_count, hits));
+
+			for (int i = 0; i < object_count; i++) {
+				broad_phase->remove(world.ids[i]);
+			}
+			memdelete(broad_phase);
+			memdelete_arr(world.objects);
+		}
+	}
+}
+
+} // namespace TestGodotBroadPhase2D
+
+#endif // TEST_GODOT_BROAD_PHASE_2D_H
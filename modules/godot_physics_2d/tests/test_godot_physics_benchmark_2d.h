@@ -0,0 +1,257 @@
+/**************************************************************************/
+/*  test_godot_physics_benchmark_2d.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_PHYSICS_BENCHMARK_2D_H
+#define TEST_GODOT_PHYSICS_BENCHMARK_2D_H
+
+#include "../godot_physics_server_2d.h"
+
+#include "core/io/json.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+class TestGodotPhysicsServer2DAccessor {
+public:
+	static GodotSpace2D *get_space(GodotPhysicsServer2D *p_server, RID p_space) {
+		return p_server->space_owner.get_or_null(p_space);
+	}
+};
+
+// Benchmark scenes for Godot Physics 2D. Each one prints a single line of JSON with the average time spent
+// in every phase of the step, so runs can be compared by scripts:
+//   godot --headless --test --test-case="[Benchmark][Physics][GodotPhysics2D]*" --no-skip
+namespace TestGodotPhysicsBenchmark2D {
+
+static const char *phase_names[GodotSpace2D::ELAPSED_TIME_MAX] = {
+	"integrate_forces",
+	"broad_phase",
+	"generate_islands",
+	"setup_constraints",
+	"solve_constraints",
+	"integrate_velocities"
+};
+
+class BenchmarkScene {
+	GodotPhysicsServer2D *server = nullptr;
+	RID space;
+	LocalVector<RID> rids;
+
+	uint64_t phase_usec[GodotSpace2D::ELAPSED_TIME_MAX] = {};
+	uint64_t step_usec = 0;
+	uint64_t query_usec = 0;
+	int step_count = 0;
+
+public:
+	GodotPhysicsServer2D *get_server() const { return server; }
+	RID get_space() const { return space; }
+
+	RID create_shape(PhysicsServer2D::ShapeType p_type, const Variant &p_data) {
+		RID shape;
+		switch (p_type) {
+			case PhysicsServer2D::SHAPE_WORLD_BOUNDARY:
+				shape = server->world_boundary_shape_create();
+				break;
+			case PhysicsServer2D::SHAPE_CIRCLE:
+				shape = server->circle_shape_create();
+				break;
+			case PhysicsServer2D::SHAPE_RECTANGLE:
+				shape = server->rectangle_shape_create();
+				break;
+			default:
+				ERR_FAIL_V(RID());
+		}
+		server->shape_set_data(shape, p_data);
+		rids.push_back(shape);
+		return shape;
+	}
+
+	RID create_body(PhysicsServer2D::BodyMode p_mode, RID p_shape, const Transform2D &p_transform) {
+		RID body = server->body_create();
+		server->body_set_mode(body, p_mode);
+		server->body_add_shape(body, p_shape);
+		server->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, p_transform);
+		server->body_set_space(body, space);
+		rids.push_back(body);
+		return body;
+	}
+
+	RID create_area(RID p_shape, const Transform2D &p_transform) {
+		RID area = server->area_create();
+		server->area_add_shape(area, p_shape);
+		server->area_set_transform(area, p_transform);
+		server->area_set_space(area, space);
+		rids.push_back(area);
+		return area;
+	}
+
+	void add_floor() {
+		Array floor_data;
+		floor_data.push_back(Vector2(0, -1));
+		floor_data.push_back(0.0);
+		create_body(PhysicsServer2D::BODY_MODE_STATIC, create_shape(PhysicsServer2D::SHAPE_WORLD_BOUNDARY, floor_data), Transform2D());
+	}
+
+	// Steps the space, timing everything p_queries does after each step as queries.
+	template <typename F>
+	void step(int p_count, F p_queries) {
+		GodotSpace2D *space_ptr = TestGodotPhysicsServer2DAccessor::get_space(server, space);
+		for (int i = 0; i < p_count; i++) {
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			server->step(1.0 / 60.0);
+			server->flush_queries();
+			uint64_t end = OS::get_singleton()->get_ticks_usec();
+			step_usec += end - begin;
+			for (int j = 0; j < GodotSpace2D::ELAPSED_TIME_MAX; j++) {
+				phase_usec[j] += space_ptr->get_elapsed_time(GodotSpace2D::ElapsedTime(j));
+			}
+
+			p_queries();
+			query_usec += OS::get_singleton()->get_ticks_usec() - end;
+			step_count++;
+		}
+	}
+
+	void step(int p_count) {
+		step(p_count, []() {});
+	}
+
+	void print_results(const String &p_name) const {
+		ERR_FAIL_COND(step_count == 0);
+
+		Dictionary results;
+		results["benchmark"] = "physics_2d/" + p_name;
+		results["steps"] = step_count;
+		results["objects"] = TestGodotPhysicsServer2DAccessor::get_space(server, space)->get_objects().size();
+		results["collision_pairs"] = server->get_process_info(PhysicsServer2D::INFO_COLLISION_PAIRS);
+		results["step_usec"] = double(step_usec) / step_count;
+		for (int i = 0; i < GodotSpace2D::ELAPSED_TIME_MAX; i++) {
+			results[String(phase_names[i]) + "_usec"] = double(phase_usec[i]) / step_count;
+		}
+		results["queries_usec"] = double(query_usec) / step_count;
+		print_line(JSON::stringify(results));
+	}
+
+	BenchmarkScene() {
+		server = memnew(GodotPhysicsServer2D);
+		server->init();
+		space = server->space_create();
+		server->space_set_active(space, true);
+	}
+
+	~BenchmarkScene() {
+		for (int64_t i = rids.size() - 1; i >= 0; i--) {
+			server->free(rids[i]);
+		}
+		server->free(space);
+		server->finish();
+		memdelete(server);
+	}
+};
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics2D] Box stacks") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	RID box = scene.create_shape(PhysicsServer2D::SHAPE_RECTANGLE, Vector2(16, 16));
+	for (int x = 0; x < 32; x++) {
+		for (int y = 0; y < 24; y++) {
+			scene.create_body(PhysicsServer2D::BODY_MODE_RIGID, box, Transform2D(0, Vector2(x * 96, -16 - y * 32.5)));
+		}
+	}
+
+	scene.step(300);
+	scene.print_results("box_stacks");
+}
+
+static int area_events = 0;
+
+static void area_monitor_callback(int p_status, const RID &p_body, ObjectID p_instance, int p_body_shape, int p_area_shape) {
+	area_events++;
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics2D] Overlapping areas") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	// Point gravity areas with monitoring, overlapping each other and all bodies passing through them.
+	RID area_shape = scene.create_shape(PhysicsServer2D::SHAPE_CIRCLE, 200.0);
+	for (int x = 0; x < 8; x++) {
+		for (int y = 0; y < 4; y++) {
+			RID area = scene.create_area(area_shape, Transform2D(0, Vector2(x * 150, -y * 150)));
+			scene.get_server()->area_set_param(area, PhysicsServer2D::AREA_PARAM_GRAVITY_OVERRIDE_MODE, PhysicsServer2D::AREA_SPACE_OVERRIDE_COMBINE);
+			scene.get_server()->area_set_param(area, PhysicsServer2D::AREA_PARAM_GRAVITY_IS_POINT, true);
+			scene.get_server()->area_set_param(area, PhysicsServer2D::AREA_PARAM_GRAVITY, 200.0);
+			scene.get_server()->area_set_monitor_callback(area, callable_mp_static(&area_monitor_callback));
+		}
+	}
+
+	RID circle = scene.create_shape(PhysicsServer2D::SHAPE_CIRCLE, 8.0);
+	for (int i = 0; i < 2048; i++) {
+		RID body = scene.create_body(PhysicsServer2D::BODY_MODE_RIGID, circle, Transform2D(0, Vector2(Math::fmod(i * 13.7, 1050.0), -10 - (i % 32) * 17)));
+		scene.get_server()->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(Math::sin(i * 0.1), Math::cos(i * 0.1)) * 100.0);
+	}
+
+	area_events = 0;
+	scene.step(300);
+	scene.print_results("overlapping_areas");
+	CHECK(area_events > 0);
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics2D] Ray query flood") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	RID box = scene.create_shape(PhysicsServer2D::SHAPE_RECTANGLE, Vector2(16, 16));
+	for (int x = 0; x < 64; x++) {
+		for (int y = 0; y < 16; y++) {
+			const PhysicsServer2D::BodyMode mode = (x + y) % 4 == 0 ? PhysicsServer2D::BODY_MODE_RIGID : PhysicsServer2D::BODY_MODE_STATIC;
+			scene.create_body(mode, box, Transform2D(0, Vector2(x * 64, -16 - y * 64)));
+		}
+	}
+
+	int hits = 0;
+	scene.step(120, [&]() {
+		PhysicsDirectSpaceState2D *state = scene.get_server()->space_get_direct_state(scene.get_space());
+		PhysicsDirectSpaceState2D::RayParameters parameters;
+		PhysicsDirectSpaceState2D::RayResult result;
+		for (int i = 0; i < 8192; i++) {
+			parameters.from = Vector2(Math::fmod(i * 11.3, 4096.0), -1100);
+			parameters.to = parameters.from + Vector2(Math::sin(i * 0.01) * 600, 1200);
+			hits += state->intersect_ray(parameters, result);
+		}
+	});
+	scene.print_results("ray_query_flood");
+	CHECK(hits > 0);
+}
+
+} // namespace TestGodotPhysicsBenchmark2D
+
+#endif // TEST_GODOT_PHYSICS_BENCHMARK_2D_H
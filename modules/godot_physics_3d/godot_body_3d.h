@@ -283,6 +283,23 @@ public:
 	void set_active(bool p_active);
 	_FORCE_INLINE_ bool is_active() const { return active; }
 
+	// Simulation state saved in space snapshots, parameters set by the user are not included.
+	struct Snapshot {
+		Transform3D transform;
+		Transform3D inv_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void get_snapshot(Snapshot &r_snapshot) const;
+	void restore_snapshot(const Snapshot &p_snapshot);
+
 	_FORCE_INLINE_ void wakeup() {
 		if ((!get_space()) || mode == PhysicsServer3D::BODY_MODE_STATIC || mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 			return;
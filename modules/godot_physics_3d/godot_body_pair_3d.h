@@ -97,6 +97,14 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	struct Snapshot {
+		int shape_A = 0;
+		int shape_B = 0;
+		Vector3 sep_axis;
+		int contact_count = 0;
+		Contact contacts[MAX_CONTACTS];
+	};
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
@@ -109,6 +117,10 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint32_t get_snapshot_size() const override { return sizeof(Snapshot); }
+	virtual void get_snapshot(uint8_t *r_data) const override;
+	virtual bool restore_snapshot(const uint8_t *p_data) override;
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
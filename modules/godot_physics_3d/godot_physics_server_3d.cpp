@@ -214,6 +214,20 @@ int GodotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PackedByteArray GodotPhysicsServer3D::space_get_snapshot(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+	ERR_FAIL_COND_V_MSG(space->is_locked(), PackedByteArray(), "Space snapshots can't be taken while the space is being stepped.");
+	return space->get_snapshot();
+}
+
+bool GodotPhysicsServer3D::space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, false);
+	ERR_FAIL_COND_V_MSG(space->is_locked(), false, "Space snapshots can't be restored while the space is being stepped.");
+	return space->restore_snapshot(p_snapshot);
+}
+
 RID GodotPhysicsServer3D::area_create() {
 	GodotArea3D *area = memnew(GodotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -1670,6 +1684,7 @@ void GodotPhysicsServer3D::flush_queries() {
 		uint64_t total_time[GodotSpace3D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace3D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broad_phase",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
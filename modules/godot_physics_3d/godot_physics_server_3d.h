@@ -43,6 +43,7 @@ class GodotPhysicsServer3D : public PhysicsServer3D {
 	GDCLASS(GodotPhysicsServer3D, PhysicsServer3D);
 
 	friend class GodotPhysicsDirectSpaceState3D;
+	friend class TestGodotPhysicsServer3DAccessor;
 	bool active = true;
 
 	int island_count = 0;
@@ -117,6 +118,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual PackedByteArray space_get_snapshot(RID p_space) const override;
+	virtual bool space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
@@ -33,6 +33,7 @@
 #include "core/io/image.h"
 #include "core/math/convex_hull.h"
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/sort_array.h"
 
 // GodotHeightMapShape3D is based on Bullet btHeightfieldTerrainShape.
@@ -1286,13 +1287,16 @@ GodotFaceShape3D::GodotFaceShape3D() {
 
 Vector<Vector3> GodotConcavePolygonShape3D::get_faces() const {
 	Vector<Vector3> rfaces;
-	rfaces.resize(faces.size() * 3);
+	rfaces.resize(vertices.size());
 
-	for (int i = 0; i < faces.size(); i++) {
-		Face f = faces.get(i);
+	const Vector3 *vr = vertices.ptr();
+	Vector3 *rfacesw = rfaces.ptrw();
 
+	for (uint32_t i = 0; i < face_indices.size(); i++) {
+		// Faces are stored in BVH order, return them in the order they were provided.
+		uint32_t dst = face_indices[i] * 3;
 		for (int j = 0; j < 3; j++) {
-			rfaces.set(i * 3 + j, vertices.get(f.indices[j]));
+			rfacesw[dst + j] = vr[i * 3 + j];
 		}
 	}
 
@@ -1345,271 +1349,548 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+/* Quantized BVH helpers */
 
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
+// Children are quantized over 65534 steps of their parent's size rather than
+// 65535, so the largest code always decodes past the parent bounds despite
+// rounding, and decoded bounds stay conservative all the way down the tree.
+static const real_t _BVH_QUANTIZE_STEPS = 65534.0;
+static const uint32_t _BVH_QUANTIZE_MAX = 65535;
+
+// Queries on large meshes use this many stack entries before falling back to the heap.
+static const uint32_t _BVH_ALLOCA_STACK_SIZE = 128;
+
+// Meshes with fewer faces than this are built on the calling thread.
+static const uint32_t _BVH_PARALLEL_BUILD_MIN_FACES = 65536;
+static const uint32_t _BVH_PARALLEL_BUILD_MIN_TASK_FACES = 8192;
+
+static const int _BVH_SAH_BINS = 16;
+
+struct _BVHBounds {
+	Vector3 min;
+	Vector3 max;
+
+	_FORCE_INLINE_ void merge_with(const _BVHBounds &p_bounds) {
+		min = min.min(p_bounds.min);
+		max = max.max(p_bounds.max);
 	}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		int face_index = params_bvh->face_index;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->face_index = face_index;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
-		}
+	_FORCE_INLINE_ bool intersects(const _BVHBounds &p_bounds) const {
+		return min.x <= p_bounds.max.x && max.x >= p_bounds.min.x &&
+				min.y <= p_bounds.max.y && max.y >= p_bounds.min.y &&
+				min.z <= p_bounds.max.z && max.z >= p_bounds.min.z;
 	}
-}
 
-bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
-	if (faces.size() == 0) {
-		return false;
+	_FORCE_INLINE_ real_t get_half_area() const {
+		Vector3 size = max - min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
 	}
+};
 
-	// unlock data
-	const Face *fr = faces.ptr();
-	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+_FORCE_INLINE_ static real_t _bvh_decode(real_t p_origin, real_t p_step, uint32_t p_code) {
+	return p_origin + p_step * real_t(p_code);
+}
 
-	GodotFaceShape3D face;
-	face.backface_collision = backface_collision && p_hit_back_faces;
+struct _BVHDecoder {
+	Vector3 origin;
+	Vector3 step;
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.dir = (p_end - p_begin).normalized();
+	_FORCE_INLINE_ void decode(const uint16_t *p_min, const uint16_t *p_max, _BVHBounds &r_bounds) const {
+		r_bounds.min.x = _bvh_decode(origin.x, step.x, p_min[0]);
+		r_bounds.min.y = _bvh_decode(origin.y, step.y, p_min[1]);
+		r_bounds.min.z = _bvh_decode(origin.z, step.z, p_min[2]);
+		r_bounds.max.x = _bvh_decode(origin.x, step.x, p_max[0]);
+		r_bounds.max.y = _bvh_decode(origin.y, step.y, p_max[1]);
+		r_bounds.max.z = _bvh_decode(origin.z, step.z, p_max[2]);
+	}
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	_FORCE_INLINE_ _BVHDecoder(const _BVHBounds &p_parent) {
+		origin = p_parent.min;
+		step = (p_parent.max - p_parent.min) * (1.0 / _BVH_QUANTIZE_STEPS);
+	}
+};
 
-	params.face = &face;
+static void _bvh_quantize(const _BVHDecoder &p_parent, const _BVHBounds &p_child, uint16_t *r_min, uint16_t *r_max) {
+	for (int i = 0; i < 3; i++) {
+		real_t origin = p_parent.origin[i];
+		real_t step = p_parent.step[i];
+		if (step <= 0.0) {
+			// Flat parent, the child can only be flat at the same coordinate.
+			r_min[i] = 0;
+			r_max[i] = 0;
+			continue;
+		}
 
-	// cull
-	_cull_segment(0, &params);
+		// Round outwards, then make sure the decoded value actually encloses the child.
+		int64_t qmin = CLAMP((int64_t)Math::floor((p_child.min[i] - origin) / step), 0, (int64_t)_BVH_QUANTIZE_MAX);
+		while (qmin > 0 && _bvh_decode(origin, step, qmin) > p_child.min[i]) {
+			qmin--;
+		}
+		int64_t qmax = CLAMP((int64_t)Math::ceil((p_child.max[i] - origin) / step), qmin, (int64_t)_BVH_QUANTIZE_MAX);
+		while (qmax < _BVH_QUANTIZE_MAX && _bvh_decode(origin, step, qmax) < p_child.max[i]) {
+			qmax++;
+		}
 
-	if (params.collisions > 0) {
-		r_result = params.result;
-		r_normal = params.normal;
-		r_face_index = params.face_index;
-		return true;
-	} else {
-		return false;
+		r_min[i] = qmin;
+		r_max[i] = qmax;
 	}
 }
 
-bool GodotConcavePolygonShape3D::intersect_point(const Vector3 &p_point) const {
-	return false; //face is flat
-}
+struct _BVHBuildElement {
+	_BVHBounds bounds;
+	Vector3 center;
+	uint32_t face = 0;
+};
 
-Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point) const {
-	return Vector3();
-}
+template <int AXIS>
+struct _BVHBuildElementCompare {
+	_FORCE_INLINE_ bool operator()(const _BVHBuildElement &a, const _BVHBuildElement &b) const {
+		return a.center[AXIS] < b.center[AXIS];
+	}
+};
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+struct _BVHBuildNode {
+	_BVHBounds bounds[2];
+	uint32_t children[2] = {};
+};
 
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
-		return false;
+struct _BVHBuildTask {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	uint32_t level = 0;
+	uint32_t parent = 0;
+	uint32_t slot = 0;
+
+	// Output, spliced into the main tree once all tasks are done.
+	LocalVector<_BVHBuildNode> nodes;
+	uint32_t root = 0;
+	uint32_t depth = 0;
+};
+
+struct _BVHBuilder {
+	static const uint32_t INVALID_PARENT = UINT32_MAX;
+
+	_BVHBuildElement *elements = nullptr;
+	LocalVector<_BVHBuildNode> nodes;
+	uint32_t root = 0;
+	uint32_t depth = 0;
+
+	// When set, ranges of at most `task_max_faces` faces are deferred to `tasks`
+	// instead of being built, so they can be built in parallel.
+	LocalVector<_BVHBuildTask> *tasks = nullptr;
+	uint32_t task_max_faces = 0;
+
+	_BVHBounds _get_range_bounds(uint32_t p_begin, uint32_t p_end) const {
+		_BVHBounds bounds = elements[p_begin].bounds;
+		for (uint32_t i = p_begin + 1; i < p_end; i++) {
+			bounds.merge_with(elements[i].bounds);
+		}
+		return bounds;
 	}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
+	uint32_t _split(uint32_t p_begin, uint32_t p_end) {
+		uint32_t count = p_end - p_begin;
+
+		Vector3 cmin = elements[p_begin].center;
+		Vector3 cmax = cmin;
+		for (uint32_t i = p_begin + 1; i < p_end; i++) {
+			cmin = cmin.min(elements[i].center);
+			cmax = cmax.max(elements[i].center);
 		}
-	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
+
+		Vector3 extent = cmax - cmin;
+		int longest_axis = extent.max_axis_index();
+		if (extent[longest_axis] <= 0.0) {
+			// All centers coincide, nothing to gain from binning.
+			return p_begin + count / 2;
+		}
+
+		// Binned surface area heuristic over all three axes.
+		int best_axis = -1;
+		int best_bin = 0;
+		real_t best_cost = INFINITY;
+
+		for (int axis = 0; axis < 3; axis++) {
+			if (extent[axis] <= 0.0) {
+				continue;
+			}
+
+			uint32_t bin_counts[_BVH_SAH_BINS] = {};
+			_BVHBounds bin_bounds[_BVH_SAH_BINS];
+			real_t bin_scale = _BVH_SAH_BINS / extent[axis];
+
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				int bin = MIN(int((elements[i].center[axis] - cmin[axis]) * bin_scale), _BVH_SAH_BINS - 1);
+				if (bin_counts[bin] == 0) {
+					bin_bounds[bin] = elements[i].bounds;
+				} else {
+					bin_bounds[bin].merge_with(elements[i].bounds);
+				}
+				bin_counts[bin]++;
+			}
+
+			// Sweep from the right to get the cost of every right hand side.
+			real_t right_costs[_BVH_SAH_BINS] = {};
+			_BVHBounds accum;
+			uint32_t accum_count = 0;
+			for (int bin = _BVH_SAH_BINS - 1; bin > 0; bin--) {
+				if (bin_counts[bin]) {
+					if (accum_count == 0) {
+						accum = bin_bounds[bin];
+					} else {
+						accum.merge_with(bin_bounds[bin]);
+					}
+					accum_count += bin_counts[bin];
+				}
+				right_costs[bin] = accum_count ? accum.get_half_area() * accum_count : 0.0;
+			}
+
+			accum_count = 0;
+			for (int bin = 0; bin < _BVH_SAH_BINS - 1; bin++) {
+				if (bin_counts[bin]) {
+					if (accum_count == 0) {
+						accum = bin_bounds[bin];
+					} else {
+						accum.merge_with(bin_bounds[bin]);
+					}
+					accum_count += bin_counts[bin];
+				}
+				if (accum_count == 0 || accum_count == count) {
+					continue;
+				}
+				real_t cost = accum.get_half_area() * accum_count + right_costs[bin + 1];
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_axis = axis;
+					best_bin = bin;
+				}
 			}
 		}
 
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
+		if (best_axis != -1) {
+			real_t bin_scale = _BVH_SAH_BINS / extent[best_axis];
+			uint32_t mid = p_begin;
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				int bin = MIN(int((elements[i].center[best_axis] - cmin[best_axis]) * bin_scale), _BVH_SAH_BINS - 1);
+				if (bin <= best_bin) {
+					SWAP(elements[i], elements[mid]);
+					mid++;
+				}
+			}
+			if (mid != p_begin && mid != p_end) {
+				return mid;
 			}
 		}
-	}
 
-	return false;
-}
+		// Binning could not separate the faces, fall back to a median split.
+		uint32_t mid = p_begin + count / 2;
+		switch (longest_axis) {
+			case 0: {
+				SortArray<_BVHBuildElement, _BVHBuildElementCompare<0>> sort_x;
+				sort_x.nth_element(p_begin, p_end, mid, elements);
+			} break;
+			case 1: {
+				SortArray<_BVHBuildElement, _BVHBuildElementCompare<1>> sort_y;
+				sort_y.nth_element(p_begin, p_end, mid, elements);
+			} break;
+			case 2: {
+				SortArray<_BVHBuildElement, _BVHBuildElementCompare<2>> sort_z;
+				sort_z.nth_element(p_begin, p_end, mid, elements);
+			} break;
+		}
+		return mid;
+	}
 
-void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
-	// make matrix local to concave
-	if (faces.size() == 0) {
-		return;
+	void _set_child(uint32_t p_parent, uint32_t p_slot, uint32_t p_child) {
+		if (p_parent == INVALID_PARENT) {
+			root = p_child;
+		} else {
+			nodes[p_parent].children[p_slot] = p_child;
+		}
 	}
 
-	AABB local_aabb = p_local_aabb;
+	void build(uint32_t p_begin, uint32_t p_end, uint32_t p_level, uint32_t p_parent, uint32_t p_slot) {
+		uint32_t count = p_end - p_begin;
 
-	// unlock data
-	const Face *fr = faces.ptr();
-	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+		if (count <= GodotConcavePolygonShape3D::BVH_MAX_LEAF_FACES) {
+			_set_child(p_parent, p_slot, GodotConcavePolygonShape3D::BVH_LEAF_BIT | (p_begin << GodotConcavePolygonShape3D::BVH_LEAF_COUNT_BITS) | count);
+			return;
+		}
 
-	GodotFaceShape3D face; // use this to send in the callback
-	face.backface_collision = backface_collision;
-	face.invert_backface_collision = p_invert_backface_collision;
+		if (tasks && count <= task_max_faces) {
+			_BVHBuildTask task;
+			task.begin = p_begin;
+			task.end = p_end;
+			task.level = p_level;
+			task.parent = p_parent;
+			task.slot = p_slot;
+			tasks->push_back(task);
+			return;
+		}
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
-	params.callback = p_callback;
-	params.userdata = p_userdata;
+		uint32_t mid = _split(p_begin, p_end);
 
-	// cull
-	_cull(0, &params);
-}
+		uint32_t idx = nodes.size();
+		nodes.push_back(_BVHBuildNode());
+		nodes[idx].bounds[0] = _get_range_bounds(p_begin, mid);
+		nodes[idx].bounds[1] = _get_range_bounds(mid, p_end);
+		_set_child(p_parent, p_slot, idx);
+		depth = MAX(depth, p_level + 1);
 
-Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
-	// use bad AABB approximation
-	Vector3 extents = get_aabb().size * 0.5;
+		build(p_begin, mid, p_level + 1, idx, 0);
+		build(mid, p_end, p_level + 1, idx, 1);
+	}
+};
 
-	return Vector3(
-			(p_mass / 3.0) * (extents.y * extents.y + extents.z * extents.z),
-			(p_mass / 3.0) * (extents.x * extents.x + extents.z * extents.z),
-			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
+static void _bvh_build_task(void *p_userdata, uint32_t p_index) {
+	_BVHBuilder *main_builder = (_BVHBuilder *)p_userdata;
+	_BVHBuildTask &task = (*main_builder->tasks)[p_index];
+
+	_BVHBuilder builder;
+	builder.elements = main_builder->elements;
+	builder.build(task.begin, task.end, task.level, _BVHBuilder::INVALID_PARENT, 0);
+
+	task.nodes = std::move(builder.nodes);
+	task.root = builder.root;
+	task.depth = builder.depth;
 }
 
-struct _Volume_BVH_Element {
-	AABB aabb;
-	Vector3 center;
-	int face_index = 0;
-};
+void GodotConcavePolygonShape3D::_fill_face(uint32_t p_face, GodotFaceShape3D *r_face) const {
+	const Vector3 *v = _get_face_vertices(p_face);
+	r_face->vertex[0] = v[0];
+	r_face->vertex[1] = v[1];
+	r_face->vertex[2] = v[2];
+	r_face->normal = face_normals[p_face];
+}
 
-struct _Volume_BVH_CompareX {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.x < b.center.x;
+bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
+	if (face_indices.is_empty()) {
+		return false;
 	}
-};
 
-struct _Volume_BVH_CompareY {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.y < b.center.y;
+	GodotFaceShape3D face;
+	face.backface_collision = backface_collision && p_hit_back_faces;
+
+	Vector3 rel = p_end - p_begin;
+	real_t length = rel.length();
+	if (length == 0.0) {
+		return false;
 	}
-};
+	Vector3 dir = rel / length;
 
-struct _Volume_BVH_CompareZ {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.z < b.center.z;
+	// Slab test setup, the segment is p_begin + rel * t with t in [0, max_t].
+	Vector3 inv_rel;
+	for (int i = 0; i < 3; i++) {
+		inv_rel[i] = rel[i] != 0.0 ? 1.0 / rel[i] : 0.0;
 	}
-};
 
-struct _Volume_BVH {
-	AABB aabb;
-	_Volume_BVH *left = nullptr;
-	_Volume_BVH *right = nullptr;
+	real_t min_d = 1e20;
+	real_t max_t = 1.0;
+	int hit_face = -1;
 
-	int face_index = 0;
-};
+	struct StackEntry {
+		uint32_t node;
+		_BVHBounds bounds;
+	};
 
-_Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int &count) {
-	_Volume_BVH *bvh = memnew(_Volume_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
+	LocalVector<StackEntry> heap_stack;
+	StackEntry *stack;
+	if (bvh_depth <= _BVH_ALLOCA_STACK_SIZE) {
+		stack = (StackEntry *)alloca((bvh_depth + 1) * sizeof(StackEntry));
 	} else {
-		bvh->face_index = -1;
-	}
+		heap_stack.resize(bvh_depth + 1);
+		stack = heap_stack.ptr();
+	}
+
+	uint32_t stack_size = 1;
+	stack[0].node = 0;
+	stack[0].bounds.min = bvh_aabb.position;
+	stack[0].bounds.max = bvh_aabb.get_end();
+
+	while (stack_size) {
+		stack_size--;
+		const BVHNode &node = bvh[stack[stack_size].node];
+		_BVHDecoder decoder(stack[stack_size].bounds);
+
+		real_t child_t[2];
+		_BVHBounds child_bounds[2];
+		bool child_hit[2];
+
+		for (int c = 0; c < 2; c++) {
+			decoder.decode(node.min[c], node.max[c], child_bounds[c]);
+
+			// Clip the segment against the slabs of the child bounds.
+			real_t tmin = 0.0;
+			real_t tmax = max_t;
+			bool hit = true;
+			for (int i = 0; i < 3 && hit; i++) {
+				if (inv_rel[i] == 0.0) {
+					hit = p_begin[i] >= child_bounds[c].min[i] && p_begin[i] <= child_bounds[c].max[i];
+				} else {
+					real_t t0 = (child_bounds[c].min[i] - p_begin[i]) * inv_rel[i];
+					real_t t1 = (child_bounds[c].max[i] - p_begin[i]) * inv_rel[i];
+					if (t0 > t1) {
+						SWAP(t0, t1);
+					}
+					tmin = MAX(tmin, t0);
+					tmax = MIN(tmax, t1);
+					hit = tmin <= tmax;
+				}
+			}
+			child_hit[c] = hit;
+			child_t[c] = tmin;
+		}
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
+		// Leaves are tested right away, nodes are pushed far to near so the nearest is visited first.
+		int order[2] = { 0, 1 };
+		if (child_t[1] > child_t[0]) {
+			SWAP(order[0], order[1]);
+		}
+
+		for (int o = 0; o < 2; o++) {
+			int c = order[o];
+			if (!child_hit[c]) {
+				continue;
+			}
+
+			uint32_t child = node.children[c];
+			if (child & BVH_LEAF_BIT) {
+				uint32_t first = (child & ~BVH_LEAF_BIT) >> BVH_LEAF_COUNT_BITS;
+				uint32_t last = first + (child & BVH_LEAF_COUNT_MASK);
+				for (uint32_t f = first; f < last; f++) {
+					const Vector3 *v = _get_face_vertices(f);
+					face.vertex[0] = v[0];
+					face.vertex[1] = v[1];
+					face.vertex[2] = v[2];
+
+					Vector3 res;
+					Vector3 normal;
+					int face_index = f;
+					if (face.intersect_segment(p_begin, p_end, res, normal, face_index, true)) {
+						real_t d = dir.dot(res) - dir.dot(p_begin);
+						if ((d > 0) && (d < min_d)) {
+							min_d = d;
+							r_result = res;
+							r_normal = normal;
+							hit_face = f;
+							// Nothing further than the closest hit can matter anymore.
+							max_t = MIN(max_t, d / length);
+						}
+					}
+				}
+			} else {
+				stack[stack_size].node = child;
+				stack[stack_size].bounds = child_bounds[c];
+				stack_size++;
+			}
 		}
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
 
-		} break;
-		case 1: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
+	if (hit_face >= 0) {
+		r_face_index = face_indices[hit_face];
+		return true;
+	} else {
+		return false;
 	}
+}
 
-	int split = p_size / 2;
-	bvh->left = _volume_build_bvh(p_elements, split, count);
-	bvh->right = _volume_build_bvh(&p_elements[split], p_size - split, count);
+bool GodotConcavePolygonShape3D::intersect_point(const Vector3 &p_point) const {
+	return false; //face is flat
+}
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
+Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point) const {
+	return Vector3();
 }
 
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
+void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
+	// make matrix local to concave
+	if (face_indices.is_empty()) {
+		return;
+	}
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	_BVHBounds local_bounds;
+	local_bounds.min = p_local_aabb.position;
+	local_bounds.max = p_local_aabb.get_end();
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	GodotFaceShape3D face; // use this to send in the callback
+	face.backface_collision = backface_collision;
+	face.invert_backface_collision = p_invert_backface_collision;
 
+	struct StackEntry {
+		uint32_t node;
+		_BVHBounds bounds;
+	};
+
+	LocalVector<StackEntry> heap_stack;
+	StackEntry *stack;
+	if (bvh_depth <= _BVH_ALLOCA_STACK_SIZE) {
+		stack = (StackEntry *)alloca((bvh_depth + 1) * sizeof(StackEntry));
 	} else {
-		p_bvh_array[p_idx].left = -1;
+		heap_stack.resize(bvh_depth + 1);
+		stack = heap_stack.ptr();
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	uint32_t stack_size = 1;
+	stack[0].node = 0;
+	stack[0].bounds.min = bvh_aabb.position;
+	stack[0].bounds.max = bvh_aabb.get_end();
 
-	} else {
-		p_bvh_array[p_idx].right = -1;
+	while (stack_size) {
+		stack_size--;
+		const BVHNode &node = bvh[stack[stack_size].node];
+		_BVHDecoder decoder(stack[stack_size].bounds);
+
+		for (int c = 1; c >= 0; c--) {
+			_BVHBounds child_bounds;
+			decoder.decode(node.min[c], node.max[c], child_bounds);
+			if (!local_bounds.intersects(child_bounds)) {
+				continue;
+			}
+
+			uint32_t child = node.children[c];
+			if (child & BVH_LEAF_BIT) {
+				uint32_t first = (child & ~BVH_LEAF_BIT) >> BVH_LEAF_COUNT_BITS;
+				uint32_t last = first + (child & BVH_LEAF_COUNT_MASK);
+				for (uint32_t f = first; f < last; f++) {
+					const Vector3 *v = _get_face_vertices(f);
+					_BVHBounds face_bounds;
+					face_bounds.min = v[0].min(v[1]).min(v[2]);
+					face_bounds.max = v[0].max(v[1]).max(v[2]);
+					if (!local_bounds.intersects(face_bounds)) {
+						continue;
+					}
+
+					_fill_face(f, &face);
+					if (p_callback(p_userdata, &face)) {
+						return;
+					}
+				}
+			} else {
+				stack[stack_size].node = child;
+				stack[stack_size].bounds = child_bounds;
+				stack_size++;
+			}
+		}
 	}
+}
 
-	memdelete(p_bvh_tree);
+Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
+	// use bad AABB approximation
+	Vector3 extents = get_aabb().size * 0.5;
+
+	return Vector3(
+			(p_mass / 3.0) * (extents.y * extents.y + extents.z * extents.z),
+			(p_mass / 3.0) * (extents.x * extents.x + extents.z * extents.z),
+			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
 void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
+	vertices.clear();
+	face_normals.clear();
+	face_indices.clear();
+	bvh.clear();
+	bvh_depth = 0;
+
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
 		configure(AABB());
@@ -1617,56 +1898,137 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 	}
 	ERR_FAIL_COND(src_face_count % 3);
 	src_face_count /= 3;
+	ERR_FAIL_COND_MSG((uint32_t)src_face_count > BVH_MAX_FACES, vformat("Concave polygon shapes support at most %d faces.", BVH_MAX_FACES));
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_Volume_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
+	LocalVector<_BVHBuildElement> elements;
+	elements.resize(src_face_count);
 
-	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptrw();
+	_BVHBounds root_bounds;
 
-	faces.resize(src_face_count);
-	Face *facesw = faces.ptrw();
-
-	vertices.resize(src_face_count * 3);
-
-	Vector3 *verticesw = vertices.ptrw();
+	for (int i = 0; i < src_face_count; i++) {
+		const Vector3 &v0 = facesr[i * 3 + 0];
+		const Vector3 &v1 = facesr[i * 3 + 1];
+		const Vector3 &v2 = facesr[i * 3 + 2];
 
-	AABB _aabb;
+		_BVHBuildElement &element = elements[i];
+		element.bounds.min = v0.min(v1).min(v2);
+		element.bounds.max = v0.max(v1).max(v2);
+		element.center = (element.bounds.min + element.bounds.max) * 0.5;
+		element.face = i;
 
-	for (int i = 0; i < src_face_count; i++) {
-		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
-
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.get_center();
-		bvh_arrayw[i].face_index = i;
-		facesw[i].indices[0] = i * 3 + 0;
-		facesw[i].indices[1] = i * 3 + 1;
-		facesw[i].indices[2] = i * 3 + 2;
-		facesw[i].normal = face.get_plane().normal;
-		verticesw[i * 3 + 0] = face.vertex[0];
-		verticesw[i * 3 + 1] = face.vertex[1];
-		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			root_bounds = element.bounds;
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			root_bounds.merge_with(element.bounds);
+		}
+	}
+
+	// Build the tree with full precision bounds first.
+
+	_BVHBuilder builder;
+	builder.elements = elements.ptr();
+
+	if ((uint32_t)src_face_count <= BVH_MAX_LEAF_FACES) {
+		// The root must be a node, give it a single leaf child and an empty one.
+		_BVHBuildNode root;
+		root.bounds[0] = root_bounds;
+		root.bounds[1] = _BVHBounds();
+		root.bounds[1].min = root_bounds.min;
+		root.bounds[1].max = root_bounds.min;
+		root.children[0] = BVH_LEAF_BIT | src_face_count;
+		root.children[1] = BVH_LEAF_BIT;
+		builder.nodes.push_back(root);
+		builder.depth = 1;
+	} else {
+		LocalVector<_BVHBuildTask> tasks;
+		WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+		// Don't block a pool thread (i.e. threaded resource loading) on a group task.
+		if ((uint32_t)src_face_count >= _BVH_PARALLEL_BUILD_MIN_FACES && thread_pool->get_thread_count() > 1 && WorkerThreadPool::get_thread_index() == -1) {
+			builder.tasks = &tasks;
+			builder.task_max_faces = MAX((uint32_t)src_face_count / (thread_pool->get_thread_count() * 4), _BVH_PARALLEL_BUILD_MIN_TASK_FACES);
+		}
+
+		builder.build(0, src_face_count, 0, _BVHBuilder::INVALID_PARENT, 0);
+
+		if (!tasks.is_empty()) {
+			WorkerThreadPool::GroupID group_task = thread_pool->add_native_group_task(&_bvh_build_task, &builder, tasks.size(), -1, true, SNAME("GodotConcavePolygonShape3DBuildBVH"));
+			thread_pool->wait_for_group_task_completion(group_task);
+
+			// Append the subtrees after the top of the tree, and link them in.
+			for (_BVHBuildTask &task : tasks) {
+				uint32_t offset = builder.nodes.size();
+				for (_BVHBuildNode &node : task.nodes) {
+					for (int c = 0; c < 2; c++) {
+						if (!(node.children[c] & BVH_LEAF_BIT)) {
+							node.children[c] += offset;
+						}
+					}
+					builder.nodes.push_back(node);
+				}
+				uint32_t task_root = task.root;
+				if (!(task_root & BVH_LEAF_BIT)) {
+					task_root += offset;
+				}
+				builder.nodes[task.parent].children[task.slot] = task_root;
+				builder.depth = MAX(builder.depth, task.depth);
+			}
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
+	// Quantize the tree top-down, each node relative to its parent's decoded bounds.
 
-	bvh.resize(count + 1);
+	bvh.resize(builder.nodes.size());
+	bvh_depth = builder.depth;
 
-	BVH *bvh_arrayw2 = bvh.ptrw();
+	struct QuantizeEntry {
+		uint32_t node;
+		_BVHBounds bounds;
+	};
+	LocalVector<QuantizeEntry> quantize_stack;
+	quantize_stack.push_back({ 0, root_bounds });
+
+	while (!quantize_stack.is_empty()) {
+		QuantizeEntry entry = quantize_stack[quantize_stack.size() - 1];
+		quantize_stack.resize(quantize_stack.size() - 1);
+
+		const _BVHBuildNode &src = builder.nodes[entry.node];
+		BVHNode &dst = bvh[entry.node];
+		_BVHDecoder decoder(entry.bounds);
+
+		for (int c = 0; c < 2; c++) {
+			_bvh_quantize(decoder, src.bounds[c], dst.min[c], dst.max[c]);
+			dst.children[c] = src.children[c];
+			if (!(src.children[c] & BVH_LEAF_BIT)) {
+				QuantizeEntry child;
+				child.node = src.children[c];
+				decoder.decode(dst.min[c], dst.max[c], child.bounds);
+				quantize_stack.push_back(child);
+			}
+		}
+	}
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	// Store the faces in leaf order.
+
+	vertices.resize(src_face_count * 3);
+	Vector3 *verticesw = vertices.ptrw();
+	face_normals.resize(src_face_count);
+	face_indices.resize(src_face_count);
+
+	for (int i = 0; i < src_face_count; i++) {
+		uint32_t src_face = elements[i].face;
+		face_indices[i] = src_face;
+		verticesw[i * 3 + 0] = facesr[src_face * 3 + 0];
+		verticesw[i * 3 + 1] = facesr[src_face * 3 + 1];
+		verticesw[i * 3 + 2] = facesr[src_face * 3 + 2];
+		face_normals[i] = Plane(verticesw[i * 3 + 0], verticesw[i * 3 + 1], verticesw[i * 3 + 2]).normal;
+	}
 
 	backface_collision = p_backface_collision;
 
-	configure(_aabb); // this type of shape has no margin
+	bvh_aabb = AABB(root_bounds.min, root_bounds.max - root_bounds.min);
+	configure(bvh_aabb); // this type of shape has no margin
 }
 
 void GodotConcavePolygonShape3D::set_data(const Variant &p_data) {
@@ -302,62 +302,43 @@ public:
 	GodotConvexPolygonShape3D();
 };
 
-struct _Volume_BVH;
 struct GodotFaceShape3D;
 
 struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	// always a trimesh
 
-	struct Face {
-		Vector3 normal;
-		int indices[3] = {};
-	};
-
-	Vector<Face> faces;
+	// Faces are stored in BVH leaf order, three vertices each, so a leaf
+	// references a contiguous range of `vertices`. `face_indices` maps them
+	// back to the order they were provided in, which is what queries report.
 	Vector<Vector3> vertices;
-
-	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
-
-		int face_index = 0;
+	LocalVector<Vector3> face_normals;
+	LocalVector<uint32_t> face_indices;
+
+	// Quantized BVH. Each node stores the bounds of both of its children as
+	// 16-bit offsets relative to the node's own (decoded) bounds, so a node
+	// fits in 32 bytes and two of them share a cache line. The root node is
+	// relative to the shape AABB.
+	static const uint32_t BVH_LEAF_BIT = 1u << 31;
+	static const uint32_t BVH_LEAF_COUNT_BITS = 3;
+	static const uint32_t BVH_LEAF_COUNT_MASK = (1u << BVH_LEAF_COUNT_BITS) - 1;
+	static const uint32_t BVH_MAX_LEAF_FACES = 4;
+	static const uint32_t BVH_MAX_FACES = (1u << (31 - BVH_LEAF_COUNT_BITS)) - 1;
+
+	struct BVHNode {
+		uint16_t min[2][3] = {};
+		uint16_t max[2][3] = {};
+		// Either a node index, or BVH_LEAF_BIT | (first_face << BVH_LEAF_COUNT_BITS) | face_count.
+		uint32_t children[2] = {};
 	};
 
-	Vector<BVH> bvh;
-
-	struct _CullParams {
-		AABB aabb;
-		QueryCallback callback = nullptr;
-		void *userdata = nullptr;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-	};
-
-	struct _SegmentCullParams {
-		Vector3 from;
-		Vector3 to;
-		Vector3 dir;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-
-		Vector3 result;
-		Vector3 normal;
-		int face_index = -1;
-		real_t min_d = 1e20;
-		int collisions = 0;
-	};
+	LocalVector<BVHNode> bvh;
+	AABB bvh_aabb;
+	uint32_t bvh_depth = 0;
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
-
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	_FORCE_INLINE_ const Vector3 *_get_face_vertices(uint32_t p_face) const { return &vertices.ptr()[p_face * 3]; }
+	void _fill_face(uint32_t p_face, GodotFaceShape3D *r_face) const;
 
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
@@ -33,6 +33,7 @@
 #include "godot_space_3d.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/rb_map.h"
 #include "servers/rendering_server.h"
 
@@ -169,21 +170,30 @@ void GodotSoftBody3D::update_rendering_server(PhysicsServer3DRenderingServerHand
 }
 
 void GodotSoftBody3D::update_normals_and_centroids() {
-	for (Node &node : nodes) {
-		node.n = Vector3();
-	}
+	// Node normals are gathered from their faces rather than scattered from each face,
+	// so that both passes can run on separate threads.
+	_solve_range(&GodotSoftBody3D::_update_face_normals, faces.size());
+	_solve_range(&GodotSoftBody3D::_update_node_normals, nodes.size());
+}
 
-	for (Face &face : faces) {
-		const Vector3 n = vec3_cross(face.n[0]->x - face.n[2]->x, face.n[0]->x - face.n[1]->x);
-		face.n[0]->n += n;
-		face.n[1]->n += n;
-		face.n[2]->n += n;
-		face.normal = n;
+void GodotSoftBody3D::_update_face_normals(uint32_t p_from, uint32_t p_to, real_t p_unused) {
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		Face &face = faces[i];
+		face.area_normal = vec3_cross(face.n[0]->x - face.n[2]->x, face.n[0]->x - face.n[1]->x);
+		face.normal = face.area_normal;
 		face.normal.normalize();
 		face.centroid = 0.33333333333 * (face.n[0]->x + face.n[1]->x + face.n[2]->x);
 	}
+}
+
+void GodotSoftBody3D::_update_node_normals(uint32_t p_from, uint32_t p_to, real_t p_unused) {
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		Node &node = nodes[i];
+		node.n = Vector3();
+		for (uint32_t j = node_face_offsets[i]; j < node_face_offsets[i + 1]; ++j) {
+			node.n += faces[node_faces[j]].area_normal;
+		}
 
-	for (Node &node : nodes) {
 		real_t len = node.n.length();
 		if (len > CMP_EPSILON) {
 			node.n /= len;
@@ -191,6 +201,29 @@ void GodotSoftBody3D::update_normals_and_centroids() {
 	}
 }
 
+void GodotSoftBody3D::_solve_range_chunk(uint32_t p_chunk, SolveRange *p_range) {
+	const uint32_t from = p_chunk * SOLVER_CHUNK_SIZE;
+	const uint32_t to = MIN(from + SOLVER_CHUNK_SIZE, p_range->count);
+	(this->*p_range->method)(p_range->from + from, p_range->from + to, p_range->param);
+}
+
+void GodotSoftBody3D::_solve_range(SolveRangeMethod p_method, uint32_t p_count, real_t p_param, uint32_t p_from) {
+	if (!solver_use_threads || p_count < SOLVER_CHUNK_SIZE * 2) {
+		(this->*p_method)(p_from, p_from + p_count, p_param);
+		return;
+	}
+
+	SolveRange range;
+	range.method = p_method;
+	range.from = p_from;
+	range.count = p_count;
+	range.param = p_param;
+
+	const uint32_t chunk_count = (p_count + SOLVER_CHUNK_SIZE - 1) / SOLVER_CHUNK_SIZE;
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotSoftBody3D::_solve_range_chunk, &range, chunk_count, -1, true, SNAME("SoftBody3DSolve"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
 void GodotSoftBody3D::update_bounds() {
 	AABB prev_bounds = bounds;
 	prev_bounds.grow_by(collision_margin);
@@ -581,7 +614,8 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 	}
 
 	generate_bending_constraints(2);
-	reoptimize_link_order();
+	generate_link_batches();
+	generate_node_faces();
 
 	update_constants();
 	update_normals_and_centroids();
@@ -688,142 +722,93 @@ void GodotSoftBody3D::generate_bending_constraints(int p_distance) {
 	}
 }
 
-//===================================================================
-//
-//
-// This function takes in a list of interdependent Links and tries
-// to maximize the distance between calculation
-// of dependent links. This increases the amount of parallelism that can
-// be exploited by out-of-order instruction processors with large but
-// (inevitably) finite instruction windows.
-//
-//===================================================================
-
-// A small structure to track lists of dependent link calculations.
-class LinkDeps {
-public:
-	// A link calculation that is dependent on this one.
-	// Positive values = "input A" while negative values = "input B".
-	int value;
-	// Next dependence in the list.
-	LinkDeps *next;
-};
-typedef LinkDeps *LinkDepsPtr;
-
-void GodotSoftBody3D::reoptimize_link_order() {
-	const int reop_not_dependent = -1;
-	const int reop_node_complete = -2;
+void GodotSoftBody3D::generate_link_batches() {
+	link_batches.clear();
 
-	uint32_t link_count = links.size();
-	uint32_t node_count = nodes.size();
-
-	if (link_count < 1 || node_count < 2) {
+	const uint32_t link_count = links.size();
+	if (link_count == 0) {
 		return;
 	}
 
-	uint32_t i;
-	Link *lr;
-	int ar, br;
-	Node *node0 = &(nodes[0]);
-	Node *node1 = &(nodes[1]);
-	LinkDepsPtr link_dep;
-	int ready_list_head, ready_list_tail, link_num, link_dep_frees, dep_link;
-
-	// Allocate temporary buffers.
-	int *node_written_at = memnew_arr(int, node_count + 1); // What link calculation produced this node's current values?
-	int *link_dep_A = memnew_arr(int, link_count); // Link calculation input is dependent upon prior calculation #N
-	int *link_dep_B = memnew_arr(int, link_count);
-	int *ready_list = memnew_arr(int, link_count); // List of ready-to-process link calculations (# of links, maximum)
-	LinkDeps *link_dep_free_list = memnew_arr(LinkDeps, 2 * link_count); // Dependent-on-me list elements (2x# of links, maximum)
-	LinkDepsPtr *link_dep_list_starts = memnew_arr(LinkDepsPtr, link_count); // Start nodes of dependent-on-me lists, one for each link
-
-	// Copy the original, unsorted links to a side buffer.
-	Link *link_buffer = memnew_arr(Link, link_count);
-	memcpy(link_buffer, &(links[0]), sizeof(Link) * link_count);
-
-	// Clear out the node setup and ready list.
-	for (i = 0; i < node_count + 1; i++) {
-		node_written_at[i] = reop_not_dependent;
-	}
-	for (i = 0; i < link_count; i++) {
-		link_dep_list_starts[i] = nullptr;
-	}
-	ready_list_head = ready_list_tail = link_dep_frees = 0;
-
-	// Initial link analysis to set up data structures.
-	for (i = 0; i < link_count; i++) {
-		// Note which prior link calculations we are dependent upon & build up dependence lists.
-		lr = &(links[i]);
-		ar = (lr->n[0] - node0) / (node1 - node0);
-		br = (lr->n[1] - node0) / (node1 - node0);
-		if (node_written_at[ar] > reop_not_dependent) {
-			link_dep_A[i] = node_written_at[ar];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = i;
-			link_dep->next = link_dep_list_starts[node_written_at[ar]];
-			link_dep_list_starts[node_written_at[ar]] = link_dep;
-		} else {
-			link_dep_A[i] = reop_not_dependent;
+	// Greedy graph coloring: each link takes the lowest color that isn't used yet by
+	// another link of one of its nodes, so that links of the same color share no node
+	// and can be solved concurrently. Links left without a color end up in a last
+	// batch that is always solved serially.
+	LocalVector<uint64_t> node_colors; // Bit mask of the colors already used around each node.
+	node_colors.resize(nodes.size());
+	memset(node_colors.ptr(), 0, node_colors.size() * sizeof(uint64_t));
+
+	LocalVector<uint32_t> link_colors;
+	link_colors.resize(link_count);
+
+	uint32_t color_count = 0;
+	uint32_t batch_sizes[LINK_BATCH_MAX_COLORS + 1] = {};
+	for (uint32_t i = 0; i < link_count; ++i) {
+		const uint32_t node_a = links[i].n[0]->index;
+		const uint32_t node_b = links[i].n[1]->index;
+		const uint64_t used_colors = node_colors[node_a] | node_colors[node_b];
+
+		uint32_t color = 0;
+		while (color < LINK_BATCH_MAX_COLORS && (used_colors & (uint64_t(1) << color))) {
+			++color;
 		}
-		if (node_written_at[br] > reop_not_dependent) {
-			link_dep_B[i] = node_written_at[br];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = -(int)(i + 1);
-			link_dep->next = link_dep_list_starts[node_written_at[br]];
-			link_dep_list_starts[node_written_at[br]] = link_dep;
-		} else {
-			link_dep_B[i] = reop_not_dependent;
+
+		if (color < LINK_BATCH_MAX_COLORS) {
+			node_colors[node_a] |= uint64_t(1) << color;
+			node_colors[node_b] |= uint64_t(1) << color;
+			color_count = MAX(color_count, color + 1);
 		}
 
-		// Add this link to the initial ready list, if it is not dependent on any other links.
-		if ((link_dep_A[i] == reop_not_dependent) && (link_dep_B[i] == reop_not_dependent)) {
-			ready_list[ready_list_tail++] = i;
-			link_dep_A[i] = link_dep_B[i] = reop_node_complete; // Probably not needed now.
+		link_colors[i] = color;
+		++batch_sizes[color];
+	}
+
+	// Sort links by color, keeping their original order within a batch.
+	uint32_t batch_offsets[LINK_BATCH_MAX_COLORS + 1];
+	uint32_t offset = 0;
+	link_batches.resize(color_count + 1);
+	for (uint32_t color = 0; color <= LINK_BATCH_MAX_COLORS; ++color) {
+		if (color < color_count) {
+			link_batches[color] = offset;
 		}
+		batch_offsets[color] = offset;
+		offset += batch_sizes[color];
+	}
+	link_batches[color_count] = batch_offsets[LINK_BATCH_MAX_COLORS];
 
-		// Update the nodes to mark which ones are calculated by this link.
-		node_written_at[ar] = node_written_at[br] = i;
-	}
-
-	// Process the ready list and create the sorted list of links:
-	// -- By treating the ready list as a queue, we maximize the distance between any
-	//    inter-dependent node calculations.
-	// -- All other (non-related) nodes in the ready list will automatically be inserted
-	//    in between each set of inter-dependent link calculations by this loop.
-	i = 0;
-	while (ready_list_head != ready_list_tail) {
-		// Use ready list to select the next link to process.
-		link_num = ready_list[ready_list_head++];
-		// Copy the next-to-calculate link back into the original link array.
-		links[i++] = link_buffer[link_num];
-
-		// Free up any link inputs that are dependent on this one.
-		link_dep = link_dep_list_starts[link_num];
-		while (link_dep) {
-			dep_link = link_dep->value;
-			if (dep_link >= 0) {
-				link_dep_A[dep_link] = reop_not_dependent;
-			} else {
-				dep_link = -dep_link - 1;
-				link_dep_B[dep_link] = reop_not_dependent;
-			}
-			// Add this dependent link calculation to the ready list if *both* inputs are clear.
-			if ((link_dep_A[dep_link] == reop_not_dependent) && (link_dep_B[dep_link] == reop_not_dependent)) {
-				ready_list[ready_list_tail++] = dep_link;
-				link_dep_A[dep_link] = link_dep_B[dep_link] = reop_node_complete; // Probably not needed now.
-			}
-			link_dep = link_dep->next;
+	LocalVector<Link> sorted_links;
+	sorted_links.resize(link_count);
+	for (uint32_t i = 0; i < link_count; ++i) {
+		sorted_links[batch_offsets[link_colors[i]]++] = links[i];
+	}
+	links = sorted_links;
+}
+
+void GodotSoftBody3D::generate_node_faces() {
+	const uint32_t node_count = nodes.size();
+	node_face_offsets.resize(node_count + 1);
+	memset(node_face_offsets.ptr(), 0, node_face_offsets.size() * sizeof(uint32_t));
+
+	for (const Face &face : faces) {
+		for (int j = 0; j < 3; ++j) {
+			++node_face_offsets[face.n[j]->index + 1];
 		}
 	}
+	for (uint32_t i = 0; i < node_count; ++i) {
+		node_face_offsets[i + 1] += node_face_offsets[i];
+	}
 
-	// Delete the temporary buffers.
-	memdelete_arr(node_written_at);
-	memdelete_arr(link_dep_A);
-	memdelete_arr(link_dep_B);
-	memdelete_arr(ready_list);
-	memdelete_arr(link_dep_free_list);
-	memdelete_arr(link_dep_list_starts);
-	memdelete_arr(link_buffer);
+	LocalVector<uint32_t> node_face_counts;
+	node_face_counts.resize(node_count);
+	memset(node_face_counts.ptr(), 0, node_count * sizeof(uint32_t));
+
+	node_faces.resize(node_face_offsets[node_count]);
+	for (const Face &face : faces) {
+		for (int j = 0; j < 3; ++j) {
+			const uint32_t node_index = face.n[j]->index;
+			node_faces[node_face_offsets[node_index] + node_face_counts[node_index]++] = face.index;
+		}
+	}
 }
 
 void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
@@ -969,9 +954,7 @@ Vector3 GodotSoftBody3D::_compute_area_windforce(const GodotArea3D *p_area, cons
 	return nodal_force_magnitude * p_face->normal;
 }
 
-void GodotSoftBody3D::predict_motion(real_t p_delta) {
-	const real_t inv_delta = 1.0 / p_delta;
-
+void GodotSoftBody3D::predict_motion(real_t p_delta, bool p_use_threads) {
 	ERR_FAIL_NULL(get_space());
 
 	bool gravity_done = false;
@@ -1028,22 +1011,10 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 		apply_forces(wind_areas);
 	}
 
-	// Avoid soft body from 'exploding' so use some upper threshold of maximum motion
-	// that a node can travel per frame.
-	const real_t max_displacement = 1000.0;
-	real_t clamp_delta_v = max_displacement * inv_delta;
-
 	// Integrate.
-	for (Node &node : nodes) {
-		node.q = node.x;
-		Vector3 delta_v = node.f * node.im * p_delta;
-		for (int c = 0; c < 3; c++) {
-			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
-		}
-		node.v += delta_v;
-		node.x += node.v * p_delta;
-		node.f = Vector3();
-	}
+	solver_use_threads = p_use_threads;
+	_solve_range(&GodotSoftBody3D::_integrate_nodes, nodes.size(), p_delta);
+	solver_use_threads = false;
 
 	// Bounds and tree update.
 	update_bounds();
@@ -1067,26 +1038,64 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	face_tree.optimize_incremental(1);
 }
 
-void GodotSoftBody3D::solve_constraints(real_t p_delta) {
-	const real_t inv_delta = 1.0 / p_delta;
+void GodotSoftBody3D::_integrate_nodes(uint32_t p_from, uint32_t p_to, real_t p_delta) {
+	// Avoid soft body from 'exploding' so use some upper threshold of maximum motion
+	// that a node can travel per frame.
+	const real_t max_displacement = 1000.0;
+	const real_t clamp_delta_v = max_displacement / p_delta;
 
-	for (Link &link : links) {
-		link.c3 = link.n[1]->q - link.n[0]->q;
-		link.c2 = 1 / (link.c3.length_squared() * link.c0);
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		Node &node = nodes[i];
+		node.q = node.x;
+		Vector3 delta_v = node.f * node.im * p_delta;
+		for (int c = 0; c < 3; c++) {
+			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
+		}
+		node.v += delta_v;
+		node.x += node.v * p_delta;
+		node.f = Vector3();
 	}
+}
+
+void GodotSoftBody3D::solve_constraints(real_t p_delta, bool p_use_threads) {
+	solver_use_threads = p_use_threads;
+
+	_solve_range(&GodotSoftBody3D::_update_link_gradients, links.size());
 
 	// Solve velocities.
-	for (Node &node : nodes) {
-		node.x = node.q + node.v * p_delta;
-	}
+	_solve_range(&GodotSoftBody3D::_predict_node_positions, nodes.size(), p_delta);
 
 	// Solve positions.
 	for (int isolve = 0; isolve < iteration_count; ++isolve) {
 		const real_t ti = isolve / (real_t)iteration_count;
 		solve_links(1.0, ti);
 	}
-	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
-	for (Node &node : nodes) {
+	_solve_range(&GodotSoftBody3D::_update_node_velocities, nodes.size(), p_delta);
+
+	update_normals_and_centroids();
+
+	solver_use_threads = false;
+}
+
+void GodotSoftBody3D::_update_link_gradients(uint32_t p_from, uint32_t p_to, real_t p_unused) {
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		Link &link = links[i];
+		link.c3 = link.n[1]->q - link.n[0]->q;
+		link.c2 = 1 / (link.c3.length_squared() * link.c0);
+	}
+}
+
+void GodotSoftBody3D::_predict_node_positions(uint32_t p_from, uint32_t p_to, real_t p_delta) {
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		Node &node = nodes[i];
+		node.x = node.q + node.v * p_delta;
+	}
+}
+
+void GodotSoftBody3D::_update_node_velocities(uint32_t p_from, uint32_t p_to, real_t p_delta) {
+	const real_t vc = (1.0 - damping_coefficient) / p_delta;
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		Node &node = nodes[i];
 		node.x += node.bv * p_delta;
 		node.bv = Vector3();
 
@@ -1094,19 +1103,33 @@ void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 
 		node.q = node.x;
 	}
-
-	update_normals_and_centroids();
 }
 
 void GodotSoftBody3D::solve_links(real_t kst, real_t ti) {
-	for (Link &link : links) {
+	if (link_batches.is_empty()) {
+		return;
+	}
+
+	// Links of a batch share no node, the batches themselves are solved in order.
+	const uint32_t batch_count = link_batches.size() - 1;
+	for (uint32_t batch = 0; batch < batch_count; ++batch) {
+		_solve_range(&GodotSoftBody3D::_solve_link_range, link_batches[batch + 1] - link_batches[batch], kst, link_batches[batch]);
+	}
+
+	// Links that couldn't be colored.
+	_solve_link_range(link_batches[batch_count], links.size(), kst);
+}
+
+void GodotSoftBody3D::_solve_link_range(uint32_t p_from, uint32_t p_to, real_t p_kst) {
+	for (uint32_t i = p_from; i < p_to; ++i) {
+		const Link &link = links[i];
 		if (link.c0 > 0) {
 			Node &node_a = *link.n[0];
 			Node &node_b = *link.n[1];
 			const Vector3 del = node_b.x - node_a.x;
 			const real_t len = del.length_squared();
 			if (link.c1 + len > CMP_EPSILON) {
-				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * kst;
+				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * p_kst;
 				node_a.x -= del * (k * node_a.im);
 				node_b.x += del * (k * node_b.im);
 			}
@@ -1223,6 +1246,10 @@ void GodotSoftBody3D::destroy() {
 	links.clear();
 	faces.clear();
 
+	link_batches.clear();
+	node_face_offsets.clear();
+	node_faces.clear();
+
 	bounds = AABB();
 	deinitialize_shape();
 }
@@ -44,6 +44,8 @@
 class GodotConstraint3D;
 
 class GodotSoftBody3D : public GodotCollisionObject3D {
+	friend class TestGodotSoftBody3DAccessor;
+
 	RID soft_mesh;
 
 	struct Node {
@@ -73,6 +75,7 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 		Vector3 centroid;
 		Node *n[3] = { nullptr, nullptr, nullptr }; // Node pointers
 		Vector3 normal; // Normal
+		Vector3 area_normal; // Normal scaled by twice the area
 		real_t ra = 0.0; // Rest area
 		DynamicBVH::ID leaf; // Leaf data
 		uint32_t index = 0;
@@ -82,6 +85,28 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 	LocalVector<Link> links;
 	LocalVector<Face> faces;
 
+	// Links are sorted by color so that links within a batch share no node, see `generate_link_batches()`.
+	// Holds the first link of each batch, then the first link that couldn't be colored.
+	LocalVector<uint32_t> link_batches;
+
+	// Faces around each node, the ones of node `i` are in [node_face_offsets[i], node_face_offsets[i + 1]).
+	LocalVector<uint32_t> node_face_offsets;
+	LocalVector<uint32_t> node_faces;
+
+	static const uint32_t LINK_BATCH_MAX_COLORS = 64;
+	static const uint32_t SOLVER_CHUNK_SIZE = 1024;
+
+	typedef void (GodotSoftBody3D::*SolveRangeMethod)(uint32_t p_from, uint32_t p_to, real_t p_param);
+
+	struct SolveRange {
+		SolveRangeMethod method = nullptr;
+		uint32_t from = 0;
+		uint32_t count = 0;
+		real_t param = 0.0;
+	};
+
+	bool solver_use_threads = false;
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
@@ -201,8 +226,12 @@ public:
 	void set_drag_coefficient(real_t p_val);
 	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
 
-	void predict_motion(real_t p_delta);
-	void solve_constraints(real_t p_delta);
+	_FORCE_INLINE_ uint32_t get_link_count() const { return links.size(); }
+
+	// Both split the work across WorkerThreadPool when p_use_threads is true,
+	// which must not be the case when called from one of its group tasks.
+	void predict_motion(real_t p_delta, bool p_use_threads = false);
+	void solve_constraints(real_t p_delta, bool p_use_threads = false);
 
 	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return static_cast<Node *>(p_node)->index; }
 	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return static_cast<Face *>(p_face)->index; }
@@ -233,12 +262,24 @@ private:
 
 	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
-	void reoptimize_link_order();
+	void generate_link_batches();
+	void generate_node_faces();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
 	void solve_links(real_t kst, real_t ti);
 
+	void _solve_range_chunk(uint32_t p_chunk, SolveRange *p_range);
+	void _solve_range(SolveRangeMethod p_method, uint32_t p_count, real_t p_param = 0.0, uint32_t p_from = 0);
+
+	void _integrate_nodes(uint32_t p_from, uint32_t p_to, real_t p_delta);
+	void _update_link_gradients(uint32_t p_from, uint32_t p_to, real_t p_unused);
+	void _predict_node_positions(uint32_t p_from, uint32_t p_to, real_t p_delta);
+	void _solve_link_range(uint32_t p_from, uint32_t p_to, real_t p_kst);
+	void _update_node_velocities(uint32_t p_from, uint32_t p_to, real_t p_delta);
+	void _update_face_normals(uint32_t p_from, uint32_t p_to, real_t p_unused);
+	void _update_node_normals(uint32_t p_from, uint32_t p_to, real_t p_unused);
+
 	void initialize_face_tree();
 	void update_face_tree(real_t p_delta);
 
@@ -64,6 +64,7 @@ class GodotSpace3D {
 public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
+		ELAPSED_TIME_BROAD_PHASE,
 		ELAPSED_TIME_GENERATE_ISLANDS,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
@@ -211,6 +212,9 @@ public:
 
 	bool test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result);
 
+	PackedByteArray get_snapshot() const;
+	bool restore_snapshot(const PackedByteArray &p_snapshot);
+
 	GodotSpace3D();
 	~GodotSpace3D();
 };
@@ -40,6 +40,7 @@
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define SOFT_BODY_PARALLEL_SOLVE_LINK_COUNT 8192
 
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -158,6 +159,10 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
+void GodotStep3D::_solve_soft_body(uint32_t p_soft_body_index, void *p_userdata) {
+	soft_bodies[p_soft_body_index]->solve_constraints(delta);
+}
+
 void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -214,19 +219,25 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	const SelfList<GodotSoftBody3D> *sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->predict_motion(p_delta);
+		sb->self()->predict_motion(p_delta, true);
 		sb = sb->next();
 		active_count++;
 	}
 
 	p_space->set_active_objects(active_count);
 
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		profile_begtime = profile_endtime;
+	}
+
 	// Update the broadphase to register collision pairs.
 	p_space->update();
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROAD_PHASE, profile_endtime - profile_begtime);
 		profile_begtime = profile_endtime;
 	}
 
@@ -390,12 +401,22 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* UPDATE SOFT BODY CONSTRAINTS */
 
+	// Large soft bodies split their own solving across threads, smaller ones are solved concurrently.
 	sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->solve_constraints(p_delta);
+		GodotSoftBody3D *soft_body = sb->self();
+		if (soft_body->get_link_count() >= SOFT_BODY_PARALLEL_SOLVE_LINK_COUNT) {
+			soft_body->solve_constraints(p_delta, true);
+		} else {
+			soft_bodies.push_back(soft_body);
+		}
 		sb = sb->next();
 	}
 
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_soft_body, nullptr, soft_bodies.size(), -1, true, SNAME("Physics3DSoftBodySolve"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	soft_bodies.clear();
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_VELOCITIES, profile_endtime - profile_begtime);
@@ -0,0 +1,263 @@
+/**************************************************************************/
+/*  test_godot_concave_polygon_shape_3d.h                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_CONCAVE_POLYGON_SHAPE_3D_H
+#define TEST_GODOT_CONCAVE_POLYGON_SHAPE_3D_H
+
+#include "../godot_shape_3d.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotConcavePolygonShape3D {
+
+real_t rand_range(RandomPCG &p_rng, real_t p_from, real_t p_to) {
+	return p_rng.random(p_from, p_to);
+}
+
+// Bumpy terrain of p_size * p_size quads, with faces shuffled so BVH order differs from input order.
+Vector<Vector3> make_terrain(int p_size, real_t p_cell_size, RandomPCG &p_rng) {
+	LocalVector<Vector3> heights;
+	heights.resize((p_size + 1) * (p_size + 1));
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			heights[z * (p_size + 1) + x] = Vector3(x * p_cell_size, rand_range(p_rng, -1.0, 1.0), z * p_cell_size);
+		}
+	}
+
+	LocalVector<uint32_t> order;
+	order.resize(p_size * p_size * 2);
+	for (uint32_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	for (uint32_t i = order.size() - 1; i > 0; i--) {
+		SWAP(order[i], order[p_rng.rand() % (i + 1)]);
+	}
+
+	Vector<Vector3> faces;
+	faces.resize(order.size() * 3);
+	Vector3 *w = faces.ptrw();
+	for (uint32_t i = 0; i < order.size(); i++) {
+		int quad = order[i] / 2;
+		int x = quad % p_size;
+		int z = quad / p_size;
+		const Vector3 &a = heights[z * (p_size + 1) + x];
+		const Vector3 &b = heights[z * (p_size + 1) + x + 1];
+		const Vector3 &c = heights[(z + 1) * (p_size + 1) + x];
+		const Vector3 &d = heights[(z + 1) * (p_size + 1) + x + 1];
+		if (order[i] % 2 == 0) {
+			w[i * 3 + 0] = a;
+			w[i * 3 + 1] = b;
+			w[i * 3 + 2] = c;
+		} else {
+			w[i * 3 + 0] = b;
+			w[i * 3 + 1] = d;
+			w[i * 3 + 2] = c;
+		}
+	}
+	return faces;
+}
+
+void setup_shape(GodotConcavePolygonShape3D &p_shape, const Vector<Vector3> &p_faces, bool p_backface_collision = false) {
+	Dictionary data;
+	data["faces"] = p_faces;
+	data["backface_collision"] = p_backface_collision;
+	p_shape.set_data(data);
+}
+
+bool collect_face_centers(void *p_userdata, GodotShape3D *p_face) {
+	GodotFaceShape3D *face = static_cast<GodotFaceShape3D *>(p_face);
+	static_cast<Vector<Vector3> *>(p_userdata)->push_back((face->vertex[0] + face->vertex[1] + face->vertex[2]) / 3.0);
+	return false;
+}
+
+bool count_faces(void *p_userdata, GodotShape3D *p_face) {
+	(*static_cast<int *>(p_userdata))++;
+	return false;
+}
+
+TEST_CASE("[Physics][GodotConcavePolygonShape3D] Faces are returned in their original order") {
+	RandomPCG rng(1234);
+	Vector<Vector3> faces = make_terrain(20, 1.0, rng);
+
+	GodotConcavePolygonShape3D shape;
+	setup_shape(shape, faces);
+
+	CHECK(shape.get_faces() == faces);
+	CHECK(shape.get_aabb().has_point(Vector3(10, 0, 10)));
+
+	Dictionary data = shape.get_data();
+	CHECK(Vector<Vector3>(data["faces"]) == faces);
+
+	setup_shape(shape, Vector<Vector3>());
+	CHECK(shape.get_faces().is_empty());
+	int count = 0;
+	shape.cull(AABB(Vector3(-100, -100, -100), Vector3(200, 200, 200)), count_faces, &count, false);
+	CHECK(count == 0);
+}
+
+TEST_CASE("[Physics][GodotConcavePolygonShape3D] Small meshes") {
+	Vector<Vector3> faces = { Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1) };
+
+	GodotConcavePolygonShape3D shape;
+	setup_shape(shape, faces);
+
+	Vector3 result;
+	Vector3 normal;
+	int face_index = -1;
+	CHECK(shape.intersect_segment(Vector3(0.25, 1, 0.25), Vector3(0.25, -1, 0.25), result, normal, face_index, false));
+	CHECK(result.is_equal_approx(Vector3(0.25, 0, 0.25)));
+	CHECK(normal.is_equal_approx(Vector3(0, 1, 0)));
+	CHECK(face_index == 0);
+
+	CHECK_FALSE(shape.intersect_segment(Vector3(2, 1, 2), Vector3(2, -1, 2), result, normal, face_index, false));
+	// Back face is not hit unless enabled.
+	CHECK_FALSE(shape.intersect_segment(Vector3(0.25, -1, 0.25), Vector3(0.25, 1, 0.25), result, normal, face_index, true));
+
+	setup_shape(shape, faces, true);
+	CHECK(shape.intersect_segment(Vector3(0.25, -1, 0.25), Vector3(0.25, 1, 0.25), result, normal, face_index, true));
+	CHECK(normal.is_equal_approx(Vector3(0, -1, 0)));
+
+	int count = 0;
+	shape.cull(AABB(Vector3(-1, -1, -1), Vector3(0.5, 2, 0.5)), count_faces, &count, false);
+	CHECK(count == 0);
+	shape.cull(AABB(Vector3(0.1, -1, 0.1), Vector3(0.1, 2, 0.1)), count_faces, &count, false);
+	CHECK(count == 1);
+}
+
+TEST_CASE("[Physics][GodotConcavePolygonShape3D] Queries match brute force") {
+	RandomPCG rng(5678);
+	Vector<Vector3> faces = make_terrain(64, 0.5, rng);
+	const int face_count = faces.size() / 3;
+
+	GodotConcavePolygonShape3D shape;
+	setup_shape(shape, faces);
+
+	SUBCASE("Segments") {
+		for (int i = 0; i < 200; i++) {
+			Vector3 from(rand_range(rng, -1, 33), rand_range(rng, 2, 4), rand_range(rng, -1, 33));
+			Vector3 to(rand_range(rng, -1, 33), rand_range(rng, -4, -2), rand_range(rng, -1, 33));
+
+			real_t best = 1e20;
+			int best_face = -1;
+			for (int f = 0; f < face_count; f++) {
+				Vector3 hit;
+				if (Geometry3D::segment_intersects_triangle(from, to, faces[f * 3 + 0], faces[f * 3 + 1], faces[f * 3 + 2], &hit)) {
+					real_t d = from.distance_to(hit);
+					if (d < best) {
+						best = d;
+						best_face = f;
+					}
+				}
+			}
+
+			Vector3 result;
+			Vector3 normal;
+			int face_index = -1;
+			bool hit = shape.intersect_segment(from, to, result, normal, face_index, false);
+			CHECK(hit == (best_face >= 0));
+			if (hit && best_face >= 0) {
+				CHECK(face_index == best_face);
+				CHECK(Math::is_equal_approx(from.distance_to(result), best));
+			}
+		}
+	}
+
+	SUBCASE("AABB cull") {
+		for (int i = 0; i < 50; i++) {
+			AABB query(Vector3(rand_range(rng, -1, 33), rand_range(rng, -2, 2), rand_range(rng, -1, 33)), Vector3(rand_range(rng, 0, 4), rand_range(rng, 0, 1), rand_range(rng, 0, 4)));
+
+			Vector<Vector3> expected;
+			for (int f = 0; f < face_count; f++) {
+				Face3 face(faces[f * 3 + 0], faces[f * 3 + 1], faces[f * 3 + 2]);
+				if (query.intersects_inclusive(face.get_aabb())) {
+					expected.push_back((face.vertex[0] + face.vertex[1] + face.vertex[2]) / 3.0);
+				}
+			}
+
+			Vector<Vector3> culled;
+			shape.cull(query, collect_face_centers, &culled, false);
+
+			expected.sort();
+			culled.sort();
+			CHECK(culled.size() == expected.size());
+			if (culled.size() == expected.size()) {
+				for (int j = 0; j < culled.size(); j++) {
+					CHECK(culled[j].is_equal_approx(expected[j]));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotConcavePolygonShape3D] Build, segment and cull queries") {
+	// Only uses the public shape interface, so it can also be run against older revisions for comparison.
+	RandomPCG rng(42);
+	const int size = 512;
+	Vector<Vector3> faces = make_terrain(size, 1.0, rng);
+
+	GodotConcavePolygonShape3D shape;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	setup_shape(shape, faces);
+	uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	const int query_count = 100000;
+	int hits = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < query_count; i++) {
+		Vector3 from(rand_range(rng, 0, size), 5, rand_range(rng, 0, size));
+		Vector3 to = from + Vector3(rand_range(rng, -20, 20), -10, rand_range(rng, -20, 20));
+		Vector3 result;
+		Vector3 normal;
+		int face_index;
+		hits += shape.intersect_segment(from, to, result, normal, face_index, false);
+	}
+	uint64_t segment_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	int culled = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < query_count; i++) {
+		AABB query(Vector3(rand_range(rng, 0, size), -1, rand_range(rng, 0, size)), Vector3(2, 2, 2));
+		shape.cull(query, count_faces, &culled, false);
+	}
+	uint64_t cull_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	print_line(vformat("GodotConcavePolygonShape3D benchmark: %d faces, build %.2f ms.", faces.size() / 3, build_usec / 1000.0));
+	print_line(vformat("  %d segments: %.3f us/query (%d hits).", query_count, double(segment_usec) / query_count, hits));
+	print_line(vformat("  %d AABB culls: %.3f us/query (%d faces).", query_count, double(cull_usec) / query_count, culled));
+	CHECK(hits > 0);
+}
+
+} // namespace TestGodotConcavePolygonShape3D
+
+#endif // TEST_GODOT_CONCAVE_POLYGON_SHAPE_3D_H
@@ -0,0 +1,376 @@
+/**************************************************************************/
+/*  test_godot_physics_benchmark_3d.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_PHYSICS_BENCHMARK_3D_H
+#define TEST_GODOT_PHYSICS_BENCHMARK_3D_H
+
+#include "../godot_physics_server_3d.h"
+
+#include "core/io/json.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+class TestGodotPhysicsServer3DAccessor {
+public:
+	static GodotSpace3D *get_space(GodotPhysicsServer3D *p_server, RID p_space) {
+		return p_server->space_owner.get_or_null(p_space);
+	}
+};
+
+// Benchmark scenes for Godot Physics 3D. Each one prints a single line of JSON with the average time spent
+// in every phase of the step, so runs can be compared by scripts:
+//   godot --headless --test --test-case="[Benchmark][Physics][GodotPhysics3D]*" --no-skip
+namespace TestGodotPhysicsBenchmark3D {
+
+static const char *phase_names[GodotSpace3D::ELAPSED_TIME_MAX] = {
+	"integrate_forces",
+	"broad_phase",
+	"generate_islands",
+	"setup_constraints",
+	"solve_constraints",
+	"integrate_velocities"
+};
+
+class BenchmarkScene {
+	GodotPhysicsServer3D *server = nullptr;
+	RID space;
+	LocalVector<RID> rids;
+
+	uint64_t phase_usec[GodotSpace3D::ELAPSED_TIME_MAX] = {};
+	uint64_t step_usec = 0;
+	uint64_t query_usec = 0;
+	int step_count = 0;
+
+public:
+	GodotPhysicsServer3D *get_server() const { return server; }
+	RID get_space() const { return space; }
+
+	RID create_shape(PhysicsServer3D::ShapeType p_type, const Variant &p_data) {
+		RID shape;
+		switch (p_type) {
+			case PhysicsServer3D::SHAPE_WORLD_BOUNDARY:
+				shape = server->world_boundary_shape_create();
+				break;
+			case PhysicsServer3D::SHAPE_SPHERE:
+				shape = server->sphere_shape_create();
+				break;
+			case PhysicsServer3D::SHAPE_BOX:
+				shape = server->box_shape_create();
+				break;
+			case PhysicsServer3D::SHAPE_CAPSULE:
+				shape = server->capsule_shape_create();
+				break;
+			case PhysicsServer3D::SHAPE_CONCAVE_POLYGON:
+				shape = server->concave_polygon_shape_create();
+				break;
+			default:
+				ERR_FAIL_V(RID());
+		}
+		server->shape_set_data(shape, p_data);
+		rids.push_back(shape);
+		return shape;
+	}
+
+	RID create_body(PhysicsServer3D::BodyMode p_mode, RID p_shape, const Transform3D &p_transform) {
+		RID body = server->body_create();
+		server->body_set_mode(body, p_mode);
+		server->body_add_shape(body, p_shape);
+		server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, p_transform);
+		server->body_set_space(body, space);
+		rids.push_back(body);
+		return body;
+	}
+
+	RID create_area(RID p_shape, const Transform3D &p_transform) {
+		RID area = server->area_create();
+		server->area_add_shape(area, p_shape);
+		server->area_set_transform(area, p_transform);
+		server->area_set_space(area, space);
+		rids.push_back(area);
+		return area;
+	}
+
+	RID create_joint() {
+		RID joint = server->joint_create();
+		rids.push_back(joint);
+		return joint;
+	}
+
+	void add_floor() {
+		create_body(PhysicsServer3D::BODY_MODE_STATIC, create_shape(PhysicsServer3D::SHAPE_WORLD_BOUNDARY, Plane(Vector3(0, 1, 0), 0)), Transform3D());
+	}
+
+	// Steps the space, timing everything p_queries does after each step as queries.
+	template <typename F>
+	void step(int p_count, F p_queries) {
+		GodotSpace3D *space_ptr = TestGodotPhysicsServer3DAccessor::get_space(server, space);
+		for (int i = 0; i < p_count; i++) {
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			server->step(1.0 / 60.0);
+			server->flush_queries();
+			uint64_t end = OS::get_singleton()->get_ticks_usec();
+			step_usec += end - begin;
+			for (int j = 0; j < GodotSpace3D::ELAPSED_TIME_MAX; j++) {
+				phase_usec[j] += space_ptr->get_elapsed_time(GodotSpace3D::ElapsedTime(j));
+			}
+
+			p_queries();
+			query_usec += OS::get_singleton()->get_ticks_usec() - end;
+			step_count++;
+		}
+	}
+
+	void step(int p_count) {
+		step(p_count, []() {});
+	}
+
+	void print_results(const String &p_name) const {
+		ERR_FAIL_COND(step_count == 0);
+
+		Dictionary results;
+		results["benchmark"] = "physics_3d/" + p_name;
+		results["steps"] = step_count;
+		results["objects"] = TestGodotPhysicsServer3DAccessor::get_space(server, space)->get_objects().size();
+		results["collision_pairs"] = server->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS);
+		results["step_usec"] = double(step_usec) / step_count;
+		for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
+			results[String(phase_names[i]) + "_usec"] = double(phase_usec[i]) / step_count;
+		}
+		results["queries_usec"] = double(query_usec) / step_count;
+		print_line(JSON::stringify(results));
+	}
+
+	BenchmarkScene() {
+		server = memnew(GodotPhysicsServer3D);
+		server->init();
+		space = server->space_create();
+		server->space_set_active(space, true);
+	}
+
+	~BenchmarkScene() {
+		for (int64_t i = rids.size() - 1; i >= 0; i--) {
+			server->free(rids[i]);
+		}
+		server->free(space);
+		server->finish();
+		memdelete(server);
+	}
+};
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics3D] Box stacks") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	RID box = scene.create_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5));
+	for (int x = 0; x < 8; x++) {
+		for (int z = 0; z < 8; z++) {
+			for (int y = 0; y < 12; y++) {
+				scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, box, Transform3D(Basis(), Vector3(x * 3, 0.5 + y * 1.01, z * 3)));
+			}
+		}
+	}
+
+	scene.step(300);
+	scene.print_results("box_stacks");
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics3D] Ragdoll pile") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	Dictionary limb_data;
+	limb_data["radius"] = 0.1;
+	limb_data["height"] = 0.6;
+	RID limb = scene.create_shape(PhysicsServer3D::SHAPE_CAPSULE, limb_data);
+	RID torso = scene.create_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.25, 0.35, 0.15));
+	RID head = scene.create_shape(PhysicsServer3D::SHAPE_SPHERE, 0.15);
+
+	// Limb offsets from the torso center, joined at the torso edge.
+	const Vector3 limb_offsets[4] = { Vector3(-0.45, 0.2, 0), Vector3(0.45, 0.2, 0), Vector3(-0.15, -0.7, 0), Vector3(0.15, -0.7, 0) };
+	const Vector3 limb_joints[4] = { Vector3(-0.25, 0.2, 0), Vector3(0.25, 0.2, 0), Vector3(-0.15, -0.35, 0), Vector3(0.15, -0.35, 0) };
+	const Basis limb_bases[4] = { Basis(Vector3(0, 0, 1), Math_PI / 2), Basis(Vector3(0, 0, 1), Math_PI / 2), Basis(), Basis() };
+
+	for (int i = 0; i < 64; i++) {
+		const Vector3 origin(Math::fmod(i * 0.7, 3.0), 2 + i * 0.8, Math::fmod(i * 1.3, 3.0));
+		const Basis basis(Vector3(0, 1, 0), i * 0.5);
+		RID torso_body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, torso, Transform3D(basis, origin));
+
+		RID head_body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, head, Transform3D(basis, origin + basis.xform(Vector3(0, 0.55, 0))));
+		scene.get_server()->joint_make_cone_twist(scene.create_joint(), torso_body, Transform3D(Basis(), Vector3(0, 0.35, 0)), head_body, Transform3D(Basis(), Vector3(0, -0.2, 0)));
+
+		for (int j = 0; j < 4; j++) {
+			RID limb_body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, limb, Transform3D(basis * limb_bases[j], origin + basis.xform(limb_offsets[j])));
+			const Transform3D limb_frame = Transform3D(limb_bases[j], limb_offsets[j]).affine_inverse() * Transform3D(Basis(), limb_joints[j]);
+			scene.get_server()->joint_make_cone_twist(scene.create_joint(), torso_body, Transform3D(Basis(), limb_joints[j]), limb_body, limb_frame);
+		}
+	}
+
+	scene.step(300);
+	scene.print_results("ragdoll_pile");
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics3D] Characters on trimesh terrain") {
+	BenchmarkScene scene;
+
+	const int resolution = 128;
+	const real_t size = 128;
+	PackedVector3Array faces;
+	auto height = [](real_t p_x, real_t p_z) { return Math::sin(p_x * 0.2) * Math::cos(p_z * 0.15) * 3.0; };
+	for (int z = 0; z < resolution; z++) {
+		for (int x = 0; x < resolution; x++) {
+			const real_t x0 = x * size / resolution - size / 2;
+			const real_t z0 = z * size / resolution - size / 2;
+			const real_t x1 = x0 + size / resolution;
+			const real_t z1 = z0 + size / resolution;
+			const Vector3 v00(x0, height(x0, z0), z0);
+			const Vector3 v10(x1, height(x1, z0), z0);
+			const Vector3 v01(x0, height(x0, z1), z1);
+			const Vector3 v11(x1, height(x1, z1), z1);
+			faces.append_array({ v00, v10, v01, v10, v11, v01 });
+		}
+	}
+	Dictionary terrain_data;
+	terrain_data["faces"] = faces;
+	terrain_data["backface_collision"] = false;
+	scene.create_body(PhysicsServer3D::BODY_MODE_STATIC, scene.create_shape(PhysicsServer3D::SHAPE_CONCAVE_POLYGON, terrain_data), Transform3D());
+
+	// Some rigid bodies for the characters to walk into.
+	RID box = scene.create_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5));
+	for (int i = 0; i < 256; i++) {
+		scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, box, Transform3D(Basis(), Vector3(Math::fmod(i * 7.3, 100.0) - 50, 6, Math::fmod(i * 3.7, 100.0) - 50)));
+	}
+
+	Dictionary character_data;
+	character_data["radius"] = 0.4;
+	character_data["height"] = 1.8;
+	RID character_shape = scene.create_shape(PhysicsServer3D::SHAPE_CAPSULE, character_data);
+
+	struct Character {
+		RID body;
+		Transform3D transform;
+		Vector3 velocity;
+	};
+	LocalVector<Character> characters;
+	for (int i = 0; i < 512; i++) {
+		Character character;
+		character.transform.origin = Vector3(Math::fmod(i * 5.1, 100.0) - 50, 5, Math::fmod(i * 9.7, 100.0) - 50);
+		character.velocity = Vector3(Math::cos(i * 0.3), 0, Math::sin(i * 0.3)) * 4.0;
+		character.body = scene.create_body(PhysicsServer3D::BODY_MODE_KINEMATIC, character_shape, character.transform);
+		characters.push_back(character);
+	}
+
+	// A simplified `CharacterBody3D::move_and_slide()`, with up to two slides.
+	scene.step(120, [&]() {
+		const real_t delta = 1.0 / 60.0;
+		for (Character &character : characters) {
+			character.velocity.y -= 9.8 * delta;
+			Vector3 motion = character.velocity * delta;
+			for (int slide = 0; slide < 2; slide++) {
+				PhysicsServer3D::MotionResult result;
+				const bool collided = scene.get_server()->body_test_motion(character.body, PhysicsServer3D::MotionParameters(character.transform, motion), &result);
+				character.transform.origin += result.travel;
+				if (!collided) {
+					break;
+				}
+				const Vector3 normal = result.collisions[0].normal;
+				motion = result.remainder.slide(normal);
+				character.velocity = character.velocity.slide(normal);
+			}
+			scene.get_server()->body_set_state(character.body, PhysicsServer3D::BODY_STATE_TRANSFORM, character.transform);
+		}
+	});
+	scene.print_results("terrain_characters");
+}
+
+static int area_events = 0;
+
+static void area_monitor_callback(int p_status, const RID &p_body, ObjectID p_instance, int p_body_shape, int p_area_shape) {
+	area_events++;
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics3D] Overlapping areas") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	// Point gravity areas with monitoring, overlapping each other and all bodies passing through them.
+	RID area_shape = scene.create_shape(PhysicsServer3D::SHAPE_SPHERE, 6.0);
+	for (int x = 0; x < 8; x++) {
+		for (int z = 0; z < 8; z++) {
+			RID area = scene.create_area(area_shape, Transform3D(Basis(), Vector3(x * 5, 3, z * 5)));
+			scene.get_server()->area_set_param(area, PhysicsServer3D::AREA_PARAM_GRAVITY_OVERRIDE_MODE, PhysicsServer3D::AREA_SPACE_OVERRIDE_COMBINE);
+			scene.get_server()->area_set_param(area, PhysicsServer3D::AREA_PARAM_GRAVITY_IS_POINT, true);
+			scene.get_server()->area_set_param(area, PhysicsServer3D::AREA_PARAM_GRAVITY, 2.0);
+			scene.get_server()->area_set_monitor_callback(area, callable_mp_static(&area_monitor_callback));
+		}
+	}
+
+	RID sphere = scene.create_shape(PhysicsServer3D::SHAPE_SPHERE, 0.3);
+	for (int i = 0; i < 2048; i++) {
+		RID body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, sphere, Transform3D(Basis(), Vector3(Math::fmod(i * 1.37, 35.0), 1 + (i % 16) * 0.7, Math::fmod(i * 2.71, 35.0))));
+		scene.get_server()->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(Math::sin(i * 0.1), 0, Math::cos(i * 0.1)) * 3.0);
+	}
+
+	area_events = 0;
+	scene.step(300);
+	scene.print_results("overlapping_areas");
+	CHECK(area_events > 0);
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotPhysics3D] Ray query flood") {
+	BenchmarkScene scene;
+	scene.add_floor();
+
+	RID box = scene.create_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5));
+	for (int x = 0; x < 32; x++) {
+		for (int z = 0; z < 32; z++) {
+			const PhysicsServer3D::BodyMode mode = (x + z) % 4 == 0 ? PhysicsServer3D::BODY_MODE_RIGID : PhysicsServer3D::BODY_MODE_STATIC;
+			scene.create_body(mode, box, Transform3D(Basis(), Vector3(x * 2, 0.5 + (x * z % 3), z * 2)));
+		}
+	}
+
+	int hits = 0;
+	scene.step(120, [&]() {
+		PhysicsDirectSpaceState3D *state = scene.get_server()->space_get_direct_state(scene.get_space());
+		PhysicsDirectSpaceState3D::RayParameters parameters;
+		PhysicsDirectSpaceState3D::RayResult result;
+		for (int i = 0; i < 8192; i++) {
+			parameters.from = Vector3(Math::fmod(i * 0.37, 64.0), 10, Math::fmod(i * 0.73, 64.0));
+			parameters.to = parameters.from + Vector3(Math::sin(i * 0.01) * 20, -15, Math::cos(i * 0.01) * 20);
+			hits += state->intersect_ray(parameters, result);
+		}
+	});
+	scene.print_results("ray_query_flood");
+	CHECK(hits > 0);
+}
+
+} // namespace TestGodotPhysicsBenchmark3D
+
+#endif // TEST_GODOT_PHYSICS_BENCHMARK_3D_H
@@ -0,0 +1,216 @@
+/**************************************************************************/
+/*  test_godot_soft_body_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SOFT_BODY_3D_H
+#define TEST_GODOT_SOFT_BODY_3D_H
+
+#include "../godot_soft_body_3d.h"
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+class TestGodotSoftBody3DAccessor {
+public:
+	static bool create_from_trimesh(GodotSoftBody3D *p_soft_body, const Vector<int> &p_indices, const Vector<Vector3> &p_vertices) {
+		return p_soft_body->create_from_trimesh(p_indices, p_vertices);
+	}
+
+	// Returns false if two links of a batch share a node.
+	static bool check_link_batches(GodotSoftBody3D *p_soft_body) {
+		const LocalVector<uint32_t> &batches = p_soft_body->link_batches;
+		if (batches.is_empty() || batches[batches.size() - 1] > p_soft_body->links.size()) {
+			return false;
+		}
+
+		LocalVector<uint32_t> node_batches;
+		node_batches.resize(p_soft_body->nodes.size());
+		for (uint32_t i = 0; i < node_batches.size(); i++) {
+			node_batches[i] = UINT32_MAX;
+		}
+
+		for (uint32_t batch = 0; batch + 1 < batches.size(); batch++) {
+			for (uint32_t i = batches[batch]; i < batches[batch + 1]; i++) {
+				for (int j = 0; j < 2; j++) {
+					uint32_t &node_batch = node_batches[p_soft_body->links[i].n[j]->index];
+					if (node_batch == batch) {
+						return false;
+					}
+					node_batch = batch;
+				}
+			}
+		}
+		return true;
+	}
+
+	static uint32_t get_link_batch_count(GodotSoftBody3D *p_soft_body) {
+		return p_soft_body->link_batches.size() - 1;
+	}
+
+	// Same as a physics step without collisions, without the space `predict_motion()` needs.
+	static void step(GodotSoftBody3D *p_soft_body, real_t p_delta, bool p_use_threads) {
+		p_soft_body->add_velocity(Vector3(0, -9.8, 0) * p_delta);
+		p_soft_body->solver_use_threads = p_use_threads;
+		p_soft_body->_solve_range(&GodotSoftBody3D::_integrate_nodes, p_soft_body->nodes.size(), p_delta);
+		p_soft_body->solver_use_threads = false;
+		p_soft_body->solve_constraints(p_delta, p_use_threads);
+	}
+};
+
+namespace TestGodotSoftBody3D {
+
+// Cloth of p_resolution * p_resolution quads, hanging from two of its corners.
+void setup_cloth(GodotSoftBody3D *p_soft_body, int p_resolution) {
+	const int row = p_resolution + 1;
+
+	Vector<Vector3> vertices;
+	vertices.resize(row * row);
+	for (int z = 0; z < row; z++) {
+		for (int x = 0; x < row; x++) {
+			vertices.write[z * row + x] = Vector3(x, 0, z) / p_resolution;
+		}
+	}
+
+	Vector<int> indices;
+	for (int z = 0; z < p_resolution; z++) {
+		for (int x = 0; x < p_resolution; x++) {
+			const int i = z * row + x;
+			indices.push_back(i);
+			indices.push_back(i + 1);
+			indices.push_back(i + row);
+			indices.push_back(i + 1);
+			indices.push_back(i + row + 1);
+			indices.push_back(i + row);
+		}
+	}
+
+	p_soft_body->pin_vertex(0);
+	p_soft_body->pin_vertex(p_resolution);
+	p_soft_body->set_total_mass(1.0);
+	TestGodotSoftBody3DAccessor::create_from_trimesh(p_soft_body, indices, vertices);
+}
+
+TEST_CASE("[Physics][GodotSoftBody3D] Link batches share no node") {
+	GodotSoftBody3D soft_body;
+	setup_cloth(&soft_body, 24);
+
+	CHECK(soft_body.get_link_count() > 0);
+	CHECK(TestGodotSoftBody3DAccessor::check_link_batches(&soft_body));
+	// A regular cloth has a low node degree, links should all fit in a few colors.
+	CHECK(TestGodotSoftBody3DAccessor::get_link_batch_count(&soft_body) < 32);
+}
+
+TEST_CASE("[Physics][GodotSoftBody3D] Threaded solve matches the serial solve") {
+	GodotSoftBody3D serial_soft_body;
+	GodotSoftBody3D threaded_soft_body;
+	setup_cloth(&serial_soft_body, 64);
+	setup_cloth(&threaded_soft_body, 64);
+
+	for (int i = 0; i < 10; i++) {
+		TestGodotSoftBody3DAccessor::step(&serial_soft_body, 1.0 / 60.0, false);
+		TestGodotSoftBody3DAccessor::step(&threaded_soft_body, 1.0 / 60.0, true);
+	}
+
+	// Links of a batch share no node, so the result doesn't depend on how batches are split.
+	int mismatches = 0;
+	for (uint32_t i = 0; i < serial_soft_body.get_node_count(); i++) {
+		if (serial_soft_body.get_node_position(i) != threaded_soft_body.get_node_position(i)) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+
+	// Pinned corners don't move, the rest of the cloth falls.
+	CHECK(serial_soft_body.get_node_position(0) == Vector3());
+	CHECK(serial_soft_body.get_node_position(serial_soft_body.get_node_count() - 1).y < 0);
+	for (uint32_t i = 0; i < serial_soft_body.get_face_count(); i++) {
+		CHECK_FALSE(serial_soft_body.get_face_normal(i).is_zero_approx());
+	}
+}
+
+void solve_cloth(void *p_userdata, uint32_t p_index) {
+	GodotSoftBody3D *soft_bodies = static_cast<GodotSoftBody3D *>(p_userdata);
+	TestGodotSoftBody3DAccessor::step(&soft_bodies[p_index], 1.0 / 60.0, false);
+}
+
+TEST_CASE_BENCHMARK("[Physics][GodotSoftBody3D] Cloth solve") {
+	const int step_count = 60;
+
+	for (int resolution : { 16, 32, 64 }) {
+		GodotSoftBody3D serial_soft_body;
+		GodotSoftBody3D threaded_soft_body;
+		setup_cloth(&serial_soft_body, resolution);
+		setup_cloth(&threaded_soft_body, resolution);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < step_count; i++) {
+			TestGodotSoftBody3DAccessor::step(&serial_soft_body, 1.0 / 60.0, false);
+		}
+		uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < step_count; i++) {
+			TestGodotSoftBody3DAccessor::step(&threaded_soft_body, 1.0 / 60.0, true);
+		}
+		uint64_t threaded_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(vformat("GodotSoftBody3D benchmark: %dx%d cloth, %d nodes, %d links in %d batches.", resolution, resolution, serial_soft_body.get_node_count(), serial_soft_body.get_link_count(), TestGodotSoftBody3DAccessor::get_link_batch_count(&serial_soft_body)));
+		print_line(vformat("  serial %.3f ms/step, threaded %.3f ms/step.", serial_usec / 1000.0 / step_count, threaded_usec / 1000.0 / step_count));
+	}
+
+	const int cloth_count = 16;
+	GodotSoftBody3D *soft_bodies = memnew_arr(GodotSoftBody3D, cloth_count);
+	for (int i = 0; i < cloth_count; i++) {
+		setup_cloth(&soft_bodies[i], 24);
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < step_count; i++) {
+		for (int j = 0; j < cloth_count; j++) {
+			solve_cloth(soft_bodies, j);
+		}
+	}
+	uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < step_count; i++) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&solve_cloth, soft_bodies, cloth_count, -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+	uint64_t concurrent_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	print_line(vformat("  %d 24x24 cloths: one by one %.3f ms/step, concurrently %.3f ms/step.", cloth_count, serial_usec / 1000.0 / step_count, concurrent_usec / 1000.0 / step_count));
+	memdelete_arr(soft_bodies);
+}
+
+} // namespace TestGodotSoftBody3D
+
+#endif // TEST_GODOT_SOFT_BODY_3D_H
@@ -0,0 +1,137 @@
+/**************************************************************************/
+/*  test_godot_space_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SPACE_3D_H
+#define TEST_GODOT_SPACE_3D_H
+
+#include "../godot_physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotSpace3D {
+
+struct BodyState {
+	Transform3D transform;
+	Vector3 linear_velocity;
+	Vector3 angular_velocity;
+
+	bool operator==(const BodyState &p_other) const {
+		return transform == p_other.transform && linear_velocity == p_other.linear_velocity && angular_velocity == p_other.angular_velocity;
+	}
+	bool operator!=(const BodyState &p_other) const { return !(*this == p_other); }
+};
+
+Vector<BodyState> get_body_states(PhysicsServer3D *p_server, const Vector<RID> &p_bodies) {
+	Vector<BodyState> states;
+	for (const RID &body : p_bodies) {
+		BodyState state;
+		state.transform = p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		state.linear_velocity = p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		state.angular_velocity = p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+		states.push_back(state);
+	}
+	return states;
+}
+
+TEST_CASE("[Physics][GodotSpace3D] Restoring a snapshot replays the same simulation") {
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID floor_shape = server->world_boundary_shape_create();
+	server->shape_set_data(floor_shape, Plane(Vector3(0, 1, 0), 0));
+	RID floor = server->body_create();
+	server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	server->body_add_shape(floor, floor_shape);
+	server->body_set_space(floor, space);
+
+	// A leaning stack keeps contacts and accumulated impulses alive across the snapshot.
+	RID box_shape = server->box_shape_create();
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	Vector<RID> boxes;
+	for (int i = 0; i < 6; i++) {
+		RID box = server->body_create();
+		server->body_add_shape(box, box_shape);
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(Vector3(0, 1, 0), 0.1 * i), Vector3(0.1 * i, 0.5 + 1.05 * i, 0)));
+		server->body_set_space(box, space);
+		boxes.push_back(box);
+	}
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	const Vector<BodyState> snapshot_states = get_body_states(server, boxes);
+	const PackedByteArray snapshot = server->space_get_snapshot(space);
+	CHECK(snapshot.size() > 0);
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+	const Vector<BodyState> expected_states = get_body_states(server, boxes);
+	CHECK(expected_states != snapshot_states);
+
+	CHECK(server->space_restore_snapshot(space, snapshot));
+	CHECK(get_body_states(server, boxes) == snapshot_states);
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+	CHECK(get_body_states(server, boxes) == expected_states);
+
+	ERR_PRINT_OFF;
+	CHECK_FALSE(server->space_restore_snapshot(space, PackedByteArray()));
+	PackedByteArray truncated = snapshot;
+	truncated.resize(snapshot.size() / 2);
+	CHECK_FALSE(server->space_restore_snapshot(space, truncated));
+	// Only the last pair record is cut, after all the body records were read.
+	truncated = snapshot;
+	truncated.resize(snapshot.size() - 1);
+	CHECK_FALSE(server->space_restore_snapshot(space, truncated));
+	ERR_PRINT_ON;
+	// A failed restore leaves the bodies as they were.
+	CHECK(get_body_states(server, boxes) == expected_states);
+
+	for (const RID &box : boxes) {
+		server->free(box);
+	}
+	server->free(floor);
+	server->free(box_shape);
+	server->free(floor_shape);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestGodotSpace3D
+
+#endif // TEST_GODOT_SPACE_3D_H
@@ -271,6 +271,12 @@ real_t FORWARD_1_C(map_get_cell_size, RID, p_map, rid_to_rid);
 void FORWARD_2(map_set_use_edge_connections, RID, p_map, bool, p_enabled, rid_to_rid, bool_to_bool);
 bool FORWARD_1_C(map_get_use_edge_connections, RID, p_map, rid_to_rid);
 
+void FORWARD_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled, rid_to_rid, bool_to_bool);
+bool FORWARD_1_C(map_get_use_hierarchical_pathfinding, RID, p_map, rid_to_rid);
+
+void FORWARD_2(map_set_use_async_iterations, RID, p_map, bool, p_enabled, rid_to_rid, bool_to_bool);
+bool FORWARD_1_C(map_get_use_async_iterations, RID, p_map, rid_to_rid);
+
 void FORWARD_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin, rid_to_rid, real_to_real);
 real_t FORWARD_1_C(map_get_edge_connection_margin, RID, p_map, rid_to_rid);
 
@@ -466,6 +472,49 @@ void GodotNavigationServer2D::query_path(const Ref<NavigationPathQueryParameters
 	p_query_result->set_path_types(_query_result.path_types);
 	p_query_result->set_path_rids(_query_result.path_rids);
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
+	p_query_result->set_path_length(_query_result.path_length);
+	p_query_result->set_explored_polygon_count(_query_result.explored_polygon_count);
+	p_query_result->set_query_time_usec(_query_result.query_time_usec);
+}
+
+int64_t GodotNavigationServer2D::query_paths_async(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_V_MSG(p_query_parameters.size() != p_query_results.size(), 0, "The number of path query parameters and results must match.");
+
+	LocalVector<NavigationUtilities::PathQueryParameters> parameters;
+	parameters.resize(p_query_parameters.size());
+	for (int i = 0; i < p_query_parameters.size(); i++) {
+		const Ref<NavigationPathQueryParameters2D> query_parameters = p_query_parameters[i];
+		ERR_FAIL_COND_V(query_parameters.is_null(), 0);
+		ERR_FAIL_COND_V(Ref<NavigationPathQueryResult2D>(p_query_results[i]).is_null(), 0);
+		parameters[i] = query_parameters->get_parameters();
+	}
+
+	return NavigationServer3D::get_singleton()->_query_paths_async(parameters, callable_mp(this, &GodotNavigationServer2D::_path_query_batch_finished).bind(p_query_results, p_callback));
+}
+
+bool GodotNavigationServer2D::is_path_query_batch_completed(int64_t p_batch_id) const {
+	return NavigationServer3D::get_singleton()->is_path_query_batch_completed(p_batch_id);
+}
+
+void GodotNavigationServer2D::_path_query_batch_finished(int64_t p_batch_id, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback) {
+	LocalVector<NavigationUtilities::PathQueryResult> results;
+	ERR_FAIL_COND(!NavigationServer3D::get_singleton()->_path_query_batch_get_results(p_batch_id, results));
+	ERR_FAIL_COND(results.size() != (uint32_t)p_query_results.size());
+
+	for (uint32_t i = 0; i < results.size(); i++) {
+		Ref<NavigationPathQueryResult2D> query_result = p_query_results[i];
+		query_result->set_path(vector_v3_to_v2(results[i].path));
+		query_result->set_path_types(results[i].path_types);
+		query_result->set_path_rids(results[i].path_rids);
+		query_result->set_path_owner_ids(results[i].path_owner_ids);
+		query_result->set_path_length(results[i].path_length);
+		query_result->set_explored_polygon_count(results[i].explored_polygon_count);
+		query_result->set_query_time_usec(results[i].query_time_usec);
+	}
+
+	if (p_callback.is_valid()) {
+		p_callback.call(p_batch_id);
+	}
 }
 
 RID GodotNavigationServer2D::source_geometry_parser_create() {
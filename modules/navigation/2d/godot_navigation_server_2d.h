@@ -51,6 +51,8 @@ class GodotNavigationServer2D : public NavigationServer2D {
 	NavMeshGenerator2D *navmesh_generator_2d = nullptr;
 #endif // CLIPPER2_ENABLED
 
+	void _path_query_batch_finished(int64_t p_batch_id, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback);
+
 public:
 	GodotNavigationServer2D();
 	virtual ~GodotNavigationServer2D();
@@ -64,6 +66,10 @@ public:
 	virtual real_t map_get_cell_size(RID p_map) const override;
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) override;
 	virtual bool map_get_use_edge_connections(RID p_map) const override;
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) override;
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+	virtual void map_set_use_async_iterations(RID p_map, bool p_enabled) override;
+	virtual bool map_get_use_async_iterations(RID p_map) const override;
 	virtual void map_set_edge_connection_margin(RID p_map, real_t p_connection_margin) override;
 	virtual real_t map_get_edge_connection_margin(RID p_map) const override;
 	virtual void map_set_link_connection_radius(RID p_map, real_t p_connection_radius) override;
@@ -243,6 +249,8 @@ public:
 	virtual uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const override;
 
 	virtual void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const override;
+	virtual int64_t query_paths_async(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) override;
+	virtual bool is_path_query_batch_completed(int64_t p_batch_id) const override;
 
 	virtual void init() override;
 	virtual void sync() override;
@@ -30,7 +30,9 @@
 
 #include "godot_navigation_server_3d.h"
 
+#include "core/config/project_settings.h"
 #include "core/os/mutex.h"
+#include "core/os/os.h"
 #include "scene/main/node.h"
 
 #ifndef _3D_DISABLED
@@ -209,6 +211,34 @@ bool GodotNavigationServer3D::map_get_use_edge_connections(RID p_map) const {
 	return map->get_use_edge_connections();
 }
 
+COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_hierarchical_pathfinding(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_hierarchical_pathfinding(RID p_map) const {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_hierarchical_pathfinding();
+}
+
+COMMAND_2(map_set_use_async_iterations, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_async_iterations(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_async_iterations(RID p_map) const {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_async_iterations();
+}
+
 COMMAND_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin) {
 	NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL(map);
@@ -1151,6 +1181,17 @@ void GodotNavigationServer3D::bake_from_source_geometry_data(const Ref<Navigatio
 #endif // _3D_DISABLED
 }
 
+void GodotNavigationServer3D::bake_tiles_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Ref<NavigationMeshTiles3D> &p_navigation_mesh_tiles, const Callable &p_callback) {
+#ifndef _3D_DISABLED
+	ERR_FAIL_COND_MSG(!p_navigation_mesh.is_valid(), "Invalid navigation mesh.");
+	ERR_FAIL_COND_MSG(!p_source_geometry_data.is_valid(), "Invalid NavigationMeshSourceGeometryData3D.");
+	ERR_FAIL_COND_MSG(!p_navigation_mesh_tiles.is_valid(), "Invalid NavigationMeshTiles3D.");
+
+	ERR_FAIL_NULL(NavMeshGenerator3D::get_singleton());
+	NavMeshGenerator3D::get_singleton()->bake_tiles_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, p_navigation_mesh_tiles, p_callback);
+#endif // _3D_DISABLED
+}
+
 void GodotNavigationServer3D::bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback) {
 #ifndef _3D_DISABLED
 	ERR_FAIL_COND_MSG(!p_navigation_mesh.is_valid(), "Invalid navigation mesh.");
@@ -1293,9 +1334,12 @@ void GodotNavigationServer3D::map_force_update(RID p_map) {
 	NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL(map);
 
+	// Same as in `process`, the async path queries may still read the maps that are about to be freed or synced.
+	_finish_path_queries();
+
 	flush_queries();
 
-	map->sync();
+	map->sync(true);
 }
 
 uint32_t GodotNavigationServer3D::map_get_iteration_id(RID p_map) const {
@@ -1314,9 +1358,14 @@ void GodotNavigationServer3D::sync() {
 }
 
 void GodotNavigationServer3D::process(real_t p_delta_time) {
+	// Async path queries read the maps, so they need to finish before any command or sync modifies them.
+	_finish_path_queries();
+
 	flush_queries();
 
 	if (!active) {
+		// Maps are not synced while inactive, but queued path queries still run on their last synced state.
+		_dispatch_path_queries();
 		return;
 	}
 
@@ -1329,13 +1378,19 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	int _new_pm_edge_connection_count = 0;
 	int _new_pm_edge_free_count = 0;
 	int _new_pm_obstacle_count = 0;
+	uint64_t _new_pm_map_sync_time = 0;
+	uint64_t _new_pm_avoidance_time = 0;
 
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
 	MutexLock lock(operations_mutex);
 	for (uint32_t i(0); i < active_maps.size(); i++) {
+		const uint64_t sync_begin_usec = OS::get_singleton()->get_ticks_usec();
 		active_maps[i]->sync();
+		const uint64_t step_begin_usec = OS::get_singleton()->get_ticks_usec();
 		active_maps[i]->step(p_delta_time);
+		_new_pm_map_sync_time += step_begin_usec - sync_begin_usec;
+		_new_pm_avoidance_time += OS::get_singleton()->get_ticks_usec() - step_begin_usec;
 		active_maps[i]->dispatch_callbacks();
 
 		_new_pm_region_count += active_maps[i]->get_pm_region_count();
@@ -1365,15 +1420,31 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
 	pm_obstacle_count = _new_pm_obstacle_count;
+	pm_map_sync_time = _new_pm_map_sync_time;
+	pm_avoidance_time = _new_pm_avoidance_time;
+
+	_dispatch_path_queries();
 }
 
 void GodotNavigationServer3D::init() {
+	max_async_path_queries_per_frame = GLOBAL_GET("navigation/pathfinding/max_async_path_queries_per_frame");
+
 #ifndef _3D_DISABLED
 	navmesh_generator_3d = memnew(NavMeshGenerator3D);
 #endif // _3D_DISABLED
 }
 
 void GodotNavigationServer3D::finish() {
+	if (path_query_group_task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(path_query_group_task);
+		path_query_group_task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+	for (KeyValue<int64_t, PathQueryBatch *> &E : path_query_batches) {
+		memdelete(E.value);
+	}
+	path_query_batches.clear();
+	path_query_tasks.clear();
+
 	flush_queries();
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
@@ -1385,34 +1456,51 @@ void GodotNavigationServer3D::finish() {
 }
 
 PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &p_parameters) const {
-	PathQueryResult r_query_result;
-
 	const NavMap *map = map_owner.get_or_null(p_parameters.map);
-	ERR_FAIL_NULL_V(map, r_query_result);
+	ERR_FAIL_NULL_V(map, PathQueryResult());
+
+	return _query_map_path(map, p_parameters);
+}
+
+PathQueryResult GodotNavigationServer3D::_query_map_path(const NavMap *p_map, const PathQueryParameters &p_parameters) const {
+	const uint64_t query_begin_usec = OS::get_singleton()->get_ticks_usec();
+	PathQueryResult r_query_result;
 
 	// run the pathfinding
 
 	if (p_parameters.pathfinding_algorithm == PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR) {
 		// while postprocessing is still part of map.get_path() need to check and route it here for the correct "optimize" post-processing
 		if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_CORRIDORFUNNEL) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					true,
 					p_parameters.navigation_layers,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
-					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
+					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+				&r_query_result.explored_polygon_count);
 		} else if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_EDGECENTERED) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					false,
 					p_parameters.navigation_layers,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
-					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
+					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+				&r_query_result.explored_polygon_count);
 		}
+	} else if (p_parameters.pathfinding_algorithm == PathfindingAlgorithm::PATHFINDING_ALGORITHM_FLOW_FIELD) {
+		r_query_result.path = p_map->get_flow_field_path(
+				p_parameters.start_position,
+				p_parameters.target_position,
+				p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_CORRIDORFUNNEL,
+				p_parameters.navigation_layers,
+				p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
+				p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
+				p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+				&r_query_result.explored_polygon_count);
 	} else {
 		return r_query_result;
 	}
@@ -1463,9 +1551,111 @@ PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &
 
 	// add path stats
 
+	for (int i = 1; i < r_query_result.path.size(); i++) {
+		r_query_result.path_length += r_query_result.path[i - 1].distance_to(r_query_result.path[i]);
+	}
+	r_query_result.query_time_usec = OS::get_singleton()->get_ticks_usec() - query_begin_usec;
+
 	return r_query_result;
 }
 
+int64_t GodotNavigationServer3D::_query_paths_async(const LocalVector<PathQueryParameters> &p_parameters, const Callable &p_callback) {
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	batch->parameters = p_parameters;
+	batch->results.resize(p_parameters.size());
+	batch->callback = p_callback;
+
+	MutexLock lock(path_queries_mutex);
+	const int64_t batch_id = ++path_query_last_batch_id;
+	path_query_batches.insert(batch_id, batch);
+	return batch_id;
+}
+
+bool GodotNavigationServer3D::is_path_query_batch_completed(int64_t p_batch_id) const {
+	MutexLock lock(path_queries_mutex);
+	return p_batch_id > 0 && p_batch_id <= path_query_last_batch_id && !path_query_batches.has(p_batch_id);
+}
+
+bool GodotNavigationServer3D::_path_query_batch_get_results(int64_t p_batch_id, LocalVector<PathQueryResult> &r_results) {
+	MutexLock lock(path_queries_mutex);
+	PathQueryBatch **batch = path_query_finished_batches.getptr(p_batch_id);
+	if (batch == nullptr) {
+		return false;
+	}
+	r_results = std::move((*batch)->results);
+	return true;
+}
+
+void GodotNavigationServer3D::_process_path_query(uint32_t p_index, PathQueryTask *p_tasks) {
+	PathQueryTask &task = p_tasks[p_index];
+	task.batch->results[task.index] = _query_map_path(task.map, task.batch->parameters[task.index]);
+}
+
+void GodotNavigationServer3D::_dispatch_path_queries() {
+	DEV_ASSERT(path_query_group_task == WorkerThreadPool::INVALID_TASK_ID);
+
+	MutexLock lock(path_queries_mutex);
+	path_query_tasks.clear();
+
+	const uint32_t budget = max_async_path_queries_per_frame > 0 ? max_async_path_queries_per_frame : UINT32_MAX;
+	for (KeyValue<int64_t, PathQueryBatch *> &E : path_query_batches) {
+		PathQueryBatch *batch = E.value;
+		while (batch->dispatched_count < batch->parameters.size() && path_query_tasks.size() < budget) {
+			const uint32_t index = batch->dispatched_count++;
+			const NavMap *map = map_owner.get_or_null(batch->parameters[index].map);
+			if (map == nullptr) {
+				ERR_PRINT("Async path query uses an invalid navigation map.");
+				continue;
+			}
+			path_query_tasks.push_back({ batch, map, index });
+		}
+		if (path_query_tasks.size() >= budget) {
+			break;
+		}
+	}
+
+	if (path_query_tasks.is_empty()) {
+		return;
+	}
+	path_query_group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer3D::_process_path_query, path_query_tasks.ptr(), path_query_tasks.size(), -1, true, SNAME("NavigationServerPathQueries"));
+}
+
+void GodotNavigationServer3D::_finish_path_queries() {
+	if (path_query_group_task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(path_query_group_task);
+		path_query_group_task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+
+	LocalVector<int64_t> finished_batch_ids;
+	{
+		MutexLock lock(path_queries_mutex);
+		path_query_tasks.clear();
+		for (const KeyValue<int64_t, PathQueryBatch *> &E : path_query_batches) {
+			if (E.value->dispatched_count == E.value->parameters.size()) {
+				finished_batch_ids.push_back(E.key);
+			}
+		}
+		for (const int64_t batch_id : finished_batch_ids) {
+			path_query_finished_batches.insert(batch_id, path_query_batches[batch_id]);
+			path_query_batches.erase(batch_id);
+		}
+	}
+
+	// Callbacks may queue new batches, so they run without holding the lock.
+	for (const int64_t batch_id : finished_batch_ids) {
+		const Callable &callback = path_query_finished_batches[batch_id]->callback;
+		if (callback.is_valid()) {
+			callback.call(batch_id);
+		}
+	}
+
+	MutexLock lock(path_queries_mutex);
+	for (const int64_t batch_id : finished_batch_ids) {
+		memdelete(path_query_finished_batches[batch_id]);
+		path_query_finished_batches.erase(batch_id);
+	}
+}
+
 RID GodotNavigationServer3D::source_geometry_parser_create() {
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
@@ -1602,6 +1792,12 @@ int GodotNavigationServer3D::get_process_info(ProcessInfo p_info) const {
 		case INFO_OBSTACLE_COUNT: {
 			return pm_obstacle_count;
 		} break;
+		case INFO_MAP_SYNC_TIME: {
+			return pm_map_sync_time;
+		} break;
+		case INFO_AVOIDANCE_TIME: {
+			return pm_avoidance_time;
+		} break;
 	}
 
 	return 0;
@@ -37,6 +37,8 @@
 #include "../nav_obstacle.h"
 #include "../nav_region.h"
 
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
@@ -86,6 +88,28 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	NavMeshGenerator3D *navmesh_generator_3d = nullptr;
 #endif // _3D_DISABLED
 
+	struct PathQueryBatch {
+		LocalVector<NavigationUtilities::PathQueryParameters> parameters;
+		LocalVector<NavigationUtilities::PathQueryResult> results;
+		uint32_t dispatched_count = 0;
+		Callable callback;
+	};
+
+	struct PathQueryTask {
+		PathQueryBatch *batch = nullptr;
+		const NavMap *map = nullptr;
+		uint32_t index = 0;
+	};
+
+	/// Async path queries run between two `process` calls, while no map is synced or freed.
+	Mutex path_queries_mutex;
+	int64_t path_query_last_batch_id = 0;
+	HashMap<int64_t, PathQueryBatch *> path_query_batches;
+	HashMap<int64_t, PathQueryBatch *> path_query_finished_batches;
+	LocalVector<PathQueryTask> path_query_tasks;
+	WorkerThreadPool::GroupID path_query_group_task = WorkerThreadPool::INVALID_TASK_ID;
+	uint32_t max_async_path_queries_per_frame = 256;
+
 	// Performance Monitor
 	int pm_region_count = 0;
 	int pm_agent_count = 0;
@@ -96,6 +120,8 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
+	int pm_map_sync_time = 0;
+	int pm_avoidance_time = 0;
 
 public:
 	GodotNavigationServer3D();
@@ -124,6 +150,12 @@ public:
 	COMMAND_2(map_set_use_edge_connections, RID, p_map, bool, p_enabled);
 	virtual bool map_get_use_edge_connections(RID p_map) const override;
 
+	COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+
+	COMMAND_2(map_set_use_async_iterations, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_async_iterations(RID p_map) const override;
+
 	COMMAND_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin);
 	virtual real_t map_get_edge_connection_margin(RID p_map) const override;
 
@@ -265,6 +297,7 @@ public:
 
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
+	virtual void bake_tiles_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Ref<NavigationMeshTiles3D> &p_navigation_mesh_tiles, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
 	virtual bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const override;
 
@@ -289,10 +322,18 @@ public:
 	virtual void finish() override;
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
+	virtual bool is_path_query_batch_completed(int64_t p_batch_id) const override;
+	virtual int64_t _query_paths_async(const LocalVector<NavigationUtilities::PathQueryParameters> &p_parameters, const Callable &p_callback) override;
+	virtual bool _path_query_batch_get_results(int64_t p_batch_id, LocalVector<NavigationUtilities::PathQueryResult> &r_results) override;
 
 	int get_process_info(ProcessInfo p_info) const override;
 
 private:
+	NavigationUtilities::PathQueryResult _query_map_path(const NavMap *p_map, const NavigationUtilities::PathQueryParameters &p_parameters) const;
+	void _process_path_query(uint32_t p_index, PathQueryTask *p_tasks);
+	void _dispatch_path_queries();
+	void _finish_path_queries();
+
 	void internal_free_agent(RID p_object);
 	void internal_free_obstacle(RID p_object);
 };
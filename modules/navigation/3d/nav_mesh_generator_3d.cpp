@@ -46,6 +46,7 @@
 #include "scene/resources/3d/cylinder_shape_3d.h"
 #include "scene/resources/3d/height_map_shape_3d.h"
 #include "scene/resources/3d/navigation_mesh_source_geometry_data_3d.h"
+#include "scene/resources/3d/navigation_mesh_tiles_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
 #include "scene/resources/3d/shape_3d.h"
 #include "scene/resources/3d/sphere_shape_3d.h"
@@ -199,6 +200,29 @@ void NavMeshGenerator3D::bake_from_source_geometry_data(Ref<NavigationMesh> p_na
 	}
 }
 
+void NavMeshGenerator3D::bake_tiles_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Ref<NavigationMeshTiles3D> p_navigation_mesh_tiles, const Callable &p_callback) {
+	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
+	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
+	ERR_FAIL_COND(!p_navigation_mesh_tiles.is_valid());
+
+	if (is_baking(p_navigation_mesh)) {
+		ERR_FAIL_MSG("NavigationMesh is already baking. Wait for current bake to finish.");
+	}
+	baking_navmesh_mutex.lock();
+	baking_navmeshes.insert(p_navigation_mesh);
+	baking_navmesh_mutex.unlock();
+
+	generator_bake_tiles_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, p_navigation_mesh_tiles);
+
+	baking_navmesh_mutex.lock();
+	baking_navmeshes.erase(p_navigation_mesh);
+	baking_navmesh_mutex.unlock();
+
+	if (p_callback.is_valid()) {
+		generator_emit_callback(p_callback);
+	}
+}
+
 void NavMeshGenerator3D::bake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback) {
 	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
 	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
@@ -662,63 +686,20 @@ void NavMeshGenerator3D::generator_parse_source_geometry_data(const Ref<Navigati
 	}
 };
 
-void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data) {
-	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
-		return;
-	}
-
-	Vector<float> source_geometry_vertices;
-	Vector<int> source_geometry_indices;
-	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
-
-	p_source_geometry_data->get_data(
-			source_geometry_vertices,
-			source_geometry_indices,
-			projected_obstructions);
-
-	if (source_geometry_vertices.size() < 3 || source_geometry_indices.size() < 3) {
-		return;
-	}
-
-	rcHeightfield *hf = nullptr;
-	rcCompactHeightfield *chf = nullptr;
-	rcContourSet *cset = nullptr;
-	rcPolyMesh *poly_mesh = nullptr;
-	rcPolyMeshDetail *detail_mesh = nullptr;
-	rcContext ctx;
-
-	// added to keep track of steps, no functionality right now
-	String bake_state = "";
-
-	bake_state = "Setting up Configuration..."; // step #1
-
-	const float *verts = source_geometry_vertices.ptr();
-	const int nverts = source_geometry_vertices.size() / 3;
-	const int *tris = source_geometry_indices.ptr();
-	const int ntris = source_geometry_indices.size() / 3;
-
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
-
+// Prints the bake settings that lose precision when converted to the Recast voxel units.
+static void _generator_check_bake_settings(const Ref<NavigationMesh> &p_navigation_mesh) {
 	rcConfig cfg;
 	memset(&cfg, 0, sizeof(cfg));
 
 	cfg.cs = p_navigation_mesh->get_cell_size();
 	cfg.ch = p_navigation_mesh->get_cell_height();
-	if (p_navigation_mesh->get_border_size() > 0.0) {
-		cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / cfg.cs);
-	}
-	cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
 	cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / cfg.ch);
 	cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / cfg.ch);
 	cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cfg.cs);
 	cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
 	cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
 	cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
 	cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
-	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
-	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
 
 	if (p_navigation_mesh->get_border_size() > 0.0 && Math::fmod(p_navigation_mesh->get_border_size(), p_navigation_mesh->get_cell_size()) != 0.0) {
 		WARN_PRINT("Property border_size is ceiled to cell_size voxel units and loses precision.");
@@ -747,23 +728,66 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
 		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
 	}
+}
+
+// Bakes the walkable polygons of the source triangles. When tile bounds are given, only the polygons inside them are
+// kept, and the source triangles around them are used as a border so the edges of neighboring tiles line up.
+static void _generator_bake_polygons(const Ref<NavigationMesh> &p_navigation_mesh, const float *verts, int nverts, const int *tris, int ntris, const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &projected_obstructions, const AABB *p_tile_bounds, Vector<Vector3> &r_vertices, Vector<Vector<int>> &r_polygons) {
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
+	rcContext ctx;
+
+	// added to keep track of steps, no functionality right now
+	String bake_state = "";
+
+	bake_state = "Setting up Configuration..."; // step #1
+
+	rcConfig cfg;
+	memset(&cfg, 0, sizeof(cfg));
 
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
+	cfg.cs = p_navigation_mesh->get_cell_size();
+	cfg.ch = p_navigation_mesh->get_cell_height();
+	if (p_navigation_mesh->get_border_size() > 0.0) {
+		cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / cfg.cs);
+	}
+	cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
+	cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / cfg.ch);
+	cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / cfg.ch);
+	cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cfg.cs);
+	cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
+	cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
+	cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
+	cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
+	cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
+	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
+	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
 
-	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
-	if (baking_aabb.has_volume()) {
-		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
-		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
-		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
-		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
-		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
-		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
-		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+	if (p_tile_bounds) {
+		// The border has to cover the agent radius, or the erosion would differ on both sides of the tile edges.
+		cfg.borderSize = cfg.walkableRadius + 3;
+		const float border = cfg.borderSize * cfg.cs;
+		cfg.bmin[0] = p_tile_bounds->position.x - border;
+		cfg.bmin[1] = p_tile_bounds->position.y;
+		cfg.bmin[2] = p_tile_bounds->position.z - border;
+		cfg.bmax[0] = p_tile_bounds->position.x + p_tile_bounds->size.x + border;
+		cfg.bmax[1] = p_tile_bounds->position.y + p_tile_bounds->size.y;
+		cfg.bmax[2] = p_tile_bounds->position.z + p_tile_bounds->size.z + border;
+	} else {
+		rcCalcBounds(verts, nverts, cfg.bmin, cfg.bmax);
+
+		AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+		if (baking_aabb.has_volume()) {
+			Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
+			cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
+			cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
+			cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
+			cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
+			cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
+			cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+		}
 	}
 
 	bake_state = "Calculating grid size..."; // step #2
@@ -892,9 +916,6 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	bake_state = "Converting to native navigation mesh..."; // step #10
 
-	Vector<Vector3> nav_vertices;
-	Vector<Vector<int>> nav_polygons;
-
 	HashMap<Vector3, int> recast_vertex_to_native_index;
 	LocalVector<int> recast_index_to_native_index;
 	recast_index_to_native_index.resize(detail_mesh->nverts);
@@ -907,7 +928,7 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 			int new_index = recast_vertex_to_native_index.size();
 			recast_index_to_native_index[i] = new_index;
 			recast_vertex_to_native_index[vertex] = new_index;
-			nav_vertices.push_back(vertex);
+			r_vertices.push_back(vertex);
 		} else {
 			recast_index_to_native_index[i] = *existing_index_ptr;
 		}
@@ -931,12 +952,10 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 			nav_indices.write[1] = recast_index_to_native_index[index2];
 			nav_indices.write[2] = recast_index_to_native_index[index3];
 
-			nav_polygons.push_back(nav_indices);
+			r_polygons.push_back(nav_indices);
 		}
 	}
 
-	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
-
 	bake_state = "Cleanup..."; // step #11
 
 	rcFreePolyMesh(poly_mesh);
@@ -947,6 +966,272 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	bake_state = "Baking finished."; // step #12
 }
 
+void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data) {
+	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
+		return;
+	}
+
+	Vector<float> source_geometry_vertices;
+	Vector<int> source_geometry_indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+
+	p_source_geometry_data->get_data(
+			source_geometry_vertices,
+			source_geometry_indices,
+			projected_obstructions);
+
+	if (source_geometry_vertices.size() < 3 || source_geometry_indices.size() < 3) {
+		return;
+	}
+
+	_generator_check_bake_settings(p_navigation_mesh);
+
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	_generator_bake_polygons(p_navigation_mesh, source_geometry_vertices.ptr(), source_geometry_vertices.size() / 3, source_geometry_indices.ptr(), source_geometry_indices.size() / 3, projected_obstructions, nullptr, nav_vertices, nav_polygons);
+
+	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
+}
+
+struct NavMeshTileBake3D {
+	Vector2i tile;
+	AABB bounds;
+	LocalVector<int> indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+	uint32_t source_hash = 0;
+	Ref<NavigationMesh> navigation_mesh;
+};
+
+struct NavMeshTilesBake3D {
+	const float *vertices = nullptr;
+	int vertex_count = 0;
+	LocalVector<NavMeshTileBake3D *> tiles;
+};
+
+static void _generator_bake_tile(void *p_userdata, uint32_t p_index) {
+	NavMeshTilesBake3D *tiles_bake = static_cast<NavMeshTilesBake3D *>(p_userdata);
+	NavMeshTileBake3D *tile_bake = tiles_bake->tiles[p_index];
+
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	_generator_bake_polygons(tile_bake->navigation_mesh, tiles_bake->vertices, tiles_bake->vertex_count, tile_bake->indices.ptr(), tile_bake->indices.size() / 3, tile_bake->projected_obstructions, &tile_bake->bounds, nav_vertices, nav_polygons);
+
+	tile_bake->navigation_mesh->set_data(nav_vertices, nav_polygons);
+}
+
+static uint32_t _generator_hash_bake_settings(const Ref<NavigationMesh> &p_navigation_mesh) {
+	uint32_t h = hash_murmur3_one_real(p_navigation_mesh->get_cell_size());
+	h = hash_murmur3_one_real(p_navigation_mesh->get_cell_height(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_agent_height(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_agent_radius(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_agent_max_climb(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_agent_max_slope(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_region_min_size(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_region_merge_size(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_edge_max_length(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_edge_max_error(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_vertices_per_polygon(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_detail_sample_distance(), h);
+	h = hash_murmur3_one_real(p_navigation_mesh->get_detail_sample_max_error(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_sample_partition_type(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_filter_low_hanging_obstacles(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_filter_ledge_spans(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_filter_walkable_low_height_spans(), h);
+	return h;
+}
+
+void NavMeshGenerator3D::generator_bake_tiles_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Ref<NavigationMeshTiles3D> p_navigation_mesh_tiles) {
+	const HashMap<Vector2i, NavigationMeshTiles3D::Tile> &previous_tiles = p_navigation_mesh_tiles->_get_tiles();
+
+	Vector<float> source_geometry_vertices;
+	Vector<int> source_geometry_indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+
+	p_source_geometry_data->get_data(
+			source_geometry_vertices,
+			source_geometry_indices,
+			projected_obstructions);
+
+	const real_t tile_size = p_navigation_mesh_tiles->get_tile_size();
+	const float *verts = source_geometry_vertices.ptr();
+	const int nverts = source_geometry_vertices.size() / 3;
+	const int *tris = source_geometry_indices.ptr();
+	const int ntris = source_geometry_indices.size() / 3;
+
+	HashMap<Vector2i, NavMeshTileBake3D> tile_bakes;
+
+	if (nverts >= 3 && ntris >= 1) {
+		_generator_check_bake_settings(p_navigation_mesh);
+		if (Math::fmod(tile_size, p_navigation_mesh->get_cell_size()) != 0.0) {
+			WARN_PRINT("Property tile_size is not a multiple of cell_size, the edges of neighboring tiles may not line up.");
+		}
+
+		// Must match the border used by the tile bakes, every tile needs the source geometry that overlaps its border.
+		const real_t border = ((int)Math::ceil(p_navigation_mesh->get_agent_radius() / p_navigation_mesh->get_cell_size()) + 3) * p_navigation_mesh->get_cell_size();
+
+		float bmin[3], bmax[3];
+		rcCalcBounds(verts, nverts, bmin, bmax);
+		AABB geometry_bounds(Vector3(bmin[0], bmin[1], bmin[2]), Vector3(bmax[0] - bmin[0], bmax[1] - bmin[1], bmax[2] - bmin[2]));
+
+		AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+		const bool use_baking_aabb = baking_aabb.has_volume();
+		if (use_baking_aabb) {
+			baking_aabb.position += p_navigation_mesh->get_filter_baking_aabb_offset();
+			geometry_bounds.position.y = baking_aabb.position.y;
+			geometry_bounds.size.y = baking_aabb.size.y;
+		}
+
+		// A tile exists when a triangle overlaps it, the triangles around it only contribute to its border.
+		for (int i = 0; i < ntris; i++) {
+			const float *v0 = &verts[tris[i * 3 + 0] * 3];
+			const float *v1 = &verts[tris[i * 3 + 1] * 3];
+			const float *v2 = &verts[tris[i * 3 + 2] * 3];
+			const real_t min_x = MIN(v0[0], MIN(v1[0], v2[0]));
+			const real_t max_x = MAX(v0[0], MAX(v1[0], v2[0]));
+			const real_t min_z = MIN(v0[2], MIN(v1[2], v2[2]));
+			const real_t max_z = MAX(v0[2], MAX(v1[2], v2[2]));
+
+			const int from_x = (int)Math::floor(min_x / tile_size);
+			const int from_z = (int)Math::floor(min_z / tile_size);
+			const int to_x = MAX(from_x, (int)Math::ceil(max_x / tile_size) - 1);
+			const int to_z = MAX(from_z, (int)Math::ceil(max_z / tile_size) - 1);
+
+			for (int z = from_z; z <= to_z; z++) {
+				for (int x = from_x; x <= to_x; x++) {
+					const Vector2i tile(x, z);
+					if (tile_bakes.has(tile)) {
+						continue;
+					}
+					AABB bounds = p_navigation_mesh_tiles->get_tile_bounds(tile);
+					bounds.position.y = geometry_bounds.position.y;
+					bounds.size.y = geometry_bounds.size.y;
+					if (use_baking_aabb) {
+						if (!bounds.intersects(baking_aabb)) {
+							continue;
+						}
+						bounds = bounds.intersection(baking_aabb);
+					}
+					NavMeshTileBake3D &tile_bake = tile_bakes[tile];
+					tile_bake.tile = tile;
+					tile_bake.bounds = bounds;
+				}
+			}
+		}
+
+		for (int i = 0; i < ntris; i++) {
+			const float *v0 = &verts[tris[i * 3 + 0] * 3];
+			const float *v1 = &verts[tris[i * 3 + 1] * 3];
+			const float *v2 = &verts[tris[i * 3 + 2] * 3];
+			const int from_x = (int)Math::floor((MIN(v0[0], MIN(v1[0], v2[0])) - border) / tile_size);
+			const int to_x = (int)Math::floor((MAX(v0[0], MAX(v1[0], v2[0])) + border) / tile_size);
+			const int from_z = (int)Math::floor((MIN(v0[2], MIN(v1[2], v2[2])) - border) / tile_size);
+			const int to_z = (int)Math::floor((MAX(v0[2], MAX(v1[2], v2[2])) + border) / tile_size);
+
+			for (int z = from_z; z <= to_z; z++) {
+				for (int x = from_x; x <= to_x; x++) {
+					NavMeshTileBake3D *tile_bake = tile_bakes.getptr(Vector2i(x, z));
+					if (tile_bake) {
+						tile_bake->indices.push_back(tris[i * 3 + 0]);
+						tile_bake->indices.push_back(tris[i * 3 + 1]);
+						tile_bake->indices.push_back(tris[i * 3 + 2]);
+					}
+				}
+			}
+		}
+
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
+			if (projected_obstruction.vertices.size() < 6) {
+				continue;
+			}
+			real_t min_x = projected_obstruction.vertices[0];
+			real_t max_x = min_x;
+			real_t min_z = projected_obstruction.vertices[2];
+			real_t max_z = min_z;
+			for (int i = 3; i + 2 < projected_obstruction.vertices.size(); i += 3) {
+				min_x = MIN(min_x, projected_obstruction.vertices[i]);
+				max_x = MAX(max_x, projected_obstruction.vertices[i]);
+				min_z = MIN(min_z, projected_obstruction.vertices[i + 2]);
+				max_z = MAX(max_z, projected_obstruction.vertices[i + 2]);
+			}
+
+			const int from_x = (int)Math::floor((min_x - border) / tile_size);
+			const int to_x = (int)Math::floor((max_x + border) / tile_size);
+			const int from_z = (int)Math::floor((min_z - border) / tile_size);
+			const int to_z = (int)Math::floor((max_z + border) / tile_size);
+
+			for (int z = from_z; z <= to_z; z++) {
+				for (int x = from_x; x <= to_x; x++) {
+					NavMeshTileBake3D *tile_bake = tile_bakes.getptr(Vector2i(x, z));
+					if (tile_bake) {
+						tile_bake->projected_obstructions.push_back(projected_obstruction);
+					}
+				}
+			}
+		}
+	}
+
+	HashMap<Vector2i, NavigationMeshTiles3D::Tile> tiles;
+	Vector<Vector2i> changed_tiles;
+	NavMeshTilesBake3D tiles_bake;
+	tiles_bake.vertices = verts;
+	tiles_bake.vertex_count = nverts;
+
+	const uint32_t settings_hash = _generator_hash_bake_settings(p_navigation_mesh);
+
+	for (KeyValue<Vector2i, NavMeshTileBake3D> &E : tile_bakes) {
+		NavMeshTileBake3D &tile_bake = E.value;
+
+		uint32_t h = hash_murmur3_one_32(HashMapHasherDefault::hash(tile_bake.bounds), settings_hash);
+		for (const int index : tile_bake.indices) {
+			h = hash_murmur3_buffer(&verts[index * 3], sizeof(float) * 3, h);
+		}
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : tile_bake.projected_obstructions) {
+			h = hash_murmur3_buffer(projected_obstruction.vertices.ptr(), sizeof(float) * projected_obstruction.vertices.size(), h);
+			h = hash_murmur3_one_float(projected_obstruction.elevation, h);
+			h = hash_murmur3_one_float(projected_obstruction.height, h);
+			h = hash_murmur3_one_32(projected_obstruction.carve, h);
+		}
+		tile_bake.source_hash = hash_fmix32(h);
+
+		const NavigationMeshTiles3D::Tile *previous_tile = previous_tiles.getptr(E.key);
+		if (previous_tile && previous_tile->source_hash == tile_bake.source_hash) {
+			tiles.insert(E.key, *previous_tile);
+			continue;
+		}
+
+		// Resources can't be created safely on the worker threads, so the tile meshes are prepared here.
+		tile_bake.navigation_mesh = p_navigation_mesh->duplicate();
+		tile_bake.navigation_mesh->clear();
+		tiles_bake.tiles.push_back(&tile_bake);
+		changed_tiles.push_back(E.key);
+	}
+
+	for (const KeyValue<Vector2i, NavigationMeshTiles3D::Tile> &E : previous_tiles) {
+		if (!tile_bakes.has(E.key)) {
+			changed_tiles.push_back(E.key);
+		}
+	}
+
+	if (baking_use_multiple_threads && tiles_bake.tiles.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_generator_bake_tile, &tiles_bake, tiles_bake.tiles.size(), -1, baking_use_high_priority_threads, SNAME("NavMeshGeneratorBakeTiles3D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < tiles_bake.tiles.size(); i++) {
+			_generator_bake_tile(&tiles_bake, i);
+		}
+	}
+
+	for (const NavMeshTileBake3D *tile_bake : tiles_bake.tiles) {
+		NavigationMeshTiles3D::Tile tile;
+		tile.navigation_mesh = tile_bake->navigation_mesh;
+		tile.source_hash = tile_bake->source_hash;
+		tiles.insert(tile_bake->tile, tile);
+	}
+
+	changed_tiles.sort();
+	p_navigation_mesh_tiles->_set_tiles(tiles, changed_tiles);
+}
+
 bool NavMeshGenerator3D::generator_emit_callback(const Callable &p_callback) {
 	ERR_FAIL_COND_V(!p_callback.is_valid(), false);
 
@@ -127,7 +127,189 @@ Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygo
 	}
 }
 
-Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size) {
+// Returns the polygon closest to `p_point` among the ones in compatible layers.
+// Ties go to the polygon with the lowest index, as they would with a linear scan.
+static const gd::Polygon *_polygons_get_closest_polygon(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point, uint32_t p_navigation_layers, Vector3 &r_closest_point) {
+	const gd::Polygon *closest_polygon = nullptr;
+	uint32_t closest_polygon_index = UINT32_MAX;
+	real_t closest_distance = FLT_MAX;
+
+	auto polygon_callback = [&](uint32_t p_polygon_index) -> real_t {
+		const gd::Polygon &p = p_polygons[p_polygon_index];
+		// Only consider the polygon if it in a region with compatible layers.
+		if ((p_navigation_layers & p.owner->get_navigation_layers()) != 0) {
+			// For each face check the distance to the point.
+			for (uint32_t point_id = 2; point_id < p.points.size(); point_id++) {
+				const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				const Vector3 point = face.get_closest_point_to(p_point);
+				const real_t distance_to_point = point.distance_to(p_point);
+				if (distance_to_point < closest_distance || (distance_to_point == closest_distance && p_polygon_index < closest_polygon_index)) {
+					closest_distance = distance_to_point;
+					closest_polygon = &p;
+					closest_polygon_index = p_polygon_index;
+					r_closest_point = point;
+				}
+			}
+		}
+		return closest_polygon ? closest_distance * closest_distance : FLT_MAX;
+	};
+	p_polygons_index.query_nearest(AABB(p_point, Vector3()), FLT_MAX, polygon_callback);
+
+	return closest_polygon;
+}
+
+// Builds the path from the begin polygon to `p_end_id` by following the back navigation polygons.
+static Vector<Vector3> _navigation_polys_get_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, bool p_optimize, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up) {
+	Vector<Vector3> path;
+	// Optimize the path.
+	if (p_optimize) {
+		// Set the apex poly/point to the end point
+		const gd::NavigationPoly *apex_poly = &p_navigation_polys[p_end_id];
+
+		Vector3 back_pathway[2] = { apex_poly->back_navigation_edge_pathway_start, apex_poly->back_navigation_edge_pathway_end };
+		const Vector3 back_edge_closest_point = Geometry3D::get_closest_point_to_segment(p_end_point, back_pathway);
+		if (p_end_point.is_equal_approx(back_edge_closest_point)) {
+			// The end point is basically on top of the last crossed edge, funneling around the corners would at best do nothing.
+			// At worst it would add an unwanted path point before the last point due to precision issues so skip to the next polygon.
+			if (apex_poly->back_navigation_poly_id != -1) {
+				apex_poly = &p_navigation_polys[apex_poly->back_navigation_poly_id];
+			}
+		}
+
+		Vector3 apex_point = p_end_point;
+
+		const gd::NavigationPoly *left_poly = apex_poly;
+		Vector3 left_portal = apex_point;
+		const gd::NavigationPoly *right_poly = apex_poly;
+		Vector3 right_portal = apex_point;
+
+		const gd::NavigationPoly *p = apex_poly;
+
+		path.push_back(p_end_point);
+		APPEND_METADATA(p_end_poly);
+
+		while (p) {
+			// Set left and right points of the pathway between polygons.
+			Vector3 left = p->back_navigation_edge_pathway_start;
+			Vector3 right = p->back_navigation_edge_pathway_end;
+			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left, right).dot(p_map_up) < 0) {
+				SWAP(left, right);
+			}
+
+			bool skip = false;
+			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left_portal, left).dot(p_map_up) >= 0) {
+				//process
+				if (left_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, left, right_portal).dot(p_map_up) > 0) {
+					left_poly = p;
+					left_portal = left;
+				} else {
+					NavMeshQueries3D::clip_path(p_navigation_polys, path, apex_poly, right_portal, right_poly, r_path_types, r_path_rids, r_path_owners, p_map_up);
+
+					apex_point = right_portal;
+					p = right_poly;
+					left_poly = p;
+					apex_poly = p;
+					left_portal = apex_point;
+					right_portal = apex_point;
+
+					path.push_back(apex_point);
+					APPEND_METADATA(apex_poly->poly);
+					skip = true;
+				}
+			}
+
+			if (!skip && THREE_POINTS_CROSS_PRODUCT(apex_point, right_portal, right).dot(p_map_up) <= 0) {
+				//process
+				if (right_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, right, left_portal).dot(p_map_up) < 0) {
+					right_poly = p;
+					right_portal = right;
+				} else {
+					NavMeshQueries3D::clip_path(p_navigation_polys, path, apex_poly, left_portal, left_poly, r_path_types, r_path_rids, r_path_owners, p_map_up);
+
+					apex_point = left_portal;
+					p = left_poly;
+					right_poly = p;
+					apex_poly = p;
+					right_portal = apex_point;
+					left_portal = apex_point;
+
+					path.push_back(apex_point);
+					APPEND_METADATA(apex_poly->poly);
+				}
+			}
+
+			// Go to the previous polygon.
+			if (p->back_navigation_poly_id != -1) {
+				p = &p_navigation_polys[p->back_navigation_poly_id];
+			} else {
+				// The end
+				p = nullptr;
+			}
+		}
+
+		// If the last point is not the begin point, add it to the list.
+		if (path[path.size() - 1] != p_begin_point) {
+			path.push_back(p_begin_point);
+			APPEND_METADATA(p_begin_poly);
+		}
+
+		path.reverse();
+		if (r_path_types) {
+			r_path_types->reverse();
+		}
+		if (r_path_rids) {
+			r_path_rids->reverse();
+		}
+		if (r_path_owners) {
+			r_path_owners->reverse();
+		}
+
+	} else {
+		path.push_back(p_end_point);
+		APPEND_METADATA(p_end_poly);
+
+		// Add mid points
+		int np_id = p_end_id;
+		while (np_id != -1 && p_navigation_polys[np_id].back_navigation_poly_id != -1) {
+			if (p_navigation_polys[np_id].back_navigation_edge != -1) {
+				int prev = p_navigation_polys[np_id].back_navigation_edge;
+				int prev_n = (p_navigation_polys[np_id].back_navigation_edge + 1) % p_navigation_polys[np_id].poly->points.size();
+				Vector3 point = (p_navigation_polys[np_id].poly->points[prev].pos + p_navigation_polys[np_id].poly->points[prev_n].pos) * 0.5;
+
+				path.push_back(point);
+				APPEND_METADATA(p_navigation_polys[np_id].poly);
+			} else {
+				path.push_back(p_navigation_polys[np_id].entry);
+				APPEND_METADATA(p_navigation_polys[np_id].poly);
+			}
+
+			np_id = p_navigation_polys[np_id].back_navigation_poly_id;
+		}
+
+		path.push_back(p_begin_point);
+		APPEND_METADATA(p_begin_poly);
+
+		path.reverse();
+		if (r_path_types) {
+			r_path_types->reverse();
+		}
+		if (r_path_rids) {
+			r_path_rids->reverse();
+		}
+		if (r_path_owners) {
+			r_path_owners->reverse();
+		}
+	}
+
+	// Ensure post conditions (path arrays MUST match in size).
+	CRASH_COND(r_path_types && path.size() != r_path_types->size());
+	CRASH_COND(r_path_rids && path.size() != r_path_rids->size());
+	CRASH_COND(r_path_owners && path.size() != r_path_owners->size());
+
+	return path;
+}
+
+Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, const NavHierarchy *p_hierarchy, uint32_t *r_explored_polygon_count) {
 	// Clear metadata outputs.
 	if (r_path_types) {
 		r_path_types->clear();
@@ -138,47 +320,24 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 	if (r_path_owners) {
 		r_path_owners->clear();
 	}
+	if (r_explored_polygon_count) {
+		*r_explored_polygon_count = 0;
+	}
 
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	real_t begin_d = FLT_MAX;
+	const gd::Polygon *begin_poly = _polygons_get_closest_polygon(p_polygons, p_polygons_index, p_origin, p_navigation_layers, begin_point);
+	const gd::Polygon *end_poly = _polygons_get_closest_polygon(p_polygons, p_polygons_index, p_destination, p_navigation_layers, end_point);
 	real_t end_d = FLT_MAX;
-	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : p_polygons) {
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			real_t distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
 		return Vector<Vector3>();
 	}
+	if (r_explored_polygon_count) {
+		*r_explored_polygon_count = 1;
+	}
 	if (begin_poly == end_poly) {
 		if (r_path_types) {
 			r_path_types->resize(2);
@@ -205,6 +364,10 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		return path;
 	}
 
+	// Restrict the search to the clusters along a coarse route when the map has a hierarchy.
+	LocalVector<bool> corridor_clusters;
+	bool use_corridor = p_hierarchy && p_hierarchy->get_corridor(begin_poly, begin_point, end_poly, end_point, p_navigation_layers, corridor_clusters);
+
 	// List of all reachable navigation polys.
 	LocalVector<gd::NavigationPoly> navigation_polys;
 	navigation_polys.resize(p_polygons.size() + p_link_polygons_size);
@@ -242,6 +405,11 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 					continue;
 				}
 
+				// Stay inside the coarse route.
+				if (use_corridor && !corridor_clusters[p_hierarchy->get_polygon_cluster(connection.polygon->id)]) {
+					continue;
+				}
+
 				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				real_t poly_enter_cost = 0.0;
 				real_t poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
@@ -297,6 +465,23 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		// When the heap of traversable polygons is empty at this point it means the end polygon is
 		// unreachable.
 		if (traversable_polys.is_empty()) {
+			if (use_corridor) {
+				// The coarse route could not be followed, search the whole map instead.
+				use_corridor = false;
+				for (gd::NavigationPoly &nav_poly : navigation_polys) {
+					nav_poly.poly = nullptr;
+				}
+				navigation_polys[begin_poly->id].poly = begin_poly;
+
+				least_cost_id = begin_poly->id;
+				prev_least_cost_id = -1;
+
+				reachable_end = nullptr;
+				distance_to_reachable_end = FLT_MAX;
+
+				continue;
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -373,6 +558,9 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 
 		// Pop the polygon with the lowest travel cost from the heap of traversable polygons.
 		least_cost_id = traversable_polys.pop()->poly->id;
+		if (r_explored_polygon_count) {
+			(*r_explored_polygon_count)++;
+		}
 
 		// Store the farthest reachable end polygon in case our goal is not reachable.
 		if (is_reachable) {
@@ -430,251 +618,207 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		return path;
 	}
 
-	Vector<Vector3> path;
-	// Optimize the path.
-	if (p_optimize) {
-		// Set the apex poly/point to the end point
-		gd::NavigationPoly *apex_poly = &navigation_polys[least_cost_id];
-
-		Vector3 back_pathway[2] = { apex_poly->back_navigation_edge_pathway_start, apex_poly->back_navigation_edge_pathway_end };
-		const Vector3 back_edge_closest_point = Geometry3D::get_closest_point_to_segment(end_point, back_pathway);
-		if (end_point.is_equal_approx(back_edge_closest_point)) {
-			// The end point is basically on top of the last crossed edge, funneling around the corners would at best do nothing.
-			// At worst it would add an unwanted path point before the last point due to precision issues so skip to the next polygon.
-			if (apex_poly->back_navigation_poly_id != -1) {
-				apex_poly = &navigation_polys[apex_poly->back_navigation_poly_id];
-			}
-		}
-
-		Vector3 apex_point = end_point;
-
-		gd::NavigationPoly *left_poly = apex_poly;
-		Vector3 left_portal = apex_point;
-		gd::NavigationPoly *right_poly = apex_poly;
-		Vector3 right_portal = apex_point;
-
-		gd::NavigationPoly *p = apex_poly;
-
-		path.push_back(end_point);
-		APPEND_METADATA(end_poly);
-
-		while (p) {
-			// Set left and right points of the pathway between polygons.
-			Vector3 left = p->back_navigation_edge_pathway_start;
-			Vector3 right = p->back_navigation_edge_pathway_end;
-			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left, right).dot(p_map_up) < 0) {
-				SWAP(left, right);
-			}
-
-			bool skip = false;
-			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left_portal, left).dot(p_map_up) >= 0) {
-				//process
-				if (left_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, left, right_portal).dot(p_map_up) > 0) {
-					left_poly = p;
-					left_portal = left;
-				} else {
-					clip_path(navigation_polys, path, apex_poly, right_portal, right_poly, r_path_types, r_path_rids, r_path_owners, p_map_up);
-
-					apex_point = right_portal;
-					p = right_poly;
-					left_poly = p;
-					apex_poly = p;
-					left_portal = apex_point;
-					right_portal = apex_point;
-
-					path.push_back(apex_point);
-					APPEND_METADATA(apex_poly->poly);
-					skip = true;
-				}
-			}
-
-			if (!skip && THREE_POINTS_CROSS_PRODUCT(apex_point, right_portal, right).dot(p_map_up) <= 0) {
-				//process
-				if (right_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, right, left_portal).dot(p_map_up) < 0) {
-					right_poly = p;
-					right_portal = right;
-				} else {
-					clip_path(navigation_polys, path, apex_poly, left_portal, left_poly, r_path_types, r_path_rids, r_path_owners, p_map_up);
-
-					apex_point = left_portal;
-					p = left_poly;
-					right_poly = p;
-					apex_poly = p;
-					right_portal = apex_point;
-					left_portal = apex_point;
-
-					path.push_back(apex_point);
-					APPEND_METADATA(apex_poly->poly);
-				}
-			}
-
-			// Go to the previous polygon.
-			if (p->back_navigation_poly_id != -1) {
-				p = &navigation_polys[p->back_navigation_poly_id];
-			} else {
-				// The end
-				p = nullptr;
-			}
-		}
-
-		// If the last point is not the begin point, add it to the list.
-		if (path[path.size() - 1] != begin_point) {
-			path.push_back(begin_point);
-			APPEND_METADATA(begin_poly);
-		}
-
-		path.reverse();
-		if (r_path_types) {
-			r_path_types->reverse();
-		}
-		if (r_path_rids) {
-			r_path_rids->reverse();
-		}
-		if (r_path_owners) {
-			r_path_owners->reverse();
-		}
+	return _navigation_polys_get_path(navigation_polys, least_cost_id, begin_poly, begin_point, end_poly, end_point, p_optimize, r_path_types, r_path_rids, r_path_owners, p_map_up);
+}
 
-	} else {
-		path.push_back(end_point);
-		APPEND_METADATA(end_poly);
+const gd::Polygon *NavMeshQueries3D::polygons_get_closest_polygon(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point, uint32_t p_navigation_layers, Vector3 &r_closest_point) {
+	return _polygons_get_closest_polygon(p_polygons, p_polygons_index, p_point, p_navigation_layers, r_closest_point);
+}
 
-		// Add mid points
-		int np_id = least_cost_id;
-		while (np_id != -1 && navigation_polys[np_id].back_navigation_poly_id != -1) {
-			if (navigation_polys[np_id].back_navigation_edge != -1) {
-				int prev = navigation_polys[np_id].back_navigation_edge;
-				int prev_n = (navigation_polys[np_id].back_navigation_edge + 1) % navigation_polys[np_id].poly->points.size();
-				Vector3 point = (navigation_polys[np_id].poly->points[prev].pos + navigation_polys[np_id].poly->points[prev_n].pos) * 0.5;
+Vector<Vector3> NavMeshQueries3D::polygons_get_flow_field_path(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const NavFlowField &p_flow_field, Vector3 p_origin, const Vector3 &p_end_point, bool p_optimize, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t *r_explored_polygon_count) {
+	// Clear metadata outputs.
+	if (r_path_types) {
+		r_path_types->clear();
+	}
+	if (r_path_rids) {
+		r_path_rids->clear();
+	}
+	if (r_path_owners) {
+		r_path_owners->clear();
+	}
+	if (r_explored_polygon_count) {
+		*r_explored_polygon_count = 0;
+	}
 
-				path.push_back(point);
-				APPEND_METADATA(navigation_polys[np_id].poly);
-			} else {
-				path.push_back(navigation_polys[np_id].entry);
-				APPEND_METADATA(navigation_polys[np_id].poly);
-			}
+	Vector3 begin_point;
+	const gd::Polygon *begin_poly = _polygons_get_closest_polygon(p_polygons, p_polygons_index, p_origin, p_flow_field.get_navigation_layers(), begin_point);
+	const gd::Polygon *end_poly = p_flow_field.get_goal();
+	if (!begin_poly) {
+		return Vector<Vector3>();
+	}
 
-			np_id = navigation_polys[np_id].back_navigation_poly_id;
+	if (begin_poly == end_poly) {
+		if (r_explored_polygon_count) {
+			*r_explored_polygon_count = 1;
 		}
-
+		Vector<Vector3> path;
 		path.push_back(begin_point);
 		APPEND_METADATA(begin_poly);
+		path.push_back(p_end_point);
+		APPEND_METADATA(end_poly);
+		return path;
+	}
 
-		path.reverse();
-		if (r_path_types) {
-			r_path_types->reverse();
-		}
-		if (r_path_rids) {
-			r_path_rids->reverse();
-		}
-		if (r_path_owners) {
-			r_path_owners->reverse();
-		}
+	// The caller falls back to a regular search when the goal can't be reached from here.
+	if (p_flow_field.get_step(begin_poly->id).next_polygon == nullptr) {
+		return Vector<Vector3>();
 	}
 
-	// Ensure post conditions (path arrays MUST match in size).
-	CRASH_COND(r_path_types && path.size() != r_path_types->size());
-	CRASH_COND(r_path_rids && path.size() != r_path_rids->size());
-	CRASH_COND(r_path_owners && path.size() != r_path_owners->size());
+	// Follow the field to the goal. The corridor is stored like the one of a
+	// regular search, with each polygon pointing back at the previous one.
+	LocalVector<gd::NavigationPoly> navigation_polys;
+	gd::NavigationPoly begin_navigation_poly;
+	begin_navigation_poly.poly = begin_poly;
+	begin_navigation_poly.entry = begin_point;
+	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
+	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
+	navigation_polys.push_back(begin_navigation_poly);
+
+	const gd::Polygon *current = begin_poly;
+	while (current != end_poly) {
+		const NavFlowField::Step &step = p_flow_field.get_step(current->id);
+		ERR_FAIL_NULL_V_MSG(step.next_polygon, Vector<Vector3>(), "Flow field doesn't lead to its goal.");
+		ERR_FAIL_COND_V_MSG(navigation_polys.size() > p_flow_field.get_polygon_count(), Vector<Vector3>(), "Flow field contains a loop.");
+
+		const Vector3 pathway[2] = { step.pathway_start, step.pathway_end };
+
+		gd::NavigationPoly navigation_poly;
+		navigation_poly.poly = step.next_polygon;
+		navigation_poly.back_navigation_poly_id = navigation_polys.size() - 1;
+		navigation_poly.back_navigation_edge = step.next_edge;
+		navigation_poly.back_navigation_edge_pathway_start = step.pathway_start;
+		navigation_poly.back_navigation_edge_pathway_end = step.pathway_end;
+		navigation_poly.entry = Geometry3D::get_closest_point_to_segment(navigation_polys[navigation_polys.size() - 1].entry, pathway);
+		navigation_polys.push_back(navigation_poly);
+
+		current = step.next_polygon;
+	}
 
-	return path;
+	if (r_explored_polygon_count) {
+		*r_explored_polygon_count = navigation_polys.size();
+	}
+
+	return _navigation_polys_get_path(navigation_polys, navigation_polys.size() - 1, begin_poly, begin_point, end_poly, p_end_point, p_optimize, r_path_types, r_path_rids, r_path_owners, p_map_up);
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) {
-	bool use_collision = p_use_collision;
+Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) {
 	Vector3 closest_point;
+	uint32_t closest_polygon_index = UINT32_MAX;
 	real_t closest_point_distance = FLT_MAX;
 
-	for (const gd::Polygon &polygon : p_polygons) {
-		// For each face check the distance to the segment.
-		for (size_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
+	// Only the polygons overlapping the segment bounds can intersect it.
+	bool found_collision = false;
+	auto collision_callback = [&](uint32_t p_polygon_index) {
+		const gd::Polygon &polygon = p_polygons[p_polygon_index];
+		for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
 			const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
 			Vector3 intersection_point;
 			if (face.intersects_segment(p_from, p_to, &intersection_point)) {
 				const real_t d = p_from.distance_to(intersection_point);
-				if (!use_collision) {
-					closest_point = intersection_point;
-					use_collision = true;
-					closest_point_distance = d;
-				} else if (closest_point_distance > d) {
+				if (d < closest_point_distance || (d == closest_point_distance && p_polygon_index < closest_polygon_index)) {
 					closest_point = intersection_point;
+					closest_polygon_index = p_polygon_index;
 					closest_point_distance = d;
+					found_collision = true;
 				}
 			}
-			// If segment does not itersect face, check the distance from segment's endpoints.
-			else if (!use_collision) {
-				const Vector3 p_from_closest = face.get_closest_point_to(p_from);
-				const real_t d_p_from = p_from.distance_to(p_from_closest);
-				if (closest_point_distance > d_p_from) {
-					closest_point = p_from_closest;
-					closest_point_distance = d_p_from;
-				}
+		}
+	};
+	AABB segment_aabb(p_from, Vector3());
+	segment_aabb.expand_to(p_to);
+	p_polygons_index.query_aabb(segment_aabb, collision_callback);
 
-				const Vector3 p_to_closest = face.get_closest_point_to(p_to);
-				const real_t d_p_to = p_to.distance_to(p_to_closest);
-				if (closest_point_distance > d_p_to) {
-					closest_point = p_to_closest;
-					closest_point_distance = d_p_to;
-				}
+	if (found_collision || p_use_collision) {
+		return closest_point;
+	}
+
+	// The segment does not intersect the map, look for the closest distance between the segment and the polygons.
+	auto distance_callback = [&](uint32_t p_polygon_index) -> real_t {
+		const gd::Polygon &polygon = p_polygons[p_polygon_index];
+		// For each face check the distance from segment's endpoints.
+		for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
+			const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+
+			const Vector3 p_from_closest = face.get_closest_point_to(p_from);
+			const real_t d_p_from = p_from.distance_to(p_from_closest);
+			if (d_p_from < closest_point_distance || (d_p_from == closest_point_distance && p_polygon_index < closest_polygon_index)) {
+				closest_point = p_from_closest;
+				closest_polygon_index = p_polygon_index;
+				closest_point_distance = d_p_from;
+			}
+
+			const Vector3 p_to_closest = face.get_closest_point_to(p_to);
+			const real_t d_p_to = p_to.distance_to(p_to_closest);
+			if (d_p_to < closest_point_distance || (d_p_to == closest_point_distance && p_polygon_index < closest_polygon_index)) {
+				closest_point = p_to_closest;
+				closest_polygon_index = p_polygon_index;
+				closest_point_distance = d_p_to;
 			}
 		}
 		// Finally, check for a case when shortest distance is between some point located on a face's edge and some point located on a line segment.
-		if (!use_collision) {
-			for (size_t point_id = 0; point_id < polygon.points.size(); point_id += 1) {
-				Vector3 a, b;
-
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						polygon.points[point_id].pos,
-						polygon.points[(point_id + 1) % polygon.points.size()].pos,
-						a,
-						b);
-
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_distance) {
-					closest_point_distance = d;
-					closest_point = b;
-				}
+		for (uint32_t point_id = 0; point_id < polygon.points.size(); point_id += 1) {
+			Vector3 a, b;
+
+			Geometry3D::get_closest_points_between_segments(
+					p_from,
+					p_to,
+					polygon.points[point_id].pos,
+					polygon.points[(point_id + 1) % polygon.points.size()].pos,
+					a,
+					b);
+
+			const real_t d = a.distance_to(b);
+			if (d < closest_point_distance || (d == closest_point_distance && p_polygon_index < closest_polygon_index)) {
+				closest_point = b;
+				closest_polygon_index = p_polygon_index;
+				closest_point_distance = d;
 			}
 		}
-	}
+		return closest_polygon_index != UINT32_MAX ? closest_point_distance * closest_point_distance : FLT_MAX;
+	};
+	p_polygons_index.query_nearest(segment_aabb, FLT_MAX, distance_callback);
 
 	return closest_point;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+Vector3 NavMeshQueries3D::polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_polygons_index, p_point);
 	return cp.point;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+Vector3 NavMeshQueries3D::polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_polygons_index, p_point);
 	return cp.normal;
 }
 
-gd::ClosestPointQueryResult NavMeshQueries3D::polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
+gd::ClosestPointQueryResult NavMeshQueries3D::polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point) {
 	gd::ClosestPointQueryResult result;
+	uint32_t closest_polygon_index = UINT32_MAX;
 	real_t closest_point_distance_squared = FLT_MAX;
 
-	for (const gd::Polygon &polygon : p_polygons) {
-		for (size_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
+	auto polygon_callback = [&](uint32_t p_polygon_index) -> real_t {
+		const gd::Polygon &polygon = p_polygons[p_polygon_index];
+		for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
 			const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
 			const Vector3 closest_point_on_face = face.get_closest_point_to(p_point);
 			const real_t distance_squared_to_point = closest_point_on_face.distance_squared_to(p_point);
-			if (distance_squared_to_point < closest_point_distance_squared) {
+			if (distance_squared_to_point < closest_point_distance_squared || (distance_squared_to_point == closest_point_distance_squared && p_polygon_index < closest_polygon_index)) {
 				result.point = closest_point_on_face;
 				result.normal = face.get_plane().normal;
 				result.owner = polygon.owner->get_self();
+				closest_polygon_index = p_polygon_index;
 				closest_point_distance_squared = distance_squared_to_point;
 			}
 		}
-	}
+		return closest_point_distance_squared;
+	};
+	p_polygons_index.query_nearest(AABB(p_point, Vector3()), FLT_MAX, polygon_callback);
 
 	return result;
 }
 
-RID NavMeshQueries3D::polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+RID NavMeshQueries3D::polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_polygons_index, p_point);
 	return cp.owner;
 }
 
@@ -33,18 +33,25 @@
 
 #ifndef _3D_DISABLED
 
+#include "../nav_flow_field.h"
+#include "../nav_hierarchy.h"
 #include "../nav_map.h"
+#include "../nav_polygon_index.h"
 
 class NavMeshQueries3D {
 public:
 	static Vector3 polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly);
 
-	static Vector<Vector3> polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size);
-	static Vector3 polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision);
-	static Vector3 polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static Vector3 polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static gd::ClosestPointQueryResult polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static RID polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
+	static Vector<Vector3> polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, const NavHierarchy *p_hierarchy = nullptr, uint32_t *r_explored_polygon_count = nullptr);
+	/// Follows `p_flow_field` from `p_origin` to its goal polygon, ending at `p_end_point`. Returns an empty path when the goal can't be reached.
+	/// The polygons walked along the field are counted as explored, not the ones visited while building it.
+	static Vector<Vector3> polygons_get_flow_field_path(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const NavFlowField &p_flow_field, Vector3 p_origin, const Vector3 &p_end_point, bool p_optimize, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t *r_explored_polygon_count = nullptr);
+	static const gd::Polygon *polygons_get_closest_polygon(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point, uint32_t p_navigation_layers, Vector3 &r_closest_point);
+	static Vector3 polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision);
+	static Vector3 polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point);
+	static Vector3 polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point);
+	static gd::ClosestPointQueryResult polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point);
+	static RID polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonIndex &p_polygons_index, const Vector3 &p_point);
 
 	static void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up);
 };
@@ -0,0 +1,272 @@
+/**************************************************************************/
+/*  nav_avoidance_grid.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_AVOIDANCE_GRID_H
+#define NAV_AVOIDANCE_GRID_H
+
+#include "core/math/math_funcs.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/sort_array.h"
+
+#include <Agent2d.h>
+#include <Agent3d.h>
+
+static _FORCE_INLINE_ float _get_avoidance_agent_coordinate(const RVO2D::Agent2D *p_agent, int p_axis) {
+	return p_axis == 0 ? p_agent->position_.x() : p_agent->position_.y();
+}
+
+static _FORCE_INLINE_ float _get_avoidance_agent_coordinate(const RVO3D::Agent3D *p_agent, int p_axis) {
+	return p_agent->position_[p_axis];
+}
+
+/**
+ * Uniform grid of avoidance agents, used to find the neighbors of every agent
+ * during the avoidance step in place of the RVO2 agent k-d trees.
+ *
+ * The grid has to be rebuilt whenever agents move. Building it only computes a
+ * cell per agent, in parallel, and sorts the agents by cell with a counting
+ * sort. The agent positions are copied into flat arrays in cell order, so the
+ * agents of a whole row of cells are checked in one pass, and the agents out
+ * of range are rejected without touching the agents themselves.
+ */
+template <typename TAgent, int TDimensions>
+class NavAvoidanceGrid {
+	float cell_size = 1.0;
+	float inv_cell_size = 1.0;
+	float origin[TDimensions] = {};
+
+	/// Number of cells on each axis, unused axes have one cell.
+	int32_t cell_counts[3] = { 1, 1, 1 };
+
+	const LocalVector<TAgent *> *build_agents = nullptr;
+	LocalVector<uint32_t> agent_cells;
+
+	/// Agents and their positions, sorted by cell.
+	LocalVector<TAgent *> agents;
+	LocalVector<float> positions[TDimensions];
+
+	/// Index of the first agent of every cell, with an extra element with the agent count.
+	LocalVector<uint32_t> cell_starts;
+
+	_FORCE_INLINE_ int32_t _get_cell_coordinate(float p_coordinate, int p_axis) const {
+		return CLAMP((int32_t)((p_coordinate - origin[p_axis]) * inv_cell_size), 0, cell_counts[p_axis] - 1);
+	}
+
+	_FORCE_INLINE_ uint32_t _get_cell_index(int32_t p_x, int32_t p_y, int32_t p_z) const {
+		return p_x + cell_counts[0] * (p_y + cell_counts[1] * p_z);
+	}
+
+	void _compute_agent_cell(uint32_t p_index, void *p_userdata) {
+		const TAgent *agent = (*build_agents)[p_index];
+		int32_t cell[3] = { 0, 0, 0 };
+		for (int i = 0; i < TDimensions; i++) {
+			cell[i] = _get_cell_coordinate(_get_avoidance_agent_coordinate(agent, i), i);
+		}
+		agent_cells[p_index] = _get_cell_index(cell[0], cell[1], cell[2]);
+	}
+
+	_FORCE_INLINE_ void _insert_neighbors(TAgent *p_agent, const float *p_position, uint32_t p_from, uint32_t p_to, float &r_range_sq) const {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			float distance_sq = 0.0;
+			for (int j = 0; j < TDimensions; j++) {
+				const float d = positions[j][i] - p_position[j];
+				distance_sq += d * d;
+			}
+			if (distance_sq < r_range_sq) {
+				p_agent->insertAgentNeighbor(agents[i], r_range_sq);
+			}
+		}
+	}
+
+	_FORCE_INLINE_ void _insert_row_neighbors(TAgent *p_agent, const float *p_position, int32_t p_from_x, int32_t p_to_x, int32_t p_y, int32_t p_z, float &r_range_sq) const {
+		const uint32_t row_index = _get_cell_index(0, p_y, p_z);
+		_insert_neighbors(p_agent, p_position, cell_starts[row_index + p_from_x], cell_starts[row_index + p_to_x + 1], r_range_sq);
+	}
+
+public:
+	void build(const LocalVector<TAgent *> &p_agents, bool p_use_threads) {
+		agents.clear();
+		cell_starts.clear();
+		if (p_agents.is_empty()) {
+			return;
+		}
+
+		float neighbor_dist_sum = 0.0;
+		float bounds_max[TDimensions];
+		for (int i = 0; i < TDimensions; i++) {
+			origin[i] = bounds_max[i] = _get_avoidance_agent_coordinate(p_agents[0], i);
+		}
+		for (const TAgent *agent : p_agents) {
+			neighbor_dist_sum += agent->neighborDist_;
+			for (int i = 0; i < TDimensions; i++) {
+				const float coordinate = _get_avoidance_agent_coordinate(agent, i);
+				origin[i] = MIN(origin[i], coordinate);
+				bounds_max[i] = MAX(bounds_max[i], coordinate);
+			}
+		}
+
+		// Cells should hold about one agent each, so the first rings of cells around an agent already hold its
+		// nearest neighbors. Larger cells than the neighbor distance would only add agents out of range.
+		// Agents usually spread over a plane, even in 3D, so the density is taken from the two largest extents.
+		float extents[TDimensions];
+		for (int i = 0; i < TDimensions; i++) {
+			extents[i] = bounds_max[i] - origin[i];
+		}
+		SortArray<float> extent_sorter;
+		extent_sorter.sort(extents, TDimensions);
+		const float area = extents[TDimensions - 1] * extents[TDimensions - 2];
+		const float density_cell_size = Math::sqrt(area / p_agents.size());
+		cell_size = CLAMP(density_cell_size, 0.1f, MAX(neighbor_dist_sum / p_agents.size(), 0.1f));
+
+		// The cells are stored densely, grow them when the agents are spread too far apart to keep the grid small.
+		const uint64_t max_cell_count = MAX(p_agents.size() * 4, 1024u);
+		while (true) {
+			inv_cell_size = 1.0f / cell_size;
+			uint64_t cell_count = 1;
+			for (int i = 0; i < TDimensions; i++) {
+				cell_counts[i] = (int32_t)MIN((uint64_t)((bounds_max[i] - origin[i]) * inv_cell_size) + 1, max_cell_count);
+				cell_count *= cell_counts[i];
+			}
+			if (cell_count <= max_cell_count) {
+				break;
+			}
+			cell_size *= 2.0f;
+		}
+
+		build_agents = &p_agents;
+		agent_cells.resize(p_agents.size());
+		if (p_use_threads && p_agents.size() > 1024) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavAvoidanceGrid::_compute_agent_cell, (void *)nullptr, p_agents.size(), -1, true, SNAME("NavAvoidanceGrid"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t i = 0; i < p_agents.size(); i++) {
+				_compute_agent_cell(i, nullptr);
+			}
+		}
+		build_agents = nullptr;
+
+		// Counting sort of the agents by cell.
+		cell_starts.resize(cell_counts[0] * cell_counts[1] * cell_counts[2] + 1);
+		memset(cell_starts.ptr(), 0, cell_starts.size() * sizeof(uint32_t));
+		for (uint32_t cell : agent_cells) {
+			cell_starts[cell + 1]++;
+		}
+		for (uint32_t i = 1; i < cell_starts.size(); i++) {
+			cell_starts[i] += cell_starts[i - 1];
+		}
+
+		agents.resize(p_agents.size());
+		for (int i = 0; i < TDimensions; i++) {
+			positions[i].resize(p_agents.size());
+		}
+		for (uint32_t i = 0; i < p_agents.size(); i++) {
+			// Uses the start of the cell as insertion point, the starts are shifted back to place after the loop.
+			const uint32_t index = cell_starts[agent_cells[i]]++;
+			TAgent *agent = p_agents[i];
+			agents[index] = agent;
+			for (int j = 0; j < TDimensions; j++) {
+				positions[j][index] = _get_avoidance_agent_coordinate(agent, j);
+			}
+		}
+		for (uint32_t i = cell_starts.size() - 1; i > 0; i--) {
+			cell_starts[i] = cell_starts[i - 1];
+		}
+		cell_starts[0] = 0;
+	}
+
+	/// Adds the agents within the range to the neighbors of the agent, like the RVO2 k-d trees.
+	void compute_agent_neighbors(TAgent *p_agent, float p_range_sq) const {
+		if (agents.is_empty()) {
+			return;
+		}
+
+		float position[TDimensions];
+		int32_t center[3] = { 0, 0, 0 };
+		for (int i = 0; i < TDimensions; i++) {
+			position[i] = _get_avoidance_agent_coordinate(p_agent, i);
+			center[i] = _get_cell_coordinate(position[i], i);
+		}
+
+		float range_sq = p_range_sq;
+
+		// Checking every agent is cheaper than looking up more cells than there are agents.
+		const int32_t max_ring = (int32_t)MIN(Math::ceil(Math::sqrt(p_range_sq) * inv_cell_size), (float)(1 << 20)) + 1;
+		uint64_t search_cell_count = 1;
+		for (int i = 0; i < TDimensions; i++) {
+			search_cell_count *= MIN(2 * max_ring + 1, cell_counts[i]);
+		}
+		if (search_cell_count >= agents.size()) {
+			_insert_neighbors(p_agent, position, 0, agents.size(), range_sq);
+			return;
+		}
+
+		// Search rings of cells around the agent. Once enough neighbors are found the range shrinks, and the rings
+		// further away than the range can be skipped.
+		for (int32_t ring = 0; ring <= max_ring; ring++) {
+			if (ring > 1 && (ring - 1) * cell_size > Math::sqrt(range_sq)) {
+				break;
+			}
+
+			int32_t from[3] = { 0, 0, 0 };
+			int32_t to[3] = { 0, 0, 0 };
+			bool inside_grid = false;
+			for (int i = 0; i < TDimensions; i++) {
+				from[i] = MAX(center[i] - ring, 0);
+				to[i] = MIN(center[i] + ring, cell_counts[i] - 1);
+				inside_grid = inside_grid || center[i] - ring >= 0 || center[i] + ring < cell_counts[i];
+			}
+			if (!inside_grid) {
+				break;
+			}
+
+			// The cells of a row on the ring are contiguous, the other rows only cross the ring at both ends.
+			for (int32_t z = from[2]; z <= to[2]; z++) {
+				for (int32_t y = from[1]; y <= to[1]; y++) {
+					if (ABS(y - center[1]) == ring || ABS(z - center[2]) == ring) {
+						_insert_row_neighbors(p_agent, position, from[0], to[0], y, z, range_sq);
+					} else {
+						if (center[0] - ring >= 0) {
+							_insert_row_neighbors(p_agent, position, center[0] - ring, center[0] - ring, y, z, range_sq);
+						}
+						if (center[0] + ring < cell_counts[0]) {
+							_insert_row_neighbors(p_agent, position, center[0] + ring, center[0] + ring, y, z, range_sq);
+						}
+					}
+				}
+			}
+		}
+	}
+};
+
+typedef NavAvoidanceGrid<RVO2D::Agent2D, 2> NavAvoidanceGrid2D;
+typedef NavAvoidanceGrid<RVO3D::Agent3D, 3> NavAvoidanceGrid3D;
+
+#endif // NAV_AVOIDANCE_GRID_H
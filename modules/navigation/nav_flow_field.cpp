@@ -0,0 +1,169 @@
+/**************************************************************************/
+/*  nav_flow_field.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_flow_field.h"
+
+#include "nav_base.h"
+
+struct NavFlowFieldCostGreaterThan {
+	const NavFlowField::Step *steps = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return steps[p_a].cost > steps[p_b].cost;
+	}
+};
+
+struct NavFlowFieldHeapIndexer {
+	uint32_t *heap_indices = nullptr;
+
+	void operator()(uint32_t p_value, uint32_t p_heap_index) const {
+		heap_indices[p_value] = p_heap_index;
+	}
+};
+
+void NavFlowField::build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, uint32_t p_link_polygons_count, const gd::Polygon *p_goal, uint32_t p_navigation_layers) {
+	goal = p_goal;
+	navigation_layers = p_navigation_layers;
+
+	const uint32_t polygon_count = p_polygons.size() + p_link_polygons_count;
+	steps.clear();
+	steps.resize(polygon_count);
+
+	LocalVector<const gd::Polygon *> polygons;
+	polygons.resize(polygon_count);
+	for (const gd::Polygon &polygon : p_polygons) {
+		polygons[polygon.id] = &polygon;
+	}
+	for (uint32_t i = 0; i < p_link_polygons_count; i++) {
+		polygons[p_link_polygons[i].id] = &p_link_polygons[i];
+	}
+
+	// The search runs backwards, so it needs the connections entering each polygon.
+	struct Incoming {
+		const gd::Polygon *polygon = nullptr;
+		const gd::Edge::Connection *connection = nullptr;
+	};
+	LocalVector<uint32_t> incoming_start;
+	incoming_start.resize(polygon_count + 1);
+	memset(incoming_start.ptr(), 0, incoming_start.size() * sizeof(uint32_t));
+	for (const gd::Polygon *polygon : polygons) {
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				incoming_start[connection.polygon->id + 1]++;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		incoming_start[i + 1] += incoming_start[i];
+	}
+	LocalVector<Incoming> incoming;
+	incoming.resize(incoming_start[polygon_count]);
+	LocalVector<uint32_t> incoming_count;
+	incoming_count.resize(polygon_count);
+	memset(incoming_count.ptr(), 0, incoming_count.size() * sizeof(uint32_t));
+	for (const gd::Polygon *polygon : polygons) {
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t target = connection.polygon->id;
+				incoming[incoming_start[target] + incoming_count[target]++] = { polygon, &connection };
+			}
+		}
+	}
+
+	LocalVector<uint32_t> heap_indices;
+	heap_indices.resize(polygon_count);
+	LocalVector<bool> closed;
+	closed.resize(polygon_count);
+	memset(closed.ptr(), 0, closed.size() * sizeof(bool));
+
+	NavFlowFieldCostGreaterThan greater_than;
+	greater_than.steps = steps.ptr();
+	NavFlowFieldHeapIndexer indexer;
+	indexer.heap_indices = heap_indices.ptr();
+	gd::Heap<uint32_t, NavFlowFieldCostGreaterThan, NavFlowFieldHeapIndexer> heap(greater_than, indexer);
+
+	steps[goal->id].cost = 0.0;
+	heap.push(goal->id);
+
+	while (!heap.is_empty()) {
+		const uint32_t current_id = heap.pop();
+		closed[current_id] = true;
+		const gd::Polygon *current = polygons[current_id];
+		const Step &current_step = steps[current_id];
+
+		// Costs are measured from where the polygon is left: the middle of its
+		// next pathway, or the center of the goal.
+		Vector3 current_point;
+		if (current == goal) {
+			for (const gd::Point &point : current->points) {
+				current_point += point.pos;
+			}
+			current_point /= current->points.size();
+		} else {
+			current_point = (current_step.pathway_start + current_step.pathway_end) * 0.5;
+		}
+
+		for (uint32_t i = incoming_start[current_id]; i < incoming_start[current_id + 1]; i++) {
+			const gd::Polygon *neighbor = incoming[i].polygon;
+			const gd::Edge::Connection &connection = *incoming[i].connection;
+			if (closed[neighbor->id]) {
+				continue;
+			}
+
+			// Only polygons a path query may start from or travel through are part of the field.
+			if ((p_navigation_layers & neighbor->owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+
+			const Vector3 crossing_point = (connection.pathway_start + connection.pathway_end) * 0.5;
+			real_t cost = current_step.cost + crossing_point.distance_to(current_point) * current->owner->get_travel_cost();
+			if (neighbor->owner != current->owner) {
+				cost += current->owner->get_enter_cost();
+			}
+
+			Step &neighbor_step = steps[neighbor->id];
+			if (cost >= neighbor_step.cost) {
+				continue;
+			}
+
+			const bool queued = neighbor_step.cost != FLT_MAX;
+			neighbor_step.next_polygon = current;
+			neighbor_step.next_edge = connection.edge;
+			neighbor_step.pathway_start = connection.pathway_start;
+			neighbor_step.pathway_end = connection.pathway_end;
+			neighbor_step.cost = cost;
+			if (queued) {
+				heap.shift(heap_indices[neighbor->id]);
+			} else {
+				heap.push(neighbor->id);
+			}
+		}
+	}
+}
@@ -0,0 +1,79 @@
+/**************************************************************************/
+/*  nav_flow_field.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_FLOW_FIELD_H
+#define NAV_FLOW_FIELD_H
+
+#include "nav_utils.h"
+
+#include "core/templates/safe_refcount.h"
+
+/**
+ * Travel cost from every polygon of a map to a goal polygon, with the
+ * connection each polygon takes towards the goal.
+ *
+ * The field is built once with a backwards Dijkstra search from the goal. Any
+ * number of path queries heading to the goal can then follow the connections
+ * instead of running their own search.
+ */
+class NavFlowField {
+public:
+	struct Step {
+		/// Next polygon towards the goal, `nullptr` at the goal or when the goal can't be reached.
+		const gd::Polygon *next_polygon = nullptr;
+		/// Edge of `next_polygon` that is crossed, or -1 when entering a link.
+		int next_edge = -1;
+		Vector3 pathway_start;
+		Vector3 pathway_end;
+		/// Travel cost to the goal, `FLT_MAX` when the goal can't be reached.
+		real_t cost = FLT_MAX;
+	};
+
+private:
+	const gd::Polygon *goal = nullptr;
+	uint32_t navigation_layers = 0;
+	LocalVector<Step> steps;
+
+	/// Last time the field was used, to find the fields that can be discarded.
+	SafeNumeric<uint64_t> last_used;
+
+public:
+	void build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, uint32_t p_link_polygons_count, const gd::Polygon *p_goal, uint32_t p_navigation_layers);
+
+	const gd::Polygon *get_goal() const { return goal; }
+	uint32_t get_navigation_layers() const { return navigation_layers; }
+	uint32_t get_polygon_count() const { return steps.size(); }
+	const Step &get_step(uint32_t p_polygon_id) const { return steps[p_polygon_id]; }
+
+	void set_last_used(uint64_t p_tick) { last_used.set(p_tick); }
+	uint64_t get_last_used() const { return last_used.get(); }
+};
+
+#endif // NAV_FLOW_FIELD_H
@@ -0,0 +1,379 @@
+/**************************************************************************/
+/*  nav_hierarchy.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_hierarchy.h"
+
+#include "nav_base.h"
+
+#include "core/object/worker_thread_pool.h"
+
+struct NavHierarchyCostGreaterThan {
+	const real_t *costs = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return costs[p_a] > costs[p_b];
+	}
+};
+
+struct NavHierarchyHeapIndexer {
+	uint32_t *heap_indices = nullptr;
+
+	void operator()(uint32_t p_value, uint32_t p_heap_index) const {
+		heap_indices[p_value] = p_heap_index;
+	}
+};
+
+typedef gd::Heap<uint32_t, NavHierarchyCostGreaterThan, NavHierarchyHeapIndexer> NavHierarchyHeap;
+
+real_t NavHierarchy::_get_crossing_cost(const gd::Polygon *p_from, const Vector3 &p_from_point, const gd::Edge::Connection &p_connection) const {
+	const Vector3 crossing_point = (p_connection.pathway_start + p_connection.pathway_end) * 0.5;
+	return p_from_point.distance_to(crossing_point) * p_from->owner->get_travel_cost() +
+			crossing_point.distance_to(polygon_centers[p_connection.polygon->id]) * p_connection.polygon->owner->get_travel_cost();
+}
+
+void NavHierarchy::_get_cluster_costs(const gd::Polygon *p_source, const Vector3 &p_source_point, LocalVector<real_t> &r_costs) const {
+	// Dijkstra search from the source polygon, without leaving its cluster.
+	const uint32_t cluster_index = polygon_clusters[p_source->id];
+	const Cluster &cluster = clusters[cluster_index];
+
+	r_costs.resize(cluster.polygons_count);
+	for (real_t &cost : r_costs) {
+		cost = FLT_MAX;
+	}
+
+	LocalVector<uint32_t> heap_indices;
+	heap_indices.resize(cluster.polygons_count);
+
+	NavHierarchyCostGreaterThan greater_than;
+	greater_than.costs = r_costs.ptr();
+	NavHierarchyHeapIndexer indexer;
+	indexer.heap_indices = heap_indices.ptr();
+	NavHierarchyHeap heap(greater_than, indexer);
+
+	const uint32_t source_index = polygon_cluster_indices[p_source->id];
+	r_costs[source_index] = 0.0;
+	heap.push(source_index);
+
+	while (!heap.is_empty()) {
+		const uint32_t current_index = heap.pop();
+		const gd::Polygon *current = polygons[cluster_polygons[cluster.polygons_start + current_index]];
+		const Vector3 &current_point = current == p_source ? p_source_point : polygon_centers[current->id];
+
+		for (const gd::Edge &edge : current->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (polygon_clusters[connection.polygon->id] != cluster_index) {
+					continue;
+				}
+
+				const uint32_t neighbor_index = polygon_cluster_indices[connection.polygon->id];
+				const real_t cost = r_costs[current_index] + _get_crossing_cost(current, current_point, connection);
+				if (cost >= r_costs[neighbor_index]) {
+					continue;
+				}
+
+				const bool queued = r_costs[neighbor_index] != FLT_MAX;
+				r_costs[neighbor_index] = cost;
+				if (queued && heap_indices[neighbor_index] != UINT32_MAX) {
+					heap.shift(heap_indices[neighbor_index]);
+				} else {
+					heap.push(neighbor_index);
+				}
+			}
+		}
+	}
+}
+
+void NavHierarchy::_build_cluster_edges(uint32_t p_index, Cluster *p_clusters) {
+	const Cluster &cluster = p_clusters[p_index];
+
+	LocalVector<real_t> costs;
+	for (uint32_t portal = cluster.portals_start; portal < cluster.portals_start + cluster.portals_count; portal++) {
+		const gd::Polygon *polygon = polygons[portal_polygons[portal]];
+		LocalVector<PortalEdge> &edges = portal_edge_lists[portal];
+
+		// Travel to the other portals of the cluster.
+		_get_cluster_costs(polygon, polygon_centers[polygon->id], costs);
+		for (uint32_t other_portal = cluster.portals_start; other_portal < cluster.portals_start + cluster.portals_count; other_portal++) {
+			const real_t cost = costs[polygon_cluster_indices[portal_polygons[other_portal]]];
+			if (other_portal != portal && cost != FLT_MAX) {
+				edges.push_back({ other_portal, cost });
+			}
+		}
+
+		// Cross over to the portals of the neighbor clusters.
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (polygon_clusters[connection.polygon->id] != p_index) {
+					edges.push_back({ polygon_portals[connection.polygon->id], _get_crossing_cost(polygon, polygon_centers[polygon->id], connection) });
+				}
+			}
+		}
+	}
+}
+
+void NavHierarchy::build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, uint32_t p_link_polygons_count, const NavPolygonIndex &p_polygons_index, bool p_use_threads) {
+	clear();
+
+	const uint32_t polygon_count = p_polygons.size() + p_link_polygons_count;
+	polygons.resize(polygon_count);
+	polygon_centers.resize(polygon_count);
+	polygon_clusters.resize(polygon_count);
+	polygon_cluster_indices.resize(polygon_count);
+	polygon_portals.resize(polygon_count);
+
+	// Region polygons are clustered by proximity, each link is a cluster of its own.
+	uint32_t cluster_count = p_polygons_index.get_clusters(MAX_CLUSTER_SIZE, polygon_clusters);
+	for (uint32_t i = 0; i < p_polygons.size(); i++) {
+		polygons[i] = &p_polygons[i];
+	}
+	for (uint32_t i = 0; i < p_link_polygons_count; i++) {
+		polygons[p_polygons.size() + i] = &p_link_polygons[i];
+		polygon_clusters[p_polygons.size() + i] = cluster_count++;
+	}
+
+	min_travel_cost = FLT_MAX;
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		const gd::Polygon *polygon = polygons[i];
+		ERR_FAIL_COND_MSG(polygon->id != i, "Navigation map polygons must be numbered in order to build a hierarchy.");
+
+		Vector3 center;
+		for (const gd::Point &point : polygon->points) {
+			center += point.pos;
+		}
+		polygon_centers[i] = polygon->points.is_empty() ? center : center / polygon->points.size();
+		polygon_portals[i] = UINT32_MAX;
+
+		const uint32_t navigation_layers = polygon->owner->get_navigation_layers();
+		if (!owner_navigation_layers.has(navigation_layers)) {
+			owner_navigation_layers.push_back(navigation_layers);
+		}
+		min_travel_cost = MIN(min_travel_cost, polygon->owner->get_travel_cost());
+	}
+
+	// Group the polygons by cluster.
+	clusters.resize(cluster_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		polygon_cluster_indices[i] = clusters[polygon_clusters[i]].polygons_count++;
+	}
+	uint32_t polygons_start = 0;
+	for (Cluster &cluster : clusters) {
+		cluster.polygons_start = polygons_start;
+		polygons_start += cluster.polygons_count;
+	}
+	cluster_polygons.resize(polygon_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		const Cluster &cluster = clusters[polygon_clusters[i]];
+		cluster_polygons[cluster.polygons_start + polygon_cluster_indices[i]] = i;
+	}
+
+	// Polygons on either side of a connection between two clusters are portals.
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		for (const gd::Edge &edge : polygons[i]->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (polygon_clusters[connection.polygon->id] != polygon_clusters[i]) {
+					polygon_portals[i] = 0;
+					polygon_portals[connection.polygon->id] = 0;
+				}
+			}
+		}
+	}
+	for (Cluster &cluster : clusters) {
+		cluster.portals_start = portal_polygons.size();
+		for (uint32_t i = cluster.polygons_start; i < cluster.polygons_start + cluster.polygons_count; i++) {
+			const uint32_t polygon_id = cluster_polygons[i];
+			if (polygon_portals[polygon_id] != UINT32_MAX) {
+				polygon_portals[polygon_id] = portal_polygons.size();
+				portal_polygons.push_back(polygon_id);
+			}
+		}
+		cluster.portals_count = portal_polygons.size() - cluster.portals_start;
+	}
+
+	portal_edge_lists.resize(portal_polygons.size());
+	if (p_use_threads) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavHierarchy::_build_cluster_edges, clusters.ptr(), clusters.size(), -1, true, SNAME("NavHierarchyClusters"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < clusters.size(); i++) {
+			_build_cluster_edges(i, clusters.ptr());
+		}
+	}
+
+	portal_edges_start.resize(portal_polygons.size() + 1);
+	portal_edges_start[0] = 0;
+	for (uint32_t i = 0; i < portal_edge_lists.size(); i++) {
+		portal_edges_start[i + 1] = portal_edges_start[i] + portal_edge_lists[i].size();
+	}
+	portal_edges.resize(portal_edges_start[portal_polygons.size()]);
+	for (uint32_t i = 0; i < portal_edge_lists.size(); i++) {
+		for (uint32_t j = 0; j < portal_edge_lists[i].size(); j++) {
+			portal_edges[portal_edges_start[i] + j] = portal_edge_lists[i][j];
+		}
+	}
+	portal_edge_lists.clear();
+
+	valid = true;
+}
+
+void NavHierarchy::clear() {
+	valid = false;
+	polygons.clear();
+	polygon_centers.clear();
+	polygon_clusters.clear();
+	polygon_cluster_indices.clear();
+	polygon_portals.clear();
+	clusters.clear();
+	cluster_polygons.clear();
+	portal_polygons.clear();
+	portal_edges_start.clear();
+	portal_edges.clear();
+	portal_edge_lists.clear();
+	owner_navigation_layers.clear();
+	min_travel_cost = 1.0;
+}
+
+bool NavHierarchy::get_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers, LocalVector<bool> &r_clusters) const {
+	if (!valid) {
+		return false;
+	}
+
+	const uint32_t begin_cluster = polygon_clusters[p_begin_poly->id];
+	const uint32_t end_cluster = polygon_clusters[p_end_poly->id];
+	if (begin_cluster == end_cluster) {
+		return false;
+	}
+
+	// The graph was built through every polygon, it doesn't hold when some of them are excluded.
+	for (uint32_t navigation_layers : owner_navigation_layers) {
+		if ((p_navigation_layers & navigation_layers) == 0) {
+			return false;
+		}
+	}
+
+	// The last node of the search is the end point, reached from the portals of the end cluster.
+	const uint32_t portal_count = portal_polygons.size();
+	const uint32_t goal = portal_count;
+
+	LocalVector<real_t> travel_costs;
+	LocalVector<real_t> total_costs;
+	LocalVector<uint32_t> previous;
+	LocalVector<uint32_t> heap_indices;
+	travel_costs.resize(portal_count + 1);
+	total_costs.resize(portal_count + 1);
+	previous.resize(portal_count + 1);
+	heap_indices.resize(portal_count + 1);
+	for (uint32_t i = 0; i <= portal_count; i++) {
+		travel_costs[i] = FLT_MAX;
+		previous[i] = UINT32_MAX;
+		heap_indices[i] = UINT32_MAX;
+	}
+
+	NavHierarchyCostGreaterThan greater_than;
+	greater_than.costs = total_costs.ptr();
+	NavHierarchyHeapIndexer indexer;
+	indexer.heap_indices = heap_indices.ptr();
+	NavHierarchyHeap heap(greater_than, indexer);
+
+	// Enter the graph through the portals of the begin cluster.
+	LocalVector<real_t> cluster_costs;
+	_get_cluster_costs(p_begin_poly, p_begin_point, cluster_costs);
+	const Cluster &begin = clusters[begin_cluster];
+	for (uint32_t portal = begin.portals_start; portal < begin.portals_start + begin.portals_count; portal++) {
+		const real_t cost = cluster_costs[polygon_cluster_indices[portal_polygons[portal]]];
+		if (cost != FLT_MAX) {
+			travel_costs[portal] = cost;
+			total_costs[portal] = cost + polygon_centers[portal_polygons[portal]].distance_to(p_end_point) * min_travel_cost;
+			heap.push(portal);
+		}
+	}
+
+	// Leave the graph through the portals of the end cluster. The cluster links are
+	// symmetric, so the cost from the end polygon to a portal is the cost back.
+	LocalVector<real_t> end_costs;
+	_get_cluster_costs(p_end_poly, p_end_point, end_costs);
+
+	while (!heap.is_empty()) {
+		const uint32_t current = heap.pop();
+		if (current == goal) {
+			break;
+		}
+
+		const real_t current_cost = travel_costs[current];
+		const uint32_t current_polygon = portal_polygons[current];
+		if (polygon_clusters[current_polygon] == end_cluster) {
+			const real_t end_cost = end_costs[polygon_cluster_indices[current_polygon]];
+			if (end_cost != FLT_MAX && current_cost + end_cost < travel_costs[goal]) {
+				const bool queued = travel_costs[goal] != FLT_MAX;
+				travel_costs[goal] = current_cost + end_cost;
+				total_costs[goal] = travel_costs[goal];
+				previous[goal] = current;
+				if (queued) {
+					heap.shift(heap_indices[goal]);
+				} else {
+					heap.push(goal);
+				}
+			}
+		}
+
+		for (uint32_t i = portal_edges_start[current]; i < portal_edges_start[current + 1]; i++) {
+			const PortalEdge &edge = portal_edges[i];
+			const real_t cost = current_cost + edge.cost;
+			if (cost >= travel_costs[edge.portal]) {
+				continue;
+			}
+
+			const bool queued = travel_costs[edge.portal] != FLT_MAX;
+			travel_costs[edge.portal] = cost;
+			total_costs[edge.portal] = cost + polygon_centers[portal_polygons[edge.portal]].distance_to(p_end_point) * min_travel_cost;
+			previous[edge.portal] = current;
+			if (queued && heap_indices[edge.portal] != UINT32_MAX) {
+				heap.shift(heap_indices[edge.portal]);
+			} else {
+				heap.push(edge.portal);
+			}
+		}
+	}
+
+	if (previous[goal] == UINT32_MAX) {
+		return false;
+	}
+
+	r_clusters.resize(clusters.size());
+	for (bool &cluster : r_clusters) {
+		cluster = false;
+	}
+	r_clusters[begin_cluster] = true;
+	r_clusters[end_cluster] = true;
+	for (uint32_t portal = previous[goal]; portal != UINT32_MAX; portal = previous[portal]) {
+		r_clusters[polygon_clusters[portal_polygons[portal]]] = true;
+	}
+
+	return true;
+}
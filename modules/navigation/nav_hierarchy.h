@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*  nav_hierarchy.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_HIERARCHY_H
+#define NAV_HIERARCHY_H
+
+#include "nav_polygon_index.h"
+#include "nav_utils.h"
+
+/**
+ * Coarse navigation graph used to plan long paths before refining them.
+ *
+ * The map polygons are grouped in small clusters. Polygons connected to another
+ * cluster are portals, and the graph links the portals of a cluster with the
+ * travel cost between them, and the portals of neighbor clusters with the cost
+ * of crossing over. A path query first searches this graph, then runs the
+ * regular polygon search restricted to the clusters along the coarse route.
+ */
+class NavHierarchy {
+	struct Cluster {
+		uint32_t polygons_start = 0;
+		uint32_t polygons_count = 0;
+		uint32_t portals_start = 0;
+		uint32_t portals_count = 0;
+	};
+
+	struct PortalEdge {
+		uint32_t portal = 0;
+		real_t cost = 0.0;
+	};
+
+	bool valid = false;
+
+	/// Polygons of the map, followed by the link polygons.
+	LocalVector<const gd::Polygon *> polygons;
+	LocalVector<Vector3> polygon_centers;
+	LocalVector<uint32_t> polygon_clusters;
+	/// Position of each polygon in its cluster.
+	LocalVector<uint32_t> polygon_cluster_indices;
+	/// Portal of each polygon, or `UINT32_MAX` when the polygon is not a portal.
+	LocalVector<uint32_t> polygon_portals;
+
+	LocalVector<Cluster> clusters;
+	/// Polygons grouped by cluster.
+	LocalVector<uint32_t> cluster_polygons;
+
+	/// Portals are numbered cluster by cluster, so the portals of a cluster are a contiguous range.
+	LocalVector<uint32_t> portal_polygons;
+	/// Outgoing edges of each portal are `portal_edges[portal_edges_start[portal]..portal_edges_start[portal + 1]]`.
+	LocalVector<uint32_t> portal_edges_start;
+	LocalVector<PortalEdge> portal_edges;
+	/// Edges computed by the cluster build tasks, before they are packed into `portal_edges`.
+	LocalVector<LocalVector<PortalEdge>> portal_edge_lists;
+
+	/// Navigation layers of the map regions and links. The graph only holds for
+	/// queries compatible with all of them.
+	LocalVector<uint32_t> owner_navigation_layers;
+	/// Lowest travel cost of the map, to keep the coarse search heuristic admissible.
+	real_t min_travel_cost = 1.0;
+
+	static constexpr uint32_t MAX_CLUSTER_SIZE = 64;
+
+	real_t _get_crossing_cost(const gd::Polygon *p_from, const Vector3 &p_from_point, const gd::Edge::Connection &p_connection) const;
+	void _get_cluster_costs(const gd::Polygon *p_source, const Vector3 &p_source_point, LocalVector<real_t> &r_costs) const;
+	void _build_cluster_edges(uint32_t p_index, Cluster *p_clusters);
+
+public:
+	void build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, uint32_t p_link_polygons_count, const NavPolygonIndex &p_polygons_index, bool p_use_threads);
+	void clear();
+
+	bool is_valid() const { return valid; }
+	uint32_t get_cluster_count() const { return clusters.size(); }
+	uint32_t get_portal_count() const { return portal_polygons.size(); }
+	uint32_t get_polygon_cluster(uint32_t p_polygon_id) const { return polygon_clusters[p_polygon_id]; }
+
+	/// Searches the coarse graph between two polygons and marks the clusters the
+	/// route goes through in `r_clusters`. Returns `false` when the graph can't
+	/// be used for this query or holds no route, in which case the whole map has
+	/// to be searched.
+	bool get_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers, LocalVector<bool> &r_clusters) const;
+};
+
+#endif // NAV_HIERARCHY_H
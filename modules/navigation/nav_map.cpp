@@ -94,6 +94,18 @@ void NavMap::set_use_edge_connections(bool p_enabled) {
 	regenerate_links = true;
 }
 
+void NavMap::set_use_hierarchical_pathfinding(bool p_enabled) {
+	if (use_hierarchical_pathfinding == p_enabled) {
+		return;
+	}
+	use_hierarchical_pathfinding = p_enabled;
+	regenerate_links = true;
+}
+
+void NavMap::set_use_async_iterations(bool p_enabled) {
+	use_async_iterations = p_enabled;
+}
+
 void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
 	if (edge_connection_margin == p_edge_connection_margin) {
 		return;
@@ -123,62 +135,165 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
+Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, uint32_t *r_explored_polygon_count) const {
 	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector<Vector3>();
 	}
 
 	return NavMeshQueries3D::polygons_get_path(
-			polygons, p_origin, p_destination, p_optimize, p_navigation_layers,
-			r_path_types, r_path_rids, r_path_owners, up, link_polygons.size());
+			iteration.polygons, iteration.polygons_index, p_origin, p_destination, p_optimize, p_navigation_layers,
+			r_path_types, r_path_rids, r_path_owners, up, iteration.link_polygons.size(), &iteration.hierarchy, r_explored_polygon_count);
+}
+
+Vector<Vector3> NavMap::get_flow_field_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, uint32_t *r_explored_polygon_count) const {
+	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return Vector<Vector3>();
+	}
+
+	Vector3 end_point;
+	const gd::Polygon *end_poly = NavMeshQueries3D::polygons_get_closest_polygon(iteration.polygons, iteration.polygons_index, p_destination, p_navigation_layers, end_point);
+
+	Vector<Vector3> path;
+	if (end_poly) {
+		const uint64_t tick = flow_fields_tick.increment();
+		const NavFlowField *found_flow_field = nullptr;
+		{
+			RWLockRead flow_fields_read_lock(flow_fields_rwlock);
+			for (NavFlowField *flow_field : flow_fields) {
+				if (flow_field->get_goal() == end_poly && flow_field->get_navigation_layers() == p_navigation_layers) {
+					flow_field->set_last_used(tick);
+					found_flow_field = flow_field;
+					path = NavMeshQueries3D::polygons_get_flow_field_path(iteration.polygons, iteration.polygons_index, *flow_field, p_origin, end_point, p_optimize, r_path_types, r_path_rids, r_path_owners, up, r_explored_polygon_count);
+					break;
+				}
+			}
+		}
+
+		if (found_flow_field == nullptr) {
+			bool cache_in_use = false;
+			{
+				RWLockRead flow_fields_read_lock(flow_fields_rwlock);
+				if (flow_fields.size() == MAX_FLOW_FIELDS) {
+					cache_in_use = true;
+					for (const NavFlowField *flow_field : flow_fields) {
+						if (flow_field->get_last_used() + FLOW_FIELD_REUSE_TICKS < tick) {
+							cache_in_use = false;
+							break;
+						}
+					}
+				}
+			}
+
+			// When every cached field is still in use, the path is searched for directly below instead.
+			if (!cache_in_use) {
+				// Built without holding the lock, as it explores the whole map.
+				NavFlowField *flow_field = memnew(NavFlowField);
+				flow_field->build(iteration.polygons, iteration.link_polygons, iteration.link_polygons_count, end_poly, p_navigation_layers);
+				flow_field->set_last_used(tick);
+				path = NavMeshQueries3D::polygons_get_flow_field_path(iteration.polygons, iteration.polygons_index, *flow_field, p_origin, end_point, p_optimize, r_path_types, r_path_rids, r_path_owners, up, r_explored_polygon_count);
+
+				RWLockWrite flow_fields_write_lock(flow_fields_rwlock);
+				bool already_cached = false;
+				for (const NavFlowField *other_flow_field : flow_fields) {
+					if (other_flow_field->get_goal() == end_poly && other_flow_field->get_navigation_layers() == p_navigation_layers) {
+						// Another query built the same field in the meantime.
+						already_cached = true;
+						break;
+					}
+				}
+
+				if (already_cached) {
+					memdelete(flow_field);
+				} else if (flow_fields.size() < MAX_FLOW_FIELDS) {
+					flow_fields.push_back(flow_field);
+				} else {
+					// Replace the field that went unused for the longest time.
+					uint32_t oldest_index = 0;
+					for (uint32_t i = 1; i < flow_fields.size(); i++) {
+						if (flow_fields[i]->get_last_used() < flow_fields[oldest_index]->get_last_used()) {
+							oldest_index = i;
+						}
+					}
+					memdelete(flow_fields[oldest_index]);
+					flow_fields[oldest_index] = flow_field;
+				}
+			}
+		}
+	}
+
+	if (path.is_empty()) {
+		// Either no field was used, or it doesn't lead to the destination from here, so look for the closest reachable point instead.
+		return NavMeshQueries3D::polygons_get_path(
+				iteration.polygons, iteration.polygons_index, p_origin, p_destination, p_optimize, p_navigation_layers,
+				r_path_types, r_path_rids, r_path_owners, up, iteration.link_polygons.size(), &iteration.hierarchy, r_explored_polygon_count);
+	}
+
+	return path;
+}
+
+void NavMap::_clear_flow_fields() {
+	RWLockWrite flow_fields_write_lock(flow_fields_rwlock);
+	for (NavFlowField *flow_field : flow_fields) {
+		memdelete(flow_field);
+	}
+	flow_fields.clear();
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_to_segment(polygons, p_from, p_to, p_use_collision);
+	return NavMeshQueries3D::polygons_get_closest_point_to_segment(iteration.polygons, iteration.polygons_index, p_from, p_to, p_use_collision);
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
 	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point(iteration.polygons, iteration.polygons_index, p_point);
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
 	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_normal(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_normal(iteration.polygons, iteration.polygons_index, p_point);
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
 	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return RID();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_owner(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_owner(iteration.polygons, iteration.polygons_index, p_point);
 }
 
 gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_point) const {
 	RWLockRead read_lock(map_rwlock);
+	const Iteration &iteration = iterations[iteration_index];
 
-	return NavMeshQueries3D::polygons_get_closest_point_info(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_info(iteration.polygons, iteration.polygons_index, p_point);
 }
 
 void NavMap::add_region(NavRegion *p_region) {
@@ -189,8 +304,11 @@ void NavMap::add_region(NavRegion *p_region) {
 void NavMap::remove_region(NavRegion *p_region) {
 	int64_t region_index = regions.find(p_region);
 	if (region_index >= 0) {
+		// The region may be freed next, nothing can keep reading its polygons.
+		_finish_iteration_build(true);
 		regions.remove_at_unordered(region_index);
 		regenerate_links = true;
+		iteration_build_blocking = true;
 	}
 }
 
@@ -202,8 +320,10 @@ void NavMap::add_link(NavLink *p_link) {
 void NavMap::remove_link(NavLink *p_link) {
 	int64_t link_index = links.find(p_link);
 	if (link_index >= 0) {
+		_finish_iteration_build(true);
 		links.remove_at_unordered(link_index);
 		regenerate_links = true;
+		iteration_build_blocking = true;
 	}
 }
 
@@ -353,335 +473,499 @@ Vector3 NavMap::get_random_point(uint32_t p_navigation_layers, bool p_uniformly)
 	}
 }
 
-void NavMap::sync() {
-	RWLockWrite write_lock(map_rwlock);
-
+void NavMap::sync(bool p_wait_for_iteration) {
 	// Performance Monitor
 	int _new_pm_region_count = regions.size();
 	int _new_pm_agent_count = agents.size();
 	int _new_pm_link_count = links.size();
-	int _new_pm_polygon_count = pm_polygon_count;
-	int _new_pm_edge_count = pm_edge_count;
-	int _new_pm_edge_merge_count = pm_edge_merge_count;
-	int _new_pm_edge_connection_count = pm_edge_connection_count;
-	int _new_pm_edge_free_count = pm_edge_free_count;
 	int _new_pm_obstacle_count = obstacles.size();
 
-	// Check if we need to update the links.
-	if (regenerate_polygons) {
-		for (NavRegion *region : regions) {
-			region->scratch_polygons();
-		}
-		regenerate_links = true;
+	// While an iteration is built in the background the regions and links are left alone, they are synced once it is done.
+	bool iteration_building = iteration_build.task_id != WorkerThreadPool::INVALID_TASK_ID;
+	if (iteration_building && (p_wait_for_iteration || !use_async_iterations || WorkerThreadPool::get_singleton()->is_task_completed(iteration_build.task_id))) {
+		_finish_iteration_build(false);
+		iteration_building = false;
 	}
 
-	for (NavRegion *region : regions) {
-		if (region->sync()) {
+	if (!iteration_building) {
+		// Check if we need to update the links.
+		if (regenerate_polygons) {
+			for (NavRegion *region : regions) {
+				region->scratch_polygons();
+			}
 			regenerate_links = true;
 		}
+
+		for (NavRegion *region : regions) {
+			if (region->sync()) {
+				regenerate_links = true;
+			}
+		}
+
+		for (NavLink *link : links) {
+			if (link->check_dirty()) {
+				regenerate_links = true;
+			}
+		}
+
+		if (regenerate_links) {
+			_start_iteration_build();
+			if (use_async_iterations && !p_wait_for_iteration && !iteration_build_blocking) {
+				iteration_build.task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &NavMap::_build_iteration, nullptr, false, SNAME("NavMapBuildIteration"));
+			} else {
+				_build_iteration(nullptr);
+				_finish_iteration_build(false);
+			}
+			iteration_build_blocking = false;
+		}
+
+		regenerate_polygons = false;
+		regenerate_links = false;
 	}
 
-	for (NavLink *link : links) {
-		if (link->check_dirty()) {
-			regenerate_links = true;
+	// Do we have modified obstacle positions?
+	for (NavObstacle *obstacle : obstacles) {
+		if (obstacle->check_dirty()) {
+			obstacles_dirty = true;
+		}
+	}
+	// Do we have modified agent arrays?
+	for (NavAgent *agent : agents) {
+		if (agent->check_dirty()) {
+			agents_dirty = true;
 		}
 	}
 
-	if (regenerate_links) {
-		_new_pm_polygon_count = 0;
-		_new_pm_edge_count = 0;
-		_new_pm_edge_merge_count = 0;
-		_new_pm_edge_connection_count = 0;
-		_new_pm_edge_free_count = 0;
+	// Update avoidance worlds.
+	if (obstacles_dirty || agents_dirty) {
+		_update_rvo_simulation();
+	}
 
-		// Remove regions connections.
-		region_external_connections.clear();
-		for (NavRegion *region : regions) {
-			region_external_connections[region] = LocalVector<gd::Edge::Connection>();
+	obstacles_dirty = false;
+	agents_dirty = false;
+
+	// Performance Monitor.
+	pm_region_count = _new_pm_region_count;
+	pm_agent_count = _new_pm_agent_count;
+	pm_link_count = _new_pm_link_count;
+	pm_obstacle_count = _new_pm_obstacle_count;
+}
+
+void NavMap::_start_iteration_build() {
+	iteration_build.regions.clear();
+	for (NavRegion *region : regions) {
+		if (!region->get_enabled()) {
+			continue;
 		}
+		IterationBuild::Region build_region;
+		build_region.region = region;
+		build_region.use_edge_connections = region->get_use_edge_connections();
+		iteration_build.regions.push_back(build_region);
+	}
 
-		// Resize the polygon count.
-		int polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
-			}
-			polygon_count += region->get_polygons().size();
+	iteration_build.links.clear();
+	for (const NavLink *link : links) {
+		if (!link->get_enabled()) {
+			continue;
 		}
-		polygons.resize(polygon_count);
+		IterationBuild::Link build_link;
+		build_link.link = link;
+		build_link.start = link->get_start_position();
+		build_link.end = link->get_end_position();
+		build_link.bidirectional = link->is_bidirectional();
+		iteration_build.links.push_back(build_link);
+	}
 
-		// Copy all region polygons in the map.
-		polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
-			}
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
-			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[polygon_count] = polygons_source[n];
-				polygons[polygon_count].id = polygon_count;
-				polygon_count++;
-			}
+	iteration_build.use_edge_connections = use_edge_connections;
+	iteration_build.edge_connection_margin = edge_connection_margin;
+	iteration_build.link_connection_radius = link_connection_radius;
+	iteration_build.use_hierarchical_pathfinding = use_hierarchical_pathfinding;
+	iteration_build.use_threads = use_threads;
+	iteration_build.merge_rasterizer_cell_size = merge_rasterizer_cell_size;
+	iteration_build.merge_rasterizer_cell_height = merge_rasterizer_cell_height;
+}
+
+static gd::Edge::Connection _get_edge_connection(gd::Polygon &p_polygon, uint32_t p_edge) {
+	gd::Edge::Connection connection;
+	connection.polygon = &p_polygon;
+	connection.edge = p_edge;
+	connection.pathway_start = p_polygon.points[p_edge].pos;
+	connection.pathway_end = p_polygon.points[(p_edge + 1) % p_polygon.points.size()].pos;
+	return connection;
+}
+
+static void _merge_edge_connections(const gd::Edge::Connection &p_connection_1, const gd::Edge::Connection &p_connection_2) {
+	p_connection_1.polygon->edges[p_connection_1.edge].connections.push_back(p_connection_2);
+	p_connection_2.polygon->edges[p_connection_2.edge].connections.push_back(p_connection_1);
+	// Note: The pathway_start/end are full for those connection and do not need to be modified.
+}
+
+void NavMap::_build_iteration(void *p_unused) {
+	// Only the inactive iteration is written here, the queries keep using the other one until `_finish_iteration_build()`.
+	Iteration &iteration = iterations[(iteration_index + 1) % 2];
+	const IterationBuild &build = iteration_build;
+
+	iteration.pm_edge_count = 0;
+	iteration.pm_edge_merge_count = 0;
+	iteration.pm_edge_connection_count = 0;
+	iteration.pm_edge_free_count = 0;
+
+	// Remove regions connections.
+	iteration.region_external_connections.clear();
+
+	// Resize the polygon count.
+	uint32_t polygon_count = 0;
+	for (IterationBuild::Region &build_region : iteration_build.regions) {
+		build_region.polygons_offset = polygon_count;
+		polygon_count += build_region.region->get_polygons().size();
+	}
+	iteration.polygons.resize(polygon_count);
+
+	// Copy all region polygons in the map, along with their spatial index.
+	polygon_count = 0;
+	iteration.polygons_index.clear();
+	for (const IterationBuild::Region &build_region : build.regions) {
+		iteration.polygons_index.add_index(build_region.region->get_polygons_index(), polygon_count);
+		const LocalVector<gd::Polygon> &polygons_source = build_region.region->get_polygons();
+		for (uint32_t n = 0; n < polygons_source.size(); n++) {
+			iteration.polygons[polygon_count] = polygons_source[n];
+			iteration.polygons[polygon_count].id = polygon_count;
+			polygon_count++;
 		}
+	}
 
-		_new_pm_polygon_count = polygon_count;
+	iteration.polygons_index.update();
 
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+	iteration.pm_polygon_count = polygon_count;
 
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
-				}
-			}
+	// Connect the edges shared by the polygons of a same region, the regions found them when their polygons changed.
+	for (const IterationBuild::Region &build_region : build.regions) {
+		gd::Polygon *region_polygons = iteration.polygons.ptr() + build_region.polygons_offset;
+		for (const gd::MergedEdge &merged_edge : build_region.region->get_merged_edges()) {
+			_merge_edge_connections(
+					_get_edge_connection(region_polygons[merged_edge.a.polygon], merged_edge.a.edge),
+					_get_edge_connection(region_polygons[merged_edge.b.polygon], merged_edge.b.edge));
 		}
+		iteration.pm_edge_count += build_region.region->get_merged_edges().size();
+		iteration.pm_edge_merge_count += build_region.region->get_merged_edges().size();
+	}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
+	// Group the region border edges per key, so the ones shared by different regions get merged too.
+	struct BorderEdge {
+		gd::Edge::Connection connection;
+		uint32_t region_index = 0;
+		uint32_t count = 0;
+	};
+	HashMap<gd::EdgeKey, BorderEdge, gd::EdgeKey> border_edges;
+	for (uint32_t region_index = 0; region_index < build.regions.size(); region_index++) {
+		const IterationBuild::Region &build_region = build.regions[region_index];
+		gd::Polygon *region_polygons = iteration.polygons.ptr() + build_region.polygons_offset;
+		for (const gd::PolygonEdge &border_edge : build_region.region->get_border_edges()) {
+			gd::Polygon &poly = region_polygons[border_edge.polygon];
+			const gd::EdgeKey ek(poly.points[border_edge.edge].key, poly.points[(border_edge.edge + 1) % poly.points.size()].key);
+
+			BorderEdge *entry = border_edges.getptr(ek);
+			if (!entry) {
+				BorderEdge new_entry;
+				new_entry.connection = _get_edge_connection(poly, border_edge.edge);
+				new_entry.region_index = region_index;
+				new_entry.count = 1;
+				border_edges.insert(ek, new_entry);
+				iteration.pm_edge_count += 1;
+			} else if (entry->count == 1) {
 				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
+				_merge_edge_connections(entry->connection, _get_edge_connection(poly, border_edge.edge));
+				entry->count = 2;
+				iteration.pm_edge_merge_count += 1;
 			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
 			}
 		}
+	}
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
-
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
-
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+	LocalVector<gd::Edge::Connection> free_edges;
+	if (build.use_edge_connections) {
+		for (const KeyValue<gd::EdgeKey, BorderEdge> &E : border_edges) {
+			if (E.value.count == 1 && build.regions[E.value.region_index].use_edge_connections) {
+				free_edges.push_back(E.value.connection);
+			}
+		}
+	}
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	iteration.pm_edge_free_count = free_edges.size();
+
+	// Only edges whose bounds are within the margin of each other can be connected. Sorting the edges by
+	// their lowest x coordinate finds those candidates without comparing every edge with every other.
+	// The bounds are grown by twice the margin, so rounding never drops a pair the exact test below accepts.
+	struct FreeEdgeBounds {
+		Vector3 min;
+		Vector3 max;
+		uint32_t index = 0;
+
+		bool operator<(const FreeEdgeBounds &p_other) const {
+			return min.x < p_other.min.x;
+		}
+	};
+	const real_t bounds_margin = build.edge_connection_margin * 2.0;
+	LocalVector<FreeEdgeBounds> free_edges_bounds;
+	free_edges_bounds.resize(free_edges.size());
+	real_t max_free_edge_width = 0.0;
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		const gd::Edge::Connection &free_edge = free_edges[i];
+		free_edges_bounds[i].min = free_edge.pathway_start.min(free_edge.pathway_end);
+		free_edges_bounds[i].max = free_edge.pathway_start.max(free_edge.pathway_end);
+		free_edges_bounds[i].index = i;
+		max_free_edge_width = MAX(max_free_edge_width, free_edges_bounds[i].max.x - free_edges_bounds[i].min.x);
+	}
+	free_edges_bounds.sort();
+
+	LocalVector<uint32_t> candidates;
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		const gd::Edge::Connection &free_edge = free_edges[i];
+		Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
+		Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
+
+		const Vector3 search_min = edge_p1.min(edge_p2) - Vector3(bounds_margin, bounds_margin, bounds_margin);
+		const Vector3 search_max = edge_p1.max(edge_p2) + Vector3(bounds_margin, bounds_margin, bounds_margin);
+
+		// Skip the edges that end before the search bounds start, then stop at the first one that starts after they end.
+		uint32_t first = 0;
+		uint32_t last = free_edges_bounds.size();
+		const real_t first_min_x = search_min.x - max_free_edge_width;
+		while (first < last) {
+			const uint32_t middle = (first + last) / 2;
+			if (free_edges_bounds[middle].min.x < first_min_x) {
+				first = middle + 1;
+			} else {
+				last = middle;
+			}
+		}
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
+		candidates.clear();
+		for (uint32_t k = first; k < free_edges_bounds.size() && free_edges_bounds[k].min.x <= search_max.x; k++) {
+			const FreeEdgeBounds &other_bounds = free_edges_bounds[k];
+			if (other_bounds.max.x >= search_min.x &&
+					other_bounds.max.y >= search_min.y && other_bounds.min.y <= search_max.y &&
+					other_bounds.max.z >= search_min.z && other_bounds.min.z <= search_max.z) {
+				candidates.push_back(other_bounds.index);
+			}
+		}
+		// Connect in the order of the free edges, like comparing them all would.
+		candidates.sort();
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
+		for (uint32_t j : candidates) {
+			const gd::Edge::Connection &other_edge = free_edges[j];
+			if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
+				continue;
+			}
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+			Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
+			Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
 
-				// Add the connection to the region_connection map.
-				region_external_connections[(NavRegion *)free_edge.polygon->owner].push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
+			// Compute the projection of the opposite edge on the current one
+			Vector3 edge_vector = edge_p2 - edge_p1;
+			real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+			real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+			if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+				continue;
 			}
-		}
 
-		uint32_t link_poly_idx = 0;
-		link_polygons.resize(links.size());
-
-		// Search for polygons within range of a nav link.
-		for (const NavLink *link : links) {
-			if (!link->get_enabled()) {
+			// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+			Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+			Vector3 other1;
+			if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+				other1 = other_edge_p1;
+			} else {
+				other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+			}
+			if (other1.distance_to(self1) > build.edge_connection_margin) {
 				continue;
 			}
-			const Vector3 start = link->get_start_position();
-			const Vector3 end = link->get_end_position();
-
-			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
-			Vector3 closest_start_point;
-
-			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
-			Vector3 closest_end_point;
-
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
-
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
-				}
+
+			Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+			Vector3 other2;
+			if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+				other2 = other_edge_p2;
+			} else {
+				other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+			}
+			if (other2.distance_to(self2) > build.edge_connection_margin) {
+				continue;
 			}
 
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
+			// The edges can now be connected.
+			gd::Edge::Connection new_connection = other_edge;
+			new_connection.pathway_start = (self1 + other1) / 2.0;
+			new_connection.pathway_end = (self2 + other2) / 2.0;
+			free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+
+			// Add the connection to the region_connection map.
+			iteration.region_external_connections[(NavRegion *)free_edge.polygon->owner].push_back(new_connection);
+			iteration.pm_edge_connection_count += 1;
+		}
+	}
+
+	uint32_t link_poly_idx = 0;
+	iteration.link_polygons.resize(build.links.size());
+
+	const real_t link_connection_radius_sqr = build.link_connection_radius * build.link_connection_radius;
+	auto build_point_key = [&build](const Vector3 &p_pos) {
+		gd::PointKey p;
+		p.key = 0;
+		p.x = static_cast<int>(Math::floor(p_pos.x / build.merge_rasterizer_cell_size));
+		p.y = static_cast<int>(Math::floor(p_pos.y / build.merge_rasterizer_cell_height));
+		p.z = static_cast<int>(Math::floor(p_pos.z / build.merge_rasterizer_cell_size));
+		return p;
+	};
+
+	// Search for polygons within range of a nav link.
+	for (const IterationBuild::Link &build_link : build.links) {
+		const Vector3 start = build_link.start;
+		const Vector3 end = build_link.end;
+		gd::Polygon *closest_start_polygon = nullptr;
+		real_t closest_start_distance = build.link_connection_radius;
+		Vector3 closest_start_point;
+
+		gd::Polygon *closest_end_polygon = nullptr;
+		real_t closest_end_distance = build.link_connection_radius;
+		Vector3 closest_end_point;
+
+		// Create link to any polygons within the search radius of the start point.
+		auto start_callback = [&](uint32_t p_polygon_index) -> real_t {
+			gd::Polygon &start_poly = iteration.polygons[p_polygon_index];
+
+			// For each face check the distance to the start
+			for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
+				const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
+				const Vector3 start_point = start_face.get_closest_point_to(start);
+				const real_t start_distance = start_point.distance_to(start);
+
+				// Pick the polygon that is within our radius and is closer than anything we've seen yet.
+				// Ties go to the first polygon of the map, regardless of the order the index visits them in.
+				if (start_distance <= build.link_connection_radius && (start_distance < closest_start_distance || (start_distance == closest_start_distance && closest_start_polygon && start_poly.id < closest_start_polygon->id))) {
+					closest_start_distance = start_distance;
+					closest_start_point = start_point;
+					closest_start_polygon = &start_poly;
 				}
 			}
-
-			// If we have both a start and end point, then create a synthetic polygon to route through.
-			if (closest_start_polygon && closest_end_polygon) {
-				gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
-				new_polygon.id = polygon_count++;
-				new_polygon.owner = link;
-
-				new_polygon.edges.clear();
-				new_polygon.edges.resize(4);
-				new_polygon.points.clear();
-				new_polygon.points.reserve(4);
-
-				// Build a set of vertices that create a thin polygon going from the start to the end point.
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-
-				// Setup connections to go forward in the link.
-				{
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[0].pos;
-					entry_connection.pathway_end = new_polygon.points[1].pos;
-					closest_start_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_end_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[2].pos;
-					exit_connection.pathway_end = new_polygon.points[3].pos;
-					new_polygon.edges[2].connections.push_back(exit_connection);
+			return closest_start_distance * closest_start_distance;
+		};
+		iteration.polygons_index.query_nearest(AABB(start, Vector3()), link_connection_radius_sqr, start_callback);
+
+		// Find any polygons within the search radius of the end point.
+		auto end_callback = [&](uint32_t p_polygon_index) -> real_t {
+			gd::Polygon &end_poly = iteration.polygons[p_polygon_index];
+
+			// For each face check the distance to the end
+			for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
+				const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
+				const Vector3 end_point = end_face.get_closest_point_to(end);
+				const real_t end_distance = end_point.distance_to(end);
+
+				// Pick the polygon that is within our radius and is closer than anything we've seen yet.
+				if (end_distance <= build.link_connection_radius && (end_distance < closest_end_distance || (end_distance == closest_end_distance && closest_end_polygon && end_poly.id < closest_end_polygon->id))) {
+					closest_end_distance = end_distance;
+					closest_end_point = end_point;
+					closest_end_polygon = &end_poly;
 				}
+			}
+			return closest_end_distance * closest_end_distance;
+		};
+		iteration.polygons_index.query_nearest(AABB(end, Vector3()), link_connection_radius_sqr, end_callback);
+
+		// If we have both a start and end point, then create a synthetic polygon to route through.
+		if (closest_start_polygon && closest_end_polygon) {
+			gd::Polygon &new_polygon = iteration.link_polygons[link_poly_idx++];
+			new_polygon.id = polygon_count++;
+			new_polygon.owner = build_link.link;
+
+			new_polygon.edges.clear();
+			new_polygon.edges.resize(4);
+			new_polygon.points.clear();
+			new_polygon.points.reserve(4);
+
+			// Build a set of vertices that create a thin polygon going from the start to the end point.
+			new_polygon.points.push_back({ closest_start_point, build_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_start_point, build_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_end_point, build_point_key(closest_end_point) });
+			new_polygon.points.push_back({ closest_end_point, build_point_key(closest_end_point) });
+
+			// Setup connections to go forward in the link.
+			{
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[0].pos;
+				entry_connection.pathway_end = new_polygon.points[1].pos;
+				closest_start_polygon->edges[0].connections.push_back(entry_connection);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_end_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[2].pos;
+				exit_connection.pathway_end = new_polygon.points[3].pos;
+				new_polygon.edges[2].connections.push_back(exit_connection);
+			}
 
-				// If the link is bi-directional, create connections from the end to the start.
-				if (link->is_bidirectional()) {
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[2].pos;
-					entry_connection.pathway_end = new_polygon.points[3].pos;
-					closest_end_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_start_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[0].pos;
-					exit_connection.pathway_end = new_polygon.points[1].pos;
-					new_polygon.edges[0].connections.push_back(exit_connection);
-				}
+			// If the link is bi-directional, create connections from the end to the start.
+			if (build_link.bidirectional) {
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[2].pos;
+				entry_connection.pathway_end = new_polygon.points[3].pos;
+				closest_end_polygon->edges[0].connections.push_back(entry_connection);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_start_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[0].pos;
+				exit_connection.pathway_end = new_polygon.points[1].pos;
+				new_polygon.edges[0].connections.push_back(exit_connection);
 			}
 		}
-
-		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
-		iteration_id = iteration_id % UINT32_MAX + 1;
 	}
 
-	// Do we have modified obstacle positions?
-	for (NavObstacle *obstacle : obstacles) {
-		if (obstacle->check_dirty()) {
-			obstacles_dirty = true;
-		}
+	iteration.link_polygons_count = link_poly_idx;
+
+	if (build.use_hierarchical_pathfinding) {
+		iteration.hierarchy.build(iteration.polygons, iteration.link_polygons, link_poly_idx, iteration.polygons_index, build.use_threads);
+	} else {
+		iteration.hierarchy.clear();
 	}
-	// Do we have modified agent arrays?
-	for (NavAgent *agent : agents) {
-		if (agent->check_dirty()) {
-			agents_dirty = true;
-		}
+}
+
+void NavMap::_finish_iteration_build(bool p_discard) {
+	if (iteration_build.task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(iteration_build.task_id);
+		iteration_build.task_id = WorkerThreadPool::INVALID_TASK_ID;
+	} else if (p_discard) {
+		return;
 	}
 
-	// Update avoidance worlds.
-	if (obstacles_dirty || agents_dirty) {
-		_update_rvo_simulation();
+	if (p_discard) {
+		// Rebuild it with the next sync.
+		regenerate_links = true;
+		return;
 	}
 
-	regenerate_polygons = false;
-	regenerate_links = false;
-	obstacles_dirty = false;
-	agents_dirty = false;
+	// Swapping the iterations is all the queries wait for.
+	RWLockWrite write_lock(map_rwlock);
 
-	// Performance Monitor.
-	pm_region_count = _new_pm_region_count;
-	pm_agent_count = _new_pm_agent_count;
-	pm_link_count = _new_pm_link_count;
-	pm_polygon_count = _new_pm_polygon_count;
-	pm_edge_count = _new_pm_edge_count;
-	pm_edge_merge_count = _new_pm_edge_merge_count;
-	pm_edge_connection_count = _new_pm_edge_connection_count;
-	pm_edge_free_count = _new_pm_edge_free_count;
-	pm_obstacle_count = _new_pm_obstacle_count;
+	iteration_index = (iteration_index + 1) % 2;
+
+	_clear_flow_fields();
+
+	// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
+	iteration_id = iteration_id % UINT32_MAX + 1;
 }
 
 void NavMap::_update_rvo_obstacles_tree_2d() {
@@ -762,24 +1046,22 @@ void NavMap::_update_rvo_obstacles_tree_2d() {
 	rvo_simulation_2d.kdTree_->buildObstacleTree(raw_obstacles);
 }
 
-void NavMap::_update_rvo_agents_tree_2d() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO2D::Agent2D *> raw_agents;
+void NavMap::_update_rvo_agents_grid_2d() {
+	LocalVector<RVO2D::Agent2D *> raw_agents;
 	raw_agents.reserve(active_2d_avoidance_agents.size());
 	for (NavAgent *agent : active_2d_avoidance_agents) {
 		raw_agents.push_back(agent->get_rvo_agent_2d());
 	}
-	rvo_simulation_2d.kdTree_->buildAgentTree(raw_agents);
+	avoidance_grid_2d.build(raw_agents, use_threads && avoidance_use_multiple_threads);
 }
 
-void NavMap::_update_rvo_agents_tree_3d() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO3D::Agent3D *> raw_agents;
+void NavMap::_update_rvo_agents_grid_3d() {
+	LocalVector<RVO3D::Agent3D *> raw_agents;
 	raw_agents.reserve(active_3d_avoidance_agents.size());
 	for (NavAgent *agent : active_3d_avoidance_agents) {
 		raw_agents.push_back(agent->get_rvo_agent_3d());
 	}
-	rvo_simulation_3d.kdTree_->buildAgentTree(raw_agents);
+	avoidance_grid_3d.build(raw_agents, use_threads && avoidance_use_multiple_threads);
 }
 
 void NavMap::_update_rvo_simulation() {
@@ -787,20 +1069,39 @@ void NavMap::_update_rvo_simulation() {
 		_update_rvo_obstacles_tree_2d();
 	}
 	if (agents_dirty) {
-		_update_rvo_agents_tree_2d();
-		_update_rvo_agents_tree_3d();
+		_update_rvo_agents_grid_2d();
+		_update_rvo_agents_grid_3d();
+	}
+}
+
+// Same as the RVO2 computeNeighbors(), with the agents found in the grid instead of the agent trees.
+void NavMap::_compute_avoidance_neighbors_2d(RVO2D::Agent2D *p_agent) const {
+	p_agent->obstacleNeighbors_.clear();
+	const float obstacle_range = p_agent->timeHorizonObst_ * p_agent->maxSpeed_ + p_agent->radius_;
+	rvo_simulation_2d.kdTree_->computeObstacleNeighbors(p_agent, obstacle_range * obstacle_range);
+
+	p_agent->agentNeighbors_.clear();
+	if (p_agent->maxNeighbors_ > 0) {
+		avoidance_grid_2d.compute_agent_neighbors(p_agent, p_agent->neighborDist_ * p_agent->neighborDist_);
+	}
+}
+
+void NavMap::_compute_avoidance_neighbors_3d(RVO3D::Agent3D *p_agent) const {
+	p_agent->agentNeighbors_.clear();
+	if (p_agent->maxNeighbors_ > 0) {
+		avoidance_grid_3d.compute_agent_neighbors(p_agent, p_agent->neighborDist_ * p_agent->neighborDist_);
 	}
 }
 
 void NavMap::compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent) {
-	(*(agent + index))->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
+	_compute_avoidance_neighbors_2d((*(agent + index))->get_rvo_agent_2d());
 	(*(agent + index))->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
 	(*(agent + index))->get_rvo_agent_2d()->update(&rvo_simulation_2d);
 	(*(agent + index))->update();
 }
 
 void NavMap::compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent) {
-	(*(agent + index))->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
+	_compute_avoidance_neighbors_3d((*(agent + index))->get_rvo_agent_3d());
 	(*(agent + index))->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
 	(*(agent + index))->get_rvo_agent_3d()->update(&rvo_simulation_3d);
 	(*(agent + index))->update();
@@ -818,7 +1119,7 @@ void NavMap::step(real_t p_deltatime) {
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
 			for (NavAgent *agent : active_2d_avoidance_agents) {
-				agent->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
+				_compute_avoidance_neighbors_2d(agent->get_rvo_agent_2d());
 				agent->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
 				agent->get_rvo_agent_2d()->update(&rvo_simulation_2d);
 				agent->update();
@@ -832,7 +1133,7 @@ void NavMap::step(real_t p_deltatime) {
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
 			for (NavAgent *agent : active_3d_avoidance_agents) {
-				agent->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
+				_compute_avoidance_neighbors_3d(agent->get_rvo_agent_3d());
 				agent->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
 				agent->get_rvo_agent_3d()->update(&rvo_simulation_3d);
 				agent->update();
@@ -859,7 +1160,7 @@ void NavMap::_update_merge_rasterizer_cell_dimensions() {
 int NavMap::get_region_connections_count(NavRegion *p_region) const {
 	ERR_FAIL_NULL_V(p_region, 0);
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = region_external_connections.find(p_region);
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = iterations[iteration_index].region_external_connections.find(p_region);
 	if (found_connections) {
 		return found_connections->value.size();
 	}
@@ -869,7 +1170,7 @@ int NavMap::get_region_connections_count(NavRegion *p_region) const {
 Vector3 NavMap::get_region_connection_pathway_start(NavRegion *p_region, int p_connection_id) const {
 	ERR_FAIL_NULL_V(p_region, Vector3());
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = region_external_connections.find(p_region);
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = iterations[iteration_index].region_external_connections.find(p_region);
 	if (found_connections) {
 		ERR_FAIL_INDEX_V(p_connection_id, int(found_connections->value.size()), Vector3());
 		return found_connections->value[p_connection_id].pathway_start;
@@ -881,7 +1182,7 @@ Vector3 NavMap::get_region_connection_pathway_start(NavRegion *p_region, int p_c
 Vector3 NavMap::get_region_connection_pathway_end(NavRegion *p_region, int p_connection_id) const {
 	ERR_FAIL_NULL_V(p_region, Vector3());
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = region_external_connections.find(p_region);
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = iterations[iteration_index].region_external_connections.find(p_region);
 	if (found_connections) {
 		ERR_FAIL_INDEX_V(p_connection_id, int(found_connections->value.size()), Vector3());
 		return found_connections->value[p_connection_id].pathway_end;
@@ -896,4 +1197,6 @@ NavMap::NavMap() {
 }
 
 NavMap::~NavMap() {
+	_finish_iteration_build(true);
+	_clear_flow_fields();
 }
@@ -31,6 +31,10 @@
 #ifndef NAV_MAP_H
 #define NAV_MAP_H
 
+#include "nav_avoidance_grid.h"
+#include "nav_flow_field.h"
+#include "nav_hierarchy.h"
+#include "nav_polygon_index.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 
@@ -80,15 +84,86 @@ class NavMap : public NavRid {
 
 	/// Map links
 	LocalVector<NavLink *> links;
-	LocalVector<gd::Polygon> link_polygons;
 
-	/// Map polygons
-	LocalVector<gd::Polygon> polygons;
+	/// Coarse graph over the polygons, used to plan long paths.
+	bool use_hierarchical_pathfinding = false;
+
+	/// Polygons and connections of the map, which all the queries run on.
+	/// There are two of them, so the next one can be built while the queries keep using the current one.
+	struct Iteration {
+		LocalVector<gd::Polygon> polygons;
+		NavPolygonIndex polygons_index;
+
+		LocalVector<gd::Polygon> link_polygons;
+		/// Number of `link_polygons` in use, the others are left over from previous builds.
+		uint32_t link_polygons_count = 0;
+
+		NavHierarchy hierarchy;
+
+		HashMap<NavRegion *, LocalVector<gd::Edge::Connection>> region_external_connections;
+
+		int pm_polygon_count = 0;
+		int pm_edge_count = 0;
+		int pm_edge_merge_count = 0;
+		int pm_edge_connection_count = 0;
+		int pm_edge_free_count = 0;
+	};
+	Iteration iterations[2];
+	uint32_t iteration_index = 0;
+
+	/// What the next iteration is built from. It is copied from the map, its regions and its links
+	/// when the build starts, so the build doesn't read them while they change.
+	struct IterationBuild {
+		struct Region {
+			NavRegion *region = nullptr;
+			bool use_edge_connections = true;
+			uint32_t polygons_offset = 0;
+		};
+
+		struct Link {
+			const NavLink *link = nullptr;
+			Vector3 start;
+			Vector3 end;
+			bool bidirectional = true;
+		};
+
+		LocalVector<Region> regions;
+		LocalVector<Link> links;
+
+		bool use_edge_connections = true;
+		real_t edge_connection_margin = 0.0;
+		real_t link_connection_radius = 0.0;
+		bool use_hierarchical_pathfinding = false;
+		bool use_threads = true;
+		real_t merge_rasterizer_cell_size = 0.0;
+		real_t merge_rasterizer_cell_height = 0.0;
+
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+	};
+	IterationBuild iteration_build;
+
+	/// Build the iterations on a worker thread instead of during the sync.
+	bool use_async_iterations = false;
+	/// Set when a region or link leaves the map, the next iteration can't wait as the current one still references it.
+	bool iteration_build_blocking = false;
+
+	/// Flow fields of recent path destinations, shared by all the queries heading there.
+	/// They are built on demand and discarded whenever the polygons change.
+	mutable RWLock flow_fields_rwlock;
+	mutable LocalVector<NavFlowField *> flow_fields;
+	mutable SafeNumeric<uint64_t> flow_fields_tick;
+	static constexpr uint32_t MAX_FLOW_FIELDS = 8;
+	/// Fields used within this many queries are not replaced, so that more destinations than fields don't keep evicting each other.
+	static constexpr uint64_t FLOW_FIELD_REUSE_TICKS = MAX_FLOW_FIELDS * 4;
 
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
 	RVO3D::RVOSimulator3D rvo_simulation_3d;
 
+	/// Grids used to find the avoidance agent neighbors, they replace the agent trees of the RVO worlds.
+	NavAvoidanceGrid2D avoidance_grid_2d;
+	NavAvoidanceGrid3D avoidance_grid_3d;
+
 	/// avoidance controlled agents
 	LocalVector<NavAgent *> active_2d_avoidance_agents;
 	LocalVector<NavAgent *> active_3d_avoidance_agents;
@@ -119,15 +194,8 @@ class NavMap : public NavRid {
 	int pm_region_count = 0;
 	int pm_agent_count = 0;
 	int pm_link_count = 0;
-	int pm_polygon_count = 0;
-	int pm_edge_count = 0;
-	int pm_edge_merge_count = 0;
-	int pm_edge_connection_count = 0;
-	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>> region_external_connections;
-
 public:
 	NavMap();
 	~NavMap();
@@ -157,6 +225,16 @@ public:
 		return use_edge_connections;
 	}
 
+	void set_use_hierarchical_pathfinding(bool p_enabled);
+	bool get_use_hierarchical_pathfinding() const {
+		return use_hierarchical_pathfinding;
+	}
+
+	void set_use_async_iterations(bool p_enabled);
+	bool get_use_async_iterations() const {
+		return use_async_iterations;
+	}
+
 	void set_edge_connection_margin(real_t p_edge_connection_margin);
 	real_t get_edge_connection_margin() const {
 		return edge_connection_margin;
@@ -169,7 +247,8 @@ public:
 
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
-	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, uint32_t *r_explored_polygon_count = nullptr) const;
+	Vector<Vector3> get_flow_field_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, uint32_t *r_explored_polygon_count = nullptr) const;
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
@@ -207,7 +286,7 @@ public:
 
 	Vector3 get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const;
 
-	void sync();
+	void sync(bool p_wait_for_iteration = false);
 	void step(real_t p_deltatime);
 	void dispatch_callbacks();
 
@@ -215,11 +294,11 @@ public:
 	int get_pm_region_count() const { return pm_region_count; }
 	int get_pm_agent_count() const { return pm_agent_count; }
 	int get_pm_link_count() const { return pm_link_count; }
-	int get_pm_polygon_count() const { return pm_polygon_count; }
-	int get_pm_edge_count() const { return pm_edge_count; }
-	int get_pm_edge_merge_count() const { return pm_edge_merge_count; }
-	int get_pm_edge_connection_count() const { return pm_edge_connection_count; }
-	int get_pm_edge_free_count() const { return pm_edge_free_count; }
+	int get_pm_polygon_count() const { return iterations[iteration_index].pm_polygon_count; }
+	int get_pm_edge_count() const { return iterations[iteration_index].pm_edge_count; }
+	int get_pm_edge_merge_count() const { return iterations[iteration_index].pm_edge_merge_count; }
+	int get_pm_edge_connection_count() const { return iterations[iteration_index].pm_edge_connection_count; }
+	int get_pm_edge_free_count() const { return iterations[iteration_index].pm_edge_free_count; }
 	int get_pm_obstacle_count() const { return pm_obstacle_count; }
 
 	int get_region_connections_count(NavRegion *p_region) const;
@@ -234,10 +313,19 @@ private:
 
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree_2d();
-	void _update_rvo_agents_tree_2d();
-	void _update_rvo_agents_tree_3d();
+	void _update_rvo_agents_grid_2d();
+	void _update_rvo_agents_grid_3d();
+
+	void _compute_avoidance_neighbors_2d(RVO2D::Agent2D *p_agent) const;
+	void _compute_avoidance_neighbors_3d(RVO3D::Agent3D *p_agent) const;
 
 	void _update_merge_rasterizer_cell_dimensions();
+
+	void _clear_flow_fields();
+
+	void _start_iteration_build();
+	void _build_iteration(void *p_unused);
+	void _finish_iteration_build(bool p_discard);
 };
 
 #endif // NAV_MAP_H
@@ -0,0 +1,204 @@
+/**************************************************************************/
+/*  nav_polygon_index.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_polygon_index.h"
+
+#include "core/templates/sort_array.h"
+
+struct NavPolygonIndexCenterComparator {
+	const Vector3 *centers = nullptr;
+	int axis = 0;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return centers[p_a][axis] < centers[p_b][axis];
+	}
+};
+
+AABB NavPolygonIndex::get_polygon_aabb(const gd::Polygon &p_polygon) {
+	if (p_polygon.points.is_empty()) {
+		return AABB();
+	}
+
+	AABB aabb(p_polygon.points[0].pos, Vector3());
+	for (uint32_t i = 1; i < p_polygon.points.size(); i++) {
+		aabb.expand_to(p_polygon.points[i].pos);
+	}
+	return aabb;
+}
+
+real_t NavPolygonIndex::get_aabb_distance_squared(const AABB &p_a, const AABB &p_b) {
+	real_t distance_squared = 0.0;
+	for (int i = 0; i < 3; i++) {
+		const real_t gap = MAX(p_a.position[i] - (p_b.position[i] + p_b.size[i]), p_b.position[i] - (p_a.position[i] + p_a.size[i]));
+		if (gap > 0.0) {
+			distance_squared += gap * gap;
+		}
+	}
+	return distance_squared;
+}
+
+void NavPolygonIndex::Tree::build(const LocalVector<AABB> &p_aabbs) {
+	nodes.clear();
+	items.resize(p_aabbs.size());
+	item_aabbs.clear();
+	if (p_aabbs.is_empty()) {
+		return;
+	}
+
+	LocalVector<Vector3> centers;
+	centers.resize(p_aabbs.size());
+	for (uint32_t i = 0; i < p_aabbs.size(); i++) {
+		items[i] = i;
+		centers[i] = p_aabbs[i].get_center();
+	}
+
+	// A balanced tree has at most twice as many nodes as it has leaves.
+	nodes.reserve(2 * (p_aabbs.size() / MAX_LEAF_ITEMS + 1));
+	nodes.push_back(Node());
+	_build_node(0, 0, p_aabbs.size(), p_aabbs, centers);
+
+	item_aabbs.resize(items.size());
+	for (uint32_t i = 0; i < items.size(); i++) {
+		item_aabbs[i] = p_aabbs[items[i]];
+	}
+}
+
+void NavPolygonIndex::Tree::_build_node(uint32_t p_node, uint32_t p_first, uint32_t p_count, const LocalVector<AABB> &p_aabbs, const LocalVector<Vector3> &p_centers) {
+	AABB aabb = p_aabbs[items[p_first]];
+	AABB center_bounds(p_centers[items[p_first]], Vector3());
+	for (uint32_t i = p_first + 1; i < p_first + p_count; i++) {
+		aabb.merge_with(p_aabbs[items[i]]);
+		center_bounds.expand_to(p_centers[items[i]]);
+	}
+	nodes[p_node].aabb = aabb;
+
+	if (p_count <= MAX_LEAF_ITEMS) {
+		nodes[p_node].first = p_first;
+		nodes[p_node].count = p_count;
+		return;
+	}
+
+	// Split at the median along the axis where the polygons are the most spread out.
+	SortArray<uint32_t, NavPolygonIndexCenterComparator> sorter;
+	sorter.compare.centers = p_centers.ptr();
+	sorter.compare.axis = center_bounds.get_longest_axis_index();
+	const uint32_t half = p_count / 2;
+	sorter.nth_element(p_first, p_first + p_count, p_first + half, items.ptr());
+
+	const uint32_t children = nodes.size();
+	nodes.resize(children + 2);
+	nodes[p_node].first = children;
+	nodes[p_node].count = 0;
+
+	_build_node(children, p_first, half, p_aabbs, p_centers);
+	_build_node(children + 1, p_first + half, p_count - half, p_aabbs, p_centers);
+}
+
+void NavPolygonIndex::Tree::get_clusters(uint32_t p_node, uint32_t p_max_cluster_size, uint32_t p_polygon_offset, uint32_t &r_cluster_count, LocalVector<uint32_t> &r_polygon_clusters) const {
+	// The items of a subtree are contiguous, from its leftmost leaf to its rightmost leaf.
+	uint32_t first_leaf = p_node;
+	while (nodes[first_leaf].count == 0) {
+		first_leaf = nodes[first_leaf].first;
+	}
+	uint32_t last_leaf = p_node;
+	while (nodes[last_leaf].count == 0) {
+		last_leaf = nodes[last_leaf].first + 1;
+	}
+	const uint32_t items_begin = nodes[first_leaf].first;
+	const uint32_t items_end = nodes[last_leaf].first + nodes[last_leaf].count;
+
+	if (items_end - items_begin <= p_max_cluster_size || nodes[p_node].count > 0) {
+		for (uint32_t i = items_begin; i < items_end; i++) {
+			r_polygon_clusters[p_polygon_offset + items[i]] = r_cluster_count;
+		}
+		r_cluster_count++;
+		return;
+	}
+
+	get_clusters(nodes[p_node].first, p_max_cluster_size, p_polygon_offset, r_cluster_count, r_polygon_clusters);
+	get_clusters(nodes[p_node].first + 1, p_max_cluster_size, p_polygon_offset, r_cluster_count, r_polygon_clusters);
+}
+
+void NavPolygonIndex::build(const LocalVector<gd::Polygon> &p_polygons) {
+	clear();
+
+	LocalVector<AABB> aabbs;
+	aabbs.resize(p_polygons.size());
+	for (uint32_t i = 0; i < p_polygons.size(); i++) {
+		aabbs[i] = get_polygon_aabb(p_polygons[i]);
+	}
+
+	Region region;
+	region.tree.build(aabbs);
+	regions.push_back(region);
+	update();
+}
+
+void NavPolygonIndex::add_index(const NavPolygonIndex &p_index, uint32_t p_polygon_offset) {
+	for (const Region &region : p_index.regions) {
+		regions.push_back(region);
+		regions[regions.size() - 1].polygon_offset += p_polygon_offset;
+	}
+}
+
+void NavPolygonIndex::update() {
+	LocalVector<AABB> aabbs;
+	LocalVector<uint32_t> non_empty_regions;
+	for (uint32_t i = 0; i < regions.size(); i++) {
+		if (regions[i].tree.nodes.is_empty()) {
+			continue;
+		}
+		aabbs.push_back(regions[i].tree.nodes[0].aabb);
+		non_empty_regions.push_back(i);
+	}
+
+	region_tree.build(aabbs);
+	// Map the tree items back to the regions they were built from.
+	for (uint32_t &item : region_tree.items) {
+		item = non_empty_regions[item];
+	}
+}
+
+uint32_t NavPolygonIndex::get_clusters(uint32_t p_max_cluster_size, LocalVector<uint32_t> &r_polygon_clusters) const {
+	uint32_t cluster_count = 0;
+	for (const Region &region : regions) {
+		if (!region.tree.nodes.is_empty()) {
+			region.tree.get_clusters(0, p_max_cluster_size, region.polygon_offset, cluster_count, r_polygon_clusters);
+		}
+	}
+	return cluster_count;
+}
+
+void NavPolygonIndex::clear() {
+	regions.clear();
+	region_tree.nodes.clear();
+	region_tree.items.clear();
+	region_tree.item_aabbs.clear();
+}
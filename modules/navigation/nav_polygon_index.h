@@ -0,0 +1,217 @@
+/**************************************************************************/
+/*  nav_polygon_index.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_POLYGON_INDEX_H
+#define NAV_POLYGON_INDEX_H
+
+#include "nav_utils.h"
+
+#include "core/math/aabb.h"
+
+/**
+ * Spatial index over navigation polygons, used to find the polygons close to a
+ * point or inside an area without scanning every polygon.
+ *
+ * The index is made of one bounding volume hierarchy per region and a small
+ * hierarchy over the regions themselves, so a map only needs to rebuild the
+ * trees of the regions that changed. Items reported by the queries are
+ * polygon indices, offset by the position of each region in the polygon list.
+ */
+class NavPolygonIndex {
+	struct Node {
+		AABB aabb;
+		/// Leaves reference `count` items starting at `first`, internal nodes
+		/// reference their two children starting at `first`.
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+
+	struct Tree {
+		LocalVector<Node> nodes;
+		LocalVector<uint32_t> items;
+		/// Bounds of the items, in the same order as `items`.
+		LocalVector<AABB> item_aabbs;
+
+		void build(const LocalVector<AABB> &p_aabbs);
+
+		template <typename QueryCallback>
+		void query_aabb(const AABB &p_aabb, QueryCallback &p_callback) const;
+
+		template <typename QueryCallback>
+		void query_nearest(const AABB &p_aabb, real_t p_max_distance_squared, QueryCallback &p_callback) const;
+
+		void get_clusters(uint32_t p_node, uint32_t p_max_cluster_size, uint32_t p_polygon_offset, uint32_t &r_cluster_count, LocalVector<uint32_t> &r_polygon_clusters) const;
+
+	private:
+		void _build_node(uint32_t p_node, uint32_t p_first, uint32_t p_count, const LocalVector<AABB> &p_aabbs, const LocalVector<Vector3> &p_centers);
+	};
+
+	struct Region {
+		Tree tree;
+		uint32_t polygon_offset = 0;
+	};
+
+	LocalVector<Region> regions;
+	Tree region_tree;
+
+	static constexpr uint32_t MAX_LEAF_ITEMS = 4;
+	static constexpr uint32_t MAX_DEPTH = 64;
+
+public:
+	static AABB get_polygon_aabb(const gd::Polygon &p_polygon);
+	static real_t get_aabb_distance_squared(const AABB &p_a, const AABB &p_b);
+
+	/// Replaces the content of the index with a single region holding `p_polygons`.
+	void build(const LocalVector<gd::Polygon> &p_polygons);
+	/// Copies the region trees of `p_index`, offsetting their polygon indices by `p_polygon_offset`.
+	/// `update()` must be called once all the regions are added.
+	void add_index(const NavPolygonIndex &p_index, uint32_t p_polygon_offset);
+	/// Rebuilds the hierarchy over the regions.
+	void update();
+	void clear();
+
+	bool is_empty() const { return region_tree.nodes.is_empty(); }
+
+	/// Groups the polygons of each region into spatially coherent clusters of at
+	/// most `p_max_cluster_size` polygons. Writes the cluster of each polygon in
+	/// `r_polygon_clusters`, which must be large enough to hold every polygon, and
+	/// returns the number of clusters.
+	uint32_t get_clusters(uint32_t p_max_cluster_size, LocalVector<uint32_t> &r_polygon_clusters) const;
+
+	/// Calls `p_callback(polygon_index)` for every polygon whose bounds overlap `p_aabb`.
+	template <typename QueryCallback>
+	void query_aabb(const AABB &p_aabb, QueryCallback &p_callback) const;
+
+	/// Calls `p_callback(polygon_index)` for the polygons whose bounds are within
+	/// reach of `p_aabb`, closest first. The callback returns the squared distance
+	/// of the best candidate found so far, which prunes the remaining polygons.
+	template <typename QueryCallback>
+	void query_nearest(const AABB &p_aabb, real_t p_max_distance_squared, QueryCallback &p_callback) const;
+};
+
+template <typename QueryCallback>
+void NavPolygonIndex::Tree::query_aabb(const AABB &p_aabb, QueryCallback &p_callback) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	uint32_t stack[MAX_DEPTH * 2];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (!node.aabb.intersects_inclusive(p_aabb)) {
+			continue;
+		}
+		if (node.count > 0) {
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				if (item_aabbs[i].intersects_inclusive(p_aabb)) {
+					p_callback(items[i]);
+				}
+			}
+		} else {
+			stack[stack_size++] = node.first + 1;
+			stack[stack_size++] = node.first;
+		}
+	}
+}
+
+template <typename QueryCallback>
+void NavPolygonIndex::Tree::query_nearest(const AABB &p_aabb, real_t p_max_distance_squared, QueryCallback &p_callback) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	struct StackEntry {
+		uint32_t node;
+		real_t distance_squared;
+	};
+
+	StackEntry stack[MAX_DEPTH * 2];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = { 0, get_aabb_distance_squared(nodes[0].aabb, p_aabb) };
+
+	real_t max_distance_squared = p_max_distance_squared;
+	while (stack_size > 0) {
+		const StackEntry entry = stack[--stack_size];
+		if (entry.distance_squared > max_distance_squared) {
+			continue;
+		}
+
+		const Node &node = nodes[entry.node];
+		if (node.count > 0) {
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				if (get_aabb_distance_squared(item_aabbs[i], p_aabb) <= max_distance_squared) {
+					max_distance_squared = MIN(max_distance_squared, p_callback(items[i]));
+				}
+			}
+			continue;
+		}
+
+		// Push the farthest child first so the closest one is visited next.
+		StackEntry child_a = { node.first, get_aabb_distance_squared(nodes[node.first].aabb, p_aabb) };
+		StackEntry child_b = { node.first + 1, get_aabb_distance_squared(nodes[node.first + 1].aabb, p_aabb) };
+		if (child_a.distance_squared < child_b.distance_squared) {
+			SWAP(child_a, child_b);
+		}
+		stack[stack_size++] = child_a;
+		stack[stack_size++] = child_b;
+	}
+}
+
+template <typename QueryCallback>
+void NavPolygonIndex::query_aabb(const AABB &p_aabb, QueryCallback &p_callback) const {
+	auto region_callback = [&](uint32_t p_region) {
+		const Region &region = regions[p_region];
+		auto polygon_callback = [&](uint32_t p_polygon) {
+			p_callback(region.polygon_offset + p_polygon);
+		};
+		region.tree.query_aabb(p_aabb, polygon_callback);
+	};
+	region_tree.query_aabb(p_aabb, region_callback);
+}
+
+template <typename QueryCallback>
+void NavPolygonIndex::query_nearest(const AABB &p_aabb, real_t p_max_distance_squared, QueryCallback &p_callback) const {
+	real_t max_distance_squared = p_max_distance_squared;
+	auto region_callback = [&](uint32_t p_region) -> real_t {
+		const Region &region = regions[p_region];
+		auto polygon_callback = [&](uint32_t p_polygon) -> real_t {
+			max_distance_squared = MIN(max_distance_squared, p_callback(region.polygon_offset + p_polygon));
+			return max_distance_squared;
+		};
+		region.tree.query_nearest(p_aabb, max_distance_squared, polygon_callback);
+		return max_distance_squared;
+	};
+	region_tree.query_nearest(p_aabb, max_distance_squared, region_callback);
+}
+
+#endif // NAV_POLYGON_INDEX_H
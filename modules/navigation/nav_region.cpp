@@ -109,13 +109,13 @@ Vector3 NavRegion::get_closest_point_to_segment(const Vector3 &p_from, const Vec
 	RWLockRead read_lock(region_rwlock);
 
 	return NavMeshQueries3D::polygons_get_closest_point_to_segment(
-			get_polygons(), p_from, p_to, p_use_collision);
+			get_polygons(), get_polygons_index(), p_from, p_to, p_use_collision);
 }
 
 gd::ClosestPointQueryResult NavRegion::get_closest_point_info(const Vector3 &p_point) const {
 	RWLockRead read_lock(region_rwlock);
 
-	return NavMeshQueries3D::polygons_get_closest_point_info(get_polygons(), p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_info(get_polygons(), get_polygons_index(), p_point);
 }
 
 Vector3 NavRegion::get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const {
@@ -143,6 +143,9 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	polygons_index.clear();
+	merged_edges.clear();
+	border_edges.clear();
 	surface_area = 0.0;
 	polygons_dirty = false;
 
@@ -219,4 +222,49 @@ void NavRegion::update_polygons() {
 	}
 
 	surface_area = _new_region_surface_area;
+
+	polygons_index.build(polygons);
+
+	update_edges();
+}
+
+void NavRegion::update_edges() {
+	struct EdgeEntry {
+		gd::PolygonEdge edge;
+		uint32_t count = 0;
+	};
+
+	// Group the edges per key, like the map does for the edges of different regions.
+	HashMap<gd::EdgeKey, EdgeEntry, gd::EdgeKey> edges;
+	for (uint32_t polygon_index = 0; polygon_index < polygons.size(); polygon_index++) {
+		const gd::Polygon &polygon = polygons[polygon_index];
+		for (uint32_t p = 0; p < polygon.points.size(); p++) {
+			const gd::EdgeKey ek(polygon.points[p].key, polygon.points[(p + 1) % polygon.points.size()].key);
+
+			EdgeEntry *entry = edges.getptr(ek);
+			if (!entry) {
+				EdgeEntry new_entry;
+				new_entry.edge.polygon = polygon_index;
+				new_entry.edge.edge = p;
+				new_entry.count = 1;
+				edges.insert(ek, new_entry);
+			} else if (entry->count == 1) {
+				gd::MergedEdge merged_edge;
+				merged_edge.a = entry->edge;
+				merged_edge.b.polygon = polygon_index;
+				merged_edge.b.edge = p;
+				merged_edges.push_back(merged_edge);
+				entry->count = 2;
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+			}
+		}
+	}
+
+	for (const KeyValue<gd::EdgeKey, EdgeEntry> &E : edges) {
+		if (E.value.count == 1) {
+			border_edges.push_back(E.value.edge);
+		}
+	}
 }
@@ -32,6 +32,7 @@
 #define NAV_REGION_H
 
 #include "nav_base.h"
+#include "nav_polygon_index.h"
 #include "nav_utils.h"
 
 #include "core/os/rw_lock.h"
@@ -50,6 +51,12 @@ class NavRegion : public NavBase {
 
 	/// Cache
 	LocalVector<gd::Polygon> polygons;
+	NavPolygonIndex polygons_index;
+
+	/// Edges shared by two polygons of the region, the map connects them without searching for them.
+	LocalVector<gd::MergedEdge> merged_edges;
+	/// Edges on the border of the region, the only ones the map needs to match with other regions.
+	LocalVector<gd::PolygonEdge> border_edges;
 
 	real_t surface_area = 0.0;
 
@@ -90,6 +97,18 @@ public:
 		return polygons;
 	}
 
+	const NavPolygonIndex &get_polygons_index() const {
+		return polygons_index;
+	}
+
+	const LocalVector<gd::MergedEdge> &get_merged_edges() const {
+		return merged_edges;
+	}
+
+	const LocalVector<gd::PolygonEdge> &get_border_edges() const {
+		return border_edges;
+	}
+
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, bool p_use_collision) const;
 	gd::ClosestPointQueryResult get_closest_point_info(const Vector3 &p_point) const;
 	Vector3 get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const;
@@ -100,6 +119,7 @@ public:
 
 private:
 	void update_polygons();
+	void update_edges();
 };
 
 #endif // NAV_REGION_H
@@ -113,6 +113,18 @@ struct Polygon {
 	real_t surface_area = 0.0;
 };
 
+/// Edge of a polygon, referenced by indices so it stays valid when the polygons are copied.
+struct PolygonEdge {
+	uint32_t polygon = 0;
+	uint32_t edge = 0;
+};
+
+/// Two polygon edges with the same points, which are connected to each other.
+struct MergedEdge {
+	PolygonEdge a;
+	PolygonEdge b;
+};
+
 struct NavigationPoly {
 	/// This poly.
 	const Polygon *poly = nullptr;
@@ -0,0 +1,265 @@
+/**************************************************************************/
+/*  test_navigation_benchmark_3d.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAVIGATION_BENCHMARK_3D_H
+#define TEST_NAVIGATION_BENCHMARK_3D_H
+
+#include "core/io/json.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/resources/navigation_mesh.h"
+#include "servers/navigation/navigation_path_query_parameters_3d.h"
+#include "servers/navigation/navigation_path_query_result_3d.h"
+#include "servers/navigation_server_3d.h"
+
+#include "tests/test_macros.h"
+
+// Benchmark scenes for the 3D navigation server. Each one prints a single line of JSON with its timings, so runs
+// can be compared by scripts:
+//   godot --headless --test --test-case="[Benchmark][NavigationBenchmark3D]*" --no-skip
+namespace TestNavigationBenchmark3D {
+
+static real_t get_terrain_height(real_t p_x, real_t p_z) {
+	return Math::sin(p_x * 0.05) * Math::cos(p_z * 0.07) * 4.0;
+}
+
+// Holes in the terrain that paths have to go around: scattered single cells, and long walls with a few gaps.
+static bool is_terrain_blocked(int p_x, int p_z) {
+	const uint32_t hash = hash_murmur3_one_32(p_z, hash_murmur3_one_32(p_x));
+	if (hash % 100 < 12) {
+		return true;
+	}
+	return p_z % 32 == 31 && (p_x * 13 + p_z) % 96 > 3;
+}
+
+class BenchmarkMap {
+	NavigationServer3D *server = nullptr;
+	RID map;
+	LocalVector<RID> rids;
+
+public:
+	NavigationServer3D *get_server() const { return server; }
+	RID get_map() const { return map; }
+
+	// Adds the terrain as a grid of square regions with one quad per cell. The regions connect through their
+	// shared border vertices.
+	LocalVector<RID> add_terrain(int p_region_count, int p_region_size) {
+		LocalVector<RID> regions;
+		for (int region_z = 0; region_z < p_region_count; region_z++) {
+			for (int region_x = 0; region_x < p_region_count; region_x++) {
+				const int origin_x = region_x * p_region_size;
+				const int origin_z = region_z * p_region_size;
+
+				Vector<Vector3> vertices;
+				for (int z = 0; z <= p_region_size; z++) {
+					for (int x = 0; x <= p_region_size; x++) {
+						vertices.push_back(Vector3(origin_x + x, get_terrain_height(origin_x + x, origin_z + z), origin_z + z));
+					}
+				}
+
+				Ref<NavigationMesh> navigation_mesh;
+				navigation_mesh.instantiate();
+				navigation_mesh->set_vertices(vertices);
+				for (int z = 0; z < p_region_size; z++) {
+					for (int x = 0; x < p_region_size; x++) {
+						if (is_terrain_blocked(origin_x + x, origin_z + z)) {
+							continue;
+						}
+						const int corner = z * (p_region_size + 1) + x;
+						Vector<int> polygon;
+						polygon.push_back(corner);
+						polygon.push_back(corner + p_region_size + 1);
+						polygon.push_back(corner + p_region_size + 2);
+						polygon.push_back(corner + 1);
+						navigation_mesh->add_polygon(polygon);
+					}
+				}
+
+				RID region = server->region_create();
+				server->region_set_map(region, map);
+				server->region_set_navigation_mesh(region, navigation_mesh);
+				rids.push_back(region);
+				regions.push_back(region);
+			}
+		}
+		return regions;
+	}
+
+	RID add_agent(const Vector3 &p_position, real_t p_radius) {
+		RID agent = server->agent_create();
+		server->agent_set_map(agent, map);
+		server->agent_set_avoidance_enabled(agent, true);
+		server->agent_set_radius(agent, p_radius);
+		server->agent_set_position(agent, p_position);
+		rids.push_back(agent);
+		return agent;
+	}
+
+	static void print_results(const String &p_name, Dictionary p_results) {
+		p_results["benchmark"] = "navigation_3d/" + p_name;
+		print_line(JSON::stringify(p_results));
+	}
+
+	BenchmarkMap() {
+		server = NavigationServer3D::get_singleton();
+		map = server->map_create();
+		server->map_set_active(map, true);
+	}
+
+	~BenchmarkMap() {
+		for (int64_t i = rids.size() - 1; i >= 0; i--) {
+			server->free(rids[i]);
+		}
+		server->free(map);
+		server->process(0.0); // Give server some cycles to commit.
+	}
+};
+
+TEST_SUITE("[Navigation]") {
+	TEST_CASE_BENCHMARK("[NavigationBenchmark3D] Map sync with large procedural regions") {
+		BenchmarkMap scene;
+		NavigationServer3D *server = scene.get_server();
+		const LocalVector<RID> regions = scene.add_terrain(4, 96);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		server->map_force_update(scene.get_map());
+		const uint64_t full_usec = OS::get_singleton()->get_ticks_usec() - begin;
+		server->process(0.0);
+
+		// Every change of a region rebuilds the map iteration.
+		const int change_count = 16;
+		uint64_t change_usec = 0;
+		for (int i = 0; i < change_count; i++) {
+			server->region_set_enabled(regions[i % regions.size()], i % 2 == 1);
+			begin = OS::get_singleton()->get_ticks_usec();
+			server->map_force_update(scene.get_map());
+			change_usec += OS::get_singleton()->get_ticks_usec() - begin;
+		}
+
+		Dictionary results;
+		results["regions"] = (int)regions.size();
+		results["polygons"] = server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT);
+		results["edges"] = server->get_process_info(NavigationServer3D::INFO_EDGE_COUNT);
+		results["edges_merged"] = server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT);
+		results["full_sync_usec"] = (double)full_usec;
+		results["region_change_sync_usec"] = double(change_usec) / change_count;
+		BenchmarkMap::print_results("map_sync", results);
+		CHECK_GT(server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), 0);
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationBenchmark3D] Path queries on a large procedural map") {
+		BenchmarkMap scene;
+		NavigationServer3D *server = scene.get_server();
+		const int region_count = 4;
+		const int region_size = 96;
+		scene.add_terrain(region_count, region_size);
+		server->map_force_update(scene.get_map());
+		server->process(0.0);
+
+		const real_t extent = region_count * region_size;
+		RandomPCG rng(1234);
+		Ref<NavigationPathQueryParameters3D> query_parameters;
+		query_parameters.instantiate();
+		query_parameters->set_map(scene.get_map());
+		query_parameters->set_metadata_flags(0);
+		Ref<NavigationPathQueryResult3D> query_result;
+		query_result.instantiate();
+
+		const int query_count = 200;
+		uint64_t query_usec = 0;
+		uint64_t max_query_usec = 0;
+		uint64_t explored_polygon_count = 0;
+		real_t path_length = 0.0;
+		int found_count = 0;
+		for (int i = 0; i < query_count; i++) {
+			const real_t start_x = rng.randf() * extent;
+			const real_t start_z = rng.randf() * extent;
+			const real_t target_x = rng.randf() * extent;
+			const real_t target_z = rng.randf() * extent;
+			query_parameters->set_start_position(Vector3(start_x, get_terrain_height(start_x, start_z), start_z));
+			query_parameters->set_target_position(Vector3(target_x, get_terrain_height(target_x, target_z), target_z));
+			server->query_path(query_parameters, query_result);
+
+			query_usec += query_result->get_query_time_usec();
+			max_query_usec = MAX(max_query_usec, query_result->get_query_time_usec());
+			explored_polygon_count += query_result->get_explored_polygon_count();
+			path_length += query_result->get_path_length();
+			found_count += query_result->get_path().size() > 1;
+		}
+
+		Dictionary results;
+		results["polygons"] = server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT);
+		results["queries"] = query_count;
+		results["query_usec"] = double(query_usec) / query_count;
+		results["max_query_usec"] = (double)max_query_usec;
+		results["explored_polygons"] = double(explored_polygon_count) / query_count;
+		results["path_length"] = path_length / query_count;
+		BenchmarkMap::print_results("path_queries", results);
+		CHECK_EQ(found_count, query_count);
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationBenchmark3D] Avoidance with many agents") {
+		BenchmarkMap scene;
+		NavigationServer3D *server = scene.get_server();
+
+		const int side = 100;
+		LocalVector<RID> agents;
+		for (int i = 0; i < side * side; i++) {
+			agents.push_back(scene.add_agent(Vector3((i % side) * 1.5, 0, (i / side) * 1.5), 0.5));
+		}
+
+		// Agents move every frame, so the avoidance neighbors are searched again each step.
+		const int step_count = 10;
+		uint64_t sync_usec = 0;
+		uint64_t avoidance_usec = 0;
+		for (int step = 0; step < step_count; step++) {
+			for (uint32_t i = 0; i < agents.size(); i++) {
+				const Vector3 position((i % side) * 1.5 + step * 0.1, 0, (i / side) * 1.5);
+				server->agent_set_position(agents[i], position);
+				server->agent_set_velocity(agents[i], (Vector3(side * 0.75, 0, side * 0.75) - position).normalized());
+			}
+			server->process(1.0 / 60.0);
+			sync_usec += server->get_process_info(NavigationServer3D::INFO_MAP_SYNC_TIME);
+			avoidance_usec += server->get_process_info(NavigationServer3D::INFO_AVOIDANCE_TIME);
+		}
+
+		Dictionary results;
+		results["agents"] = server->get_process_info(NavigationServer3D::INFO_AGENT_COUNT);
+		results["sync_usec"] = double(sync_usec) / step_count;
+		results["avoidance_usec"] = double(avoidance_usec) / step_count;
+		results["agents_per_msec"] = double(agents.size()) * step_count * 1000.0 / MAX(sync_usec + avoidance_usec, (uint64_t)1);
+		BenchmarkMap::print_results("avoidance", results);
+		CHECK_EQ(server->get_process_info(NavigationServer3D::INFO_AGENT_COUNT), (int)agents.size());
+	}
+}
+
+} // namespace TestNavigationBenchmark3D
+
+#endif // TEST_NAVIGATION_BENCHMARK_3D_H
@@ -0,0 +1,485 @@
+/**************************************************************************/
+/*  static_mesh_batch_3d.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "static_mesh_batch_3d.h"
+
+#include "core/object/worker_thread_pool.h"
+#include "scene/3d/lightmap_gi.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/3d/importer_mesh.h"
+#include "scene/resources/3d/skin.h"
+
+// Arrays which can't be merged by transforming them into the space of the batch.
+static const uint64_t UNBATCHABLE_FORMAT = Mesh::ARRAY_FORMAT_BONES | Mesh::ARRAY_FORMAT_WEIGHTS | Mesh::ARRAY_FORMAT_CUSTOM0 | Mesh::ARRAY_FORMAT_CUSTOM1 | Mesh::ARRAY_FORMAT_CUSTOM2 | Mesh::ARRAY_FORMAT_CUSTOM3;
+static const uint64_t MERGED_FORMAT = Mesh::ARRAY_FORMAT_NORMAL | Mesh::ARRAY_FORMAT_TANGENT | Mesh::ARRAY_FORMAT_COLOR | Mesh::ARRAY_FORMAT_TEX_UV | Mesh::ARRAY_FORMAT_TEX_UV2;
+
+void StaticMeshBatch3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_READY: {
+			if (batch_on_ready && !Engine::get_singleton()->is_editor_hint()) {
+				batch();
+			}
+		} break;
+
+		case NOTIFICATION_ENTER_WORLD: {
+			for (const Batch &b : batches) {
+				RS::get_singleton()->instance_set_scenario(b.instance, get_world_3d()->get_scenario());
+				RS::get_singleton()->instance_set_transform(b.instance, get_global_transform());
+			}
+		} break;
+
+		case NOTIFICATION_TRANSFORM_CHANGED: {
+			for (const Batch &b : batches) {
+				RS::get_singleton()->instance_set_transform(b.instance, get_global_transform());
+			}
+		} break;
+
+		case NOTIFICATION_VISIBILITY_CHANGED: {
+			for (const Batch &b : batches) {
+				RS::get_singleton()->instance_set_visible(b.instance, is_visible_in_tree());
+			}
+		} break;
+
+		case NOTIFICATION_EXIT_WORLD: {
+			for (const Batch &b : batches) {
+				RS::get_singleton()->instance_set_scenario(b.instance, RID());
+			}
+		} break;
+	}
+}
+
+bool StaticMeshBatch3D::_is_batchable(MeshInstance3D *p_mesh_instance, const HashSet<ObjectID> &p_lightmapped) const {
+	Ref<Mesh> mesh = p_mesh_instance->get_mesh();
+	if (mesh.is_null() || !p_mesh_instance->is_visible_in_tree()) {
+		return false;
+	}
+
+	// Skinned, morphed or faded instances have to keep drawing on their own.
+	if (p_mesh_instance->get_skin().is_valid() || mesh->get_blend_shape_count() > 0) {
+		return false;
+	}
+	if (p_mesh_instance->get_transparency() > 0.0 || p_mesh_instance->get_visibility_range_begin() > 0.0 || p_mesh_instance->get_visibility_range_end() > 0.0) {
+		return false;
+	}
+
+	// Per-instance settings the batch instance can't carry for each of its sources.
+	if (p_mesh_instance->get_material_overlay().is_valid() || p_mesh_instance->has_instance_shader_parameters()) {
+		return false;
+	}
+	if (p_mesh_instance->get_lod_bias() != 1.0 || p_mesh_instance->get_extra_cull_margin() != 0.0 || p_mesh_instance->is_ignoring_occlusion_culling()) {
+		return false;
+	}
+	if (p_lightmapped.has(p_mesh_instance->get_instance_id())) {
+		return false;
+	}
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES || (mesh->surface_get_format(i) & UNBATCHABLE_FORMAT)) {
+			return false;
+		}
+	}
+
+	return mesh->get_surface_count() > 0;
+}
+
+void StaticMeshBatch3D::_collect_lightmapped(HashSet<ObjectID> &r_lightmapped) const {
+	// Baked lightmaps are assigned to the instances of their users, and can't be moved to a batch.
+	TypedArray<Node> lightmap_gis = get_tree()->get_root()->find_children("*", "LightmapGI", true, false);
+	for (int i = 0; i < lightmap_gis.size(); i++) {
+		LightmapGI *lightmap_gi = Object::cast_to<LightmapGI>(lightmap_gis[i]);
+		Ref<LightmapGIData> light_data = lightmap_gi->get_light_data();
+		if (light_data.is_null()) {
+			continue;
+		}
+		for (int j = 0; j < light_data->get_user_count(); j++) {
+			Node *user = lightmap_gi->get_node_or_null(light_data->get_user_path(j));
+			if (user) {
+				r_lightmapped.insert(user->get_instance_id());
+			}
+		}
+	}
+}
+
+void StaticMeshBatch3D::_collect_sources(Node *p_node, const Transform3D &p_to_local, const HashSet<ObjectID> &p_lightmapped, HashMap<Ref<Mesh>, LocalVector<Array>> &r_mesh_arrays, HashMap<BatchKey, uint32_t, BatchKey> &r_task_indices, LocalVector<BatchTask> &r_tasks) {
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		Node *child = p_node->get_child(i);
+		if (Object::cast_to<StaticMeshBatch3D>(child)) {
+			// Nested batches handle their own subtree.
+			continue;
+		}
+
+		MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(child);
+		if (mesh_instance && _is_batchable(mesh_instance, p_lightmapped)) {
+			Ref<Mesh> mesh = mesh_instance->get_mesh();
+
+			// Surface arrays are read once per mesh, as kits reuse the same meshes many times.
+			LocalVector<Array> *mesh_arrays = r_mesh_arrays.getptr(mesh);
+			if (!mesh_arrays) {
+				mesh_arrays = &r_mesh_arrays.insert(mesh, LocalVector<Array>())->value;
+				for (int j = 0; j < mesh->get_surface_count(); j++) {
+					mesh_arrays->push_back(mesh->surface_get_arrays(j));
+				}
+			}
+
+			Transform3D transform = p_to_local * mesh_instance->get_global_transform();
+			Vector3 center = transform.xform(mesh_instance->get_aabb().get_center());
+
+			BatchKey key;
+			key.chunk = Vector3i((center / chunk_size).floor());
+			key.cast_shadows = mesh_instance->get_cast_shadows_setting();
+			key.layer_mask = mesh_instance->get_layer_mask();
+			key.gi_mode = mesh_instance->get_gi_mode();
+
+			uint32_t *task_index = r_task_indices.getptr(key);
+			if (!task_index) {
+				task_index = &r_task_indices.insert(key, r_tasks.size())->value;
+				BatchTask task;
+				task.key = key;
+				r_tasks.push_back(task);
+			}
+			BatchTask &task = r_tasks[*task_index];
+
+			for (int j = 0; j < mesh->get_surface_count(); j++) {
+				Ref<Material> material = mesh_instance->get_active_material(j);
+				uint64_t format = mesh->surface_get_format(j) & MERGED_FORMAT;
+
+				SurfaceGroup *group = nullptr;
+				for (SurfaceGroup &existing : task.surfaces) {
+					if (existing.material == material && existing.format == format) {
+						group = &existing;
+						break;
+					}
+				}
+				if (!group) {
+					SurfaceGroup new_group;
+					new_group.material = material;
+					new_group.format = format;
+					task.surfaces.push_back(new_group);
+					group = &task.surfaces[task.surfaces.size() - 1];
+				}
+
+				SourceSurface source;
+				source.arrays = &(*mesh_arrays)[j];
+				source.transform = transform;
+				group->sources.push_back(source);
+			}
+
+			batched_sources.push_back(mesh_instance->get_instance_id());
+		}
+
+		_collect_sources(child, p_to_local, p_lightmapped, r_mesh_arrays, r_task_indices, r_tasks);
+	}
+}
+
+Array StaticMeshBatch3D::_merge_surface_group(const SurfaceGroup &p_group) {
+	int vertex_count = 0;
+	int index_count = 0;
+	for (const SourceSurface &source : p_group.sources) {
+		const Array &arrays = *source.arrays;
+		int source_vertex_count = PackedVector3Array(arrays[Mesh::ARRAY_VERTEX]).size();
+		int source_index_count = PackedInt32Array(arrays[Mesh::ARRAY_INDEX]).size();
+		vertex_count += source_vertex_count;
+		index_count += source_index_count > 0 ? source_index_count : source_vertex_count;
+	}
+
+	PackedVector3Array vertices;
+	PackedVector3Array normals;
+	PackedFloat32Array tangents;
+	PackedColorArray colors;
+	PackedVector2Array uvs;
+	PackedVector2Array uv2s;
+	PackedInt32Array indices;
+
+	vertices.resize(vertex_count);
+	indices.resize(index_count);
+	if (p_group.format & Mesh::ARRAY_FORMAT_NORMAL) {
+		normals.resize(vertex_count);
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_TANGENT) {
+		tangents.resize(vertex_count * 4);
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_COLOR) {
+		colors.resize(vertex_count);
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_TEX_UV) {
+		uvs.resize(vertex_count);
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_TEX_UV2) {
+		uv2s.resize(vertex_count);
+	}
+
+	int vertex_offset = 0;
+	int index_offset = 0;
+	for (const SourceSurface &source : p_group.sources) {
+		const Array &arrays = *source.arrays;
+		const Transform3D &xform = source.transform;
+		const Basis normal_basis = xform.basis.inverse().transposed();
+		// Mirrored instances need their winding flipped to stay front facing.
+		const bool mirrored = xform.basis.determinant() < 0.0;
+
+		const PackedVector3Array source_vertices = arrays[Mesh::ARRAY_VERTEX];
+		const int source_vertex_count = source_vertices.size();
+		Vector3 *vertices_ptr = vertices.ptrw() + vertex_offset;
+		for (int i = 0; i < source_vertex_count; i++) {
+			vertices_ptr[i] = xform.xform(source_vertices[i]);
+		}
+
+		if (p_group.format & Mesh::ARRAY_FORMAT_NORMAL) {
+			const PackedVector3Array source_normals = arrays[Mesh::ARRAY_NORMAL];
+			Vector3 *normals_ptr = normals.ptrw() + vertex_offset;
+			for (int i = 0; i < source_vertex_count; i++) {
+				normals_ptr[i] = normal_basis.xform(source_normals[i]).normalized();
+			}
+		}
+		if (p_group.format & Mesh::ARRAY_FORMAT_TANGENT) {
+			const PackedFloat32Array source_tangents = arrays[Mesh::ARRAY_TANGENT];
+			float *tangents_ptr = tangents.ptrw() + vertex_offset * 4;
+			for (int i = 0; i < source_vertex_count; i++) {
+				Vector3 tangent = xform.basis.xform(Vector3(source_tangents[i * 4 + 0], source_tangents[i * 4 + 1], source_tangents[i * 4 + 2])).normalized();
+				tangents_ptr[i * 4 + 0] = tangent.x;
+				tangents_ptr[i * 4 + 1] = tangent.y;
+				tangents_ptr[i * 4 + 2] = tangent.z;
+				tangents_ptr[i * 4 + 3] = mirrored ? -source_tangents[i * 4 + 3] : source_tangents[i * 4 + 3];
+			}
+		}
+		if (p_group.format & Mesh::ARRAY_FORMAT_COLOR) {
+			const PackedColorArray source_colors = arrays[Mesh::ARRAY_COLOR];
+			memcpy(colors.ptrw() + vertex_offset, source_colors.ptr(), source_vertex_count * sizeof(Color));
+		}
+		if (p_group.format & Mesh::ARRAY_FORMAT_TEX_UV) {
+			const PackedVector2Array source_uvs = arrays[Mesh::ARRAY_TEX_UV];
+			memcpy(uvs.ptrw() + vertex_offset, source_uvs.ptr(), source_vertex_count * sizeof(Vector2));
+		}
+		if (p_group.format & Mesh::ARRAY_FORMAT_TEX_UV2) {
+			const PackedVector2Array source_uv2s = arrays[Mesh::ARRAY_TEX_UV2];
+			memcpy(uv2s.ptrw() + vertex_offset, source_uv2s.ptr(), source_vertex_count * sizeof(Vector2));
+		}
+
+		const PackedInt32Array source_indices = arrays[Mesh::ARRAY_INDEX];
+		const int source_index_count = source_indices.is_empty() ? source_vertex_count : source_indices.size();
+		int *indices_ptr = indices.ptrw() + index_offset;
+		for (int i = 0; i < source_index_count; i++) {
+			indices_ptr[i] = vertex_offset + (source_indices.is_empty() ? i : source_indices[i]);
+		}
+		if (mirrored) {
+			for (int i = 0; i + 2 < source_index_count; i += 3) {
+				SWAP(indices_ptr[i + 1], indices_ptr[i + 2]);
+			}
+		}
+
+		vertex_offset += source_vertex_count;
+		index_offset += source_index_count;
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	if (p_group.format & Mesh::ARRAY_FORMAT_NORMAL) {
+		arrays[Mesh::ARRAY_NORMAL] = normals;
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_TANGENT) {
+		arrays[Mesh::ARRAY_TANGENT] = tangents;
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_COLOR) {
+		arrays[Mesh::ARRAY_COLOR] = colors;
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_TEX_UV) {
+		arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	}
+	if (p_group.format & Mesh::ARRAY_FORMAT_TEX_UV2) {
+		arrays[Mesh::ARRAY_TEX_UV2] = uv2s;
+	}
+	return arrays;
+}
+
+void StaticMeshBatch3D::_batch_task(uint32_t p_index, BatchTask *p_tasks) {
+	BatchTask &task = p_tasks[p_index];
+
+	task.importer_mesh.instantiate();
+	for (const SurfaceGroup &group : task.surfaces) {
+		task.importer_mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, _merge_surface_group(group), Array(), Dictionary(), group.material);
+	}
+
+	if (generate_lods) {
+		task.importer_mesh->generate_lods(lod_normal_merge_angle, 0.0, Array());
+	}
+}
+
+void StaticMeshBatch3D::batch() {
+	ERR_FAIL_COND_MSG(!is_inside_tree(), "StaticMeshBatch3D must be inside the tree to batch its children.");
+
+	clear();
+
+	HashMap<Ref<Mesh>, LocalVector<Array>> mesh_arrays;
+	HashMap<BatchKey, uint32_t, BatchKey> task_indices;
+	LocalVector<BatchTask> tasks;
+	HashSet<ObjectID> lightmapped;
+	_collect_lightmapped(lightmapped);
+	_collect_sources(this, get_global_transform().affine_inverse(), lightmapped, mesh_arrays, task_indices, tasks);
+
+	if (tasks.is_empty()) {
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &StaticMeshBatch3D::_batch_task, tasks.ptr(), tasks.size(), -1, true, SNAME("StaticMeshBatch3D"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (const BatchTask &task : tasks) {
+		Batch b;
+		b.mesh = task.importer_mesh->get_mesh();
+		if (b.mesh.is_null()) {
+			continue;
+		}
+
+		b.instance = RS::get_singleton()->instance_create();
+		RS::get_singleton()->instance_set_base(b.instance, b.mesh->get_rid());
+		RS::get_singleton()->instance_attach_object_instance_id(b.instance, get_instance_id());
+		RS::get_singleton()->instance_geometry_set_cast_shadows_setting(b.instance, RS::ShadowCastingSetting(task.key.cast_shadows));
+		RS::get_singleton()->instance_set_layer_mask(b.instance, task.key.layer_mask);
+		RS::get_singleton()->instance_geometry_set_flag(b.instance, RS::INSTANCE_FLAG_USE_BAKED_LIGHT, task.key.gi_mode == GeometryInstance3D::GI_MODE_STATIC);
+		RS::get_singleton()->instance_geometry_set_flag(b.instance, RS::INSTANCE_FLAG_USE_DYNAMIC_GI, task.key.gi_mode == GeometryInstance3D::GI_MODE_DYNAMIC);
+		RS::get_singleton()->instance_set_visible(b.instance, is_visible_in_tree());
+		RS::get_singleton()->instance_set_scenario(b.instance, get_world_3d()->get_scenario());
+		RS::get_singleton()->instance_set_transform(b.instance, get_global_transform());
+		batches.push_back(b);
+	}
+
+	// The sources stay in the tree, but are taken out of culling and drawing until cleared, whatever their visibility.
+	for (const ObjectID &id : batched_sources) {
+		MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(ObjectDB::get_instance(id));
+		mesh_instance->set_instance_hidden(true);
+	}
+}
+
+void StaticMeshBatch3D::clear() {
+	ERR_FAIL_NULL(RenderingServer::get_singleton());
+	for (const Batch &b : batches) {
+		RS::get_singleton()->free(b.instance);
+	}
+	batches.clear();
+
+	for (const ObjectID &id : batched_sources) {
+		MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(ObjectDB::get_instance(id));
+		if (mesh_instance) {
+			mesh_instance->set_instance_hidden(false);
+		}
+	}
+	batched_sources.clear();
+}
+
+int StaticMeshBatch3D::get_batch_count() const {
+	return batches.size();
+}
+
+Ref<ArrayMesh> StaticMeshBatch3D::get_batch_mesh(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, batches.size(), Ref<ArrayMesh>());
+	return batches[p_index].mesh;
+}
+
+int StaticMeshBatch3D::get_batched_source_count() const {
+	return batched_sources.size();
+}
+
+void StaticMeshBatch3D::set_chunk_size(real_t p_size) {
+	ERR_FAIL_COND(p_size <= 0.0);
+	chunk_size = p_size;
+}
+
+real_t StaticMeshBatch3D::get_chunk_size() const {
+	return chunk_size;
+}
+
+void StaticMeshBatch3D::set_batch_on_ready(bool p_enabled) {
+	batch_on_ready = p_enabled;
+}
+
+bool StaticMeshBatch3D::is_batching_on_ready() const {
+	return batch_on_ready;
+}
+
+void StaticMeshBatch3D::set_generate_lods(bool p_enabled) {
+	generate_lods = p_enabled;
+}
+
+bool StaticMeshBatch3D::is_generating_lods() const {
+	return generate_lods;
+}
+
+void StaticMeshBatch3D::set_lod_normal_merge_angle(float p_angle) {
+	lod_normal_merge_angle = p_angle;
+}
+
+float StaticMeshBatch3D::get_lod_normal_merge_angle() const {
+	return lod_normal_merge_angle;
+}
+
+void StaticMeshBatch3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_chunk_size", "size"), &StaticMeshBatch3D::set_chunk_size);
+	ClassDB::bind_method(D_METHOD("get_chunk_size"), &StaticMeshBatch3D::get_chunk_size);
+	ClassDB::bind_method(D_METHOD("set_batch_on_ready", "enabled"), &StaticMeshBatch3D::set_batch_on_ready);
+	ClassDB::bind_method(D_METHOD("is_batching_on_ready"), &StaticMeshBatch3D::is_batching_on_ready);
+	ClassDB::bind_method(D_METHOD("set_generate_lods", "enabled"), &StaticMeshBatch3D::set_generate_lods);
+	ClassDB::bind_method(D_METHOD("is_generating_lods"), &StaticMeshBatch3D::is_generating_lods);
+	ClassDB::bind_method(D_METHOD("set_lod_normal_merge_angle", "angle"), &StaticMeshBatch3D::set_lod_normal_merge_angle);
+	ClassDB::bind_method(D_METHOD("get_lod_normal_merge_angle"), &StaticMeshBatch3D::get_lod_normal_merge_angle);
+
+	ClassDB::bind_method(D_METHOD("batch"), &StaticMeshBatch3D::batch);
+	ClassDB::bind_method(D_METHOD("clear"), &StaticMeshBatch3D::clear);
+	ClassDB::bind_method(D_METHOD("get_batch_count"), &StaticMeshBatch3D::get_batch_count);
+	ClassDB::bind_method(D_METHOD("get_batch_mesh", "index"), &StaticMeshBatch3D::get_batch_mesh);
+	ClassDB::bind_method(D_METHOD("get_batched_source_count"), &StaticMeshBatch3D::get_batched_source_count);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "chunk_size", PROPERTY_HINT_RANGE, "0.01,1024,0.01,or_greater,suffix:m"), "set_chunk_size", "get_chunk_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batch_on_ready"), "set_batch_on_ready", "is_batching_on_ready");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "generate_lods"), "set_generate_lods", "is_generating_lods");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_normal_merge_angle", PROPERTY_HINT_RANGE, "0,180,0.1,degrees"), "set_lod_normal_merge_angle", "get_lod_normal_merge_angle");
+}
+
+StaticMeshBatch3D::StaticMeshBatch3D() {
+	set_notify_transform(true);
+}
+
+StaticMeshBatch3D::~StaticMeshBatch3D() {
+	if (RenderingServer::get_singleton()) {
+		for (const Batch &b : batches) {
+			RS::get_singleton()->free(b.instance);
+		}
+
+		// Sources moved out of the subtree outlive the batch.
+		for (const ObjectID &id : batched_sources) {
+			MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(ObjectDB::get_instance(id));
+			if (mesh_instance) {
+				mesh_instance->set_instance_hidden(false);
+			}
+		}
+	}
+}
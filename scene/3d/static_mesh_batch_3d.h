@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*  static_mesh_batch_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef STATIC_MESH_BATCH_3D_H
+#define STATIC_MESH_BATCH_3D_H
+
+#include "scene/3d/node_3d.h"
+#include "scene/3d/visual_instance_3d.h"
+
+class ArrayMesh;
+class ImporterMesh;
+class MeshInstance3D;
+
+class StaticMeshBatch3D : public Node3D {
+	GDCLASS(StaticMeshBatch3D, Node3D);
+
+	struct BatchKey {
+		Vector3i chunk;
+		GeometryInstance3D::ShadowCastingSetting cast_shadows = GeometryInstance3D::SHADOW_CASTING_SETTING_ON;
+		uint32_t layer_mask = 1;
+		GeometryInstance3D::GIMode gi_mode = GeometryInstance3D::GI_MODE_STATIC;
+
+		static uint32_t hash(const BatchKey &p_key) {
+			uint32_t h = hash_murmur3_one_32(p_key.chunk.x);
+			h = hash_murmur3_one_32(p_key.chunk.y, h);
+			h = hash_murmur3_one_32(p_key.chunk.z, h);
+			h = hash_murmur3_one_32(p_key.cast_shadows, h);
+			h = hash_murmur3_one_32(p_key.layer_mask, h);
+			h = hash_murmur3_one_32(p_key.gi_mode, h);
+			return hash_fmix32(h);
+		}
+
+		bool operator==(const BatchKey &p_key) const {
+			return chunk == p_key.chunk && cast_shadows == p_key.cast_shadows && layer_mask == p_key.layer_mask && gi_mode == p_key.gi_mode;
+		}
+	};
+
+	struct SourceSurface {
+		const Array *arrays = nullptr;
+		Transform3D transform;
+	};
+
+	// Surfaces sharing a material and a vertex format, merged into a single surface.
+	struct SurfaceGroup {
+		Ref<Material> material;
+		uint64_t format = 0;
+		LocalVector<SourceSurface> sources;
+	};
+
+	// Filled on the main thread, merged on worker threads.
+	struct BatchTask {
+		BatchKey key;
+		LocalVector<SurfaceGroup> surfaces;
+		Ref<ImporterMesh> importer_mesh;
+	};
+
+	struct Batch {
+		Ref<ArrayMesh> mesh;
+		RID instance;
+	};
+
+	real_t chunk_size = 32.0;
+	bool batch_on_ready = true;
+	bool generate_lods = false;
+	float lod_normal_merge_angle = 60.0;
+
+	Vector<Batch> batches;
+	LocalVector<ObjectID> batched_sources;
+
+	bool _is_batchable(MeshInstance3D *p_mesh_instance, const HashSet<ObjectID> &p_lightmapped) const;
+	void _collect_lightmapped(HashSet<ObjectID> &r_lightmapped) const;
+	void _collect_sources(Node *p_node, const Transform3D &p_to_local, const HashSet<ObjectID> &p_lightmapped, HashMap<Ref<Mesh>, LocalVector<Array>> &r_mesh_arrays, HashMap<BatchKey, uint32_t, BatchKey> &r_task_indices, LocalVector<BatchTask> &r_tasks);
+	static Array _merge_surface_group(const SurfaceGroup &p_group);
+	void _batch_task(uint32_t p_index, BatchTask *p_tasks);
+
+protected:
+	void _notification(int p_what);
+	static void _bind_methods();
+
+public:
+	void set_chunk_size(real_t p_size);
+	real_t get_chunk_size() const;
+
+	void set_batch_on_ready(bool p_enabled);
+	bool is_batching_on_ready() const;
+
+	void set_generate_lods(bool p_enabled);
+	bool is_generating_lods() const;
+
+	void set_lod_normal_merge_angle(float p_angle);
+	float get_lod_normal_merge_angle() const;
+
+	void batch();
+	void clear();
+
+	int get_batch_count() const;
+	Ref<ArrayMesh> get_batch_mesh(int p_index) const;
+	int get_batched_source_count() const;
+
+	StaticMeshBatch3D();
+	~StaticMeshBatch3D();
+};
+
+#endif // STATIC_MESH_BATCH_3D_H
@@ -55,7 +55,7 @@ void VisualInstance3D::_update_visibility() {
 		}
 	}
 
-	RS::get_singleton()->instance_set_visible(instance, visible);
+	RS::get_singleton()->instance_set_visible(instance, visible && !instance_hidden);
 }
 
 void VisualInstance3D::_physics_interpolated_changed() {
@@ -144,6 +144,18 @@ RID VisualInstance3D::get_instance() const {
 	return instance;
 }
 
+void VisualInstance3D::set_instance_hidden(bool p_hidden) {
+	if (instance_hidden == p_hidden) {
+		return;
+	}
+	instance_hidden = p_hidden;
+	_update_visibility();
+}
+
+bool VisualInstance3D::is_instance_hidden() const {
+	return instance_hidden;
+}
+
 void VisualInstance3D::set_layer_mask(uint32_t p_mask) {
 	layers = p_mask;
 	RenderingServer::get_singleton()->instance_set_layer_mask(instance, p_mask);
@@ -425,7 +437,7 @@ void GeometryInstance3D::set_instance_shader_parameter(const StringName &p_name,
 	if (p_value.get_type() == Variant::NIL) {
 		Variant def_value = RS::get_singleton()->instance_geometry_get_shader_parameter_default_value(get_instance(), p_name);
 		RS::get_singleton()->instance_geometry_set_shader_parameter(get_instance(), p_name, def_value);
-		instance_shader_parameters.erase(p_value);
+		instance_shader_parameters.erase(p_name);
 	} else {
 		instance_shader_parameters[p_name] = p_value;
 		if (p_value.get_type() == Variant::OBJECT) {
@@ -441,6 +453,10 @@ Variant GeometryInstance3D::get_instance_shader_parameter(const StringName &p_na
 	return RS::get_singleton()->instance_geometry_get_shader_parameter(get_instance(), p_name);
 }
 
+bool GeometryInstance3D::has_instance_shader_parameters() const {
+	return !instance_shader_parameters.is_empty();
+}
+
 void GeometryInstance3D::set_custom_aabb(AABB p_aabb) {
 	if (p_aabb == custom_aabb) {
 		return;
@@ -41,6 +41,7 @@ class VisualInstance3D : public Node3D {
 	uint32_t layers = 1;
 	float sorting_offset = 0.0;
 	bool sorting_use_aabb_center = true;
+	bool instance_hidden = false;
 
 protected:
 	void _update_visibility();
@@ -64,6 +65,10 @@ public:
 	RID get_instance() const;
 	virtual AABB get_aabb() const;
 
+	// Keeps the instance out of drawing regardless of the node visibility, for nodes drawn by another node (see StaticMeshBatch3D).
+	void set_instance_hidden(bool p_hidden);
+	bool is_instance_hidden() const;
+
 	void set_base(const RID &p_base);
 	RID get_base() const;
 
@@ -190,6 +195,7 @@ public:
 
 	void set_instance_shader_parameter(const StringName &p_name, const Variant &p_value);
 	Variant get_instance_shader_parameter(const StringName &p_name) const;
+	bool has_instance_shader_parameters() const;
 
 	void set_custom_aabb(AABB p_aabb);
 	AABB get_custom_aabb() const;
@@ -147,6 +147,7 @@
 #include "scene/resources/text_file.h"
 #include "scene/resources/text_line.h"
 #include "scene/resources/text_paragraph.h"
+#include "scene/resources/texture_streamer.h"
 #include "scene/resources/texture.h"
 #include "scene/resources/texture_rd.h"
 #include "scene/resources/theme.h"
@@ -281,6 +282,7 @@
 #include "scene/3d/skeleton_modifier_3d.h"
 #include "scene/3d/soft_body_3d.h"
 #include "scene/3d/sprite_3d.h"
+#include "scene/3d/static_mesh_batch_3d.h"
 #include "scene/3d/visible_on_screen_notifier_3d.h"
 #include "scene/3d/voxel_gi.h"
 #include "scene/3d/world_environment.h"
@@ -299,6 +301,7 @@
 #include "scene/resources/3d/importer_mesh.h"
 #include "scene/resources/3d/mesh_library.h"
 #include "scene/resources/3d/navigation_mesh_source_geometry_data_3d.h"
+#include "scene/resources/3d/navigation_mesh_tiles_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
 #include "scene/resources/3d/separation_ray_shape_3d.h"
 #include "scene/resources/3d/sky_material.h"
@@ -313,6 +316,7 @@ static Ref<ResourceFormatLoaderText> resource_loader_text;
 static Ref<ResourceFormatLoaderCompressedTexture2D> resource_loader_stream_texture;
 static Ref<ResourceFormatLoaderCompressedTextureLayered> resource_loader_texture_layered;
 static Ref<ResourceFormatLoaderCompressedTexture3D> resource_loader_texture_3d;
+static TextureStreamer *texture_streamer = nullptr;
 
 static Ref<ResourceFormatSaverShader> resource_saver_shader;
 static Ref<ResourceFormatLoaderShader> resource_loader_shader;
@@ -329,6 +333,8 @@ void register_scene_types() {
 
 	Node::init_node_hrcr();
 
+	texture_streamer = memnew(TextureStreamer);
+
 	resource_loader_stream_texture.instantiate();
 	ResourceLoader::add_resource_format_loader(resource_loader_stream_texture);
 
@@ -617,6 +623,7 @@ void register_scene_types() {
 	GDREGISTER_CLASS(RayCast3D);
 	GDREGISTER_CLASS(ShapeCast3D);
 	GDREGISTER_CLASS(MultiMeshInstance3D);
+	GDREGISTER_CLASS(StaticMeshBatch3D);
 
 	GDREGISTER_CLASS(Curve3D);
 	GDREGISTER_CLASS(Path3D);
@@ -887,6 +894,7 @@ void register_scene_types() {
 
 	GDREGISTER_CLASS(MeshLibrary);
 	GDREGISTER_CLASS(NavigationMeshSourceGeometryData3D);
+	GDREGISTER_CLASS(NavigationMeshTiles3D);
 
 	OS::get_singleton()->yield(); // may take time to init
 
@@ -1251,6 +1259,8 @@ void unregister_scene_types() {
 	ResourceLoader::remove_resource_format_loader(resource_loader_stream_texture);
 	resource_loader_stream_texture.unref();
 
+	memdelete(texture_streamer);
+
 	ResourceSaver::remove_resource_format_saver(resource_saver_text);
 	resource_saver_text.unref();
 
@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*  navigation_mesh_tiles_3d.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "navigation_mesh_tiles_3d.h"
+
+void NavigationMeshTiles3D::set_tile_size(real_t p_tile_size) {
+	ERR_FAIL_COND_MSG(p_tile_size <= 0.0, "Tile size must be greater than zero.");
+	if (tile_size == p_tile_size) {
+		return;
+	}
+	tile_size = p_tile_size;
+	// The tiles no longer match the grid, so they all need to be baked again.
+	clear();
+}
+
+TypedArray<Vector2i> NavigationMeshTiles3D::get_tiles() const {
+	TypedArray<Vector2i> ret;
+	ret.resize(tiles.size());
+	int index = 0;
+	for (const KeyValue<Vector2i, Tile> &E : tiles) {
+		ret[index++] = E.key;
+	}
+	return ret;
+}
+
+bool NavigationMeshTiles3D::has_tile(const Vector2i &p_tile) const {
+	return tiles.has(p_tile);
+}
+
+Ref<NavigationMesh> NavigationMeshTiles3D::get_tile_navigation_mesh(const Vector2i &p_tile) const {
+	const Tile *tile = tiles.getptr(p_tile);
+	if (!tile) {
+		return Ref<NavigationMesh>();
+	}
+	return tile->navigation_mesh;
+}
+
+AABB NavigationMeshTiles3D::get_tile_bounds(const Vector2i &p_tile) const {
+	// Tiles cover the whole height of the source geometry, only their horizontal extent is known here.
+	return AABB(Vector3(p_tile.x * tile_size, 0.0, p_tile.y * tile_size), Vector3(tile_size, 0.0, tile_size));
+}
+
+TypedArray<Vector2i> NavigationMeshTiles3D::get_changed_tiles() const {
+	TypedArray<Vector2i> ret;
+	ret.resize(changed_tiles.size());
+	for (int i = 0; i < changed_tiles.size(); i++) {
+		ret[i] = changed_tiles[i];
+	}
+	return ret;
+}
+
+void NavigationMeshTiles3D::clear() {
+	tiles.clear();
+	changed_tiles.clear();
+}
+
+void NavigationMeshTiles3D::_set_tiles(const HashMap<Vector2i, Tile> &p_tiles, const Vector<Vector2i> &p_changed_tiles) {
+	tiles = p_tiles;
+	changed_tiles = p_changed_tiles;
+}
+
+void NavigationMeshTiles3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_tile_size", "tile_size"), &NavigationMeshTiles3D::set_tile_size);
+	ClassDB::bind_method(D_METHOD("get_tile_size"), &NavigationMeshTiles3D::get_tile_size);
+
+	ClassDB::bind_method(D_METHOD("get_tiles"), &NavigationMeshTiles3D::get_tiles);
+	ClassDB::bind_method(D_METHOD("has_tile", "tile"), &NavigationMeshTiles3D::has_tile);
+	ClassDB::bind_method(D_METHOD("get_tile_navigation_mesh", "tile"), &NavigationMeshTiles3D::get_tile_navigation_mesh);
+	ClassDB::bind_method(D_METHOD("get_tile_bounds", "tile"), &NavigationMeshTiles3D::get_tile_bounds);
+
+	ClassDB::bind_method(D_METHOD("get_changed_tiles"), &NavigationMeshTiles3D::get_changed_tiles);
+
+	ClassDB::bind_method(D_METHOD("clear"), &NavigationMeshTiles3D::clear);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "tile_size", PROPERTY_HINT_RANGE, "0.01,1024,0.01,or_greater,suffix:m"), "set_tile_size", "get_tile_size");
+}
@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*  navigation_mesh_tiles_3d.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAVIGATION_MESH_TILES_3D_H
+#define NAVIGATION_MESH_TILES_3D_H
+
+#include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/variant/typed_array.h"
+#include "scene/resources/navigation_mesh.h"
+
+class NavigationMeshTiles3D : public RefCounted {
+	GDCLASS(NavigationMeshTiles3D, RefCounted);
+
+public:
+	struct Tile {
+		Ref<NavigationMesh> navigation_mesh;
+		/// Hash of the source geometry and bake settings the tile was baked from.
+		uint32_t source_hash = 0;
+	};
+
+private:
+	real_t tile_size = 32.0;
+
+	HashMap<Vector2i, Tile> tiles;
+	Vector<Vector2i> changed_tiles;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_tile_size(real_t p_tile_size);
+	real_t get_tile_size() const { return tile_size; }
+
+	TypedArray<Vector2i> get_tiles() const;
+	bool has_tile(const Vector2i &p_tile) const;
+	Ref<NavigationMesh> get_tile_navigation_mesh(const Vector2i &p_tile) const;
+	AABB get_tile_bounds(const Vector2i &p_tile) const;
+
+	TypedArray<Vector2i> get_changed_tiles() const;
+
+	void clear();
+
+	// Used by the navigation mesh generator.
+	const HashMap<Vector2i, Tile> &_get_tiles() const { return tiles; }
+	void _set_tiles(const HashMap<Vector2i, Tile> &p_tiles, const Vector<Vector2i> &p_changed_tiles);
+};
+
+#endif // NAVIGATION_MESH_TILES_3D_H
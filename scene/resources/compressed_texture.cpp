@@ -31,6 +31,7 @@
 #include "compressed_texture.h"
 
 #include "scene/resources/bit_map.h"
+#include "scene/resources/texture_streamer.h"
 
 Error CompressedTexture2D::_load_data(const String &p_path, int &r_width, int &r_height, Ref<Image> &image, bool &r_request_3d, bool &r_request_normal, bool &r_request_roughness, int &mipmap_limit, int p_size_limit) {
 	alpha_cache.unref();
@@ -135,11 +136,20 @@ Error CompressedTexture2D::load(const String &p_path) {
 	bool request_roughness;
 	int mipmap_limit;
 
-	Error err = _load_data(p_path, lw, lh, image, request_3d, request_normal, request_roughness, mipmap_limit);
+	// Textures imported for streaming only load their smallest mipmaps here.
+	TextureStreamer *streamer = TextureStreamer::get_singleton();
+	const int size_limit = streamer && streamer->is_enabled() ? streamer->get_minimum_size() : 0;
+
+	Error err = _load_data(p_path, lw, lh, image, request_3d, request_normal, request_roughness, mipmap_limit, size_limit);
 	if (err) {
 		return err;
 	}
 
+	if (streamed) {
+		streamer->unregister_texture(texture);
+		streamed = false;
+	}
+
 	if (texture.is_valid()) {
 		RID new_texture = RS::get_singleton()->texture_2d_create(image);
 		RS::get_singleton()->texture_replace(texture, new_texture);
@@ -160,6 +170,16 @@ Error CompressedTexture2D::load(const String &p_path) {
 		RenderingServer::get_singleton()->texture_set_path(texture, p_path);
 	}
 
+	if (size_limit > 0 && (image->get_width() < lw || image->get_height() < lh)) {
+		int resident_mipmap = 0;
+		while (MAX(MAX(lw, lh) >> resident_mipmap, 1) > MAX(image->get_width(), image->get_height())) {
+			resident_mipmap++;
+		}
+		RS::get_singleton()->texture_set_streaming(texture, true);
+		streamer->register_texture(this, texture, p_path, lw, lh, format, resident_mipmap);
+		streamed = true;
+	}
+
 #ifdef TOOLS_ENABLED
 
 	if (request_3d) {
@@ -192,6 +212,16 @@ Error CompressedTexture2D::load(const String &p_path) {
 	return OK;
 }
 
+void CompressedTexture2D::_stream_update(const Ref<Image> &p_image) {
+	RID new_texture = RS::get_singleton()->texture_2d_create(p_image);
+	RS::get_singleton()->texture_replace(texture, new_texture);
+	RS::get_singleton()->texture_set_size_override(texture, w, h);
+	RS::get_singleton()->texture_set_streaming(texture, true);
+	RS::get_singleton()->texture_set_path(texture, get_path().is_empty() ? path_to_file : get_path());
+
+	alpha_cache.unref();
+}
+
 String CompressedTexture2D::get_load_path() const {
 	return path_to_file;
 }
@@ -296,6 +326,22 @@ void CompressedTexture2D::reload_from_file() {
 void CompressedTexture2D::_validate_property(PropertyInfo &p_property) const {
 }
 
+Ref<Image> CompressedTexture2D::load_image_from_path(const String &p_path, int p_size_limit) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(f.is_null(), Ref<Image>(), vformat("Unable to open file: %s.", p_path));
+
+	uint8_t header[4];
+	f->get_buffer(header, 4);
+	if (header[0] != 'G' || header[1] != 'S' || header[2] != 'T' || header[3] != '2') {
+		ERR_FAIL_V_MSG(Ref<Image>(), "Compressed texture file is corrupt (Bad header).");
+	}
+
+	//skip version, size, data format, mipmap limit and reserved
+	f->seek(f->get_position() + 32);
+
+	return load_image_from_file(f, p_size_limit);
+}
+
 Ref<Image> CompressedTexture2D::load_image_from_file(Ref<FileAccess> f, int p_size_limit) {
 	uint32_t data_format = f->get_32();
 	uint32_t w = f->get_16();
@@ -318,7 +364,7 @@ Ref<Image> CompressedTexture2D::load_image_from_file(Ref<FileAccess> f, int p_si
 		for (uint32_t i = 0; i < mipmaps + 1; i++) {
 			uint32_t size = f->get_32();
 
-			if (p_size_limit > 0 && i < (mipmaps - 1) && (sw > p_size_limit || sh > p_size_limit)) {
+			if (p_size_limit > 0 && i < mipmaps && (sw > p_size_limit || sh > p_size_limit)) {
 				//can't load this due to size limit
 				sw = MAX(sw >> 1, 1);
 				sh = MAX(sh >> 1, 1);
@@ -389,21 +435,13 @@ Ref<Image> CompressedTexture2D::load_image_from_file(Ref<FileAccess> f, int p_si
 				}
 			}
 
-			image->set_data(w, h, true, mipmap_images[0]->get_format(), img_data);
+			image->set_data(mipmap_images[0]->get_width(), mipmap_images[0]->get_height(), true, mipmap_images[0]->get_format(), img_data);
 			return image;
 		}
 
 	} else if (data_format == DATA_FORMAT_BASIS_UNIVERSAL) {
-		int sw = w;
-		int sh = h;
+		// All mipmaps are stored in a single image, so the size limit can't be applied.
 		uint32_t size = f->get_32();
-		if (p_size_limit > 0 && (sw > p_size_limit || sh > p_size_limit)) {
-			//can't load this due to size limit
-			sw = MAX(sw >> 1, 1);
-			sh = MAX(sh >> 1, 1);
-			f->seek(f->get_position() + size);
-			return Ref<Image>();
-		}
 		Vector<uint8_t> pv;
 		pv.resize(size);
 		{
@@ -416,23 +454,21 @@ Ref<Image> CompressedTexture2D::load_image_from_file(Ref<FileAccess> f, int p_si
 			ERR_FAIL_COND_V(img.is_null() || img->is_empty(), Ref<Image>());
 		}
 		format = img->get_format();
-		sw = MAX(sw >> 1, 1);
-		sh = MAX(sh >> 1, 1);
 		return img;
 	} else if (data_format == DATA_FORMAT_IMAGE) {
 		int size = Image::get_image_data_size(w, h, format, mipmaps ? true : false);
+		uint64_t data_start = f->get_position();
 
 		for (uint32_t i = 0; i < mipmaps + 1; i++) {
 			int tw, th;
 			int ofs = Image::get_image_mipmap_offset_and_dimensions(w, h, format, i, tw, th);
 
-			if (p_size_limit > 0 && i < mipmaps && (p_size_limit > tw || p_size_limit > th)) {
-				if (ofs) {
-					f->seek(f->get_position() + ofs);
-				}
+			if (p_size_limit > 0 && i < mipmaps && (tw > p_size_limit || th > p_size_limit)) {
 				continue; //oops, size limit enforced, go to next
 			}
 
+			f->seek(data_start + ofs);
+
 			Vector<uint8_t> data;
 			data.resize(size - ofs);
 
@@ -460,6 +496,9 @@ void CompressedTexture2D::_bind_methods() {
 CompressedTexture2D::CompressedTexture2D() {}
 
 CompressedTexture2D::~CompressedTexture2D() {
+	if (streamed && TextureStreamer::get_singleton()) {
+		TextureStreamer::get_singleton()->unregister_texture(texture);
+	}
 	if (texture.is_valid()) {
 		ERR_FAIL_NULL(RenderingServer::get_singleton());
 		RS::get_singleton()->free(texture);
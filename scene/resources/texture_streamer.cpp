@@ -0,0 +1,272 @@
+/**************************************************************************/
+/*  texture_streamer.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "texture_streamer.h"
+
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "scene/resources/compressed_texture.h"
+#include "servers/rendering_server.h"
+
+// Frames during which a texture that is no longer requested keeps its mipmaps,
+// so that textures going briefly out of view are not reloaded over and over.
+static const uint64_t TEXTURE_STREAMING_EVICTION_DELAY = 120;
+
+TextureStreamer *TextureStreamer::singleton = nullptr;
+
+int TextureStreamer::_get_mipmap_for_screen_size(const StreamedTexture &p_texture, float p_screen_size) const {
+	// Use the smallest mipmap which still has about as many texels as there are pixels on screen.
+	const int size = MAX(p_texture.width, p_texture.height);
+	int mipmap = 0;
+	while (mipmap < p_texture.min_mipmap && (size >> (mipmap + 1)) >= p_screen_size) {
+		mipmap++;
+	}
+	return mipmap;
+}
+
+int64_t TextureStreamer::_get_mipmap_bytes(const StreamedTexture &p_texture, int p_mipmap) const {
+	return Image::get_image_data_size(MAX(p_texture.width >> p_mipmap, 1), MAX(p_texture.height >> p_mipmap, 1), p_texture.format, true);
+}
+
+void TextureStreamer::_load_task(LoadTask *p_task) {
+	p_task->image = CompressedTexture2D::load_image_from_path(p_task->path, p_task->size_limit);
+}
+
+void TextureStreamer::_start_load(StreamedTexture &p_texture) {
+	const int mipmap = p_texture.target_mipmap;
+
+	p_texture.load_task = memnew(LoadTask);
+	p_texture.load_task->path = p_texture.path;
+	if (mipmap > 0) {
+		p_texture.load_task->size_limit = MAX(MAX(p_texture.width >> mipmap, 1), MAX(p_texture.height >> mipmap, 1));
+	}
+	p_texture.loading_mipmap = mipmap;
+	p_texture.task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &TextureStreamer::_load_task, p_texture.load_task, false, "TextureStreamer:" + p_texture.path);
+	pending_loads++;
+}
+
+void TextureStreamer::_finish_load(StreamedTexture &p_texture, bool p_apply) {
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(p_texture.task_id);
+	p_texture.task_id = WorkerThreadPool::INVALID_TASK_ID;
+	pending_loads--;
+
+	Ref<Image> image = p_texture.load_task->image;
+	memdelete(p_texture.load_task);
+	p_texture.load_task = nullptr;
+
+	if (!p_apply) {
+		return;
+	}
+
+	if (image.is_null() || image->is_empty()) {
+		// Keep what is resident, instead of retrying every frame.
+		p_texture.failed = true;
+		ERR_FAIL_MSG(vformat("Failed to stream mipmaps of texture: %s.", p_texture.path));
+	}
+
+	p_texture.texture->_stream_update(image);
+	p_texture.resident_mipmap = p_texture.loading_mipmap;
+	p_texture.resident_bytes = image->get_data().size();
+}
+
+void TextureStreamer::_texture_streaming_requested(const TypedArray<RID> &p_textures, const PackedFloat32Array &p_screen_sizes) {
+	ERR_FAIL_COND(p_textures.size() != p_screen_sizes.size());
+
+	MutexLock lock(mutex);
+	for (int i = 0; i < p_textures.size(); i++) {
+		StreamedTexture *texture = textures.getptr(p_textures[i]);
+		if (!texture) {
+			continue;
+		}
+		texture->screen_size = p_screen_sizes[i];
+		texture->request_frame = frame;
+	}
+}
+
+void TextureStreamer::_update() {
+	MutexLock lock(mutex);
+
+	if (textures.is_empty()) {
+		frame++;
+		return;
+	}
+
+	LocalVector<StreamedTexture *> sorted_textures;
+	sorted_textures.reserve(textures.size());
+	int64_t target_bytes = 0;
+	memory_requested = 0;
+
+	for (KeyValue<RID, StreamedTexture> &E : textures) {
+		StreamedTexture &texture = E.value;
+
+		if (texture.task_id != WorkerThreadPool::INVALID_TASK_ID && WorkerThreadPool::get_singleton()->is_task_completed(texture.task_id)) {
+			_finish_load(texture, true);
+		}
+
+		if (frame - texture.request_frame > TEXTURE_STREAMING_EVICTION_DELAY) {
+			texture.screen_size = 0.0;
+		}
+		texture.target_mipmap = texture.screen_size > 0.0 ? _get_mipmap_for_screen_size(texture, texture.screen_size) : texture.min_mipmap;
+
+		const int64_t bytes = _get_mipmap_bytes(texture, texture.target_mipmap);
+		memory_requested += bytes;
+		target_bytes += bytes;
+		sorted_textures.push_back(&texture);
+	}
+
+	sorted_textures.sort_custom<LowerPriority>();
+
+	// Over budget, drop one mipmap at a time from each texture, starting with the ones
+	// seen the longest time ago and the smallest on screen, so that the loss of detail
+	// is spread across textures instead of emptying a few of them.
+	bool dropped = true;
+	while (target_bytes > memory_budget && dropped) {
+		dropped = false;
+		for (StreamedTexture *texture : sorted_textures) {
+			if (texture->target_mipmap >= texture->min_mipmap) {
+				continue;
+			}
+			target_bytes -= _get_mipmap_bytes(*texture, texture->target_mipmap);
+			texture->target_mipmap++;
+			target_bytes += _get_mipmap_bytes(*texture, texture->target_mipmap);
+			dropped = true;
+			if (target_bytes <= memory_budget) {
+				break;
+			}
+		}
+	}
+
+	// Start the loads of the textures with the highest priority first.
+	for (int i = int(sorted_textures.size()) - 1; i >= 0 && pending_loads < max_concurrent_loads; i--) {
+		StreamedTexture *texture = sorted_textures[i];
+		if (texture->task_id == WorkerThreadPool::INVALID_TASK_ID && !texture->failed && texture->target_mipmap != texture->resident_mipmap) {
+			_start_load(*texture);
+		}
+	}
+
+	memory_used = 0;
+	for (const StreamedTexture *texture : sorted_textures) {
+		memory_used += texture->resident_bytes;
+	}
+
+	frame++;
+}
+
+void TextureStreamer::register_texture(CompressedTexture2D *p_texture, RID p_rid, const String &p_path, int p_width, int p_height, Image::Format p_format, int p_resident_mipmap) {
+	ERR_FAIL_COND(!enabled);
+
+	MutexLock lock(mutex);
+
+	if (!connected) {
+		RenderingServer::get_singleton()->connect(SNAME("texture_streaming_requested"), callable_mp(this, &TextureStreamer::_texture_streaming_requested));
+		RenderingServer::get_singleton()->connect(SNAME("frame_post_draw"), callable_mp(this, &TextureStreamer::_update));
+		connected = true;
+	}
+
+	StreamedTexture *existing = textures.getptr(p_rid);
+	if (existing && existing->task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		_finish_load(*existing, false);
+	}
+
+	StreamedTexture texture;
+	texture.texture = p_texture;
+	texture.path = p_path;
+	texture.width = p_width;
+	texture.height = p_height;
+	texture.format = p_format;
+	texture.min_mipmap = p_resident_mipmap;
+	texture.resident_mipmap = p_resident_mipmap;
+	texture.target_mipmap = p_resident_mipmap;
+	texture.resident_bytes = _get_mipmap_bytes(texture, p_resident_mipmap);
+	textures[p_rid] = texture;
+}
+
+void TextureStreamer::unregister_texture(RID p_rid) {
+	MutexLock lock(mutex);
+
+	StreamedTexture *texture = textures.getptr(p_rid);
+	if (!texture) {
+		return;
+	}
+	if (texture->task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		_finish_load(*texture, false);
+	}
+	textures.erase(p_rid);
+}
+
+void TextureStreamer::set_memory_budget(int64_t p_bytes) {
+	MutexLock lock(mutex);
+	memory_budget = p_bytes;
+}
+
+int64_t TextureStreamer::get_memory_budget() {
+	MutexLock lock(mutex);
+	return memory_budget;
+}
+
+int TextureStreamer::get_texture_count() {
+	MutexLock lock(mutex);
+	return textures.size();
+}
+
+int TextureStreamer::get_pending_load_count() {
+	MutexLock lock(mutex);
+	return pending_loads;
+}
+
+int64_t TextureStreamer::get_memory_used() {
+	MutexLock lock(mutex);
+	return memory_used;
+}
+
+int64_t TextureStreamer::get_memory_requested() {
+	MutexLock lock(mutex);
+	return memory_requested;
+}
+
+TextureStreamer::TextureStreamer() {
+	singleton = this;
+
+	memory_budget = int64_t(GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/textures/streaming/memory_budget_mb", PROPERTY_HINT_RANGE, "1,65536,1,or_greater,suffix:MiB"), 512)) * 1024 * 1024;
+	minimum_size = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/textures/streaming/minimum_size", PROPERTY_HINT_RANGE, "1,4096,1,suffix:px"), 128);
+	max_concurrent_loads = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/textures/streaming/max_concurrent_loads", PROPERTY_HINT_RANGE, "1,64,1"), 2);
+
+	// Textures are always loaded fully in the editor.
+	enabled = !Engine::get_singleton()->is_editor_hint();
+}
+
+TextureStreamer::~TextureStreamer() {
+	for (KeyValue<RID, StreamedTexture> &E : textures) {
+		if (E.value.task_id != WorkerThreadPool::INVALID_TASK_ID) {
+			_finish_load(E.value, false);
+		}
+	}
+	singleton = nullptr;
+}
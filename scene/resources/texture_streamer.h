@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*  texture_streamer.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include "core/io/image.h"
+#include "core/object/object.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/typed_array.h"
+
+class CompressedTexture2D;
+
+// Keeps the mipmaps of streamed CompressedTexture2Ds resident depending on
+// their on-screen size as reported by the RenderingServer, within a memory budget.
+class TextureStreamer : public Object {
+	GDCLASS(TextureStreamer, Object);
+
+	static TextureStreamer *singleton;
+
+	struct LoadTask {
+		String path;
+		int size_limit = 0;
+		Ref<Image> image;
+	};
+
+	struct StreamedTexture {
+		CompressedTexture2D *texture = nullptr;
+		String path;
+		int width = 0;
+		int height = 0;
+		Image::Format format = Image::FORMAT_L8;
+		// Mipmap level loaded when the texture is not used; never evicted.
+		int min_mipmap = 0;
+		int resident_mipmap = 0;
+		int target_mipmap = 0;
+		int64_t resident_bytes = 0;
+
+		float screen_size = 0.0;
+		uint64_t request_frame = 0;
+
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+		LoadTask *load_task = nullptr;
+		int loading_mipmap = -1;
+		bool failed = false;
+	};
+
+	struct LowerPriority {
+		_FORCE_INLINE_ bool operator()(const StreamedTexture *p_a, const StreamedTexture *p_b) const {
+			if (p_a->request_frame != p_b->request_frame) {
+				return p_a->request_frame < p_b->request_frame;
+			}
+			return p_a->screen_size < p_b->screen_size;
+		}
+	};
+
+	bool enabled = false;
+	bool connected = false;
+	int minimum_size = 128;
+	int64_t memory_budget = 0;
+	int max_concurrent_loads = 2;
+
+	Mutex mutex;
+	HashMap<RID, StreamedTexture> textures;
+	uint64_t frame = 0;
+	int pending_loads = 0;
+	int64_t memory_used = 0;
+	int64_t memory_requested = 0;
+
+	int _get_mipmap_for_screen_size(const StreamedTexture &p_texture, float p_screen_size) const;
+	int64_t _get_mipmap_bytes(const StreamedTexture &p_texture, int p_mipmap) const;
+	void _load_task(LoadTask *p_task);
+	void _start_load(StreamedTexture &p_texture);
+	void _finish_load(StreamedTexture &p_texture, bool p_apply);
+
+	void _texture_streaming_requested(const TypedArray<RID> &p_textures, const PackedFloat32Array &p_screen_sizes);
+	void _update();
+
+public:
+	static TextureStreamer *get_singleton() { return singleton; }
+
+	bool is_enabled() const { return enabled; }
+	int get_minimum_size() const { return minimum_size; }
+
+	void register_texture(CompressedTexture2D *p_texture, RID p_rid, const String &p_path, int p_width, int p_height, Image::Format p_format, int p_resident_mipmap);
+	void unregister_texture(RID p_rid);
+
+	void set_memory_budget(int64_t p_bytes);
+	int64_t get_memory_budget();
+
+	int get_texture_count();
+	int get_pending_load_count();
+	int64_t get_memory_used();
+	int64_t get_memory_requested();
+
+	TextureStreamer();
+	~TextureStreamer();
+};
+
+#endif // TEXTURE_STREAMER_H
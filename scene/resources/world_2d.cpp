@@ -60,6 +60,8 @@ RID World2D::get_navigation_map() const {
 		NavigationServer2D::get_singleton()->map_set_active(navigation_map, true);
 		NavigationServer2D::get_singleton()->map_set_cell_size(navigation_map, GLOBAL_GET("navigation/2d/default_cell_size"));
 		NavigationServer2D::get_singleton()->map_set_use_edge_connections(navigation_map, GLOBAL_GET("navigation/2d/use_edge_connections"));
+		NavigationServer2D::get_singleton()->map_set_use_hierarchical_pathfinding(navigation_map, GLOBAL_GET("navigation/2d/use_hierarchical_pathfinding"));
+		NavigationServer2D::get_singleton()->map_set_use_async_iterations(navigation_map, GLOBAL_GET("navigation/2d/use_async_iterations"));
 		NavigationServer2D::get_singleton()->map_set_edge_connection_margin(navigation_map, GLOBAL_GET("navigation/2d/default_edge_connection_margin"));
 		NavigationServer2D::get_singleton()->map_set_link_connection_radius(navigation_map, GLOBAL_GET("navigation/2d/default_link_connection_radius"));
 	}
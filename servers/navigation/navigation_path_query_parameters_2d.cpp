@@ -35,6 +35,9 @@ void NavigationPathQueryParameters2D::set_pathfinding_algorithm(const Navigation
 		case PATHFINDING_ALGORITHM_ASTAR: {
 			parameters.pathfinding_algorithm = NavigationUtilities::PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR;
 		} break;
+		case PATHFINDING_ALGORITHM_FLOW_FIELD: {
+			parameters.pathfinding_algorithm = NavigationUtilities::PathfindingAlgorithm::PATHFINDING_ALGORITHM_FLOW_FIELD;
+		} break;
 		default: {
 			WARN_PRINT_ONCE("No match for used PathfindingAlgorithm - fallback to default");
 			parameters.pathfinding_algorithm = NavigationUtilities::PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR;
@@ -46,6 +49,8 @@ NavigationPathQueryParameters2D::PathfindingAlgorithm NavigationPathQueryParamet
 	switch (parameters.pathfinding_algorithm) {
 		case NavigationUtilities::PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR:
 			return PATHFINDING_ALGORITHM_ASTAR;
+		case NavigationUtilities::PathfindingAlgorithm::PATHFINDING_ALGORITHM_FLOW_FIELD:
+			return PATHFINDING_ALGORITHM_FLOW_FIELD;
 		default:
 			WARN_PRINT_ONCE("No match for used PathfindingAlgorithm - fallback to default");
 			return PATHFINDING_ALGORITHM_ASTAR;
@@ -167,13 +172,14 @@ void NavigationPathQueryParameters2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "start_position"), "set_start_position", "get_start_position");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "target_position"), "set_target_position", "get_target_position");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "navigation_layers", PROPERTY_HINT_LAYERS_2D_NAVIGATION), "set_navigation_layers", "get_navigation_layers");
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "pathfinding_algorithm", PROPERTY_HINT_ENUM, "AStar"), "set_pathfinding_algorithm", "get_pathfinding_algorithm");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "pathfinding_algorithm", PROPERTY_HINT_ENUM, "AStar,Flow Field"), "set_pathfinding_algorithm", "get_pathfinding_algorithm");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "path_postprocessing", PROPERTY_HINT_ENUM, "Corridorfunnel,Edgecentered"), "set_path_postprocessing", "get_path_postprocessing");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "metadata_flags", PROPERTY_HINT_FLAGS, "Include Types,Include RIDs,Include Owners"), "set_metadata_flags", "get_metadata_flags");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "simplify_path"), "set_simplify_path", "get_simplify_path");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "simplify_epsilon"), "set_simplify_epsilon", "get_simplify_epsilon");
 
 	BIND_ENUM_CONSTANT(PATHFINDING_ALGORITHM_ASTAR);
+	BIND_ENUM_CONSTANT(PATHFINDING_ALGORITHM_FLOW_FIELD);
 
 	BIND_ENUM_CONSTANT(PATH_POSTPROCESSING_CORRIDORFUNNEL);
 	BIND_ENUM_CONSTANT(PATH_POSTPROCESSING_EDGECENTERED);
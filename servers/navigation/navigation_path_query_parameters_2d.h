@@ -45,6 +45,7 @@ protected:
 public:
 	enum PathfindingAlgorithm {
 		PATHFINDING_ALGORITHM_ASTAR = 0,
+		PATHFINDING_ALGORITHM_FLOW_FIELD,
 	};
 
 	enum PathPostProcessing {
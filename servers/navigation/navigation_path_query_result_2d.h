@@ -41,6 +41,9 @@ class NavigationPathQueryResult2D : public RefCounted {
 	Vector<int32_t> path_types;
 	TypedArray<RID> path_rids;
 	Vector<int64_t> path_owner_ids;
+	real_t path_length = 0.0;
+	int explored_polygon_count = 0;
+	uint64_t query_time_usec = 0;
 
 protected:
 	static void _bind_methods();
@@ -63,6 +66,15 @@ public:
 	void set_path_owner_ids(const Vector<int64_t> &p_path_owner_ids);
 	const Vector<int64_t> &get_path_owner_ids() const;
 
+	void set_path_length(real_t p_length);
+	real_t get_path_length() const;
+
+	void set_explored_polygon_count(int p_count);
+	int get_explored_polygon_count() const;
+
+	void set_query_time_usec(uint64_t p_usec);
+	uint64_t get_query_time_usec() const;
+
 	void reset();
 };
 
@@ -62,11 +62,38 @@ const Vector<int64_t> &NavigationPathQueryResult3D::get_path_owner_ids() const {
 	return path_owner_ids;
 }
 
+void NavigationPathQueryResult3D::set_path_length(real_t p_length) {
+	path_length = p_length;
+}
+
+real_t NavigationPathQueryResult3D::get_path_length() const {
+	return path_length;
+}
+
+void NavigationPathQueryResult3D::set_explored_polygon_count(int p_count) {
+	explored_polygon_count = p_count;
+}
+
+int NavigationPathQueryResult3D::get_explored_polygon_count() const {
+	return explored_polygon_count;
+}
+
+void NavigationPathQueryResult3D::set_query_time_usec(uint64_t p_usec) {
+	query_time_usec = p_usec;
+}
+
+uint64_t NavigationPathQueryResult3D::get_query_time_usec() const {
+	return query_time_usec;
+}
+
 void NavigationPathQueryResult3D::reset() {
 	path.clear();
 	path_types.clear();
 	path_rids.clear();
 	path_owner_ids.clear();
+	path_length = 0.0;
+	explored_polygon_count = 0;
+	query_time_usec = 0;
 }
 
 void NavigationPathQueryResult3D::_bind_methods() {
@@ -82,12 +109,24 @@ void NavigationPathQueryResult3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_path_owner_ids", "path_owner_ids"), &NavigationPathQueryResult3D::set_path_owner_ids);
 	ClassDB::bind_method(D_METHOD("get_path_owner_ids"), &NavigationPathQueryResult3D::get_path_owner_ids);
 
+	ClassDB::bind_method(D_METHOD("set_path_length", "length"), &NavigationPathQueryResult3D::set_path_length);
+	ClassDB::bind_method(D_METHOD("get_path_length"), &NavigationPathQueryResult3D::get_path_length);
+
+	ClassDB::bind_method(D_METHOD("set_explored_polygon_count", "count"), &NavigationPathQueryResult3D::set_explored_polygon_count);
+	ClassDB::bind_method(D_METHOD("get_explored_polygon_count"), &NavigationPathQueryResult3D::get_explored_polygon_count);
+
+	ClassDB::bind_method(D_METHOD("set_query_time_usec", "usec"), &NavigationPathQueryResult3D::set_query_time_usec);
+	ClassDB::bind_method(D_METHOD("get_query_time_usec"), &NavigationPathQueryResult3D::get_query_time_usec);
+
 	ClassDB::bind_method(D_METHOD("reset"), &NavigationPathQueryResult3D::reset);
 
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_VECTOR3_ARRAY, "path"), "set_path", "get_path");
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "path_types"), "set_path_types", "get_path_types");
 	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "path_rids", PROPERTY_HINT_ARRAY_TYPE, "RID"), "set_path_rids", "get_path_rids");
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT64_ARRAY, "path_owner_ids"), "set_path_owner_ids", "get_path_owner_ids");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "path_length"), "set_path_length", "get_path_length");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "explored_polygon_count"), "set_explored_polygon_count", "get_explored_polygon_count");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "query_time_usec"), "set_query_time_usec", "get_query_time_usec");
 
 	BIND_ENUM_CONSTANT(PATH_SEGMENT_TYPE_REGION);
 	BIND_ENUM_CONSTANT(PATH_SEGMENT_TYPE_LINK);
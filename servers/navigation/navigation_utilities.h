@@ -38,6 +38,7 @@ namespace NavigationUtilities {
 
 enum PathfindingAlgorithm {
 	PATHFINDING_ALGORITHM_ASTAR = 0,
+	PATHFINDING_ALGORITHM_FLOW_FIELD,
 };
 
 enum PathPostProcessing {
@@ -75,6 +76,9 @@ struct PathQueryResult {
 	PackedInt32Array path_types;
 	TypedArray<RID> path_rids;
 	PackedInt64Array path_owner_ids;
+	real_t path_length = 0.0;
+	uint32_t explored_polygon_count = 0;
+	uint64_t query_time_usec = 0;
 };
 
 } //namespace NavigationUtilities
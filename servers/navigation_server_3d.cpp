@@ -52,6 +52,10 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_merge_rasterizer_cell_scale", "map"), &NavigationServer3D::map_get_merge_rasterizer_cell_scale);
 	ClassDB::bind_method(D_METHOD("map_set_use_edge_connections", "map", "enabled"), &NavigationServer3D::map_set_use_edge_connections);
 	ClassDB::bind_method(D_METHOD("map_get_use_edge_connections", "map"), &NavigationServer3D::map_get_use_edge_connections);
+	ClassDB::bind_method(D_METHOD("map_set_use_hierarchical_pathfinding", "map", "enabled"), &NavigationServer3D::map_set_use_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("map_get_use_hierarchical_pathfinding", "map"), &NavigationServer3D::map_get_use_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("map_set_use_async_iterations", "map", "enabled"), &NavigationServer3D::map_set_use_async_iterations);
+	ClassDB::bind_method(D_METHOD("map_get_use_async_iterations", "map"), &NavigationServer3D::map_get_use_async_iterations);
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer3D::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_set_link_connection_radius", "map", "radius"), &NavigationServer3D::map_set_link_connection_radius);
@@ -73,6 +77,8 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer3D::map_get_random_point);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer3D::query_path);
+	ClassDB::bind_method(D_METHOD("query_paths_async", "parameters", "results", "callback"), &NavigationServer3D::query_paths_async, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("is_path_query_batch_completed", "batch_id"), &NavigationServer3D::is_path_query_batch_completed);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enabled", "region", "enabled"), &NavigationServer3D::region_set_enabled);
@@ -188,6 +194,7 @@ void NavigationServer3D::_bind_methods() {
 #ifndef _3D_DISABLED
 	ClassDB::bind_method(D_METHOD("parse_source_geometry_data", "navigation_mesh", "source_geometry_data", "root_node", "callback"), &NavigationServer3D::parse_source_geometry_data, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data", "navigation_mesh", "source_geometry_data", "callback"), &NavigationServer3D::bake_from_source_geometry_data, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("bake_tiles_from_source_geometry_data", "navigation_mesh", "source_geometry_data", "navigation_mesh_tiles", "callback"), &NavigationServer3D::bake_tiles_from_source_geometry_data, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data_async", "navigation_mesh", "source_geometry_data", "callback"), &NavigationServer3D::bake_from_source_geometry_data_async, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("is_baking_navigation_mesh", "navigation_mesh"), &NavigationServer3D::is_baking_navigation_mesh);
 #endif // _3D_DISABLED
@@ -221,6 +228,8 @@ void NavigationServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(INFO_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(INFO_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(INFO_MAP_SYNC_TIME);
+	BIND_ENUM_CONSTANT(INFO_AVOIDANCE_TIME);
 }
 
 NavigationServer3D *NavigationServer3D::get_singleton() {
@@ -233,6 +242,8 @@ NavigationServer3D::NavigationServer3D() {
 
 	GLOBAL_DEF_BASIC(PropertyInfo(Variant::FLOAT, "navigation/2d/default_cell_size", PROPERTY_HINT_RANGE, NavigationDefaults2D::navmesh_cell_size_hint), NavigationDefaults2D::navmesh_cell_size);
 	GLOBAL_DEF("navigation/2d/use_edge_connections", true);
+	GLOBAL_DEF("navigation/2d/use_hierarchical_pathfinding", false);
+	GLOBAL_DEF("navigation/2d/use_async_iterations", false);
 	GLOBAL_DEF_BASIC("navigation/2d/default_edge_connection_margin", NavigationDefaults2D::edge_connection_margin);
 	GLOBAL_DEF_BASIC("navigation/2d/default_link_connection_radius", NavigationDefaults2D::link_connection_radius);
 
@@ -241,12 +252,16 @@ NavigationServer3D::NavigationServer3D() {
 	GLOBAL_DEF("navigation/3d/default_up", Vector3(0, 1, 0));
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "navigation/3d/merge_rasterizer_cell_scale", PROPERTY_HINT_RANGE, "0.001,1,0.001,or_greater"), 1.0);
 	GLOBAL_DEF("navigation/3d/use_edge_connections", true);
+	GLOBAL_DEF("navigation/3d/use_hierarchical_pathfinding", false);
+	GLOBAL_DEF("navigation/3d/use_async_iterations", false);
 	GLOBAL_DEF_BASIC("navigation/3d/default_edge_connection_margin", NavigationDefaults3D::edge_connection_margin);
 	GLOBAL_DEF_BASIC("navigation/3d/default_link_connection_radius", NavigationDefaults3D::link_connection_radius);
 
 	GLOBAL_DEF("navigation/avoidance/thread_model/avoidance_use_multiple_threads", true);
 	GLOBAL_DEF("navigation/avoidance/thread_model/avoidance_use_high_priority_threads", true);
 
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "navigation/pathfinding/max_async_path_queries_per_frame", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), 256);
+
 	GLOBAL_DEF("navigation/baking/use_crash_prevention_checks", true);
 	GLOBAL_DEF("navigation/baking/thread_model/baking_use_multiple_threads", true);
 	GLOBAL_DEF("navigation/baking/thread_model/baking_use_high_priority_threads", true);
@@ -945,6 +960,45 @@ void NavigationServer3D::query_path(const Ref<NavigationPathQueryParameters3D> &
 	p_query_result->set_path_types(_query_result.path_types);
 	p_query_result->set_path_rids(_query_result.path_rids);
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
+	p_query_result->set_path_length(_query_result.path_length);
+	p_query_result->set_explored_polygon_count(_query_result.explored_polygon_count);
+	p_query_result->set_query_time_usec(_query_result.query_time_usec);
+}
+
+int64_t NavigationServer3D::query_paths_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_V_MSG(p_query_parameters.size() != p_query_results.size(), 0, "The number of path query parameters and results must match.");
+
+	LocalVector<NavigationUtilities::PathQueryParameters> parameters;
+	parameters.resize(p_query_parameters.size());
+	for (int i = 0; i < p_query_parameters.size(); i++) {
+		const Ref<NavigationPathQueryParameters3D> query_parameters = p_query_parameters[i];
+		ERR_FAIL_COND_V(query_parameters.is_null(), 0);
+		ERR_FAIL_COND_V(Ref<NavigationPathQueryResult3D>(p_query_results[i]).is_null(), 0);
+		parameters[i] = query_parameters->get_parameters();
+	}
+
+	return _query_paths_async(parameters, callable_mp(this, &NavigationServer3D::_path_query_batch_finished).bind(p_query_results, p_callback));
+}
+
+void NavigationServer3D::_path_query_batch_finished(int64_t p_batch_id, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback) {
+	LocalVector<NavigationUtilities::PathQueryResult> results;
+	ERR_FAIL_COND(!_path_query_batch_get_results(p_batch_id, results));
+	ERR_FAIL_COND(results.size() != (uint32_t)p_query_results.size());
+
+	for (uint32_t i = 0; i < results.size(); i++) {
+		Ref<NavigationPathQueryResult3D> query_result = p_query_results[i];
+		query_result->set_path(results[i].path);
+		query_result->set_path_types(results[i].path_types);
+		query_result->set_path_rids(results[i].path_rids);
+		query_result->set_path_owner_ids(results[i].path_owner_ids);
+		query_result->set_path_length(results[i].path_length);
+		query_result->set_explored_polygon_count(results[i].explored_polygon_count);
+		query_result->set_query_time_usec(results[i].query_time_usec);
+	}
+
+	if (p_callback.is_valid()) {
+		p_callback.call(p_batch_id);
+	}
 }
 
 ///////////////////////////////////////////////////////
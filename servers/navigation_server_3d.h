@@ -35,6 +35,7 @@
 #include "core/templates/rid.h"
 
 #include "scene/resources/3d/navigation_mesh_source_geometry_data_3d.h"
+#include "scene/resources/3d/navigation_mesh_tiles_3d.h"
 #include "scene/resources/navigation_mesh.h"
 #include "servers/navigation/navigation_path_query_parameters_3d.h"
 #include "servers/navigation/navigation_path_query_result_3d.h"
@@ -90,6 +91,12 @@ public:
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) = 0;
 	virtual bool map_get_use_edge_connections(RID p_map) const = 0;
 
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const = 0;
+
+	virtual void map_set_use_async_iterations(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_async_iterations(RID p_map) const = 0;
+
 	/// Set the map edge connection margin used to weld the compatible region edges.
 	virtual void map_set_edge_connection_margin(RID p_map, real_t p_connection_margin) = 0;
 
@@ -347,9 +354,20 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const = 0;
 
+	/// Queues many path queries that are processed on worker threads between two server `process` calls.
+	/// The results are written to the result objects on the main thread before `p_callback` is called with the batch id.
+	int64_t query_paths_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback = Callable());
+	virtual bool is_path_query_batch_completed(int64_t p_batch_id) const = 0;
+
+	/// `p_callback` is called on the main thread with the batch id once all results of the batch are ready.
+	virtual int64_t _query_paths_async(const LocalVector<NavigationUtilities::PathQueryParameters> &p_parameters, const Callable &p_callback) = 0;
+	/// Moves the results of a finished batch, only valid while its callback runs.
+	virtual bool _path_query_batch_get_results(int64_t p_batch_id, LocalVector<NavigationUtilities::PathQueryResult> &r_results) = 0;
+
 #ifndef _3D_DISABLED
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) = 0;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) = 0;
+	virtual void bake_tiles_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Ref<NavigationMeshTiles3D> &p_navigation_mesh_tiles, const Callable &p_callback = Callable()) = 0;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) = 0;
 	virtual bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const = 0;
 #endif // _3D_DISABLED
@@ -373,6 +391,8 @@ public:
 		INFO_EDGE_CONNECTION_COUNT,
 		INFO_EDGE_FREE_COUNT,
 		INFO_OBSTACLE_COUNT,
+		INFO_MAP_SYNC_TIME,
+		INFO_AVOIDANCE_TIME,
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) const = 0;
@@ -381,6 +401,8 @@ public:
 	bool get_debug_enabled() const;
 
 private:
+	void _path_query_batch_finished(int64_t p_batch_id, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback);
+
 	bool debug_enabled = false;
 
 #ifdef DEBUG_ENABLED
@@ -123,6 +123,9 @@ public:
 		return physics_server_2d->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(PackedByteArray, space_get_snapshot, RID);
+	FUNC2R(bool, space_restore_snapshot, RID, const PackedByteArray &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
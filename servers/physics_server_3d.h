@@ -308,6 +308,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	virtual PackedByteArray space_get_snapshot(RID p_space) const = 0;
+	virtual bool space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
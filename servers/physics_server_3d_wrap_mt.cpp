@@ -48,11 +48,184 @@ void PhysicsServer3DWrapMT::_thread_loop() {
 	}
 }
 
+void PhysicsServer3DWrapMT::_thread_step(real_t p_delta, uint64_t p_step, const Vector<RID> &p_changed_bodies) {
+	for (const RID &body : p_changed_bodies) {
+		body_state_dirty[0].insert(body);
+		body_state_dirty[1].insert(body);
+	}
+
+	physics_server_3d->step(p_delta);
+	_body_state_publish(p_step);
+}
+
+/* BODY STATE PUBLISHING */
+
+void PhysicsServer3DWrapMT::_body_state_track(RID p_body) {
+	body_state_bodies.insert(p_body);
+}
+
+void PhysicsServer3DWrapMT::_body_state_untrack(RID p_body) {
+	if (body_state_bodies.erase(p_body)) {
+		body_state_removed[0].push_back(p_body);
+		body_state_removed[1].push_back(p_body);
+	}
+}
+
+void PhysicsServer3DWrapMT::_body_state_publish(uint64_t p_step) {
+	BodyStateBuffer &buffer = body_state_buffers[p_step % 2];
+	HashSet<RID> &dirty = body_state_dirty[p_step % 2];
+
+	for (const RID &body : body_state_removed[p_step % 2]) {
+		buffer.states.erase(body);
+	}
+	body_state_removed[p_step % 2].clear();
+
+	for (const RID &body : body_state_bodies) {
+		const bool sleeping = physics_server_3d->body_get_state(body, BODY_STATE_SLEEPING);
+		BodyStateCache *state = buffer.states.getptr(body);
+		if (state && state->sleeping && sleeping && !dirty.has(body)) {
+			// Sleeping bodies don't move, the state from two steps ago is still valid.
+			continue;
+		}
+
+		if (!state) {
+			state = &buffer.states.insert(body, BodyStateCache())->value;
+		}
+		state->transform = physics_server_3d->body_get_state(body, BODY_STATE_TRANSFORM);
+		state->linear_velocity = physics_server_3d->body_get_state(body, BODY_STATE_LINEAR_VELOCITY);
+		state->angular_velocity = physics_server_3d->body_get_state(body, BODY_STATE_ANGULAR_VELOCITY);
+		state->sleeping = sleeping;
+	}
+	dirty.clear();
+
+	buffer.step = p_step;
+	body_state_front.store(&buffer, std::memory_order_release);
+}
+
+void PhysicsServer3DWrapMT::_body_state_created(RID p_body) {
+	if (!create_thread) {
+		return;
+	}
+
+	{
+		MutexLock lock(body_state_mutex);
+		body_state_rids.insert(p_body);
+	}
+	command_queue.push(this, &PhysicsServer3DWrapMT::_body_state_track, p_body);
+}
+
+void PhysicsServer3DWrapMT::_body_state_freed(RID p_body) {
+	if (!create_thread) {
+		return;
+	}
+
+	bool is_body;
+	{
+		MutexLock lock(body_state_mutex);
+		is_body = body_state_rids.erase(p_body);
+	}
+	if (is_body) {
+		_body_state_changed(p_body);
+		command_queue.push(this, &PhysicsServer3DWrapMT::_body_state_untrack, p_body);
+	}
+}
+
+void PhysicsServer3DWrapMT::_body_state_changed(RID p_body) {
+	if (!create_thread) {
+		return;
+	}
+
+	if (!Thread::is_main_thread()) {
+		MutexLock lock(body_state_mutex);
+		body_state_thread_changes.push_back(p_body);
+		body_state_thread_changes_pending.set();
+		return;
+	}
+
+	// The change is pushed before the next step, so that step is the first one to publish it.
+	body_state_changes[p_body] = body_state_pushed_step;
+	body_state_step_changes.push_back(p_body);
+}
+
+void PhysicsServer3DWrapMT::_body_state_flush_thread_changes() {
+	if (!body_state_thread_changes_pending.is_set()) {
+		return;
+	}
+
+	MutexLock lock(body_state_mutex);
+	for (const RID &body : body_state_thread_changes) {
+		body_state_changes[body] = body_state_pushed_step;
+		body_state_step_changes.push_back(body);
+	}
+	body_state_thread_changes.clear();
+	body_state_thread_changes_pending.clear();
+}
+
+bool PhysicsServer3DWrapMT::_thread_space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) {
+	if (!physics_server_3d->space_restore_snapshot(p_space, p_snapshot)) {
+		return false;
+	}
+
+	// The published states of the restored bodies are stale until the next step publishes them again.
+	for (const RID &body : body_state_bodies) {
+		if (physics_server_3d->body_get_space(body) == p_space) {
+			_body_state_changed(body);
+		}
+	}
+	return true;
+}
+
+bool PhysicsServer3DWrapMT::_body_state_get_published(RID p_body, BodyState p_state, Variant &r_value) const {
+	// Another thread could read a buffer while it's being written, the main thread can't.
+	if (!create_thread || !Thread::is_main_thread() || body_state_thread_changes_pending.is_set()) {
+		return false;
+	}
+
+	const BodyStateBuffer *buffer = body_state_front.load(std::memory_order_acquire);
+	if (!buffer) {
+		return false;
+	}
+
+	const uint64_t *changed_step = body_state_changes.getptr(p_body);
+	if (changed_step && *changed_step >= buffer->step) {
+		return false;
+	}
+
+	const BodyStateCache *state = buffer->states.getptr(p_body);
+	if (!state) {
+		return false;
+	}
+
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM:
+			r_value = state->transform;
+			return true;
+		case BODY_STATE_LINEAR_VELOCITY:
+			r_value = state->linear_velocity;
+			return true;
+		case BODY_STATE_ANGULAR_VELOCITY:
+			r_value = state->angular_velocity;
+			return true;
+		case BODY_STATE_SLEEPING:
+			r_value = state->sleeping;
+			return true;
+		default:
+			return false;
+	}
+}
+
 /* EVENT QUEUING */
 
 void PhysicsServer3DWrapMT::step(real_t p_step) {
 	if (create_thread) {
-		command_queue.push(physics_server_3d, &PhysicsServer3D::step, p_step);
+		_body_state_flush_thread_changes();
+		Vector<RID> changed_bodies;
+		changed_bodies.resize(body_state_step_changes.size());
+		for (uint32_t i = 0; i < body_state_step_changes.size(); i++) {
+			changed_bodies.write[i] = body_state_step_changes[i];
+		}
+		body_state_step_changes.clear();
+		command_queue.push(this, &PhysicsServer3DWrapMT::_thread_step, p_step, ++body_state_pushed_step, changed_bodies);
 	} else {
 		physics_server_3d->step(p_step);
 	}
@@ -61,6 +234,20 @@ void PhysicsServer3DWrapMT::step(real_t p_step) {
 void PhysicsServer3DWrapMT::sync() {
 	if (create_thread) {
 		command_queue.sync();
+
+		_body_state_flush_thread_changes();
+
+		// Both buffers have been written since these changes, nothing needs them anymore.
+		const BodyStateBuffer *buffer = body_state_front.load(std::memory_order_acquire);
+		const uint64_t published_step = buffer ? buffer->step : 0;
+		for (HashMap<RID, uint64_t>::Iterator E = body_state_changes.begin(); E;) {
+			HashMap<RID, uint64_t>::Iterator next = E;
+			++next;
+			if (E->value + 1 < published_step) {
+				body_state_changes.remove(E);
+			}
+			E = next;
+		}
 	} else {
 		command_queue.flush_all(); // Flush all pending from other threads.
 	}
@@ -33,8 +33,12 @@
 
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
 #include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/physics_server_3d.h"
 
 #ifdef DEBUG_SYNC
@@ -63,9 +67,57 @@ class PhysicsServer3DWrapMT : public PhysicsServer3D {
 
 	void _assign_mt_ids(WorkerThreadPool::TaskID p_pump_task_id);
 	void _thread_exit();
-	void _thread_step(real_t p_delta);
+	void _thread_step(real_t p_delta, uint64_t p_step, const Vector<RID> &p_changed_bodies);
 	void _thread_loop();
 
+	// With a physics thread, the state of every body is published after each step so the main thread can
+	// read it while the next step runs, instead of waiting for the physics thread to catch up.
+	// Step N is written to body_state_buffers[N % 2], then made the front buffer. The main thread reads the
+	// front buffer without locking. It can't be overwritten before the main thread pushes step N + 2, which
+	// Main only does after syncing.
+	struct BodyStateCache {
+		Transform3D transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		bool sleeping = false;
+	};
+
+	struct BodyStateBuffer {
+		HashMap<RID, BodyStateCache> states;
+		uint64_t step = 0;
+	};
+
+	BodyStateBuffer body_state_buffers[2];
+	std::atomic<BodyStateBuffer *> body_state_front = nullptr;
+
+	// Only accessed from the main thread.
+	// Step after which each body was last changed through the server, its published state is stale until then.
+	HashMap<RID, uint64_t> body_state_changes;
+	LocalVector<RID> body_state_step_changes;
+	uint64_t body_state_pushed_step = 0;
+
+	// Changes made from other threads, moved to the main thread ones on the next step or sync.
+	// Published states aren't read while some are pending.
+	LocalVector<RID> body_state_thread_changes;
+	SafeFlag body_state_thread_changes_pending;
+	HashSet<RID> body_state_rids;
+	BinaryMutex body_state_mutex;
+
+	// Only accessed from the physics thread.
+	HashSet<RID> body_state_bodies;
+	HashSet<RID> body_state_dirty[2];
+	LocalVector<RID> body_state_removed[2];
+
+	void _body_state_track(RID p_body);
+	void _body_state_untrack(RID p_body);
+	void _body_state_publish(uint64_t p_step);
+	void _body_state_created(RID p_body);
+	void _body_state_freed(RID p_body);
+	void _body_state_changed(RID p_body);
+	void _body_state_flush_thread_changes();
+	bool _thread_space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot);
+	bool _body_state_get_published(RID p_body, BodyState p_state, Variant &r_value) const;
+
 public:
 #define ServerName PhysicsServer3D
 #define ServerNameWrapMT PhysicsServer3DWrapMT
@@ -74,6 +126,29 @@ public:
 
 #include "servers/server_wrap_mt_common.h"
 
+// Same as FUNC2/FUNC3, for body setters that invalidate the published state of the body.
+#define FUNC2BS(m_type, m_arg2)                                           \
+	virtual void m_type(RID p1, m_arg2 p2) override {                     \
+		_body_state_changed(p1);                                          \
+		if (Thread::get_caller_id() != server_thread) {                   \
+			command_queue.push(server_name, &ServerName::m_type, p1, p2); \
+		} else {                                                          \
+			command_queue.flush_if_pending();                             \
+			server_name->m_type(p1, p2);                                  \
+		}                                                                 \
+	}
+
+#define FUNC3BS(m_type, m_arg2, m_arg3)                                       \
+	virtual void m_type(RID p1, m_arg2 p2, m_arg3 p3) override {              \
+		_body_state_changed(p1);                                              \
+		if (Thread::get_caller_id() != server_thread) {                       \
+			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3); \
+		} else {                                                              \
+			command_queue.flush_if_pending();                                 \
+			server_name->m_type(p1, p2, p3);                                  \
+		}                                                                     \
+	}
+
 	//FUNC1RID(shape,ShapeType); todo fix
 	FUNCRID(world_boundary_shape)
 	FUNCRID(separation_ray_shape)
@@ -128,6 +203,21 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(PackedByteArray, space_get_snapshot, RID);
+
+	virtual bool space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) override {
+		if (Thread::get_caller_id() != server_thread) {
+			bool ret;
+			command_queue.push_and_ret(this, &PhysicsServer3DWrapMT::_thread_space_restore_snapshot, p_space, p_snapshot, &ret);
+			SYNC_DEBUG
+			MAIN_THREAD_SYNC_CHECK
+			return ret;
+		} else {
+			command_queue.flush_if_pending();
+			return _thread_space_restore_snapshot(p_space, p_snapshot);
+		}
+	}
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -171,12 +261,16 @@ public:
 	/* BODY API */
 
 	//FUNC2RID(body,BodyMode,bool);
-	FUNCRID(body)
+	virtual RID body_create() override {
+		RID body = physics_server_3d->body_create();
+		_body_state_created(body);
+		return body;
+	}
 
-	FUNC2(body_set_space, RID, RID);
+	FUNC2BS(body_set_space, RID);
 	FUNC1RC(RID, body_get_space, RID);
 
-	FUNC2(body_set_mode, RID, BodyMode);
+	FUNC2BS(body_set_mode, BodyMode);
 	FUNC1RC(BodyMode, body_get_mode, RID);
 
 	FUNC4(body_add_shape, RID, RID, const Transform3D &, bool);
@@ -215,12 +309,27 @@ public:
 
 	FUNC1(body_reset_mass_properties, RID);
 
-	FUNC3(body_set_state, RID, BodyState, const Variant &);
-	FUNC2RC(Variant, body_get_state, RID, BodyState);
+	FUNC3BS(body_set_state, BodyState, const Variant &);
+
+	virtual Variant body_get_state(RID p_body, BodyState p_state) const override {
+		Variant ret;
+		if (_body_state_get_published(p_body, p_state, ret)) {
+			return ret;
+		}
+		if (Thread::get_caller_id() != server_thread) {
+			command_queue.push_and_ret(physics_server_3d, &PhysicsServer3D::body_get_state, p_body, p_state, &ret);
+			SYNC_DEBUG
+			MAIN_THREAD_SYNC_CHECK
+			return ret;
+		} else {
+			command_queue.flush_if_pending();
+			return physics_server_3d->body_get_state(p_body, p_state);
+		}
+	}
 
-	FUNC2(body_apply_torque_impulse, RID, const Vector3 &);
-	FUNC2(body_apply_central_impulse, RID, const Vector3 &);
-	FUNC3(body_apply_impulse, RID, const Vector3 &, const Vector3 &);
+	FUNC2BS(body_apply_torque_impulse, const Vector3 &);
+	FUNC2BS(body_apply_central_impulse, const Vector3 &);
+	FUNC3BS(body_apply_impulse, const Vector3 &, const Vector3 &);
 
 	FUNC2(body_apply_central_force, RID, const Vector3 &);
 	FUNC3(body_apply_force, RID, const Vector3 &, const Vector3 &);
@@ -236,7 +345,7 @@ public:
 	FUNC2(body_set_constant_torque, RID, const Vector3 &);
 	FUNC1RC(Vector3, body_get_constant_torque, RID);
 
-	FUNC2(body_set_axis_velocity, RID, const Vector3 &);
+	FUNC2BS(body_set_axis_velocity, const Vector3 &);
 
 	FUNC3(body_set_axis_lock, RID, BodyAxis, bool);
 	FUNC2RC(bool, body_is_axis_locked, RID, BodyAxis);
@@ -379,7 +488,15 @@ public:
 
 	/* MISC */
 
-	FUNC1(free, RID);
+	virtual void free(RID p_rid) override {
+		_body_state_freed(p_rid);
+		if (Thread::get_caller_id() != server_thread) {
+			command_queue.push(physics_server_3d, &PhysicsServer3D::free, p_rid);
+		} else {
+			command_queue.flush_if_pending();
+			physics_server_3d->free(p_rid);
+		}
+	}
 	FUNC1(set_active, bool);
 
 	virtual void init() override;
@@ -400,6 +517,8 @@ public:
 	PhysicsServer3DWrapMT(PhysicsServer3D *p_contained, bool p_create_thread);
 	~PhysicsServer3DWrapMT();
 
+#undef FUNC2BS
+#undef FUNC3BS
 #undef ServerNameWrapMT
 #undef ServerName
 #undef server_name
@@ -44,6 +44,52 @@ MaterialStorage::~MaterialStorage() {
 	singleton = nullptr;
 }
 
+void MaterialStorage::global_shader_parameter_add(const StringName &p_name, RS::GlobalShaderParameterType p_type, const Variant &p_value) {
+	ERR_FAIL_COND(global_shader_parameters.has(p_name));
+	DummyGlobalShaderParameter parameter;
+	parameter.type = p_type;
+	parameter.value = p_value;
+	global_shader_parameters.insert(p_name, parameter);
+}
+
+void MaterialStorage::global_shader_parameter_remove(const StringName &p_name) {
+	global_shader_parameters.erase(p_name);
+}
+
+Vector<StringName> MaterialStorage::global_shader_parameter_get_list() const {
+	Vector<StringName> names;
+	for (const KeyValue<StringName, DummyGlobalShaderParameter> &E : global_shader_parameters) {
+		names.push_back(E.key);
+	}
+	return names;
+}
+
+void MaterialStorage::global_shader_parameter_set(const StringName &p_name, const Variant &p_value) {
+	DummyGlobalShaderParameter *parameter = global_shader_parameters.getptr(p_name);
+	ERR_FAIL_NULL(parameter);
+	parameter->value = p_value;
+}
+
+Variant MaterialStorage::global_shader_parameter_get(const StringName &p_name) const {
+	const DummyGlobalShaderParameter *parameter = global_shader_parameters.getptr(p_name);
+	if (!parameter) {
+		return Variant();
+	}
+	return parameter->value;
+}
+
+RS::GlobalShaderParameterType MaterialStorage::global_shader_parameter_get_type(const StringName &p_name) const {
+	const DummyGlobalShaderParameter *parameter = global_shader_parameters.getptr(p_name);
+	if (!parameter) {
+		return RS::GLOBAL_VAR_TYPE_MAX;
+	}
+	return parameter->type;
+}
+
+void MaterialStorage::global_shader_parameters_clear() {
+	global_shader_parameters.clear();
+}
+
 RID MaterialStorage::shader_allocate() {
 	return shader_owner.allocate_rid();
 }
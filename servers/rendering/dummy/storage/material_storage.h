@@ -50,6 +50,14 @@ private:
 
 	ShaderCompiler dummy_compiler;
 
+	// Kept so global uniforms can be type checked when compiling shaders in the editor.
+	struct DummyGlobalShaderParameter {
+		RS::GlobalShaderParameterType type = RS::GLOBAL_VAR_TYPE_MAX;
+		Variant value;
+	};
+
+	HashMap<StringName, DummyGlobalShaderParameter> global_shader_parameters;
+
 public:
 	static MaterialStorage *get_singleton() { return singleton; }
 
@@ -58,17 +66,17 @@ public:
 
 	/* GLOBAL SHADER UNIFORM API */
 
-	virtual void global_shader_parameter_add(const StringName &p_name, RS::GlobalShaderParameterType p_type, const Variant &p_value) override {}
-	virtual void global_shader_parameter_remove(const StringName &p_name) override {}
-	virtual Vector<StringName> global_shader_parameter_get_list() const override { return Vector<StringName>(); }
+	virtual void global_shader_parameter_add(const StringName &p_name, RS::GlobalShaderParameterType p_type, const Variant &p_value) override;
+	virtual void global_shader_parameter_remove(const StringName &p_name) override;
+	virtual Vector<StringName> global_shader_parameter_get_list() const override;
 
-	virtual void global_shader_parameter_set(const StringName &p_name, const Variant &p_value) override {}
+	virtual void global_shader_parameter_set(const StringName &p_name, const Variant &p_value) override;
 	virtual void global_shader_parameter_set_override(const StringName &p_name, const Variant &p_value) override {}
-	virtual Variant global_shader_parameter_get(const StringName &p_name) const override { return Variant(); }
-	virtual RS::GlobalShaderParameterType global_shader_parameter_get_type(const StringName &p_name) const override { return RS::GLOBAL_VAR_TYPE_MAX; }
+	virtual Variant global_shader_parameter_get(const StringName &p_name) const override;
+	virtual RS::GlobalShaderParameterType global_shader_parameter_get_type(const StringName &p_name) const override;
 
 	virtual void global_shader_parameters_load_settings(bool p_load_textures = true) override {}
-	virtual void global_shader_parameters_clear() override {}
+	virtual void global_shader_parameters_clear() override;
 
 	virtual int32_t global_shader_parameters_instance_allocate(RID p_instance) override { return 0; }
 	virtual void global_shader_parameters_instance_free(RID p_instance) override {}
@@ -110,6 +118,7 @@ public:
 	virtual bool material_is_animated(RID p_material) override { return false; }
 	virtual bool material_casts_shadows(RID p_material) override { return false; }
 	virtual void material_get_instance_shader_parameters(RID p_material, List<InstanceShaderParam> *r_parameters) override {}
+	virtual void material_get_streamed_textures(RID p_material, LocalVector<RID> *r_textures) override {}
 	virtual void material_update_dependency(RID p_material, DependencyTracker *p_instance) override {}
 };
 
@@ -111,7 +111,14 @@ public:
 	virtual Ref<Image> texture_2d_layer_get(RID p_texture, int p_layer) const override { return Ref<Image>(); };
 	virtual Vector<Ref<Image>> texture_3d_get(RID p_texture) const override { return Vector<Ref<Image>>(); };
 
-	virtual void texture_replace(RID p_texture, RID p_by_texture) override { texture_free(p_by_texture); };
+	virtual void texture_replace(RID p_texture, RID p_by_texture) override {
+		DummyTexture *t = texture_owner.get_or_null(p_texture);
+		ERR_FAIL_NULL(t);
+		DummyTexture *by_t = texture_owner.get_or_null(p_by_texture);
+		ERR_FAIL_NULL(by_t);
+		t->image = by_t->image;
+		texture_free(p_by_texture);
+	};
 	virtual void texture_set_size_override(RID p_texture, int p_width, int p_height) override {}
 
 	virtual void texture_set_path(RID p_texture, const String &p_path) override {}
@@ -126,6 +133,7 @@ public:
 	virtual void texture_debug_usage(List<RS::TextureInfo> *r_info) override {}
 
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) override {}
+	virtual void texture_set_streaming(RID p_texture, bool p_enable) override {}
 
 	virtual Size2 texture_size_with_proxy(RID p_proxy) override { return Size2(); };
 
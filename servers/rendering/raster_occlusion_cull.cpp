@@ -0,0 +1,527 @@
+/**************************************************************************/
+/*  raster_occlusion_cull.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "raster_occlusion_cull.h"
+
+#include "core/object/worker_thread_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_OCCLUSION_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define RASTER_OCCLUSION_NEON
+#include <arm_neon.h>
+#endif
+
+// Four pixels of a span, processed together.
+namespace {
+#if defined(RASTER_OCCLUSION_SSE2)
+typedef __m128 Float4;
+typedef __m128 Mask4;
+
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return _mm_set1_ps(p_value); }
+_FORCE_INLINE_ Float4 f4_ramp(float p_value, float p_step) { return _mm_setr_ps(p_value, p_value + p_step, p_value + 2.0f * p_step, p_value + 3.0f * p_step); }
+_FORCE_INLINE_ Float4 f4_load(const float *p_ptr) { return _mm_loadu_ps(p_ptr); }
+_FORCE_INLINE_ void f4_store(float *p_ptr, Float4 p_value) { _mm_storeu_ps(p_ptr, p_value); }
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return _mm_add_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_min(Float4 p_a, Float4 p_b) { return _mm_min_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_inverse(Float4 p_value) { return _mm_div_ps(_mm_set1_ps(1.0f), p_value); }
+_FORCE_INLINE_ Mask4 m4_inside(Float4 p_a, Float4 p_b, Float4 p_c) {
+	const __m128 zero = _mm_setzero_ps();
+	return _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(p_a, zero), _mm_cmpge_ps(p_b, zero)), _mm_cmpge_ps(p_c, zero));
+}
+_FORCE_INLINE_ bool m4_any(Mask4 p_mask) { return _mm_movemask_ps(p_mask) != 0; }
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return _mm_or_ps(_mm_and_ps(p_mask, p_a), _mm_andnot_ps(p_mask, p_b)); }
+#elif defined(RASTER_OCCLUSION_NEON)
+typedef float32x4_t Float4;
+typedef uint32x4_t Mask4;
+
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return vdupq_n_f32(p_value); }
+_FORCE_INLINE_ Float4 f4_ramp(float p_value, float p_step) {
+	const float values[4] = { p_value, p_value + p_step, p_value + 2.0f * p_step, p_value + 3.0f * p_step };
+	return vld1q_f32(values);
+}
+_FORCE_INLINE_ Float4 f4_load(const float *p_ptr) { return vld1q_f32(p_ptr); }
+_FORCE_INLINE_ void f4_store(float *p_ptr, Float4 p_value) { vst1q_f32(p_ptr, p_value); }
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return vaddq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_min(Float4 p_a, Float4 p_b) { return vminq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 f4_inverse(Float4 p_value) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+	return vdivq_f32(vdupq_n_f32(1.0f), p_value);
+#else
+	// No division on 32-bit NEON, refine the estimate with two Newton-Raphson steps instead.
+	Float4 inverse = vrecpeq_f32(p_value);
+	inverse = vmulq_f32(vrecpsq_f32(p_value, inverse), inverse);
+	return vmulq_f32(vrecpsq_f32(p_value, inverse), inverse);
+#endif
+}
+_FORCE_INLINE_ Mask4 m4_inside(Float4 p_a, Float4 p_b, Float4 p_c) {
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	return vandq_u32(vandq_u32(vcgeq_f32(p_a, zero), vcgeq_f32(p_b, zero)), vcgeq_f32(p_c, zero));
+}
+_FORCE_INLINE_ bool m4_any(Mask4 p_mask) {
+	uint32x2_t folded = vorr_u32(vget_low_u32(p_mask), vget_high_u32(p_mask));
+	return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+}
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) { return vbslq_f32(p_mask, p_a, p_b); }
+#else
+struct Float4 {
+	float v[4];
+};
+struct Mask4 {
+	bool v[4];
+};
+
+_FORCE_INLINE_ Float4 f4_set(float p_value) { return { { p_value, p_value, p_value, p_value } }; }
+_FORCE_INLINE_ Float4 f4_ramp(float p_value, float p_step) { return { { p_value, p_value + p_step, p_value + 2.0f * p_step, p_value + 3.0f * p_step } }; }
+_FORCE_INLINE_ Float4 f4_load(const float *p_ptr) { return { { p_ptr[0], p_ptr[1], p_ptr[2], p_ptr[3] } }; }
+_FORCE_INLINE_ void f4_store(float *p_ptr, Float4 p_value) {
+	for (int i = 0; i < 4; i++) {
+		p_ptr[i] = p_value.v[i];
+	}
+}
+_FORCE_INLINE_ Float4 f4_add(Float4 p_a, Float4 p_b) { return { { p_a.v[0] + p_b.v[0], p_a.v[1] + p_b.v[1], p_a.v[2] + p_b.v[2], p_a.v[3] + p_b.v[3] } }; }
+_FORCE_INLINE_ Float4 f4_min(Float4 p_a, Float4 p_b) { return { { MIN(p_a.v[0], p_b.v[0]), MIN(p_a.v[1], p_b.v[1]), MIN(p_a.v[2], p_b.v[2]), MIN(p_a.v[3], p_b.v[3]) } }; }
+_FORCE_INLINE_ Float4 f4_inverse(Float4 p_value) { return { { 1.0f / p_value.v[0], 1.0f / p_value.v[1], 1.0f / p_value.v[2], 1.0f / p_value.v[3] } }; }
+_FORCE_INLINE_ Mask4 m4_inside(Float4 p_a, Float4 p_b, Float4 p_c) {
+	Mask4 mask;
+	for (int i = 0; i < 4; i++) {
+		mask.v[i] = p_a.v[i] >= 0.0f && p_b.v[i] >= 0.0f && p_c.v[i] >= 0.0f;
+	}
+	return mask;
+}
+_FORCE_INLINE_ bool m4_any(Mask4 p_mask) { return p_mask.v[0] || p_mask.v[1] || p_mask.v[2] || p_mask.v[3]; }
+_FORCE_INLINE_ Float4 f4_select(Mask4 p_mask, Float4 p_a, Float4 p_b) {
+	Float4 result;
+	for (int i = 0; i < 4; i++) {
+		result.v[i] = p_mask.v[i] ? p_a.v[i] : p_b.v[i];
+	}
+	return result;
+}
+#endif
+} // namespace
+
+void RasterOcclusionCull::RasterHZBuffer::clear() {
+	HZBuffer::clear();
+
+	depth.clear();
+	depth_stride = 0;
+}
+
+void RasterOcclusionCull::RasterHZBuffer::resize(const Size2i &p_size) {
+	if (p_size == Size2i()) {
+		clear();
+		return;
+	}
+
+	if (!sizes.is_empty() && p_size == sizes[0]) {
+		return; // Size didn't change
+	}
+
+	HZBuffer::resize(p_size);
+
+	depth_stride = (p_size.x + 3) & ~3;
+	depth.resize(depth_stride * p_size.y);
+}
+
+////////////////////////////////////////////////////////
+
+bool RasterOcclusionCull::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RasterOcclusionCull::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RasterOcclusionCull::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RasterOcclusionCull::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+	occluder->version++; // Instances using it transform their vertices again on the next update.
+}
+
+void RasterOcclusionCull::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_scenario(RID p_scenario) {
+	ERR_FAIL_COND(scenarios.has(p_scenario));
+	scenarios[p_scenario] = Scenario();
+}
+
+void RasterOcclusionCull::remove_scenario(RID p_scenario) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	scenarios.erase(p_scenario);
+}
+
+void RasterOcclusionCull::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	OccluderInstance &instance = scenario->instances[p_instance];
+
+	if (instance.occluder != p_occluder || instance.xform != p_xform) {
+		instance.occluder = p_occluder;
+		instance.xform = p_xform;
+		instance.occluder_version = 0;
+	}
+
+	instance.enabled = p_enabled;
+}
+
+void RasterOcclusionCull::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+	scenario->instances.erase(p_instance);
+}
+
+void RasterOcclusionCull::_update_instance(OccluderInstance &p_instance, const Occluder *p_occluder) {
+	int vertex_count = p_occluder->vertices.size();
+	const Vector3 *read = p_occluder->vertices.ptr();
+
+	p_instance.xformed_vertices.resize(vertex_count);
+	p_instance.aabb = AABB();
+
+	for (int i = 0; i < vertex_count; i++) {
+		Vector3 vertex = p_instance.xform.xform(read[i]);
+		p_instance.xformed_vertices[i] = vertex;
+		if (i == 0) {
+			p_instance.aabb.position = vertex;
+		} else {
+			p_instance.aabb.expand_to(vertex);
+		}
+	}
+
+	p_instance.occluder_version = p_occluder->version;
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::_clip_and_setup_triangle(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c, const Projection &p_cam_projection, real_t p_z_near, const Size2i &p_size, bool p_orthogonal) {
+	const Vector3 *corners[3] = { &p_a, &p_b, &p_c };
+
+	int inside_count = 0;
+	for (int i = 0; i < 3; i++) {
+		inside_count += (-corners[i]->z >= p_z_near) ? 1 : 0;
+	}
+
+	if (inside_count == 0) {
+		return;
+	}
+
+	if (inside_count == 3) {
+		const Vector3 view[3] = { p_a, p_b, p_c };
+		_setup_triangle(view, p_cam_projection, p_z_near, p_size, p_orthogonal);
+		return;
+	}
+
+	// Clip against the near plane, which leaves either a triangle or a quad.
+	Vector3 clipped[4];
+	int clipped_count = 0;
+
+	for (int i = 0; i < 3; i++) {
+		const Vector3 &current = *corners[i];
+		const Vector3 &next = *corners[(i + 1) % 3];
+		bool current_inside = -current.z >= p_z_near;
+		bool next_inside = -next.z >= p_z_near;
+
+		if (current_inside) {
+			clipped[clipped_count++] = current;
+		}
+
+		if (current_inside != next_inside) {
+			real_t t = (-p_z_near - current.z) / (next.z - current.z);
+			Vector3 intersection = current.lerp(next, t);
+			intersection.z = -p_z_near;
+			clipped[clipped_count++] = intersection;
+		}
+	}
+
+	for (int i = 2; i < clipped_count; i++) {
+		const Vector3 view[3] = { clipped[0], clipped[i - 1], clipped[i] };
+		_setup_triangle(view, p_cam_projection, p_z_near, p_size, p_orthogonal);
+	}
+}
+
+void RasterOcclusionCull::_setup_triangle(const Vector3 p_view[3], const Projection &p_cam_projection, real_t p_z_near, const Size2i &p_size, bool p_orthogonal) {
+	double x[3];
+	double y[3];
+	double z[3];
+
+	for (int i = 0; i < 3; i++) {
+		Vector3 ndc = p_cam_projection.xform(p_view[i]);
+		x[i] = (ndc.x * 0.5 + 0.5) * p_size.x;
+		y[i] = (ndc.y * 0.5 + 0.5) * p_size.y;
+
+		// View depth is linear in screen space for orthogonal projections, its inverse is for perspective ones.
+		double view_depth = MAX(-p_view[i].z, p_z_near);
+		z[i] = p_orthogonal ? view_depth : 1.0 / view_depth;
+	}
+
+	double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (Math::abs(area) < CMP_EPSILON) {
+		return;
+	}
+
+	// Occluders are double sided, make every triangle counter-clockwise.
+	if (area < 0.0) {
+		SWAP(x[1], x[2]);
+		SWAP(y[1], y[2]);
+		SWAP(z[1], z[2]);
+		area = -area;
+	}
+
+	// A pixel is covered when its center is inside the triangle.
+	Triangle triangle;
+	triangle.min_x = MAX(0, (int)Math::ceil(MIN(x[0], MIN(x[1], x[2])) - 0.5));
+	triangle.min_y = MAX(0, (int)Math::ceil(MIN(y[0], MIN(y[1], y[2])) - 0.5));
+	triangle.max_x = MIN(p_size.x - 1, (int)Math::floor(MAX(x[0], MAX(x[1], x[2])) - 0.5));
+	triangle.max_y = MIN(p_size.y - 1, (int)Math::floor(MAX(y[0], MAX(y[1], y[2])) - 0.5));
+
+	if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) {
+		return;
+	}
+
+	// Everything is evaluated relative to the center of the first pixel, to keep precision with floats.
+	double origin_x = triangle.min_x + 0.5;
+	double origin_y = triangle.min_y + 0.5;
+
+	double depth_a = 0.0;
+	double depth_b = 0.0;
+	double depth_c = 0.0;
+
+	for (int i = 0; i < 3; i++) {
+		int next = (i + 1) % 3;
+		int opposite = (i + 2) % 3;
+
+		double a = y[i] - y[next];
+		double b = x[next] - x[i];
+		double c = a * (origin_x - x[i]) + b * (origin_y - y[i]);
+
+		triangle.edge_a[i] = a;
+		triangle.edge_b[i] = b;
+		triangle.edge_c[i] = c;
+
+		depth_a += a * z[opposite];
+		depth_b += b * z[opposite];
+		depth_c += c * z[opposite];
+	}
+
+	triangle.depth_a = depth_a / area;
+	triangle.depth_b = depth_b / area;
+	triangle.depth_c = depth_c / area;
+
+	triangles.push_back(triangle);
+}
+
+void RasterOcclusionCull::_raster_band(uint32_t p_band, const RasterThreadData *p_data) {
+	RasterHZBuffer &buffer = *p_data->buffer;
+	const Size2i &size = buffer.sizes[0];
+	const uint32_t stride = buffer.depth_stride;
+
+	int from = p_band * size.y / p_data->band_count;
+	int to = (p_band + 1) * size.y / p_data->band_count;
+
+	float *depth = buffer.depth.ptr();
+	for (uint32_t i = from * stride; i < to * stride; i++) {
+		depth[i] = FLT_MAX;
+	}
+
+	for (uint32_t i = 0; i < p_data->triangle_count; i++) {
+		const Triangle &triangle = p_data->triangles[i];
+		if (triangle.max_y < from || triangle.min_y >= to) {
+			continue;
+		}
+
+		// Spans start on a multiple of four, so the first pixels may be left of the triangle bounds.
+		int span_x = triangle.min_x & ~3;
+		float span_offset = span_x - triangle.min_x;
+
+		Float4 edge_step[3];
+		for (int j = 0; j < 3; j++) {
+			edge_step[j] = f4_set(triangle.edge_a[j] * 4.0f);
+		}
+		Float4 depth_step = f4_set(triangle.depth_a * 4.0f);
+
+		int min_y = MAX(from, triangle.min_y);
+		int max_y = MIN(to - 1, triangle.max_y);
+
+		for (int y = min_y; y <= max_y; y++) {
+			float row = y - triangle.min_y;
+
+			Float4 edge[3];
+			for (int j = 0; j < 3; j++) {
+				edge[j] = f4_ramp(triangle.edge_a[j] * span_offset + triangle.edge_b[j] * row + triangle.edge_c[j], triangle.edge_a[j]);
+			}
+			Float4 interpolated = f4_ramp(triangle.depth_a * span_offset + triangle.depth_b * row + triangle.depth_c, triangle.depth_a);
+
+			float *pixels = &depth[y * stride];
+
+			for (int x = span_x; x <= triangle.max_x; x += 4) {
+				Mask4 inside = m4_inside(edge[0], edge[1], edge[2]);
+				if (m4_any(inside)) {
+					Float4 fragment = p_data->orthogonal ? interpolated : f4_inverse(interpolated);
+					Float4 current = f4_load(&pixels[x]);
+					f4_store(&pixels[x], f4_select(inside, f4_min(current, fragment), current));
+				}
+
+				for (int j = 0; j < 3; j++) {
+					edge[j] = f4_add(edge[j], edge_step[j]);
+				}
+				interpolated = f4_add(interpolated, depth_step);
+			}
+		}
+	}
+
+	float *mip = buffer.mips[0];
+	for (int y = from; y < to; y++) {
+		memcpy(&mip[y * size.x], &depth[y * stride], size.x * sizeof(float));
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RasterOcclusionCull::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RasterOcclusionCull::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RasterOcclusionCull::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RasterOcclusionCull::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer || buffer->is_empty()) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (!scenario) {
+		return;
+	}
+
+	const Size2i size = buffer->sizes[0];
+	const real_t z_near = p_cam_projection.get_z_near();
+	const Transform3D cam_inv_transform = p_cam_transform.affine_inverse();
+	const Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+
+	triangles.clear();
+
+	for (KeyValue<RID, OccluderInstance> &E : scenario->instances) {
+		OccluderInstance &instance = E.value;
+		const Occluder *occluder = occluder_owner.get_or_null(instance.occluder);
+
+		if (!occluder || !instance.enabled) {
+			continue;
+		}
+
+		if (instance.occluder_version != occluder->version) {
+			_update_instance(instance, occluder);
+		}
+
+		bool in_frustum = true;
+		Vector3 half_extents = instance.aabb.size * 0.5;
+		Vector3 center = instance.aabb.position + half_extents;
+		for (const Plane &plane : planes) {
+			Vector3 closest = center - half_extents * plane.normal.sign();
+			if (plane.is_point_over(closest)) {
+				in_frustum = false;
+				break;
+			}
+		}
+
+		if (!in_frustum) {
+			continue;
+		}
+
+		uint32_t vertex_count = instance.xformed_vertices.size();
+		view_vertices.resize(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			view_vertices[i] = cam_inv_transform.xform(instance.xformed_vertices[i]);
+		}
+
+		const int32_t *indices = occluder->indices.ptr();
+		int index_count = occluder->indices.size() - occluder->indices.size() % 3;
+		for (int i = 0; i < index_count; i += 3) {
+			if ((uint32_t)indices[i] >= vertex_count || (uint32_t)indices[i + 1] >= vertex_count || (uint32_t)indices[i + 2] >= vertex_count) {
+				continue;
+			}
+			_clip_and_setup_triangle(view_vertices[indices[i]], view_vertices[indices[i + 1]], view_vertices[indices[i + 2]], p_cam_projection, z_near, size, p_cam_orthogonal);
+		}
+	}
+
+	RasterThreadData td;
+	td.buffer = buffer;
+	td.triangles = triangles.ptr();
+	td.triangle_count = triangles.size();
+	td.band_count = MIN(size.y, WorkerThreadPool::get_singleton()->get_thread_count() * 4);
+	td.orthogonal = p_cam_orthogonal;
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RasterOcclusionCull::_raster_band, &td, td.band_count, -1, true, SNAME("RasterOcclusionCullRaster"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	buffer->debug_tex_range = p_cam_projection.get_z_far();
+	buffer->update_mips();
+}
+
+RasterOcclusionCull::HZBuffer *RasterOcclusionCull::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+RID RasterOcclusionCull::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
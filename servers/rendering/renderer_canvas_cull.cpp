@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
 #include "core/math/transform_interpolator.h"
+#include "core/object/worker_thread_pool.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -50,8 +51,12 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
-	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, p_canvas_cull_mask, Point2(), 1, nullptr);
+	if (canvas_item_owner.get_rid_count() >= thread_cull_threshold) {
+		_cull_canvas_item_tree_threaded(p_child_items, p_child_item_count, p_transform, p_clip_rect, p_canvas_cull_mask);
+	} else {
+		for (int i = 0; i < p_child_item_count; i++) {
+			_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, p_canvas_cull_mask, Point2(), 1, nullptr);
+		}
 	}
 
 	RendererCanvasRender::Item *list = nullptr;
@@ -124,6 +129,20 @@ void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner, RID_Owner<Renderer
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+void _mark_subtree_rect_dirty(RendererCanvasCull::Item *p_item, RID_Owner<RendererCanvasCull::Item, true> &canvas_item_owner) {
+	// Parents of a dirty item are always dirty, so stop at the first one already marked.
+	while (p_item && !p_item->subtree_rect_dirty) {
+		p_item->subtree_rect_dirty = true;
+		p_item = canvas_item_owner.owns(p_item->parent) ? canvas_item_owner.get_or_null(p_item->parent) : nullptr;
+	}
+}
+
+// Whether the children of the item can be culled apart from each other, on different threads.
+// Y sorting, canvas groups and repeating all need the whole subtree.
+static _FORCE_INLINE_ bool _is_canvas_item_splittable(const RendererCanvasCull::Item *p_item) {
+	return !p_item->sort_y && p_item->canvas_group == nullptr && !p_item->repeat_source && !p_item->child_items.is_empty();
+}
+
 void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *ci, RendererCanvasCull::Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &p_modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from) {
 	if (ci->copy_back_buffer) {
 		ci->copy_back_buffer->screen_rect = p_transform.xform(ci->copy_back_buffer->rect).intersection(p_clip_rect);
@@ -224,7 +243,9 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 
 		if (ci->visibility_notifier) {
 			if (!ci->visibility_notifier->visible_element.in_list()) {
+				visibility_notifier_list_lock.lock();
 				visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
+				visibility_notifier_list_lock.unlock();
 				ci->visibility_notifier->just_visible = true;
 			}
 
@@ -236,7 +257,7 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 	}
 }
 
-void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item) {
+void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item, LocalVector<CullSegment> *r_split_segments) {
 	Item *ci = p_canvas_item;
 
 	if (!ci->visible) {
@@ -252,7 +273,7 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		ci->children_order_dirty = false;
 	}
 
-	Rect2 rect = ci->get_rect();
+	Rect2 rect = _get_canvas_item_rect(ci);
 
 	if (ci->visibility_notifier) {
 		if (ci->visibility_notifier->area.size != Vector2()) {
@@ -291,6 +312,24 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 
 	final_xform = parent_xform * final_xform;
 
+	if (use_subtree_rects && !repeat_source_item) {
+		// When splitting the tree, leave dirty bounds to the threads culling the children.
+		if (ci->subtree_rect_dirty && !r_split_segments) {
+			_update_canvas_item_subtree_rect(ci);
+		}
+		if (!ci->subtree_rect_dirty && !ci->subtree_rect_unbounded) {
+			if (ci->subtree_rect_empty) {
+				return;
+			}
+			Rect2 global_subtree_rect = final_xform.xform(ci->subtree_rect);
+			global_subtree_rect.position += p_clip_rect.position;
+			if (!p_clip_rect.intersects(global_subtree_rect, true)) {
+				// Neither the item nor any of its descendants are on screen.
+				return;
+			}
+		}
+	}
+
 	Rect2 global_rect = final_xform.xform(rect);
 	if (repeat_source_item && (repeat_size.x || repeat_size.y)) {
 		// Top-left repeated rect.
@@ -389,6 +428,39 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 
 			_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from);
 		}
+	} else if (r_split_segments) {
+		// Only splittable items get here, emit their children as segments to be culled later, around the item itself.
+		CullSegment segment;
+		segment.xform = final_xform;
+		segment.modulate = modulate;
+		segment.z = p_z;
+		segment.canvas_clip = (Item *)ci->final_clip_owner;
+		segment.material_owner = p_material_owner;
+
+		for (int i = 0; i < child_item_count; i++) {
+			if (child_items[i]->behind) {
+				segment.item = child_items[i];
+				r_split_segments->push_back(segment);
+			}
+		}
+
+		CullSegment attach_segment;
+		attach_segment.type = CullSegment::TYPE_ATTACH;
+		attach_segment.item = ci;
+		attach_segment.xform = final_xform;
+		attach_segment.global_rect = global_rect;
+		attach_segment.modulate = modulate;
+		attach_segment.z = p_z;
+		attach_segment.canvas_clip = p_canvas_clip;
+		attach_segment.material_owner = p_material_owner;
+		r_split_segments->push_back(attach_segment);
+
+		for (int i = 0; i < child_item_count; i++) {
+			if (!child_items[i]->behind) {
+				segment.item = child_items[i];
+				r_split_segments->push_back(segment);
+			}
+		}
 	} else {
 		RendererCanvasRender::Item *canvas_group_from = nullptr;
 		bool use_canvas_group = ci->canvas_group != nullptr && (ci->canvas_group->fit_empty || ci->commands != nullptr);
@@ -413,11 +485,167 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 	}
 }
 
+void RendererCanvasCull::_cull_canvas_item_tree_threaded(Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, uint32_t p_canvas_cull_mask) {
+	const uint32_t thread_count = WorkerThreadPool::get_singleton()->get_thread_count();
+
+	cull_segments.clear();
+	for (int i = 0; i < p_child_item_count; i++) {
+		CullSegment segment;
+		segment.item = p_child_items[i].item;
+		segment.xform = p_transform;
+		cull_segments.push_back(segment);
+	}
+
+	// Split the top of the tree a level at a time, until there are enough segments to balance between threads.
+	const uint32_t segment_target = thread_count * 8;
+	for (int level = 0; level < 8 && cull_segments.size() < segment_target; level++) {
+		bool split = false;
+		cull_segments_split.clear();
+		for (const CullSegment &segment : cull_segments) {
+			if (segment.type == CullSegment::TYPE_CULL && _is_canvas_item_splittable(segment.item)) {
+				_cull_canvas_item(segment.item, segment.xform, p_clip_rect, segment.modulate, segment.z, z_list, z_last_list, segment.canvas_clip, segment.material_owner, true, p_canvas_cull_mask, Point2(), 1, nullptr, &cull_segments_split);
+				split = true;
+			} else {
+				cull_segments_split.push_back(segment);
+			}
+		}
+		cull_segments = cull_segments_split;
+		if (!split) {
+			break;
+		}
+	}
+
+	if (cull_segments.is_empty()) {
+		return;
+	}
+
+	// Group consecutive segments into ranges of similar size, using the child count as a cheap estimate of the work in a subtree.
+	uint64_t total_weight = 0;
+	for (const CullSegment &segment : cull_segments) {
+		total_weight += segment.type == CullSegment::TYPE_CULL ? segment.item->child_items.size() + 1 : 1;
+	}
+
+	uint32_t range_count = MIN(cull_segments.size(), thread_count * 2);
+	while (cull_ranges.size() < range_count) {
+		CullRange range;
+		range.z_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+		range.z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+		memset(range.z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+		memset(range.z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+		cull_ranges.push_back(range);
+	}
+
+	uint32_t range_index = 0;
+	uint64_t weight = 0;
+	cull_ranges[0].from = 0;
+	for (uint32_t i = 0; i < cull_segments.size(); i++) {
+		const CullSegment &segment = cull_segments[i];
+		weight += segment.type == CullSegment::TYPE_CULL ? segment.item->child_items.size() + 1 : 1;
+		if (range_index + 1 < range_count && weight * range_count >= total_weight * (range_index + 1)) {
+			cull_ranges[range_index].to = i + 1;
+			range_index++;
+			cull_ranges[range_index].from = i + 1;
+		}
+	}
+	cull_ranges[range_index].to = cull_segments.size();
+	range_count = range_index + 1;
+
+	ThreadedCullData cull_data;
+	cull_data.clip_rect = p_clip_rect;
+	cull_data.canvas_cull_mask = p_canvas_cull_mask;
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererCanvasCull::_cull_canvas_items_threaded, &cull_data, range_count, -1, true, SNAME("RenderCanvasCullItems"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	// Append the lists of each range in order, which keeps the draw order of a single threaded traversal.
+	for (uint32_t i = 0; i < range_count; i++) {
+		CullRange &range = cull_ranges[i];
+		for (int j = range.z_min; j <= range.z_max; j++) {
+			if (!range.z_list[j]) {
+				continue;
+			}
+			if (z_last_list[j]) {
+				z_last_list[j]->next = range.z_list[j];
+			} else {
+				z_list[j] = range.z_list[j];
+			}
+			z_last_list[j] = range.z_last_list[j];
+
+			range.z_list[j] = nullptr;
+			range.z_last_list[j] = nullptr;
+		}
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_items_threaded(uint32_t p_range, ThreadedCullData *p_data) {
+	CullRange &range = cull_ranges[p_range];
+
+	for (uint32_t i = range.from; i < range.to; i++) {
+		const CullSegment &segment = cull_segments[i];
+		if (segment.type == CullSegment::TYPE_CULL) {
+			_cull_canvas_item(segment.item, segment.xform, p_data->clip_rect, segment.modulate, segment.z, range.z_list, range.z_last_list, segment.canvas_clip, segment.material_owner, true, p_data->canvas_cull_mask, Point2(), 1, nullptr);
+		} else {
+			_attach_canvas_item_for_draw(segment.item, segment.canvas_clip, range.z_list, range.z_last_list, segment.xform, p_data->clip_rect, segment.global_rect, segment.modulate, segment.z, segment.material_owner, false, nullptr);
+		}
+	}
+
+	range.z_min = 0;
+	range.z_max = -1;
+	for (int i = 0; i < z_range; i++) {
+		if (range.z_list[i]) {
+			if (range.z_max == -1) {
+				range.z_min = i;
+			}
+			range.z_max = i;
+		}
+	}
+}
+
+void RendererCanvasCull::_update_canvas_item_subtree_rect(Item *p_item) {
+	Rect2 subtree_rect;
+	bool empty = true;
+	// These are drawn whatever their rect, or have a rect which changes without the item being touched.
+	bool unbounded = p_item->vp_render || p_item->copy_back_buffer || p_item->canvas_group || p_item->repeat_source || p_item->update_when_visible || p_item->skeleton.is_valid();
+
+	if (p_item->commands != nullptr || p_item->visibility_notifier) {
+		subtree_rect = _get_canvas_item_rect(p_item);
+		if (p_item->visibility_notifier && p_item->visibility_notifier->area.size != Vector2()) {
+			subtree_rect = subtree_rect.merge(p_item->visibility_notifier->area);
+		}
+		empty = false;
+	}
+
+	for (Item *child : p_item->child_items) {
+		// Always update dirty children, even hidden ones, so no dirty item is left below a clean one.
+		if (child->subtree_rect_dirty) {
+			_update_canvas_item_subtree_rect(child);
+		}
+		if (!child->visible || child->subtree_rect_empty) {
+			continue;
+		}
+		if (child->subtree_rect_unbounded) {
+			unbounded = true;
+			continue;
+		}
+
+		Rect2 child_rect = child->xform_curr.xform(child->subtree_rect);
+		subtree_rect = empty ? child_rect : subtree_rect.merge(child_rect);
+		empty = false;
+	}
+
+	p_item->subtree_rect = subtree_rect;
+	p_item->subtree_rect_empty = empty && !unbounded;
+	p_item->subtree_rect_unbounded = unbounded;
+	p_item->subtree_rect_dirty = false;
+}
+
 void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, const Transform2D &p_transform, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, const Rect2 &p_clip_rect, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_transforms_to_pixel, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info) {
 	RENDER_TIMESTAMP("> Render Canvas");
 
 	sdf_used = false;
 	snapping_2d_transforms_to_pixel = p_snap_2d_transforms_to_pixel;
+	// Snapping and interpolation move items away from the transforms the bounds are built from.
+	use_subtree_rects = !snapping_2d_transforms_to_pixel && !_interpolation_data.interpolation_enabled;
 
 	if (p_canvas->children_order_dirty) {
 		p_canvas->child_items.sort();
@@ -448,6 +676,7 @@ void RendererCanvasCull::canvas_set_item_mirroring(RID p_canvas, RID p_item, con
 	ERR_FAIL_NULL(canvas);
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	int idx = canvas->find_item(canvas_item);
 	ERR_FAIL_COND(idx == -1);
@@ -463,6 +692,7 @@ void RendererCanvasCull::canvas_set_item_repeat(RID p_item, const Point2 &p_repe
 	ERR_FAIL_COND(p_repeat_times < 0);
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	bool is_repeat_source = (p_repeat_size.x || p_repeat_size.y) && p_repeat_times;
 	canvas_item->repeat_source = is_repeat_source;
@@ -511,6 +741,7 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
 			}
+			_mark_subtree_rect_dirty(item_owner, canvas_item_owner);
 		}
 
 		canvas_item->parent = RID();
@@ -531,6 +762,7 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
 			}
+			_mark_subtree_rect_dirty(item_owner, canvas_item_owner);
 
 		} else {
 			ERR_FAIL_MSG("Invalid parent.");
@@ -543,6 +775,7 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 void RendererCanvasCull::canvas_item_set_visible(RID p_item, bool p_visible) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->visible = p_visible;
 
@@ -559,6 +792,7 @@ void RendererCanvasCull::canvas_item_set_light_mask(RID p_item, int p_mask) {
 void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	if (_interpolation_data.interpolation_enabled && canvas_item->interpolated) {
 		if (!canvas_item->on_interpolate_transform_list) {
@@ -603,6 +837,7 @@ void RendererCanvasCull::canvas_item_set_distance_field_mode(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
@@ -632,6 +867,7 @@ void RendererCanvasCull::canvas_item_set_draw_behind_parent(RID p_item, bool p_e
 void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_update) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->update_when_visible = p_update;
 }
@@ -639,6 +875,7 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_NULL(line);
@@ -868,6 +1105,7 @@ void RendererCanvasCull::canvas_item_add_polyline(RID p_item, const Vector<Point
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Color color = Color(1, 1, 1, 1);
 
@@ -1138,6 +1376,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 		}
 		Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 		ERR_FAIL_NULL(canvas_item);
+		_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 		Vector<Color> colors;
 		if (p_colors.size() == 1) {
@@ -1180,6 +1419,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1344,6 +1584,7 @@ void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	static const int circle_segments = 64;
 
@@ -1435,6 +1676,7 @@ void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1466,6 +1708,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, int p_outline_size, float p_px_range, float p_scale) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1500,6 +1743,7 @@ void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, co
 void RendererCanvasCull::canvas_item_add_lcd_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1532,6 +1776,7 @@ void RendererCanvasCull::canvas_item_add_lcd_texture_rect_region(RID p_item, con
 void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, bool p_clip_uv) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1573,6 +1818,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const R
 void RendererCanvasCull::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_NULL(style);
@@ -1597,6 +1843,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_NULL(prim);
@@ -1623,6 +1870,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -1644,6 +1892,7 @@ void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2
 void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -1665,6 +1914,7 @@ void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector
 void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_NULL(tr);
@@ -1674,11 +1924,13 @@ void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transfo
 void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform, const Color &p_modulate, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
 	ERR_FAIL_NULL(m);
 	m->mesh = p_mesh;
+	canvas_item->rect_from_storage = true;
 	if (canvas_item->skeleton.is_valid()) {
 		m->mesh_instance = RSG::mesh_storage->mesh_instance_create(p_mesh);
 		RSG::mesh_storage->mesh_instance_set_skeleton(m->mesh_instance, canvas_item->skeleton);
@@ -1693,10 +1945,12 @@ void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_NULL(part);
 	part->particles = p_particles;
+	canvas_item->rect_from_storage = true;
 
 	part->texture = p_texture;
 
@@ -1707,10 +1961,12 @@ void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles,
 void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_NULL(mm);
 	mm->multimesh = p_mesh;
+	canvas_item->rect_from_storage = true;
 
 	mm->texture = p_texture;
 }
@@ -1718,6 +1974,7 @@ void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_NULL(ci);
@@ -1727,6 +1984,7 @@ void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 void RendererCanvasCull::canvas_item_add_animation_slice(RID p_item, double p_animation_length, double p_slice_begin, double p_slice_end, double p_offset) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::CommandAnimationSlice *as = canvas_item->alloc_command<Item::CommandAnimationSlice>();
 	ERR_FAIL_NULL(as);
@@ -1768,6 +2026,7 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 		return;
 	}
 	canvas_item->skeleton = p_skeleton;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	Item::Command *c = canvas_item->commands;
 
@@ -1793,6 +2052,7 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	if (p_enable && (canvas_item->copy_back_buffer == nullptr)) {
 		canvas_item->copy_back_buffer = memnew(RendererCanvasRender::Item::CopyBackBuffer);
 	}
@@ -1810,8 +2070,10 @@ void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 void RendererCanvasCull::canvas_item_clear(RID p_item) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->clear();
+	canvas_item->rect_from_storage = false;
 #ifdef DEBUG_ENABLED
 	if (debug_redraw) {
 		canvas_item->debug_redraw_time = debug_redraw_time;
@@ -1855,6 +2117,7 @@ void RendererCanvasCull::canvas_item_set_use_parent_material(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_set_visibility_notifier(RID p_item, bool p_enable, const Rect2 &p_area, const Callable &p_enter_callable, const Callable &p_exit_callable) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	if (p_enable) {
 		if (!canvas_item->visibility_notifier) {
@@ -1897,6 +2160,7 @@ void RendererCanvasCull::canvas_item_reset_physics_interpolation(RID p_item) {
 void RendererCanvasCull::canvas_item_transform_physics_interpolation(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	canvas_item->xform_prev = p_transform * canvas_item->xform_prev;
 	canvas_item->xform_curr = p_transform * canvas_item->xform_curr;
 }
@@ -1904,6 +2168,7 @@ void RendererCanvasCull::canvas_item_transform_physics_interpolation(RID p_item,
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	if (p_mode == RS::CANVAS_GROUP_MODE_DISABLED) {
 		if (canvas_item->canvas_group != nullptr) {
@@ -2425,6 +2690,7 @@ bool RendererCanvasCull::free(RID p_rid) {
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
 				}
+				_mark_subtree_rect_dirty(item_owner, canvas_item_owner);
 			}
 		}
 
@@ -2609,9 +2875,17 @@ RendererCanvasCull::RendererCanvasCull() {
 
 	debug_redraw_time = GLOBAL_DEF("debug/canvas_items/debug_redraw_time", 1.0);
 	debug_redraw_color = GLOBAL_DEF("debug/canvas_items/debug_redraw_color", Color(1.0, 0.2, 0.2, 0.5));
+
+	thread_cull_threshold = GLOBAL_GET("rendering/2d/culling/threaded_cull_minimum_items");
+	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); // Make sure there is at least one item per thread.
 }
 
 RendererCanvasCull::~RendererCanvasCull() {
 	memfree(z_list);
 	memfree(z_last_list);
+
+	for (CullRange &range : cull_ranges) {
+		memfree(range.z_list);
+		memfree(range.z_last_list);
+	}
 }
@@ -31,11 +31,16 @@
 #ifndef RENDERER_CANVAS_CULL_H
 #define RENDERER_CANVAS_CULL_H
 
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
 
 class RendererCanvasCull {
+	friend class TestRendererCanvasCullInternalsAccessor;
+
 public:
 	struct Item : public RendererCanvasRender::Item {
 		RID parent; // canvas it belongs to
@@ -56,6 +61,13 @@ public:
 		int ysort_parent_abs_z_index; // Absolute Z index of parent. Only populated and used when y-sorting.
 		uint32_t visibility_layer = 0xffffffff;
 
+		// Bounds of the item and its visible descendants in local space, used to skip off-screen subtrees.
+		Rect2 subtree_rect;
+		bool subtree_rect_dirty = true;
+		bool subtree_rect_empty = true;
+		bool subtree_rect_unbounded = false; // Drawn regardless of bounds, or bounds change every frame.
+		bool rect_from_storage = false; // Rect comes from mesh or particles storage, which is not thread safe.
+
 		Vector<Item *> child_items;
 
 		struct VisibilityNotifierData {
@@ -182,12 +194,62 @@ public:
 
 	PagedAllocator<Item::VisibilityNotifierData> visibility_notifier_allocator;
 	SelfList<Item::VisibilityNotifierData>::List visibility_notifier_list;
+	SpinLock visibility_notifier_list_lock;
 
 	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from);
 
 private:
+	// A contiguous part of the canvas item tree in draw order, culled on its own when culling on multiple threads.
+	struct CullSegment {
+		enum Type {
+			TYPE_CULL, // Cull the item and its children.
+			TYPE_ATTACH, // Attach the item only, its children are in other segments.
+		};
+
+		Type type = TYPE_CULL;
+		Item *item = nullptr;
+		Transform2D xform; // Parent transform when culling, final transform when attaching.
+		Rect2 global_rect;
+		Color modulate = Color(1, 1, 1, 1);
+		int z = 0;
+		Item *canvas_clip = nullptr;
+		Item *material_owner = nullptr;
+	};
+
+	struct CullRange {
+		uint32_t from = 0;
+		uint32_t to = 0;
+		int z_min = 0;
+		int z_max = -1;
+		RendererCanvasRender::Item **z_list = nullptr;
+		RendererCanvasRender::Item **z_last_list = nullptr;
+	};
+
+	struct ThreadedCullData {
+		Rect2 clip_rect;
+		uint32_t canvas_cull_mask = 0;
+	};
+
+	LocalVector<CullSegment> cull_segments;
+	LocalVector<CullSegment> cull_segments_split;
+	LocalVector<CullRange> cull_ranges;
+	uint32_t thread_cull_threshold = 1000;
+	bool use_subtree_rects = false;
+	BinaryMutex storage_rect_mutex;
+
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info = nullptr);
-	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item);
+	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item, LocalVector<CullSegment> *r_split_segments = nullptr);
+	void _cull_canvas_item_tree_threaded(Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, uint32_t p_canvas_cull_mask);
+	void _cull_canvas_items_threaded(uint32_t p_range, ThreadedCullData *p_data);
+	void _update_canvas_item_subtree_rect(Item *p_item);
+
+	_FORCE_INLINE_ Rect2 _get_canvas_item_rect(const Item *p_item) {
+		if (p_item->rect_from_storage) {
+			MutexLock lock(storage_rect_mutex);
+			return p_item->get_rect();
+		}
+		return p_item->get_rect();
+	}
 
 	static constexpr int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
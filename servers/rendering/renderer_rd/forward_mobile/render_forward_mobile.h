@@ -32,6 +32,7 @@
 #define RENDER_FORWARD_MOBILE_H
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/renderer_rd/forward_mobile/scene_shader_forward_mobile.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 #include "servers/rendering/renderer_rd/renderer_scene_render_rd.h"
@@ -276,46 +277,44 @@ private:
 			element_info.clear();
 		}
 
-		//should eventually be replaced by radix
+		// Keeps its buffers between frames, and returns early when the order didn't change since the last sort.
+		RadixSort<GeometryInstanceSurfaceDataCache *, 2> sorter;
 
-		struct SortByKey {
-			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
-				return (A->sort.sort_key2 == B->sort.sort_key2) ? (A->sort.sort_key1 < B->sort.sort_key1) : (A->sort.sort_key2 < B->sort.sort_key2);
+		struct GetSortKey {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurfaceDataCache *p_surface, uint64_t *r_key) const {
+				r_key[0] = p_surface->sort.sort_key1;
+				r_key[1] = p_surface->sort.sort_key2;
 			}
 		};
 
 		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			sorter.sort(elements.ptr(), elements.size(), GetSortKey());
 		}
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			sorter.sort(elements.ptr() + p_from, p_size, GetSortKey());
 		}
 
-		struct SortByDepth {
-			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
-				return (A->owner->depth < B->owner->depth);
+		struct GetDepthKey {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurfaceDataCache *p_surface, uint64_t *r_key) const {
+				r_key[0] = RadixSort<GeometryInstanceSurfaceDataCache *, 2>::float_to_key(p_surface->owner->depth);
+				r_key[1] = 0;
 			}
 		};
 
 		void sort_by_depth() { //used for shadows
-
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByDepth> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			sorter.sort(elements.ptr(), elements.size(), GetDepthKey());
 		}
 
-		struct SortByReverseDepthAndPriority {
-			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
-				return (A->sort.priority == B->sort.priority) ? (A->owner->depth > B->owner->depth) : (A->sort.priority < B->sort.priority);
+		struct GetReverseDepthAndPriorityKey {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurfaceDataCache *p_surface, uint64_t *r_key) const {
+				r_key[0] = ~RadixSort<GeometryInstanceSurfaceDataCache *, 2>::float_to_key(p_surface->owner->depth);
+				r_key[1] = p_surface->sort.priority;
 			}
 		};
 
 		void sort_by_reverse_depth_and_priority() { //used for alpha
-
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByReverseDepthAndPriority> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			sorter.sort(elements.ptr(), elements.size(), GetReverseDepthAndPriorityKey());
 		}
 
 		_FORCE_INLINE_ void add_element(GeometryInstanceSurfaceDataCache *p_element) {
@@ -848,6 +848,7 @@ void MaterialStorage::MaterialData::update_textures(const HashMap<StringName, Va
 
 	bool uses_global_textures = false;
 	global_textures_pass++;
+	streamed_textures.clear();
 
 	for (int i = 0, k = 0; i < p_texture_uniforms.size(); i++) {
 		const StringName &uniform_name = p_texture_uniforms[i].name;
@@ -1002,6 +1003,9 @@ void MaterialStorage::MaterialData::update_textures(const HashMap<StringName, Va
 
 				if (tex) {
 					rd_texture = (srgb && tex->rd_texture_srgb.is_valid()) ? tex->rd_texture_srgb : tex->rd_texture;
+					if (tex->streaming && !streamed_textures.has(textures[j])) {
+						streamed_textures.push_back(textures[j]);
+					}
 #ifdef TOOLS_ENABLED
 					if (tex->detect_3d_callback && p_3d_material) {
 						tex->detect_3d_callback(tex->detect_3d_callback_ud);
@@ -2313,6 +2317,21 @@ void MaterialStorage::material_get_instance_shader_parameters(RID p_material, Li
 	}
 }
 
+void MaterialStorage::material_get_streamed_textures(RID p_material, LocalVector<RID> *r_textures) {
+	Material *material = material_owner.get_or_null(p_material);
+	ERR_FAIL_NULL(material);
+	if (material->data) {
+		for (const RID &texture : material->data->streamed_textures) {
+			if (!r_textures->has(texture)) {
+				r_textures->push_back(texture);
+			}
+		}
+	}
+	if (material->next_pass.is_valid()) {
+		material_get_streamed_textures(material->next_pass, r_textures);
+	}
+}
+
 void MaterialStorage::material_update_dependency(RID p_material, DependencyTracker *p_instance) {
 	Material *material = material_owner.get_or_null(p_material);
 	ERR_FAIL_NULL(material);
@@ -116,6 +116,7 @@ public:
 		Vector<uint8_t> ubo_data[2]; // 0: linear buffer; 1: sRGB buffer.
 		RID uniform_buffer[2]; // 0: linear buffer; 1: sRGB buffer.
 		Vector<RID> texture_cache;
+		Vector<RID> streamed_textures;
 	};
 
 	struct Samplers {
@@ -446,6 +447,8 @@ public:
 
 	virtual void material_get_instance_shader_parameters(RID p_material, List<InstanceShaderParam> *r_parameters) override;
 
+	virtual void material_get_streamed_textures(RID p_material, LocalVector<RID> *r_textures) override;
+
 	virtual void material_update_dependency(RID p_material, DependencyTracker *p_instance) override;
 
 	void material_set_data_request_function(ShaderType p_shader_type, MaterialDataRequestFunction p_function);
@@ -1643,6 +1643,13 @@ void TextureStorage::texture_debug_usage(List<RS::TextureInfo> *r_info) {
 void TextureStorage::texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) {
 }
 
+void TextureStorage::texture_set_streaming(RID p_texture, bool p_enable) {
+	Texture *tex = texture_owner.get_or_null(p_texture);
+	ERR_FAIL_NULL(tex);
+
+	tex->streaming = p_enable;
+}
+
 Size2 TextureStorage::texture_size_with_proxy(RID p_proxy) {
 	return texture_2d_get_size(p_proxy);
 }
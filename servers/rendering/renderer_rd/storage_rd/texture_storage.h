@@ -188,6 +188,8 @@ private:
 		RS::TextureDetectRoughnessCallback detect_roughness_callback = nullptr;
 		void *detect_roughness_callback_ud = nullptr;
 
+		bool streaming = false;
+
 		CanvasTexture *canvas_texture = nullptr;
 
 		void cleanup();
@@ -544,6 +546,7 @@ public:
 	virtual void texture_debug_usage(List<RS::TextureInfo> *r_info) override;
 
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) override;
+	virtual void texture_set_streaming(RID p_texture, bool p_enable) override;
 
 	virtual Size2 texture_size_with_proxy(RID p_proxy) override;
 
@@ -33,6 +33,8 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "modules/modules_enabled.gen.h" // For raycast.
+#include "raster_occlusion_cull.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_constants.h"
 #include "rendering_server_default.h"
@@ -941,16 +943,13 @@ void RendererSceneCull::instance_geometry_set_transparency(RID p_instance, float
 	}
 }
 
-void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
-	Instance *instance = instance_owner.get_or_null(p_instance);
-	ERR_FAIL_NULL(instance);
-
+void RendererSceneCull::_instance_set_transform(Instance *p_instance, const Transform3D &p_transform) {
 #ifdef RENDERING_SERVER_DEBUG_PHYSICS_INTERPOLATION
 	print_line("instance_set_transform " + rtos(p_transform.origin.x) + " .. tick " + itos(Engine::get_singleton()->get_physics_frames()));
 #endif
 
-	if (!_interpolation_data.interpolation_enabled || !instance->interpolated || !instance->scenario) {
-		if (instance->transform == p_transform) {
+	if (!_interpolation_data.interpolation_enabled || !p_instance->interpolated || !p_instance->scenario) {
+		if (p_instance->transform == p_transform) {
 			return; // Must be checked to avoid worst evil.
 		}
 
@@ -962,12 +961,12 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 		}
 
 #endif
-		instance->transform = p_transform;
-		_instance_queue_update(instance, true);
+		p_instance->transform = p_transform;
+		_instance_queue_update(p_instance, true);
 
 #if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
-		if (_interpolation_data.interpolation_enabled && !instance->interpolated && Engine::get_singleton()->is_in_physics_frame()) {
-			PHYSICS_INTERPOLATION_NODE_WARNING(instance->object_id, "Non-interpolated instance triggered from physics process");
+		if (_interpolation_data.interpolation_enabled && !p_instance->interpolated && Engine::get_singleton()->is_in_physics_frame()) {
+			PHYSICS_INTERPOLATION_NODE_WARNING(p_instance->object_id, "Non-interpolated instance triggered from physics process");
 		}
 #endif
 
@@ -975,14 +974,14 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	}
 
 	float new_checksum = TransformInterpolator::checksum_transform_3d(p_transform);
-	bool checksums_match = (instance->transform_checksum_curr == new_checksum) && (instance->transform_checksum_prev == new_checksum);
+	bool checksums_match = (p_instance->transform_checksum_curr == new_checksum) && (p_instance->transform_checksum_prev == new_checksum);
 
 	// We can't entirely reject no changes because we need the interpolation
 	// system to keep on stewing.
 
 	// Optimized check. First checks the checksums. If they pass it does the slow check at the end.
 	// Alternatively we can do this non-optimized and ignore the checksum... if no change.
-	if (checksums_match && (instance->transform_curr == p_transform) && (instance->transform_prev == p_transform)) {
+	if (checksums_match && (p_instance->transform_curr == p_transform) && (p_instance->transform_prev == p_transform)) {
 		return;
 	}
 
@@ -995,18 +994,18 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 
 #endif
 
-	instance->transform_curr = p_transform;
+	p_instance->transform_curr = p_transform;
 
 #ifdef RENDERING_SERVER_DEBUG_PHYSICS_INTERPOLATION
-	print_line("\tprev " + rtos(instance->transform_prev.origin.x) + ", curr " + rtos(instance->transform_curr.origin.x));
+	print_line("\tprev " + rtos(p_instance->transform_prev.origin.x) + ", curr " + rtos(p_instance->transform_curr.origin.x));
 #endif
 
 	// Keep checksums up to date.
-	instance->transform_checksum_curr = new_checksum;
+	p_instance->transform_checksum_curr = new_checksum;
 
-	if (!instance->on_interpolate_transform_list) {
-		_interpolation_data.instance_transform_update_list_curr->push_back(p_instance);
-		instance->on_interpolate_transform_list = true;
+	if (!p_instance->on_interpolate_transform_list) {
+		_interpolation_data.instance_transform_update_list_curr->push_back(p_instance->self);
+		p_instance->on_interpolate_transform_list = true;
 	} else {
 		DEV_ASSERT(_interpolation_data.instance_transform_update_list_curr->size());
 	}
@@ -1015,29 +1014,50 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	// transform or anything else.
 	// Ideally we would not even call the VisualServer::set_transform() when invisible but that would entail having logic
 	// to keep track of the previous transform on the SceneTree side. The "early out" below is less efficient but a lot cleaner codewise.
-	if (!instance->visible) {
+	if (!p_instance->visible) {
 		return;
 	}
 
 	// Decide on the interpolation method... slerp if possible.
-	instance->interpolation_method = TransformInterpolator::find_method(instance->transform_prev.basis, instance->transform_curr.basis);
+	p_instance->interpolation_method = TransformInterpolator::find_method(p_instance->transform_prev.basis, p_instance->transform_curr.basis);
 
-	if (!instance->on_interpolate_list) {
-		_interpolation_data.instance_interpolate_update_list.push_back(p_instance);
-		instance->on_interpolate_list = true;
+	if (!p_instance->on_interpolate_list) {
+		_interpolation_data.instance_interpolate_update_list.push_back(p_instance->self);
+		p_instance->on_interpolate_list = true;
 	} else {
 		DEV_ASSERT(_interpolation_data.instance_interpolate_update_list.size());
 	}
 
-	_instance_queue_update(instance, true);
+	_instance_queue_update(p_instance, true);
 
 #if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
 	if (!Engine::get_singleton()->is_in_physics_frame()) {
-		PHYSICS_INTERPOLATION_NODE_WARNING(instance->object_id, "Interpolated instance triggered from outside physics process");
+		PHYSICS_INTERPOLATION_NODE_WARNING(p_instance->object_id, "Interpolated instance triggered from outside physics process");
 	}
 #endif
 }
 
+void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
+	Instance *instance = instance_owner.get_or_null(p_instance);
+	ERR_FAIL_NULL(instance);
+
+	_instance_set_transform(instance, p_transform);
+}
+
+void RendererSceneCull::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND_MSG(p_instances.size() != p_transforms.size(), "The number of transforms must match the number of instances.");
+
+	// As with single transform changes, the instances are only queued for update, the indexers are updated when they are flushed.
+	const RID *instances = p_instances.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		Instance *instance = instance_owner.get_or_null(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		_instance_set_transform(instance, transforms[i]);
+	}
+}
+
 void RendererSceneCull::instance_set_interpolated(RID p_instance, bool p_interpolated) {
 	Instance *instance = instance_owner.get_or_null(p_instance);
 	ERR_FAIL_NULL(instance);
@@ -1715,7 +1735,7 @@ void RendererSceneCull::instance_geometry_get_shader_parameter_list(RID p_instan
 	}
 }
 
-void RendererSceneCull::_update_instance(Instance *p_instance) {
+bool RendererSceneCull::_update_instance_transform(Instance *p_instance) {
 	p_instance->version++;
 
 	// When not using interpolation the transform is used straight.
@@ -1792,11 +1812,11 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 			RendererSceneOcclusionCull::get_singleton()->scenario_set_instance(p_instance->scenario->self, p_instance->self, p_instance->base, *instance_xform, p_instance->visible);
 		}
 	} else if (p_instance->base_type == RS::INSTANCE_NONE) {
-		return;
+		return false;
 	}
 
 	if (!p_instance->aabb.has_surface()) {
-		return;
+		return false;
 	}
 
 	if (p_instance->base_type == RS::INSTANCE_LIGHTMAP) {
@@ -1832,29 +1852,33 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 			if (!p_instance->lightmap_sh.is_empty()) {
 				p_instance->lightmap_sh.clear(); //don't need SH
 				p_instance->lightmap_target_sh.clear(); //don't need SH
-				ERR_FAIL_NULL(geom->geometry_instance);
+				ERR_FAIL_NULL_V(geom->geometry_instance, false);
 				geom->geometry_instance->set_lightmap_capture(nullptr);
 			}
 		}
 
-		ERR_FAIL_NULL(geom->geometry_instance);
+		ERR_FAIL_NULL_V(geom->geometry_instance, false);
 		geom->geometry_instance->set_transform(*instance_xform, p_instance->aabb, p_instance->transformed_aabb);
 	}
 
 	// note: we had to remove is equal approx check here, it meant that det == 0.000004 won't work, which is the case for some of our scenes.
 	if (p_instance->scenario == nullptr || !p_instance->visible || instance_xform->basis.determinant() == 0) {
 		p_instance->prev_transformed_aabb = p_instance->transformed_aabb;
-		return;
+		return false;
 	}
 
+	return true;
+}
+
+AABB RendererSceneCull::_get_instance_bvh_aabb(const Instance *p_instance, const AABB &p_transformed_aabb) const {
 	//quantize to improve moving object performance
-	AABB bvh_aabb = p_instance->transformed_aabb;
+	AABB bvh_aabb = p_transformed_aabb;
 
 	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
 		//assume motion, see if bounds need to be quantized
 		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
 		float motion_longest_axis = motion_aabb.get_longest_axis_size();
-		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
+		float longest_axis = p_transformed_aabb.get_longest_axis_size();
 
 		if (motion_longest_axis < longest_axis * 2) {
 			//moved but not a lot, use motion aabb quantizing
@@ -1863,11 +1887,15 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		}
 	}
 
+	return bvh_aabb;
+}
+
+void RendererSceneCull::_update_instance_indexer(Instance *p_instance, const AABB &p_bvh_aabb, LocalVector<IndexerUpdate> *r_indexer_updates) {
 	if (!p_instance->indexer_id.is_valid()) {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-			p_instance->indexer_id = p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].insert(bvh_aabb, p_instance);
+			p_instance->indexer_id = p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].insert(p_bvh_aabb, p_instance);
 		} else {
-			p_instance->indexer_id = p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].insert(bvh_aabb, p_instance);
+			p_instance->indexer_id = p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].insert(p_bvh_aabb, p_instance);
 		}
 
 		p_instance->array_index = p_instance->scenario->instance_data.size();
@@ -1949,19 +1977,35 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		if (p_instance->ignore_all_culling) {
 			idata.flags |= InstanceData::FLAG_IGNORE_ALL_CULLING;
 		}
+		if (!p_instance->streamed_textures.is_empty()) {
+			idata.flags |= InstanceData::FLAG_USES_STREAMED_TEXTURES;
+		}
 
 		p_instance->scenario->instance_data.push_back(idata);
 		p_instance->scenario->instance_aabbs.push_back(InstanceBounds(p_instance->transformed_aabb));
 		_update_instance_visibility_dependencies(p_instance);
 	} else {
-		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-			p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].update(p_instance->indexer_id, bvh_aabb);
+		DynamicBVH *indexer = &p_instance->scenario->indexers[((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) ? Scenario::INDEXER_GEOMETRY : Scenario::INDEXER_VOLUMES];
+		if (r_indexer_updates) {
+			// Moved along with the other instances of the batch.
+			uint32_t update_index = 0;
+			while (update_index < r_indexer_updates->size() && (*r_indexer_updates)[update_index].indexer != indexer) {
+				update_index++;
+			}
+			if (update_index == r_indexer_updates->size()) {
+				r_indexer_updates->push_back(IndexerUpdate());
+				(*r_indexer_updates)[update_index].indexer = indexer;
+			}
+			(*r_indexer_updates)[update_index].ids.push_back(p_instance->indexer_id);
+			(*r_indexer_updates)[update_index].aabbs.push_back(p_bvh_aabb);
 		} else {
-			p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].update(p_instance->indexer_id, bvh_aabb);
+			indexer->update(p_instance->indexer_id, p_bvh_aabb);
 		}
 		p_instance->scenario->instance_aabbs[p_instance->array_index] = InstanceBounds(p_instance->transformed_aabb);
 	}
+}
 
+void RendererSceneCull::_update_instance_pairs(Instance *p_instance) {
 	if (p_instance->visibility_index != -1) {
 		p_instance->scenario->instance_visibility[p_instance->visibility_index].position = p_instance->transformed_aabb.get_center();
 	}
@@ -2020,6 +2064,15 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 	p_instance->prev_transformed_aabb = p_instance->transformed_aabb;
 }
 
+void RendererSceneCull::_update_instance(Instance *p_instance) {
+	if (!_update_instance_transform(p_instance)) {
+		return;
+	}
+
+	_update_instance_indexer(p_instance, _get_instance_bvh_aabb(p_instance, p_instance->transformed_aabb));
+	_update_instance_pairs(p_instance);
+}
+
 void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 	if (!p_instance->indexer_id.is_valid()) {
 		return; //nothing to do
@@ -2466,13 +2519,31 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	}
 }
 
-bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_mesh_lod_threshold, uint32_t p_visible_layers) {
+uint32_t RendererSceneCull::_light_instance_add_shadow_cull_pass(Instance *p_instance, Scenario *p_scenario, const Vector<Plane> &p_planes, uint32_t p_pass, int32_t p_regular_light_id, uint32_t p_visible_layers) {
+	ShadowCullPass cull_pass;
+	cull_pass.light = p_instance;
+	cull_pass.scenario = p_scenario;
+	cull_pass.planes = p_planes;
+	cull_pass.regular_light_id = p_regular_light_id;
+	cull_pass.shadow_index = max_shadows_used++;
+	cull_pass.visible_layers = p_visible_layers;
+	shadow_cull_passes.push_back(cull_pass);
+
+	RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[cull_pass.shadow_index];
+	shadow_data.light = static_cast<InstanceLightData *>(p_instance->base_data)->instance;
+	shadow_data.pass = p_pass;
+
+	return cull_pass.shadow_index;
+}
+
+bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_mesh_lod_threshold, int32_t p_regular_light_id, uint32_t p_visible_layers) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
 	Transform3D light_transform = p_instance->transform;
 	light_transform.orthonormalize(); //scale does not count on lights
 
-	bool animated_material_found = false;
+	// Casters are culled to the camera frustum too, unless the whole shadow needs an update.
+	int32_t regular_light_id = light->is_shadow_update_full() ? -1 : p_regular_light_id;
 
 	switch (RSG::light_storage->light_get_type(p_instance->base)) {
 		case RS::LIGHT_DIRECTIONAL: {
@@ -2485,9 +2556,6 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					return true;
 				}
 				for (int i = 0; i < 2; i++) {
-					//using this one ensures that raster deferred will have it
-					RENDER_TIMESTAMP("Cull OmniLight3D Shadow Paraboloid, Half " + itos(i));
-
 					real_t radius = RSG::light_storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
 
 					real_t z = i == 0 ? -1 : 1;
@@ -2500,52 +2568,9 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
-
-					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
-
-					if (!light->is_shadow_update_full()) {
-						light_culler->cull_regular_light(instance_shadow_cull_result);
-					}
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							if (instance->mesh_instance.is_valid()) {
-								RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::mesh_storage->update_mesh_instances();
+					_light_instance_add_shadow_cull_pass(p_instance, p_scenario, planes, i, regular_light_id, p_visible_layers);
 
 					RSG::light_storage->light_instance_set_shadow_transform(light->instance, Projection(), light_transform, radius, 0, i, 0);
-					shadow_data.light = light->instance;
-					shadow_data.pass = i;
 				}
 			} else { //shadow cube
 
@@ -2558,9 +2583,6 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 				cm.set_perspective(90, 1, radius * 0.005f, radius);
 
 				for (int i = 0; i < 6; i++) {
-					RENDER_TIMESTAMP("Cull OmniLight3D Shadow Cube, Side " + itos(i));
-					//using this one ensures that raster deferred will have it
-
 					static const Vector3 view_normals[6] = {
 						Vector3(+1, 0, 0),
 						Vector3(-1, 0, 0),
@@ -2582,51 +2604,9 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 					Vector<Plane> planes = cm.get_projection_planes(xform);
 
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
+					_light_instance_add_shadow_cull_pass(p_instance, p_scenario, planes, i, regular_light_id, p_visible_layers);
 
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
-
-					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
-
-					if (!light->is_shadow_update_full()) {
-						light_culler->cull_regular_light(instance_shadow_cull_result);
-					}
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							if (instance->mesh_instance.is_valid()) {
-								RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::mesh_storage->update_mesh_instances();
 					RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i, 0);
-
-					shadow_data.light = light->instance;
-					shadow_data.pass = i;
 				}
 
 				//restore the regular DP matrix
@@ -2635,8 +2615,6 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 		} break;
 		case RS::LIGHT_SPOT: {
-			RENDER_TIMESTAMP("Cull SpotLight3D Shadow");
-
 			if (max_shadows_used + 1 > MAX_UPDATE_SHADOWS) {
 				return true;
 			}
@@ -2649,56 +2627,95 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
 
-			instance_shadow_cull_result.clear();
+			_light_instance_add_shadow_cull_pass(p_instance, p_scenario, planes, 0, regular_light_id, p_visible_layers);
 
-			Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
+			RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
 
-			struct CullConvex {
-				PagedArray<Instance *> *result;
-				_FORCE_INLINE_ bool operator()(void *p_data) {
-					Instance *p_instance = (Instance *)p_data;
-					result->push_back(p_instance);
-					return false;
-				}
-			};
+		} break;
+	}
 
-			CullConvex cull_convex;
-			cull_convex.result = &instance_shadow_cull_result;
+	return false;
+}
 
-			p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+void RendererSceneCull::_light_shadow_cull_threaded(uint32_t p_pass, ShadowCullPass *p_passes) {
+	ShadowCullPass &cull_pass = p_passes[p_pass];
+	PagedArray<Instance *> &cull_result = shadow_cull_results[cull_pass.shadow_index];
+	cull_result.clear();
 
-			RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
+	Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&cull_pass.planes[0], cull_pass.planes.size());
 
-			if (!light->is_shadow_update_full()) {
-				light_culler->cull_regular_light(instance_shadow_cull_result);
-			}
+	struct CullConvex {
+		PagedArray<Instance *> *result;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			Instance *p_instance = (Instance *)p_data;
+			result->push_back(p_instance);
+			return false;
+		}
+	};
 
-			for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-					continue;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
+	CullConvex cull_convex;
+	cull_convex.result = &cull_result;
 
-					if (instance->mesh_instance.is_valid()) {
-						RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-					}
-				}
-				shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-			}
+	cull_pass.scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(cull_pass.planes.ptr(), cull_pass.planes.size(), points.ptr(), points.size(), cull_convex);
 
-			RSG::mesh_storage->update_mesh_instances();
+	if (cull_pass.regular_light_id != -1) {
+		light_culler->cull_regular_light(cull_result, cull_pass.regular_light_id);
+	}
 
-			RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
-			shadow_data.light = light->instance;
-			shadow_data.pass = 0;
+	RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[cull_pass.shadow_index];
 
-		} break;
+	// Only the casters with a mesh instance are kept in the result, their update is checked from the render thread afterwards.
+	cull_pass.mesh_instance_count = 0;
+	cull_pass.animated_material_found = false;
+
+	for (uint64_t j = 0; j < cull_result.size(); j++) {
+		Instance *instance = cull_result[j];
+		if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(cull_pass.visible_layers & instance->layer_mask)) {
+			continue;
+		}
+
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+		if (geom->material_is_animated) {
+			cull_pass.animated_material_found = true;
+		}
+
+		if (instance->mesh_instance.is_valid()) {
+			cull_result[cull_pass.mesh_instance_count++] = instance;
+		}
+
+		shadow_data.instances.push_back(geom->geometry_instance);
 	}
+}
 
-	return animated_material_found;
+void RendererSceneCull::_light_shadows_cull() {
+	if (shadow_cull_passes.is_empty()) {
+		return;
+	}
+
+	RENDER_TIMESTAMP("Cull Light3D Shadows");
+
+	if (shadow_cull_passes.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_light_shadow_cull_threaded, shadow_cull_passes.ptr(), shadow_cull_passes.size(), -1, true, SNAME("RenderCullLightShadows"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_light_shadow_cull_threaded(0, shadow_cull_passes.ptr());
+	}
+
+	for (const ShadowCullPass &cull_pass : shadow_cull_passes) {
+		PagedArray<Instance *> &cull_result = shadow_cull_results[cull_pass.shadow_index];
+		for (uint32_t j = 0; j < cull_pass.mesh_instance_count; j++) {
+			RSG::mesh_storage->mesh_instance_check_for_update(cull_result[j]->mesh_instance);
+		}
+		cull_result.clear();
+
+		if (cull_pass.animated_material_found) {
+			static_cast<InstanceLightData *>(cull_pass.light->base_data)->make_shadow_dirty();
+		}
+	}
+
+	RSG::mesh_storage->update_mesh_instances();
+
+	shadow_cull_passes.clear();
 }
 
 void RendererSceneCull::render_camera(const Ref<RenderSceneBuffers> &p_render_buffers, RID p_camera, RID p_scenario, RID p_viewport, Size2 p_viewport_size, uint32_t p_jitter_phase_count, float p_screen_mesh_lod_threshold, RID p_shadow_atlas, Ref<XRInterface> &p_xr_interface, RenderInfo *r_render_info) {
@@ -2803,9 +2820,55 @@ void RendererSceneCull::render_camera(const Ref<RenderSceneBuffers> &p_render_bu
 	RendererSceneOcclusionCull::get_singleton()->buffer_update(p_viewport, camera_data.main_transform, camera_data.main_projection, camera_data.is_orthogonal);
 
 	_render_scene(&camera_data, p_render_buffers, environment, camera->attributes, compositor, camera->visible_layers, p_scenario, p_viewport, p_shadow_atlas, RID(), -1, p_screen_mesh_lod_threshold, true, r_render_info);
+
+	_update_texture_streaming_requests(&camera_data, p_viewport_size);
 #endif
 }
 
+void RendererSceneCull::_update_texture_streaming_requests(const RendererSceneRender::CameraData *p_camera_data, const Size2 &p_viewport_size) {
+	if (scene_cull_result.streamed_instances.size() == 0) {
+		return;
+	}
+
+	// Estimate how many pixels each instance covers vertically, which is about the resolution its textures need.
+	const Vector3 camera_position = p_camera_data->main_transform.origin;
+	const real_t z_near = p_camera_data->main_projection.get_z_near();
+	const real_t pixels_per_unit = p_camera_data->main_projection.columns[1][1] * 0.5 * p_viewport_size.height;
+
+	for (uint64_t i = 0; i < scene_cull_result.streamed_instances.size(); i++) {
+		const Instance *instance = scene_cull_result.streamed_instances[i];
+		const real_t size = instance->transformed_aabb.size.length();
+		float screen_size = size * pixels_per_unit;
+		if (!p_camera_data->is_orthogonal) {
+			const real_t distance = instance->transformed_aabb.get_center().distance_to(camera_position) - size * 0.5;
+			screen_size /= MAX(distance, z_near);
+		}
+
+		for (const RID &texture : instance->streamed_textures) {
+			float *request = texture_streaming_requests.getptr(texture);
+			if (request) {
+				*request = MAX(*request, screen_size);
+			} else {
+				texture_streaming_requests.insert(texture, screen_size);
+			}
+		}
+	}
+}
+
+void RendererSceneCull::flush_texture_streaming_requests(TypedArray<RID> &r_textures, PackedFloat32Array &r_screen_sizes) {
+	r_textures.resize(texture_streaming_requests.size());
+	r_screen_sizes.resize(texture_streaming_requests.size());
+
+	int index = 0;
+	for (const KeyValue<RID, float> &E : texture_streaming_requests) {
+		r_textures[index] = E.key;
+		r_screen_sizes.set(index, E.value);
+		index++;
+	}
+
+	texture_streaming_requests.clear();
+}
+
 void RendererSceneCull::_visibility_cull_threaded(uint32_t p_thread, VisibilityCullData *cull_data) {
 	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
 	uint32_t bin_from = p_thread * cull_data->cull_count / total_threads;
@@ -3125,6 +3188,9 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 
 					if (keep) {
 						cull_result.geometry_instances.push_back(idata.instance_geometry);
+						if (idata.flags & InstanceData::FLAG_USES_STREAMED_TEXTURES) {
+							cull_result.streamed_instances.push_back(idata.instance);
+						}
 					}
 				}
 			}
@@ -3382,6 +3448,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 		}
 
 		// Positional Shadows
+		// Only the cull passes are set up here, the casters are culled for all lights at once afterwards.
+		int32_t regular_light_count = 0;
 		for (uint32_t i = 0; i < (uint32_t)scene_cull_result.lights.size(); i++) {
 			Instance *ins = scene_cull_result.lights[i];
 
@@ -3469,12 +3537,15 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			// so that we can turn off tighter caster culling.
 			light->detect_light_intersects_multiple_cameras(Engine::get_singleton()->get_frames_drawn());
 
+			int32_t regular_light_id = -1;
+
 			if (light->is_shadow_dirty()) {
 				// Dirty shadows have no need to be drawn if
 				// the light volume doesn't intersect the camera frustum.
 
 				// Returns false if the entire light can be culled.
-				bool allow_redraw = light_culler->prepare_regular_light(*ins);
+				regular_light_id = regular_light_count++;
+				bool allow_redraw = light_culler->prepare_regular_light(*ins, regular_light_id);
 
 				// Directional lights aren't handled here, _light_instance_update_shadow is called from elsewhere.
 				// Checking for this in case this changes, as this is assumed.
@@ -3497,7 +3568,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			if (redraw && max_shadows_used < MAX_UPDATE_SHADOWS) {
 				//must redraw!
 				RENDER_TIMESTAMP("> Render Light3D " + itos(i));
-				if (_light_instance_update_shadow(ins, p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect, p_shadow_atlas, scenario, p_screen_mesh_lod_threshold, p_visible_layers)) {
+				if (_light_instance_update_shadow(ins, p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect, p_shadow_atlas, scenario, p_screen_mesh_lod_threshold, regular_light_id, p_visible_layers)) {
 					light->make_shadow_dirty();
 				}
 				RENDER_TIMESTAMP("< Render Light3D " + itos(i));
@@ -3507,6 +3578,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 				}
 			}
 		}
+
+		_light_shadows_cull();
 	}
 
 	//render SDFGI
@@ -4044,7 +4117,7 @@ void RendererSceneCull::_update_instance_shader_uniforms_from_material(HashMap<S
 	}
 }
 
-void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+void RendererSceneCull::_update_dirty_instance_data(Instance *p_instance) {
 	if (p_instance->update_aabb) {
 		_update_instance_aabb(p_instance);
 	}
@@ -4088,6 +4161,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 			bool can_cast_shadows = true;
 			bool is_animated = false;
 			HashMap<StringName, Instance::InstanceShaderParameter> isparams;
+			LocalVector<RID> streamed_textures;
 
 			if (p_instance->cast_shadows == RS::SHADOW_CASTING_SETTING_OFF) {
 				can_cast_shadows = false;
@@ -4099,6 +4173,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 				}
 				is_animated = RSG::material_storage->material_is_animated(p_instance->material_override);
 				_update_instance_shader_uniforms_from_material(isparams, p_instance->instance_shader_uniforms, p_instance->material_override);
+				RSG::material_storage->material_get_streamed_textures(p_instance->material_override, &streamed_textures);
 			} else {
 				if (p_instance->base_type == RS::INSTANCE_MESH) {
 					RID mesh = p_instance->base;
@@ -4121,6 +4196,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 								}
 
 								_update_instance_shader_uniforms_from_material(isparams, p_instance->instance_shader_uniforms, mat);
+								RSG::material_storage->material_get_streamed_textures(mat, &streamed_textures);
 
 								RSG::material_storage->material_update_dependency(mat, &p_instance->dependency_tracker);
 							}
@@ -4152,6 +4228,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 								}
 
 								_update_instance_shader_uniforms_from_material(isparams, p_instance->instance_shader_uniforms, mat);
+								RSG::material_storage->material_get_streamed_textures(mat, &streamed_textures);
 
 								RSG::material_storage->material_update_dependency(mat, &p_instance->dependency_tracker);
 							}
@@ -4190,6 +4267,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 								}
 
 								_update_instance_shader_uniforms_from_material(isparams, p_instance->instance_shader_uniforms, mat);
+								RSG::material_storage->material_get_streamed_textures(mat, &streamed_textures);
 
 								RSG::material_storage->material_update_dependency(mat, &p_instance->dependency_tracker);
 							}
@@ -4206,6 +4284,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 				can_cast_shadows = can_cast_shadows && RSG::material_storage->material_casts_shadows(p_instance->material_overlay);
 				is_animated = is_animated || RSG::material_storage->material_is_animated(p_instance->material_overlay);
 				_update_instance_shader_uniforms_from_material(isparams, p_instance->instance_shader_uniforms, p_instance->material_overlay);
+				RSG::material_storage->material_get_streamed_textures(p_instance->material_overlay, &streamed_textures);
 			}
 
 			if (can_cast_shadows != geom->can_cast_shadows) {
@@ -4220,6 +4299,16 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 
 			geom->material_is_animated = is_animated;
 			p_instance->instance_shader_uniforms = isparams;
+			p_instance->streamed_textures = streamed_textures;
+
+			if (p_instance->scenario && p_instance->array_index >= 0) {
+				InstanceData &idata = p_instance->scenario->instance_data[p_instance->array_index];
+				if (p_instance->streamed_textures.is_empty()) {
+					idata.flags &= ~uint32_t(InstanceData::FLAG_USES_STREAMED_TEXTURES);
+				} else {
+					idata.flags |= InstanceData::FLAG_USES_STREAMED_TEXTURES;
+				}
+			}
 
 			if (p_instance->instance_allocated_shader_uniforms != (p_instance->instance_shader_uniforms.size() > 0)) {
 				p_instance->instance_allocated_shader_uniforms = (p_instance->instance_shader_uniforms.size() > 0);
@@ -4272,15 +4361,77 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 
 	_instance_update_list.remove(&p_instance->update_item);
 
-	_update_instance(p_instance);
-
 	p_instance->update_aabb = false;
 	p_instance->update_dependencies = false;
 }
 
+void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+	_update_dirty_instance_data(p_instance);
+	_update_instance(p_instance);
+}
+
+void RendererSceneCull::_update_dirty_instance_bounds_threaded(uint32_t p_index, AABB *r_bvh_aabbs) {
+	const Instance *instance = dirty_instance_batch[p_index];
+	if (instance->aabb.has_surface()) {
+		r_bvh_aabbs[p_index] = _get_instance_bvh_aabb(instance, instance->transform.xform(instance->aabb));
+	}
+}
+
+void RendererSceneCull::_update_indexer_threaded(uint32_t p_index, IndexerUpdate *p_updates) {
+	IndexerUpdate &update = p_updates[p_index];
+	update.indexer->update_multiple(update.ids.ptr(), update.aabbs.ptr(), update.ids.size());
+}
+
+void RendererSceneCull::_update_dirty_instance_batch() {
+	for (Instance *instance : dirty_instance_batch) {
+		_update_dirty_instance_data(instance);
+	}
+
+	// The bounds of an instance only depend on itself.
+	dirty_instance_bvh_aabbs.resize(dirty_instance_batch.size());
+	if (dirty_instance_batch.size() >= thread_cull_threshold) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_update_dirty_instance_bounds_threaded, dirty_instance_bvh_aabbs.ptr(), dirty_instance_batch.size(), -1, true, SNAME("UpdateDirtyInstanceBounds"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < dirty_instance_batch.size(); i++) {
+			_update_dirty_instance_bounds_threaded(i, dirty_instance_bvh_aabbs.ptr());
+		}
+	}
+
+	// Instances that end up indexed are kept at the front of the batch, to update their pairs once all indexers moved.
+	LocalVector<IndexerUpdate> indexer_updates;
+	uint32_t indexed_count = 0;
+	for (uint32_t i = 0; i < dirty_instance_batch.size(); i++) {
+		Instance *instance = dirty_instance_batch[i];
+		if (_update_instance_transform(instance)) {
+			_update_instance_indexer(instance, dirty_instance_bvh_aabbs[i], &indexer_updates);
+			dirty_instance_batch[indexed_count++] = instance;
+		}
+	}
+
+	// Each indexer is moved by a single task.
+	if (indexer_updates.size() > 1 && indexed_count >= thread_cull_threshold) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_update_indexer_threaded, indexer_updates.ptr(), indexer_updates.size(), -1, true, SNAME("UpdateDirtyInstanceIndexers"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < indexer_updates.size(); i++) {
+			_update_indexer_threaded(i, indexer_updates.ptr());
+		}
+	}
+
+	for (uint32_t i = 0; i < indexed_count; i++) {
+		_update_instance_pairs(dirty_instance_batch[i]);
+	}
+}
+
 void RendererSceneCull::update_dirty_instances() {
 	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
+		// Instances queued while a batch is updated are left to the next batch.
+		dirty_instance_batch.clear();
+		for (SelfList<Instance> *E = _instance_update_list.first(); E; E = E->next()) {
+			dirty_instance_batch.push_back(E->self());
+		}
+		_update_dirty_instance_batch();
 	}
 
 	// Update dirty resources after dirty instances as instance updates may affect resources.
@@ -4508,7 +4659,9 @@ RendererSceneCull::RendererSceneCull() {
 	singleton = this;
 
 	instance_cull_result.set_page_pool(&instance_cull_page_pool);
-	instance_shadow_cull_result.set_page_pool(&instance_cull_page_pool);
+	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
+		shadow_cull_results[i].set_page_pool(&instance_cull_page_pool);
+	}
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.set_page_pool(&geometry_instance_cull_page_pool);
@@ -4528,7 +4681,17 @@ RendererSceneCull::RendererSceneCull() {
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); //make sure there is at least one thread per CPU
 	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = GLOBAL_GET("rendering/occlusion_culling/jitter_projection");
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	int occlusion_culling_backend = GLOBAL_GET("rendering/occlusion_culling/backend");
+#ifndef MODULE_RAYCAST_ENABLED
+	// Without Embree, the rasterizer is the only backend available.
+	occlusion_culling_backend = RendererSceneOcclusionCull::BACKEND_RASTERIZER;
+#endif
+	if (occlusion_culling_backend == RendererSceneOcclusionCull::BACKEND_RASTERIZER) {
+		default_occlusion_culling = memnew(RasterOcclusionCull);
+	} else {
+		// Replaced by the raycast module when it's initialized.
+		default_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	}
 
 	light_culler = memnew(RenderingLightCuller);
 
@@ -4539,7 +4702,9 @@ RendererSceneCull::RendererSceneCull() {
 
 RendererSceneCull::~RendererSceneCull() {
 	instance_cull_result.reset();
-	instance_shadow_cull_result.reset();
+	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
+		shadow_cull_results[i].reset();
+	}
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.reset();
@@ -4554,8 +4719,8 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (default_occlusion_culling) {
+		memdelete(default_occlusion_culling);
 	}
 
 	if (light_culler) {
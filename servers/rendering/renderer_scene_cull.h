@@ -129,7 +129,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling = nullptr;
+	RendererSceneOcclusionCull *default_occlusion_culling = nullptr;
 
 	/* SCENARIO API */
 
@@ -279,6 +279,7 @@ public:
 			FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN = (1 << 22),
 			FLAG_GEOM_PROJECTOR_SOFTSHADOW_DIRTY = (1 << 23),
 			FLAG_IGNORE_ALL_CULLING = (1 << 24),
+			FLAG_USES_STREAMED_TEXTURES = (1 << 25),
 		};
 
 		uint32_t flags = 0;
@@ -428,6 +429,7 @@ public:
 		bool ignore_all_culling;
 
 		Vector<RID> materials;
+		LocalVector<RID> streamed_textures;
 
 		RS::ShadowCastingSetting cast_shadows;
 
@@ -654,6 +656,16 @@ public:
 	SelfList<Instance>::List _instance_update_list;
 	void _instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_dependencies = false);
 
+	// Dirty instances are updated in batches, so that the bounds are computed in parallel and each indexer is moved at once.
+	struct IndexerUpdate {
+		DynamicBVH *indexer = nullptr;
+		LocalVector<DynamicBVH::ID> ids;
+		LocalVector<AABB> aabbs;
+	};
+
+	LocalVector<Instance *> dirty_instance_batch;
+	LocalVector<AABB> dirty_instance_bvh_aabbs;
+
 	struct InstanceGeometryData : public InstanceBaseData {
 		RenderGeometryInstance *geometry_instance = nullptr;
 		HashSet<Instance *> lights;
@@ -722,6 +734,9 @@ public:
 	SpinLock visible_notifier_list_lock;
 	SelfList<InstanceVisibilityNotifierData>::List visible_notifier_list;
 
+	// Largest on-screen size in pixels of the visible instances using each streamed texture, since the last flush.
+	HashMap<RID, float> texture_streaming_requests;
+
 	struct InstanceLightData : public InstanceBaseData {
 		RID instance;
 		uint64_t last_version;
@@ -911,7 +926,6 @@ public:
 	PagedArrayPool<RID> rid_cull_page_pool;
 
 	PagedArray<Instance *> instance_cull_result;
-	PagedArray<Instance *> instance_shadow_cull_result;
 
 	struct InstanceCullResult {
 		PagedArray<RenderGeometryInstance *> geometry_instances;
@@ -923,6 +937,7 @@ public:
 		PagedArray<RID> voxel_gi_instances;
 		PagedArray<RID> mesh_instances;
 		PagedArray<RID> fog_volumes;
+		PagedArray<Instance *> streamed_instances;
 
 		struct DirectionalShadow {
 			PagedArray<RenderGeometryInstance *> cascade_geometry_instances[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
@@ -941,6 +956,7 @@ public:
 			voxel_gi_instances.clear();
 			mesh_instances.clear();
 			fog_volumes.clear();
+			streamed_instances.clear();
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].clear();
@@ -966,6 +982,7 @@ public:
 			voxel_gi_instances.reset();
 			mesh_instances.reset();
 			fog_volumes.reset();
+			streamed_instances.reset();
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].reset();
@@ -991,6 +1008,7 @@ public:
 			voxel_gi_instances.merge_unordered(p_cull_result.voxel_gi_instances);
 			mesh_instances.merge_unordered(p_cull_result.mesh_instances);
 			fog_volumes.merge_unordered(p_cull_result.fog_volumes);
+			streamed_instances.merge_unordered(p_cull_result.streamed_instances);
 
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
@@ -1017,6 +1035,7 @@ public:
 			voxel_gi_instances.set_page_pool(p_rid_pool);
 			mesh_instances.set_page_pool(p_rid_pool);
 			fog_volumes.set_page_pool(p_rid_pool);
+			streamed_instances.set_page_pool(p_instance_pool);
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].set_page_pool(p_geometry_instance_pool);
@@ -1039,6 +1058,21 @@ public:
 	RendererSceneRender::RenderShadowData render_shadow_data[MAX_UPDATE_SHADOWS];
 	uint32_t max_shadows_used = 0;
 
+	// Positional light shadows are culled together, each pass writes to its own shadow data and result.
+	struct ShadowCullPass {
+		Instance *light = nullptr;
+		Scenario *scenario = nullptr;
+		Vector<Plane> planes;
+		int32_t regular_light_id = -1;
+		uint32_t shadow_index = 0;
+		uint32_t visible_layers = 0;
+		uint32_t mesh_instance_count = 0;
+		bool animated_material_found = false;
+	};
+
+	LocalVector<ShadowCullPass> shadow_cull_passes;
+	PagedArray<Instance *> shadow_cull_results[MAX_UPDATE_SHADOWS];
+
 	RendererSceneRender::RenderSDFGIData render_sdfgi_data[SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE];
 	RendererSceneRender::RenderSDFGIUpdateData sdfgi_update_data;
 
@@ -1058,7 +1092,9 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario);
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_pivot_data(RID p_instance, float p_sorting_offset, bool p_use_aabb_center);
+	_FORCE_INLINE_ void _instance_set_transform(Instance *p_instance, const Transform3D &p_transform);
 	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform);
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms);
 	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated);
 	virtual void instance_reset_physics_interpolation(RID p_instance);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id);
@@ -1105,15 +1141,26 @@ public:
 	virtual void mesh_generate_pipelines(RID p_mesh, bool p_background_compilation);
 	virtual uint32_t get_pipeline_compilations(RS::PipelineSource p_source);
 
+	_FORCE_INLINE_ bool _update_instance_transform(Instance *p_instance);
+	_FORCE_INLINE_ AABB _get_instance_bvh_aabb(const Instance *p_instance, const AABB &p_transformed_aabb) const;
+	_FORCE_INLINE_ void _update_instance_indexer(Instance *p_instance, const AABB &p_bvh_aabb, LocalVector<IndexerUpdate> *r_indexer_updates = nullptr);
+	_FORCE_INLINE_ void _update_instance_pairs(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+	_FORCE_INLINE_ void _update_dirty_instance_data(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
+	void _update_dirty_instance_bounds_threaded(uint32_t p_index, AABB *r_bvh_aabbs);
+	void _update_indexer_threaded(uint32_t p_index, IndexerUpdate *p_updates);
+	void _update_dirty_instance_batch();
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_mesh_lod_threshold, uint32_t p_visible_layers = 0xFFFFFF);
+	uint32_t _light_instance_add_shadow_cull_pass(Instance *p_instance, Scenario *p_scenario, const Vector<Plane> &p_planes, uint32_t p_pass, int32_t p_regular_light_id, uint32_t p_visible_layers);
+	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_mesh_lod_threshold, int32_t p_regular_light_id = -1, uint32_t p_visible_layers = 0xFFFFFF);
+	void _light_shadow_cull_threaded(uint32_t p_pass, ShadowCullPass *p_passes);
+	void _light_shadows_cull();
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
 	RID _render_get_compositor(RID p_camera, RID p_scenario);
@@ -1188,6 +1235,7 @@ public:
 	bool _render_reflection_probe_step(Instance *p_instance, int p_step);
 	void _render_scene(const RendererSceneRender::CameraData *p_camera_data, const Ref<RenderSceneBuffers> &p_render_buffers, RID p_environment, RID p_force_camera_attributes, RID p_compositor, uint32_t p_visible_layers, RID p_scenario, RID p_viewport, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass, float p_screen_mesh_lod_threshold, bool p_using_shadows = true, RenderInfo *r_render_info = nullptr);
 	void render_empty_scene(const Ref<RenderSceneBuffers> &p_render_buffers, RID p_scenario, RID p_shadow_atlas);
+	void _update_texture_streaming_requests(const RendererSceneRender::CameraData *p_camera_data, const Size2 &p_viewport_size);
 
 	void render_camera(const Ref<RenderSceneBuffers> &p_render_buffers, RID p_camera, RID p_scenario, RID p_viewport, Size2 p_viewport_size, uint32_t p_jitter_phase_count, float p_screen_mesh_lod_threshold, RID p_shadow_atlas, Ref<XRInterface> &p_xr_interface, RenderingMethod::RenderInfo *r_render_info = nullptr);
 	void update_dirty_instances();
@@ -1430,6 +1478,7 @@ public:
 	void set_scene_render(RendererSceneRender *p_scene_render);
 
 	virtual void update_visibility_notifiers();
+	virtual void flush_texture_streaming_requests(TypedArray<RID> &r_textures, PackedFloat32Array &r_screen_sizes);
 
 	/* INTERPOLATION */
 
@@ -40,6 +40,12 @@ protected:
 	static RendererSceneOcclusionCull *singleton;
 
 public:
+	// Values of the "rendering/occlusion_culling/backend" project setting.
+	enum Backend {
+		BACKEND_RAYCAST,
+		BACKEND_RASTERIZER,
+	};
+
 	class HZBuffer {
 	protected:
 		static const Vector3 corners[8];
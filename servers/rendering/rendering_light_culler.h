@@ -133,12 +133,12 @@ public:
 	bool prepare_camera(const Transform3D &p_cam_transform, const Projection &p_cam_matrix);
 
 	// REGULAR LIGHTS (SPOT, OMNI).
-	// These are prepared then used for culling one by one, single threaded.
+	// These are prepared one by one, each with its own regular_light_id, then can be culled multithreaded.
 	// prepare_regular_light() returns false if the entire light is culled (i.e. there is no intersection between the light and the view frustum).
-	bool prepare_regular_light(const RendererSceneCull::Instance &p_instance) { return _prepare_light(p_instance, -1); }
+	bool prepare_regular_light(const RendererSceneCull::Instance &p_instance, int32_t p_regular_light_id);
 
-	// Cull according to the regular light planes that were setup in the previous call to prepare_regular_light.
-	void cull_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result);
+	// Cull according to the regular light planes that were setup by prepare_regular_light with the same regular_light_id.
+	void cull_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result, int32_t p_regular_light_id);
 
 	// Directional lights are prepared in advance, and can be culled multithreaded chopping and changing between
 	// different directional_light_id.
@@ -156,12 +156,15 @@ private:
 		void add_cull_plane(const Plane &p);
 		Plane cull_planes[MAX_CULL_PLANES];
 		int num_cull_planes = 0;
+
+		// The whole regular light can be out of range of the view frustum, in which case all casters should be culled.
+		bool out_of_range = false;
 #ifdef LIGHT_CULLER_DEBUG_DIRECTIONAL_LIGHT
 		uint32_t rejected_count = 0;
 #endif
 	};
 
-	bool _prepare_light(const RendererSceneCull::Instance &p_instance, int32_t p_directional_light_id = -1);
+	bool _prepare_light(const RendererSceneCull::Instance &p_instance, LightCullPlanes &r_cull_planes);
 
 	// Avoid adding extra culling planes derived from near colinear triangles.
 	// The normals derived from these will be inaccurate, and can lead to false
@@ -223,15 +226,13 @@ private:
 		// lights multiple times per frame.
 		LocalVector<LightCullPlanes> directional_cull_planes;
 
-		// Single threaded cull planes for regular lights
-		// (OMNI, SPOT). These lights reuse the same set of cull plane data.
-		LightCullPlanes regular_cull_planes;
+		// Regular lights (OMNI, SPOT) also store their own cull planes,
+		// so their shadows can be culled at the same time.
+		LocalVector<LightCullPlanes> regular_cull_planes;
 
 #ifdef LIGHT_CULLER_DEBUG_REGULAR_LIGHT
 		uint32_t regular_rejected_count = 0;
 #endif
-		// The whole regular light can be out of range of the view frustum, in which case all casters should be culled.
-		bool out_of_range = false;
 
 #ifdef RENDERING_LIGHT_CULLER_DEBUG_STRINGS
 		static String plane_bitfield_to_string(unsigned int BF);
@@ -37,10 +37,11 @@
 #include "renderer_canvas_cull.h"
 #include "renderer_scene_cull.h"
 #include "rendering_server_globals.h"
+#include "shader_compiler.h"
 
 // careful, these may run in different threads than the rendering server
 
-int RenderingServerDefault::changes = 0;
+SafeNumeric<int> RenderingServerDefault::changes;
 
 /* FREE */
 
@@ -100,6 +101,17 @@ void RenderingServerDefault::_draw(bool p_swap_buffers, double frame_step) {
 	RSG::canvas->update_visibility_notifiers();
 	RSG::scene->update_visibility_notifiers();
 
+	TypedArray<RID> streaming_textures;
+	PackedFloat32Array streaming_screen_sizes;
+	RSG::scene->flush_texture_streaming_requests(streaming_textures, streaming_screen_sizes);
+	if (!streaming_textures.is_empty()) {
+		if (create_thread) {
+			callable_mp(this, &RenderingServerDefault::_texture_streaming_requested).call_deferred(streaming_textures, streaming_screen_sizes);
+		} else {
+			_texture_streaming_requested(streaming_textures, streaming_screen_sizes);
+		}
+	}
+
 	if (create_thread) {
 		callable_mp(this, &RenderingServerDefault::_run_post_draw_steps).call_deferred();
 	} else {
@@ -199,12 +211,16 @@ void RenderingServerDefault::_run_post_draw_steps() {
 	emit_signal(SNAME("frame_post_draw"));
 }
 
+void RenderingServerDefault::_texture_streaming_requested(const TypedArray<RID> &p_textures, const PackedFloat32Array &p_screen_sizes) {
+	emit_signal(SNAME("texture_streaming_requested"), p_textures, p_screen_sizes);
+}
+
 double RenderingServerDefault::get_frame_setup_time_cpu() const {
 	return frame_setup_time;
 }
 
 bool RenderingServerDefault::has_changed() const {
-	return changes > 0;
+	return changes.get() > 0;
 }
 
 void RenderingServerDefault::_init() {
@@ -291,6 +307,12 @@ uint64_t RenderingServerDefault::get_rendering_info(RenderingInfo p_info) {
 		return RSG::canvas_render->get_pipeline_compilations(PIPELINE_SOURCE_DRAW) + RSG::scene->get_pipeline_compilations(PIPELINE_SOURCE_DRAW);
 	} else if (p_info == RENDERING_INFO_PIPELINE_COMPILATIONS_SPECIALIZATION) {
 		return RSG::canvas_render->get_pipeline_compilations(PIPELINE_SOURCE_SPECIALIZATION) + RSG::scene->get_pipeline_compilations(PIPELINE_SOURCE_SPECIALIZATION);
+	} else if (p_info == RENDERING_INFO_SHADER_CODE_CACHE_HITS) {
+		return ShaderCompiler::get_cache_hits();
+	} else if (p_info == RENDERING_INFO_SHADER_CODE_CACHE_MISSES) {
+		return ShaderCompiler::get_cache_misses();
+	} else if (p_info == RENDERING_INFO_SHADER_CODE_COMPILE_TIME) {
+		return ShaderCompiler::get_compile_time_usec();
 	}
 	return RSG::utilities->get_rendering_info(p_info);
 }
@@ -408,7 +430,7 @@ void RenderingServerDefault::draw(bool p_swap_buffers, double frame_step) {
 	ERR_FAIL_COND_MSG(!Thread::is_main_thread(), "Manually triggering the draw function from the RenderingServer can only be done on the main thread. Call this function from the main thread or use call_deferred().");
 	// Needs to be done before changes is reset to 0, to not force the editor to redraw.
 	RS::get_singleton()->emit_signal(SNAME("frame_pre_draw"));
-	changes = 0;
+	changes.set(0);
 	if (create_thread) {
 		command_queue.push(this, &RenderingServerDefault::_draw, p_swap_buffers, frame_step);
 	} else {
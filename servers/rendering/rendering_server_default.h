@@ -35,6 +35,7 @@
 #include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
 #include "renderer_canvas_cull.h"
 #include "renderer_scene_cull.h"
 #include "renderer_viewport.h"
@@ -56,7 +57,8 @@ class RenderingServerDefault : public RenderingServer {
 
 	};
 
-	static int changes;
+	// Requested from the calling thread, the render thread and the canvas culling threads.
+	static SafeNumeric<int> changes;
 	RID test_cube;
 
 	List<Callable> frame_drawn_callbacks;
@@ -87,6 +89,7 @@ class RenderingServerDefault : public RenderingServer {
 
 	void _draw(bool p_swap_buffers, double frame_step);
 	void _run_post_draw_steps();
+	void _texture_streaming_requested(const TypedArray<RID> &p_textures, const PackedFloat32Array &p_screen_sizes);
 	void _init();
 	void _finish();
 
@@ -100,13 +103,13 @@ public:
 
 #ifdef DEBUG_CHANGES
 	_FORCE_INLINE_ static void redraw_request() {
-		changes++;
+		changes.increment();
 		_changes_changed();
 	}
 
 #else
 	_FORCE_INLINE_ static void redraw_request() {
-		changes++;
+		changes.increment();
 	}
 #endif
 
@@ -231,6 +234,7 @@ public:
 	FUNC1(texture_debug_usage, List<TextureInfo> *)
 
 	FUNC2(texture_set_force_redraw_if_visible, RID, bool)
+	FUNC2(texture_set_streaming, RID, bool)
 	FUNCRIDTEX2(texture_rd, const RID &, const RS::TextureLayeredType)
 	FUNC2RC(RID, texture_get_rd_texture, RID, bool)
 	FUNC2RC(uint64_t, texture_get_native_handle, RID, bool)
@@ -870,6 +874,7 @@ public:
 	FUNC2(instance_set_layer_mask, RID, uint32_t)
 	FUNC3(instance_set_pivot_data, RID, float, bool)
 	FUNC2(instance_set_transform, RID, const Transform3D &)
+	FUNC2(instances_set_transforms, const Vector<RID> &, const Vector<Transform3D> &)
 	FUNC2(instance_set_interpolated, RID, bool)
 	FUNC1(instance_reset_physics_interpolation, RID)
 	FUNC2(instance_attach_object_instance_id, RID, ObjectID)
@@ -30,6 +30,7 @@
 
 #include "shader_compiler.h"
 
+#include "core/config/engine.h"
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 #include "servers/rendering/rendering_server_globals.h"
@@ -902,6 +903,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 
 			if (p_assigning && p_actions.write_flag_pointers.has(vnode->name)) {
 				*p_actions.write_flag_pointers[vnode->name] = true;
+				used_write_flag_pointers.insert(vnode->name);
 			}
 
 			if (p_default_actions.usage_defines.has(vnode->name) && !used_name_defines.has(vnode->name)) {
@@ -1019,6 +1021,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 
 			if (p_assigning && p_actions.write_flag_pointers.has(anode->name)) {
 				*p_actions.write_flag_pointers[anode->name] = true;
+				used_write_flag_pointers.insert(anode->name);
 			}
 
 			if (p_default_actions.usage_defines.has(anode->name) && !used_name_defines.has(anode->name)) {
@@ -1241,6 +1244,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 
 							if (found && p_actions.write_flag_pointers.has(name)) {
 								*p_actions.write_flag_pointers[name] = true;
+								used_write_flag_pointers.insert(name);
 							}
 						}
 
@@ -1471,7 +1475,7 @@ ShaderLanguage::DataType ShaderCompiler::_get_global_shader_uniform_type(const S
 	return (ShaderLanguage::DataType)RS::global_shader_uniform_type_get_shader_datatype(gvt);
 }
 
-Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+Error ShaderCompiler::_compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
 	SL::ShaderCompileInfo info;
 	info.functions = ShaderTypes::get_singleton()->get_functions(p_mode);
 	info.render_modes = ShaderTypes::get_singleton()->get_modes(p_mode);
@@ -1570,6 +1574,7 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 	used_name_defines.clear();
 	used_rmode_defines.clear();
 	used_flag_pointers.clear();
+	used_write_flag_pointers.clear();
 	fragment_varyings.clear();
 
 	shader = parser.get_shader();
@@ -1579,9 +1584,137 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 	return OK;
 }
 
+uint32_t ShaderCompiler::_hash_identifier_actions(const IdentifierActions &p_actions) {
+	// Only the names matter, the pointers change with each call. The hash
+	// doesn't depend on the order the maps were filled in.
+	uint32_t h = 0;
+	for (const KeyValue<StringName, Stage> &E : p_actions.entry_point_stages) {
+		h += hash_fmix32(hash_murmur3_one_32(E.key.hash(), E.value));
+	}
+	for (const KeyValue<StringName, Pair<int *, int>> &E : p_actions.render_mode_values) {
+		h += hash_fmix32(hash_murmur3_one_32(E.key.hash(), hash_murmur3_one_32(E.value.second, STAGE_MAX)));
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions.render_mode_flags) {
+		h += hash_fmix32(hash_murmur3_one_32(E.key.hash(), STAGE_MAX + 1));
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions.usage_flag_pointers) {
+		h += hash_fmix32(hash_murmur3_one_32(E.key.hash(), STAGE_MAX + 2));
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions.write_flag_pointers) {
+		h += hash_fmix32(hash_murmur3_one_32(E.key.hash(), STAGE_MAX + 3));
+	}
+	return h;
+}
+
+Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+	CacheKey key;
+	if (cache_enabled) {
+		key.code = p_code;
+		key.mode = p_mode;
+		key.actions_hash = _hash_identifier_actions(*p_actions);
+
+		const CacheEntry *entry = cache.getptr(key);
+		bool valid = entry != nullptr;
+		if (valid) {
+			for (const Pair<StringName, ShaderLanguage::DataType> &E : entry->global_uniforms) {
+				if (_get_global_shader_uniform_type(E.first) != E.second) {
+					valid = false;
+					break;
+				}
+			}
+		}
+
+		if (valid) {
+			// Apply the same changes to the actions as _dump_node_code() would.
+			for (const StringName &E : entry->render_modes) {
+				if (p_actions->render_mode_flags.has(E)) {
+					*p_actions->render_mode_flags[E] = true;
+				}
+				if (p_actions->render_mode_values.has(E)) {
+					Pair<int *, int> &p = p_actions->render_mode_values[E];
+					*p.first = p.second;
+				}
+			}
+			for (const StringName &E : entry->used_flags) {
+				*p_actions->usage_flag_pointers[E] = true;
+			}
+			for (const StringName &E : entry->written_flags) {
+				*p_actions->write_flag_pointers[E] = true;
+			}
+			if (p_actions->uniforms) {
+				for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : entry->uniforms) {
+					p_actions->uniforms->insert(E.key, E.value);
+				}
+			}
+			r_gen_code = entry->gen_code;
+
+			cache_hits.increment();
+			return OK;
+		}
+
+		cache_misses.increment();
+	}
+
+	// Collect the uniforms separately, so they can be stored with the code.
+	HashMap<StringName, SL::ShaderNode::Uniform> *uniforms = p_actions->uniforms;
+	HashMap<StringName, SL::ShaderNode::Uniform> compiled_uniforms;
+	if (cache_enabled) {
+		p_actions->uniforms = &compiled_uniforms;
+	}
+
+	uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	Error err = _compile(p_mode, p_code, p_actions, p_path, r_gen_code);
+	compile_time_usec.add(OS::get_singleton()->get_ticks_usec() - begin_usec);
+
+	if (!cache_enabled) {
+		return err;
+	}
+
+	p_actions->uniforms = uniforms;
+	if (uniforms) {
+		for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : compiled_uniforms) {
+			uniforms->insert(E.key, E.value);
+		}
+	}
+
+	if (err != OK) {
+		return err;
+	}
+
+	CacheEntry entry;
+	entry.gen_code = r_gen_code;
+	entry.render_modes = shader->render_modes;
+	for (const StringName &E : used_flag_pointers) {
+		entry.used_flags.push_back(E);
+	}
+	for (const StringName &E : used_write_flag_pointers) {
+		entry.written_flags.push_back(E);
+	}
+	entry.uniforms = compiled_uniforms;
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// Global uniforms are only type checked in the editor.
+		for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : shader->uniforms) {
+			if (E.value.scope == SL::ShaderNode::Uniform::SCOPE_GLOBAL) {
+				entry.global_uniforms.push_back(Pair<StringName, ShaderLanguage::DataType>(E.key, E.value.type));
+			}
+		}
+	}
+	cache.insert(key, entry);
+
+	return OK;
+}
+
 void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	actions = p_actions;
 
+	// The generated code depends on the default actions.
+	cache.clear();
+	int cache_size = GLOBAL_GET("rendering/shader_compiler/code_cache/size");
+	cache_enabled = cache_size > 0;
+	if (cache_enabled) {
+		cache.set_capacity(cache_size);
+	}
+
 	time_name = "TIME";
 
 	List<String> func_list;
@@ -1604,5 +1737,9 @@ void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	texture_functions.insert("texelFetch");
 }
 
+SafeNumeric<uint64_t> ShaderCompiler::cache_hits;
+SafeNumeric<uint64_t> ShaderCompiler::cache_misses;
+SafeNumeric<uint64_t> ShaderCompiler::compile_time_usec;
+
 ShaderCompiler::ShaderCompiler() {
 }
@@ -31,7 +31,9 @@
 #ifndef SHADER_COMPILER_H
 #define SHADER_COMPILER_H
 
+#include "core/templates/lru.h"
 #include "core/templates/pair.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/rendering/shader_language.h"
 #include "servers/rendering_server.h"
 
@@ -106,6 +108,50 @@ public:
 private:
 	ShaderLanguage parser;
 
+	// Code generated from identical shader code is reused, as long as the
+	// identifier actions it was compiled with have the same names.
+	struct CacheKey {
+		String code;
+		RS::ShaderMode mode = RS::SHADER_SPATIAL;
+		uint32_t actions_hash = 0;
+
+		bool operator==(const CacheKey &p_b) const {
+			return mode == p_b.mode && actions_hash == p_b.actions_hash && code == p_b.code;
+		}
+	};
+
+	struct CacheKeyHasher {
+		_FORCE_INLINE_ static uint32_t hash(const CacheKey &p_key) {
+			uint32_t h = p_key.code.hash();
+			h = hash_murmur3_one_32(p_key.mode, h);
+			h = hash_murmur3_one_32(p_key.actions_hash, h);
+			return hash_fmix32(h);
+		}
+	};
+
+	// Everything compile() hands back to the caller, so a cache hit has the
+	// same effect as compiling again.
+	struct CacheEntry {
+		GeneratedCode gen_code;
+		Vector<StringName> render_modes;
+		Vector<StringName> used_flags;
+		Vector<StringName> written_flags;
+		HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+		// In the editor, global uniforms are checked against the global shader
+		// parameters, which may have changed since the shader was compiled.
+		Vector<Pair<StringName, ShaderLanguage::DataType>> global_uniforms;
+	};
+
+	LRUCache<CacheKey, CacheEntry, CacheKeyHasher> cache;
+	bool cache_enabled = false;
+
+	static SafeNumeric<uint64_t> cache_hits;
+	static SafeNumeric<uint64_t> cache_misses;
+	static SafeNumeric<uint64_t> compile_time_usec;
+
+	static uint32_t _hash_identifier_actions(const IdentifierActions &p_actions);
+	Error _compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
+
 	String _get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat);
 
 	void _dump_function_deps(const ShaderLanguage::ShaderNode *p_node, const StringName &p_for_func, const HashMap<StringName, String> &p_func_code, String &r_to_add, HashSet<StringName> &added);
@@ -119,6 +165,7 @@ private:
 
 	HashSet<StringName> used_name_defines;
 	HashSet<StringName> used_flag_pointers;
+	HashSet<StringName> used_write_flag_pointers;
 	HashSet<StringName> used_rmode_defines;
 	HashSet<StringName> internal_functions;
 	HashSet<StringName> fragment_varyings;
@@ -130,6 +177,10 @@ private:
 public:
 	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
 
+	static uint64_t get_cache_hits() { return cache_hits.get(); }
+	static uint64_t get_cache_misses() { return cache_misses.get(); }
+	static uint64_t get_compile_time_usec() { return compile_time_usec.get(); }
+
 	void initialize(DefaultIdentifierActions p_actions);
 	ShaderCompiler();
 };
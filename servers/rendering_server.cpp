@@ -82,6 +82,34 @@ static PackedInt64Array to_int_array(const Vector<ObjectID> &ids) {
 	return a;
 }
 
+void RenderingServer::_instances_set_transforms_bind(const TypedArray<RID> &p_instances, const PackedFloat32Array &p_transforms) {
+	ERR_FAIL_COND_MSG(p_transforms.size() != p_instances.size() * 12, "The transforms buffer must have 12 floats per instance.");
+
+	Vector<RID> instances;
+	instances.resize(p_instances.size());
+	RID *instances_ptrw = instances.ptrw();
+	Vector<Transform3D> transforms;
+	transforms.resize(p_instances.size());
+	Transform3D *transforms_ptrw = transforms.ptrw();
+	const float *buffer = p_transforms.ptr();
+
+	for (int i = 0; i < p_instances.size(); i++) {
+		instances_ptrw[i] = p_instances[i];
+
+		// Same layout as the transforms of a MultiMesh buffer.
+		const float *ptr = buffer + i * 12;
+		Transform3D &t = transforms_ptrw[i];
+		t.basis.rows[0] = Vector3(ptr[0], ptr[1], ptr[2]);
+		t.origin.x = ptr[3];
+		t.basis.rows[1] = Vector3(ptr[4], ptr[5], ptr[6]);
+		t.origin.y = ptr[7];
+		t.basis.rows[2] = Vector3(ptr[8], ptr[9], ptr[10]);
+		t.origin.z = ptr[11];
+	}
+
+	instances_set_transforms(instances, transforms);
+}
+
 PackedInt64Array RenderingServer::_instances_cull_aabb_bind(const AABB &p_aabb, RID p_scenario) const {
 	Vector<ObjectID> ids = instances_cull_aabb(p_aabb, p_scenario);
 	return to_int_array(ids);
@@ -2262,6 +2290,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("texture_get_format", "texture"), &RenderingServer::texture_get_format);
 
 	ClassDB::bind_method(D_METHOD("texture_set_force_redraw_if_visible", "texture", "enable"), &RenderingServer::texture_set_force_redraw_if_visible);
+	ClassDB::bind_method(D_METHOD("texture_set_streaming", "texture", "enable"), &RenderingServer::texture_set_streaming);
 	ClassDB::bind_method(D_METHOD("texture_rd_create", "rd_texture", "layer_type"), &RenderingServer::texture_rd_create, DEFVAL(RenderingServer::TEXTURE_LAYERED_2D_ARRAY));
 	ClassDB::bind_method(D_METHOD("texture_get_rd_texture", "texture", "srgb"), &RenderingServer::texture_get_rd_texture, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("texture_get_native_handle", "texture", "srgb"), &RenderingServer::texture_get_native_handle, DEFVAL(false));
@@ -3129,6 +3158,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_set_layer_mask", "instance", "mask"), &RenderingServer::instance_set_layer_mask);
 	ClassDB::bind_method(D_METHOD("instance_set_pivot_data", "instance", "sorting_offset", "use_aabb_center"), &RenderingServer::instance_set_pivot_data);
 	ClassDB::bind_method(D_METHOD("instance_set_transform", "instance", "transform"), &RenderingServer::instance_set_transform);
+	ClassDB::bind_method(D_METHOD("instances_set_transforms", "instances", "transforms"), &RenderingServer::_instances_set_transforms_bind);
 	ClassDB::bind_method(D_METHOD("instance_set_interpolated", "instance", "interpolated"), &RenderingServer::instance_set_interpolated);
 	ClassDB::bind_method(D_METHOD("instance_reset_physics_interpolation", "instance"), &RenderingServer::instance_reset_physics_interpolation);
 	ClassDB::bind_method(D_METHOD("instance_attach_object_instance_id", "instance", "id"), &RenderingServer::instance_attach_object_instance_id);
@@ -3452,6 +3482,9 @@ void RenderingServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(RENDERING_INFO_PIPELINE_COMPILATIONS_SURFACE);
 	BIND_ENUM_CONSTANT(RENDERING_INFO_PIPELINE_COMPILATIONS_DRAW);
 	BIND_ENUM_CONSTANT(RENDERING_INFO_PIPELINE_COMPILATIONS_SPECIALIZATION);
+	BIND_ENUM_CONSTANT(RENDERING_INFO_SHADER_CODE_CACHE_HITS);
+	BIND_ENUM_CONSTANT(RENDERING_INFO_SHADER_CODE_CACHE_MISSES);
+	BIND_ENUM_CONSTANT(RENDERING_INFO_SHADER_CODE_COMPILE_TIME);
 
 	BIND_ENUM_CONSTANT(PIPELINE_SOURCE_CANVAS);
 	BIND_ENUM_CONSTANT(PIPELINE_SOURCE_MESH);
@@ -3462,6 +3495,7 @@ void RenderingServer::_bind_methods() {
 
 	ADD_SIGNAL(MethodInfo("frame_pre_draw"));
 	ADD_SIGNAL(MethodInfo("frame_post_draw"));
+	ADD_SIGNAL(MethodInfo("texture_streaming_requested", PropertyInfo(Variant::ARRAY, "textures", PROPERTY_HINT_ARRAY_TYPE, "RID"), PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "screen_sizes")));
 
 	ClassDB::bind_method(D_METHOD("force_sync"), &RenderingServer::sync);
 	ClassDB::bind_method(D_METHOD("force_draw", "swap_buffers", "frame_step"), &RenderingServer::draw, DEFVAL(true), DEFVAL(0.0));
@@ -3568,10 +3602,12 @@ void RenderingServer::init() {
 
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "rendering/2d/shadow_atlas/size", PROPERTY_HINT_RANGE, "128,16384"), 2048);
 	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/2d/batching/item_buffer_size", PROPERTY_HINT_RANGE, "128,1048576,1"), 16384);
+	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/2d/culling/threaded_cull_minimum_items", PROPERTY_HINT_RANGE, "32,65536,1"), 1000);
 
 	// Number of commands that can be drawn per frame.
 	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/gl_compatibility/item_buffer_size", PROPERTY_HINT_RANGE, "128,1048576,1"), 16384);
 
+	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "rendering/shader_compiler/code_cache/size", PROPERTY_HINT_RANGE, "0,4096,1"), 256);
 	GLOBAL_DEF("rendering/shader_compiler/shader_cache/enabled", true);
 	GLOBAL_DEF("rendering/shader_compiler/shader_cache/compress", true);
 	GLOBAL_DEF("rendering/shader_compiler/shader_cache/use_zstd_compression", true);
@@ -194,6 +194,7 @@ public:
 	Array _texture_debug_usage_bind();
 
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) = 0;
+	virtual void texture_set_streaming(RID p_texture, bool p_enable) = 0;
 
 	virtual RID texture_rd_create(const RID &p_rd_texture, const RenderingServer::TextureLayeredType p_layer_type = RenderingServer::TEXTURE_LAYERED_2D_ARRAY) = 0;
 	virtual RID texture_get_rd_texture(RID p_texture, bool p_srgb = false) const = 0;
@@ -1371,6 +1372,8 @@ public:
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask) = 0;
 	virtual void instance_set_pivot_data(RID p_instance, float p_sorting_offset, bool p_use_aabb_center) = 0;
 	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform) = 0;
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) = 0;
+	void _instances_set_transforms_bind(const TypedArray<RID> &p_instances, const PackedFloat32Array &p_transforms);
 	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated) = 0;
 	virtual void instance_reset_physics_interpolation(RID p_instance) = 0;
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id) = 0;
@@ -1715,6 +1718,9 @@ public:
 		RENDERING_INFO_PIPELINE_COMPILATIONS_SURFACE,
 		RENDERING_INFO_PIPELINE_COMPILATIONS_DRAW,
 		RENDERING_INFO_PIPELINE_COMPILATIONS_SPECIALIZATION,
+		RENDERING_INFO_SHADER_CODE_CACHE_HITS,
+		RENDERING_INFO_SHADER_CODE_CACHE_MISSES,
+		RENDERING_INFO_SHADER_CODE_COMPILE_TIME,
 		RENDERING_INFO_MAX
 	};
 
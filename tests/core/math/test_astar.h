@@ -32,6 +32,9 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
+#include "core/math/random_number_generator.h"
+#include "core/object/worker_thread_pool.h"
 
 #include "tests/test_macros.h"
 
@@ -213,6 +216,55 @@ TEST_CASE("[AStar3D] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
+struct ConcurrentQueries {
+	Vector<Vector<int64_t>> expected_paths;
+	Vector<bool> matches;
+
+	void query(uint32_t p_index, AStar3D *p_astar) {
+		const int64_t to_id = p_index * 7 % 1024;
+		matches.write[p_index] = p_astar->get_id_path(0, to_id) == expected_paths[p_index];
+	}
+};
+
+TEST_CASE("[AStar3D] Concurrent path queries") {
+	// 32x32 grid with a wall that has a single gap.
+	AStar3D a;
+	for (int y = 0; y < 32; y++) {
+		for (int x = 0; x < 32; x++) {
+			a.add_point(y * 32 + x, Vector3(x, y, 0));
+			if (x > 0) {
+				a.connect_points(y * 32 + x, y * 32 + x - 1);
+			}
+			if (y > 0) {
+				a.connect_points(y * 32 + x, (y - 1) * 32 + x);
+			}
+		}
+	}
+	for (int y = 0; y < 31; y++) {
+		a.set_point_disabled(y * 32 + 16);
+	}
+
+	const int query_count = 256;
+	ConcurrentQueries queries;
+	queries.expected_paths.resize(query_count);
+	queries.matches.resize(query_count);
+	int found_count = 0;
+	for (int i = 0; i < query_count; i++) {
+		queries.expected_paths.write[i] = a.get_id_path(0, i * 7 % 1024);
+		if (!queries.expected_paths[i].is_empty()) {
+			found_count++;
+		}
+	}
+	CHECK_GT(found_count, query_count - 16); // Only the targets inside the wall can't be reached.
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(&queries, &ConcurrentQueries::query, &a, query_count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (int i = 0; i < query_count; i++) {
+		CHECK_MESSAGE(queries.matches[i], vformat("Path to %d should match the one found on the main thread.", i * 7 % 1024));
+	}
+}
+
 TEST_CASE("[Stress][AStar3D] Find paths") {
 	// Random stress tests with Floyd-Warshall.
 	const int N = 30;
@@ -357,6 +409,106 @@ TEST_CASE("[Stress][AStar3D] Find paths") {
 		CHECK_MESSAGE(match, "Found all paths.");
 	}
 }
+
+static real_t get_grid_path_cost(const Ref<AStarGrid2D> &p_grid, const TypedArray<Vector2i> &p_path) {
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		const Vector2i from = p_path[i - 1];
+		const Vector2i to = p_path[i];
+		cost += Vector2(from).distance_to(Vector2(to)) * p_grid->get_point_weight_scale(to);
+	}
+	return cost;
+}
+
+TEST_CASE("[AStarGrid2D] Cost maps match the path costs") {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(-3, 2, 12, 9));
+	grid->update();
+
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(7);
+	for (int y = 2; y < 11; y++) {
+		for (int x = -3; x < 9; x++) {
+			if (rng->randf() < 0.2) {
+				grid->set_point_solid(Vector2i(x, y));
+			} else {
+				grid->set_point_weight_scale(Vector2i(x, y), rng->randf_range(1.0, 3.0));
+			}
+		}
+	}
+
+	const AStarGrid2D::DiagonalMode diagonal_modes[3] = { AStarGrid2D::DIAGONAL_MODE_ALWAYS, AStarGrid2D::DIAGONAL_MODE_NEVER, AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES };
+	for (AStarGrid2D::DiagonalMode diagonal_mode : diagonal_modes) {
+		grid->set_diagonal_mode(diagonal_mode);
+		const Vector2i source(1, 6);
+		grid->set_point_solid(source, false);
+
+		TypedArray<Vector2i> sources;
+		sources.push_back(source);
+		const PackedFloat32Array costs_from = grid->get_cost_map_from(sources);
+		const PackedFloat32Array costs_to = grid->get_cost_map_to(sources);
+		REQUIRE_EQ(costs_from.size(), 12 * 9);
+		REQUIRE_EQ(costs_to.size(), 12 * 9);
+
+		bool match = true;
+		for (int y = 2; y < 11 && match; y++) {
+			for (int x = -3; x < 9 && match; x++) {
+				const Vector2i id(x, y);
+				const int index = (y - 2) * 12 + x + 3;
+				if (grid->is_point_solid(id)) {
+					match = Math::is_inf(costs_from[index]) && Math::is_inf(costs_to[index]);
+					continue;
+				}
+				const TypedArray<Vector2i> path_from = grid->get_id_path(source, id);
+				const TypedArray<Vector2i> path_to = grid->get_id_path(id, source);
+				const real_t cost_from = path_from.is_empty() ? INFINITY : get_grid_path_cost(grid, path_from);
+				const real_t cost_to = path_to.is_empty() ? INFINITY : get_grid_path_cost(grid, path_to);
+				match = (Math::is_inf(cost_from) ? Math::is_inf(costs_from[index]) : Math::is_equal_approx(cost_from, (real_t)costs_from[index], (real_t)CMP_EPSILON * 100)) &&
+						(Math::is_inf(cost_to) ? Math::is_inf(costs_to[index]) : Math::is_equal_approx(cost_to, (real_t)costs_to[index], (real_t)CMP_EPSILON * 100));
+				CHECK_MESSAGE(match, vformat("Cost map doesn't match the path cost at %s with diagonal mode %d.", id, diagonal_mode));
+			}
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Cost maps from multiple points and with a max cost") {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_size(Vector2i(16, 16));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->set_default_compute_heuristic(AStarGrid2D::HEURISTIC_MANHATTAN);
+	grid->update();
+	grid->fill_solid_region(Rect2i(8, 0, 1, 15));
+
+	TypedArray<Vector2i> sources_a;
+	sources_a.push_back(Vector2i(2, 3));
+	TypedArray<Vector2i> sources_b;
+	sources_b.push_back(Vector2i(13, 12));
+	TypedArray<Vector2i> sources;
+	sources.append_array(sources_a);
+	sources.append_array(sources_b);
+	const PackedFloat32Array costs_a = grid->get_cost_map_from(sources_a);
+	const PackedFloat32Array costs_b = grid->get_cost_map_from(sources_b);
+	const PackedFloat32Array costs = grid->get_cost_map_from(sources);
+	for (int i = 0; i < costs.size(); i++) {
+		CHECK_EQ(costs[i], MIN(costs_a[i], costs_b[i]));
+	}
+	CHECK_EQ(costs[3 * 16 + 5], 3);
+	// Around the wall, through its gap at the bottom.
+	CHECK_EQ(costs_a[3 * 16 + 9], 12 + 7 + 12);
+	CHECK_EQ(costs_b[3 * 16 + 9], 4 + 9);
+
+	const PackedFloat32Array limited_costs = grid->get_cost_map_from(sources_a, 4.5);
+	for (int i = 0; i < costs_a.size(); i++) {
+		if (costs_a[i] <= 4.5) {
+			CHECK_EQ(limited_costs[i], costs_a[i]);
+		} else {
+			CHECK(Math::is_inf(limited_costs[i]));
+		}
+	}
+}
 } // namespace TestAStar
 
 #endif // TEST_ASTAR_H
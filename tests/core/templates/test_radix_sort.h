@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  test_radix_sort.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RADIX_SORT_H
+#define TEST_RADIX_SORT_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/radix_sort.h"
+#include "core/templates/sort_array.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRadixSort {
+
+struct KeyValue {
+	uint64_t key = 0;
+	uint32_t index = 0;
+};
+
+struct GetKeyValueKey {
+	void operator()(const KeyValue &p_value, uint64_t *r_key) const {
+		r_key[0] = p_value.key;
+	}
+};
+
+static bool is_stably_sorted(const LocalVector<KeyValue> &p_values) {
+	for (uint32_t i = 1; i < p_values.size(); i++) {
+		if (p_values[i].key < p_values[i - 1].key) {
+			return false;
+		}
+		if (p_values[i].key == p_values[i - 1].key && p_values[i].index < p_values[i - 1].index) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[RadixSort] Sorting is stable") {
+	RandomPCG rng(1234);
+	RadixSort<KeyValue> sorter;
+
+	for (uint32_t size : { 0u, 1u, 2u, 17u, 64u, 65u, 1000u, 100000u }) {
+		LocalVector<KeyValue> values;
+		values.resize(size);
+		for (uint32_t i = 0; i < size; i++) {
+			// Few distinct keys, with the high bits in use too.
+			values[i].key = (uint64_t(rng.rand() % 16) << 56) | (rng.rand() % 8);
+			values[i].index = i;
+		}
+
+		sorter.sort(values.ptr(), values.size(), GetKeyValueKey());
+		CHECK_MESSAGE(values.size() == size, "Sorting should keep the size of the array.");
+		CHECK_MESSAGE(is_stably_sorted(values), "Array of size ", size, " should be sorted, keeping the order of equal keys.");
+	}
+}
+
+TEST_CASE("[RadixSort] Sorting matches SortArray") {
+	RandomPCG rng(42);
+	RadixSort<uint64_t> sorter;
+
+	LocalVector<uint64_t> values;
+	for (uint32_t i = 0; i < 5000; i++) {
+		values.push_back((uint64_t(rng.rand()) << 32) | rng.rand());
+	}
+	LocalVector<uint64_t> expected = values;
+
+	sorter.sort(values.ptr(), values.size(), [](uint64_t p_value, uint64_t *r_key) { r_key[0] = p_value; });
+	SortArray<uint64_t> sort_array;
+	sort_array.sort(expected.ptr(), expected.size());
+
+	bool all_match = true;
+	for (uint32_t i = 0; i < values.size(); i++) {
+		if (values[i] != expected[i]) {
+			all_match = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(all_match, "Radix sort should give the same order as SortArray.");
+}
+
+TEST_CASE("[RadixSort] Multiple word keys") {
+	RandomPCG rng(7);
+	RadixSort<KeyValue, 2> sorter;
+
+	// The index is used as the most significant word, and the key as the least significant one.
+	LocalVector<KeyValue> values;
+	for (uint32_t i = 0; i < 3000; i++) {
+		KeyValue value;
+		value.key = rng.rand() % 100;
+		value.index = rng.rand() % 10;
+		values.push_back(value);
+	}
+
+	sorter.sort(values.ptr(), values.size(), [](const KeyValue &p_value, uint64_t *r_key) {
+		r_key[0] = p_value.key;
+		r_key[1] = p_value.index;
+	});
+
+	bool sorted = true;
+	for (uint32_t i = 1; i < values.size(); i++) {
+		const KeyValue &a = values[i - 1];
+		const KeyValue &b = values[i];
+		if (a.index > b.index || (a.index == b.index && a.key > b.key)) {
+			sorted = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(sorted, "Keys should be sorted by their most significant word first.");
+}
+
+TEST_CASE("[RadixSort] Float keys") {
+	const float floats[] = { 3.5f, -0.0f, 0.0f, -2.0f, 1e-30f, -1e30f, 1e30f, -1e-30f, 2.0f };
+	LocalVector<float> values;
+	for (float f : floats) {
+		values.push_back(f);
+	}
+
+	RadixSort<float> sorter;
+	sorter.sort(values.ptr(), values.size(), [](float p_value, uint64_t *r_key) { r_key[0] = RadixSort<float>::float_to_key(p_value); });
+
+	bool sorted = true;
+	for (uint32_t i = 1; i < values.size(); i++) {
+		if (values[i] < values[i - 1]) {
+			sorted = false;
+		}
+	}
+	CHECK_MESSAGE(sorted, "Floats should be sorted in ascending order, negative values first.");
+	CHECK(values[0] == -1e30f);
+	CHECK(values[values.size() - 1] == 1e30f);
+}
+
+// Mimics the render list of the forward renderers, which sorts surface pointers by a 128-bit key.
+struct Surface {
+	uint64_t sort_key1 = 0;
+	uint64_t sort_key2 = 0;
+	float depth = 0.0;
+};
+
+struct SortSurfaceByKey {
+	_FORCE_INLINE_ bool operator()(const Surface *A, const Surface *B) const {
+		return (A->sort_key2 == B->sort_key2) ? (A->sort_key1 < B->sort_key1) : (A->sort_key2 < B->sort_key2);
+	}
+};
+
+struct SortSurfaceByDepth {
+	_FORCE_INLINE_ bool operator()(const Surface *A, const Surface *B) const {
+		return A->depth < B->depth;
+	}
+};
+
+TEST_CASE_BENCHMARK("[RadixSort] Render list keys compared to SortArray") {
+	const uint32_t surface_count = 60000;
+	const int frames = 20;
+	RandomPCG rng(2024);
+
+	// Tens of shaders, hundreds of materials, one or two surfaces per mesh and a few LODs.
+	LocalVector<Surface> surfaces;
+	surfaces.resize(surface_count);
+	for (uint32_t i = 0; i < surface_count; i++) {
+		Surface &surface = surfaces[i];
+		uint64_t lod = rng.rand() % 3;
+		uint64_t surface_index = rng.rand() % 2;
+		uint64_t geometry_id = 1 + i / 2;
+		uint64_t material_id = 5000 + rng.rand() % 300;
+		uint64_t shader_id = 1000 + rng.rand() % 40;
+		surface.sort_key1 = lod | (surface_index << 8) | (geometry_id << 16) | ((material_id & 0xFFFF) << 48);
+		surface.sort_key2 = (material_id >> 16) | (shader_id << 16);
+		surface.depth = rng.random(-1.0f, 500.0f);
+	}
+
+	LocalVector<Surface *> elements;
+	for (Surface &surface : surfaces) {
+		elements.push_back(&surface);
+	}
+	// Shuffle, so the pointed objects are not visited in memory order.
+	for (uint32_t i = surface_count - 1; i > 0; i--) {
+		SWAP(elements[i], elements[rng.rand() % (i + 1)]);
+	}
+	const LocalVector<Surface *> shuffled = elements;
+
+	RadixSort<Surface *, 2> radix_sort;
+	auto get_key = [](const Surface *p_surface, uint64_t *r_key) {
+		r_key[0] = p_surface->sort_key1;
+		r_key[1] = p_surface->sort_key2;
+	};
+	auto get_depth_key = [](const Surface *p_surface, uint64_t *r_key) {
+		r_key[0] = RadixSort<Surface *, 2>::float_to_key(p_surface->depth);
+		r_key[1] = 0;
+	};
+
+	auto time_sort = [&](bool p_radix, bool p_by_depth, bool p_presorted) {
+		uint64_t total = 0;
+		for (int i = 0; i < frames; i++) {
+			if (!p_presorted || i == 0) {
+				elements = shuffled;
+			}
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			if (p_radix) {
+				if (p_by_depth) {
+					radix_sort.sort(elements.ptr(), elements.size(), get_depth_key);
+				} else {
+					radix_sort.sort(elements.ptr(), elements.size(), get_key);
+				}
+			} else {
+				if (p_by_depth) {
+					SortArray<Surface *, SortSurfaceByDepth> sorter;
+					sorter.sort(elements.ptr(), elements.size());
+				} else {
+					SortArray<Surface *, SortSurfaceByKey> sorter;
+					sorter.sort(elements.ptr(), elements.size());
+				}
+			}
+			total += OS::get_singleton()->get_ticks_usec() - begin;
+		}
+		return total / frames;
+	};
+
+	uint64_t intro_key = time_sort(false, false, false);
+	uint64_t radix_key = time_sort(true, false, false);
+	SortSurfaceByKey by_key;
+	bool sorted = true;
+	for (uint32_t i = 1; i < surface_count; i++) {
+		if (by_key(elements[i], elements[i - 1])) {
+			sorted = false;
+		}
+	}
+	CHECK_MESSAGE(sorted, "Radix sort should sort the render list by key.");
+
+	uint64_t intro_key_presorted = time_sort(false, false, true);
+	uint64_t radix_key_presorted = time_sort(true, false, true);
+	uint64_t intro_depth = time_sort(false, true, false);
+	uint64_t radix_depth = time_sort(true, true, false);
+
+	MESSAGE("Sort ", surface_count, " surfaces by key: SortArray ", intro_key, " usec, RadixSort ", radix_key, " usec.");
+	MESSAGE("Sort ", surface_count, " surfaces by key, sorted the previous frame: SortArray ", intro_key_presorted, " usec, RadixSort ", radix_key_presorted, " usec.");
+	MESSAGE("Sort ", surface_count, " surfaces by depth: SortArray ", intro_depth, " usec, RadixSort ", radix_depth, " usec.");
+}
+
+} // namespace TestRadixSort
+
+#endif // TEST_RADIX_SORT_H
@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  test_static_mesh_batch_3d.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STATIC_MESH_BATCH_3D_H
+#define TEST_STATIC_MESH_BATCH_3D_H
+
+#include "scene/3d/lightmap_gi.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/3d/static_mesh_batch_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/3d/primitive_meshes.h"
+#include "scene/resources/material.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStaticMeshBatch3D {
+
+static MeshInstance3D *add_mesh_instance(Node *p_parent, const Ref<Mesh> &p_mesh, const Ref<Material> &p_material, const Transform3D &p_transform) {
+	MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
+	mesh_instance->set_mesh(p_mesh);
+	mesh_instance->set_material_override(p_material);
+	mesh_instance->set_transform(p_transform);
+	p_parent->add_child(mesh_instance);
+	return mesh_instance;
+}
+
+// Returns how many triangles are wound so that their face normal points along their vertex normals.
+static int count_front_facing_triangles(const Ref<ArrayMesh> &p_mesh, int p_surface) {
+	Array arrays = p_mesh->surface_get_arrays(p_surface);
+	PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+	PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+	PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+	int count = 0;
+	for (int i = 0; i < indices.size(); i += 3) {
+		Vector3 face_normal = (vertices[indices[i + 1]] - vertices[indices[i]]).cross(vertices[indices[i + 2]] - vertices[indices[i]]);
+		if (face_normal.dot(normals[indices[i]]) > 0.0) {
+			count++;
+		}
+	}
+	return count;
+}
+
+TEST_CASE("[SceneTree][StaticMeshBatch3D] Merge static meshes per chunk and material") {
+	StaticMeshBatch3D *batch = memnew(StaticMeshBatch3D);
+	batch->set_batch_on_ready(false);
+	batch->set_chunk_size(10.0);
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	Ref<BoxMesh> box_mesh = memnew(BoxMesh);
+	Ref<StandardMaterial3D> material_a = memnew(StandardMaterial3D);
+	Ref<StandardMaterial3D> material_b = memnew(StandardMaterial3D);
+	const int box_vertex_count = box_mesh->surface_get_array_len(0);
+
+	// Two chunks, the first one using both materials. The nested instance is batched too.
+	add_mesh_instance(batch, box_mesh, material_a, Transform3D(Basis(), Vector3(1, 0, 1)));
+	MeshInstance3D *parent_instance = add_mesh_instance(batch, box_mesh, material_a, Transform3D(Basis(), Vector3(3, 0, 1)));
+	add_mesh_instance(parent_instance, box_mesh, material_b, Transform3D(Basis(), Vector3(2, 0, 0)));
+	add_mesh_instance(batch, box_mesh, material_a, Transform3D(Basis(), Vector3(15, 0, 1)));
+
+	// Hidden instances are left alone.
+	MeshInstance3D *hidden_instance = add_mesh_instance(batch, box_mesh, material_a, Transform3D(Basis(), Vector3(2, 0, 2)));
+	hidden_instance->hide();
+
+	batch->batch();
+
+	CHECK_EQ(batch->get_batched_source_count(), 4);
+	REQUIRE_EQ(batch->get_batch_count(), 2);
+
+	Ref<ArrayMesh> near_mesh = batch->get_batch_mesh(0);
+	Ref<ArrayMesh> far_mesh = batch->get_batch_mesh(1);
+	if (near_mesh->get_aabb().position.x > far_mesh->get_aabb().position.x) {
+		SWAP(near_mesh, far_mesh);
+	}
+
+	REQUIRE_EQ(near_mesh->get_surface_count(), 2);
+	REQUIRE_EQ(far_mesh->get_surface_count(), 1);
+	CHECK_EQ(near_mesh->surface_get_material(0), material_a);
+	CHECK_EQ(near_mesh->surface_get_material(1), material_b);
+	CHECK_EQ(near_mesh->surface_get_array_len(0), box_vertex_count * 2);
+	CHECK_EQ(near_mesh->surface_get_array_len(1), box_vertex_count);
+	CHECK_EQ(far_mesh->surface_get_array_len(0), box_vertex_count);
+
+	// Vertices are in the space of the batch.
+	CHECK(near_mesh->get_aabb().is_equal_approx(AABB(Vector3(0.5, -0.5, 0.5), Vector3(5, 1, 1))));
+	CHECK(far_mesh->get_aabb().is_equal_approx(AABB(Vector3(14.5, -0.5, 0.5), Vector3(1, 1, 1))));
+
+	batch->clear();
+	CHECK_EQ(batch->get_batch_count(), 0);
+	CHECK_EQ(batch->get_batched_source_count(), 0);
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][StaticMeshBatch3D] Mirrored instances stay front facing") {
+	StaticMeshBatch3D *batch = memnew(StaticMeshBatch3D);
+	batch->set_batch_on_ready(false);
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	Ref<BoxMesh> box_mesh = memnew(BoxMesh);
+	Ref<StandardMaterial3D> material = memnew(StandardMaterial3D);
+	MeshInstance3D *mesh_instance = add_mesh_instance(batch, box_mesh, material, Transform3D());
+
+	batch->batch();
+	REQUIRE_EQ(batch->get_batch_count(), 1);
+	const int front_facing = count_front_facing_triangles(batch->get_batch_mesh(0), 0);
+
+	mesh_instance->set_transform(Transform3D(Basis().scaled(Vector3(-1, 1, 1)), Vector3()));
+	batch->batch();
+	REQUIRE_EQ(batch->get_batch_count(), 1);
+	CHECK_EQ(count_front_facing_triangles(batch->get_batch_mesh(0), 0), front_facing);
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][StaticMeshBatch3D] Batched instances stay hidden") {
+	StaticMeshBatch3D *batch = memnew(StaticMeshBatch3D);
+	batch->set_batch_on_ready(false);
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	Node3D *group = memnew(Node3D);
+	batch->add_child(group);
+	Ref<BoxMesh> box_mesh = memnew(BoxMesh);
+	MeshInstance3D *mesh_instance = add_mesh_instance(group, box_mesh, Ref<Material>(), Transform3D());
+	mesh_instance->set_custom_aabb(AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+
+	// Hidden instances are taken out of the scenario, so culling only finds the drawn ones.
+	const RID scenario = batch->get_world_3d()->get_scenario();
+	const AABB cull_aabb(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+	REQUIRE(RS::get_singleton()->instances_cull_aabb(cull_aabb, scenario).has(mesh_instance->get_instance_id()));
+
+	batch->batch();
+	REQUIRE_EQ(batch->get_batched_source_count(), 1);
+	CHECK_FALSE(RS::get_singleton()->instances_cull_aabb(cull_aabb, scenario).has(mesh_instance->get_instance_id()));
+
+	SUBCASE("Showing the batch again should not draw the sources") {
+		batch->hide();
+		batch->show();
+	}
+
+	SUBCASE("Showing a parent of the source again should not draw it") {
+		group->hide();
+		group->show();
+	}
+
+	SUBCASE("Showing the source again should not draw it") {
+		mesh_instance->hide();
+		mesh_instance->show();
+	}
+
+	SUBCASE("Entering the world again should not draw the sources") {
+		batch->remove_child(group);
+		batch->add_child(group);
+	}
+
+	CHECK_FALSE(RS::get_singleton()->instances_cull_aabb(cull_aabb, scenario).has(mesh_instance->get_instance_id()));
+
+	batch->clear();
+	CHECK(RS::get_singleton()->instances_cull_aabb(cull_aabb, scenario).has(mesh_instance->get_instance_id()));
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][StaticMeshBatch3D] Instances with per-instance settings are left alone") {
+	StaticMeshBatch3D *batch = memnew(StaticMeshBatch3D);
+	batch->set_batch_on_ready(false);
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	Ref<BoxMesh> box_mesh = memnew(BoxMesh);
+	add_mesh_instance(batch, box_mesh, Ref<Material>(), Transform3D());
+	MeshInstance3D *mesh_instance = add_mesh_instance(batch, box_mesh, Ref<Material>(), Transform3D(Basis(), Vector3(2, 0, 0)));
+
+	SUBCASE("Material overlay") {
+		mesh_instance->set_material_overlay(memnew(StandardMaterial3D));
+	}
+
+	SUBCASE("Instance shader parameter") {
+		mesh_instance->set_instance_shader_parameter("tint", Color(1, 0, 0));
+	}
+
+	SUBCASE("LOD bias") {
+		mesh_instance->set_lod_bias(2.0);
+	}
+
+	SUBCASE("Extra cull margin") {
+		mesh_instance->set_extra_cull_margin(1.0);
+	}
+
+	SUBCASE("Ignore occlusion culling") {
+		mesh_instance->set_ignore_occlusion_culling(true);
+	}
+
+	SUBCASE("Baked lightmap") {
+		LightmapGI *lightmap_gi = memnew(LightmapGI);
+		batch->add_child(lightmap_gi);
+		Ref<LightmapGIData> light_data;
+		light_data.instantiate();
+		light_data->add_user(lightmap_gi->get_path_to(mesh_instance), Rect2(0, 0, 1, 1), 0);
+		lightmap_gi->set_light_data(light_data);
+	}
+
+	batch->batch();
+	CHECK_EQ(batch->get_batched_source_count(), 1);
+	CHECK_EQ(batch->get_batch_count(), 1);
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][StaticMeshBatch3D] Instances are only merged with instances sharing their GI mode") {
+	StaticMeshBatch3D *batch = memnew(StaticMeshBatch3D);
+	batch->set_batch_on_ready(false);
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	Ref<BoxMesh> box_mesh = memnew(BoxMesh);
+	add_mesh_instance(batch, box_mesh, Ref<Material>(), Transform3D());
+	MeshInstance3D *mesh_instance = add_mesh_instance(batch, box_mesh, Ref<Material>(), Transform3D(Basis(), Vector3(2, 0, 0)));
+	mesh_instance->set_gi_mode(GeometryInstance3D::GI_MODE_DYNAMIC);
+
+	batch->batch();
+	CHECK_EQ(batch->get_batched_source_count(), 2);
+	CHECK_EQ(batch->get_batch_count(), 2);
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][StaticMeshBatch3D] Batch when ready") {
+	StaticMeshBatch3D *batch = memnew(StaticMeshBatch3D);
+	Ref<BoxMesh> box_mesh = memnew(BoxMesh);
+	for (int i = 0; i < 8; i++) {
+		add_mesh_instance(batch, box_mesh, Ref<Material>(), Transform3D(Basis(), Vector3(i * 2, 0, 0)));
+	}
+	CHECK_EQ(batch->get_batch_count(), 0);
+
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+	CHECK_EQ(batch->get_batch_count(), 1);
+	CHECK_EQ(batch->get_batched_source_count(), 8);
+
+	memdelete(batch);
+}
+
+} // namespace TestStaticMeshBatch3D
+
+#endif // TEST_STATIC_MESH_BATCH_3D_H
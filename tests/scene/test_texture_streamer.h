@@ -0,0 +1,174 @@
+/**************************************************************************/
+/*  test_texture_streamer.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_TEXTURE_STREAMER_H
+#define TEST_TEXTURE_STREAMER_H
+
+#include "core/io/image.h"
+#include "scene/resources/compressed_texture.h"
+#include "scene/resources/texture_streamer.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestTextureStreamer {
+
+// Writes an uncompressed, mipmapped texture like the importer does with `mipmaps/stream` enabled.
+static String save_streamed_texture(const String &p_file_name, int p_size) {
+	Ref<Image> image = Image::create_empty(p_size, p_size, false, Image::FORMAT_RGBA8);
+	image->fill(Color(0.5, 0.25, 1.0));
+	image->generate_mipmaps();
+
+	const String path = TestUtils::get_temp_path(p_file_name);
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+	f->store_8('G');
+	f->store_8('S');
+	f->store_8('T');
+	f->store_8('2');
+	f->store_32(CompressedTexture2D::FORMAT_VERSION);
+	f->store_32(image->get_width());
+	f->store_32(image->get_height());
+	f->store_32(CompressedTexture2D::FORMAT_BIT_STREAM | CompressedTexture2D::FORMAT_BIT_HAS_MIPMAPS);
+	f->store_32(-1); // Mipmap limit.
+	f->store_32(0);
+	f->store_32(0);
+	f->store_32(0);
+
+	f->store_32(CompressedTexture2D::DATA_FORMAT_IMAGE);
+	f->store_16(image->get_width());
+	f->store_16(image->get_height());
+	f->store_32(image->get_mipmap_count());
+	f->store_32(image->get_format());
+	f->store_buffer(image->get_data());
+
+	return path;
+}
+
+static int get_resident_width(const Ref<CompressedTexture2D> &p_texture) {
+	return RS::get_singleton()->texture_2d_get(p_texture->get_rid())->get_width();
+}
+
+static void request(const Ref<CompressedTexture2D> &p_texture, float p_screen_size) {
+	TypedArray<RID> textures;
+	textures.push_back(p_texture->get_rid());
+	PackedFloat32Array screen_sizes;
+	screen_sizes.push_back(p_screen_size);
+	RS::get_singleton()->emit_signal(SNAME("texture_streaming_requested"), textures, screen_sizes);
+}
+
+// Draws frames until all the loads started are applied.
+static void draw_frames(int p_count = 1) {
+	for (int i = 0; i < p_count; i++) {
+		RS::get_singleton()->emit_signal(SNAME("frame_post_draw"));
+	}
+	while (TextureStreamer::get_singleton()->get_pending_load_count() > 0) {
+		OS::get_singleton()->delay_usec(1000);
+		RS::get_singleton()->emit_signal(SNAME("frame_post_draw"));
+	}
+}
+
+static int64_t get_mipmap_bytes(int p_size) {
+	return Image::get_image_data_size(p_size, p_size, Image::FORMAT_RGBA8, true);
+}
+
+TEST_CASE("[SceneTree][TextureStreamer] Only the smallest mipmaps are loaded up front") {
+	TextureStreamer *streamer = TextureStreamer::get_singleton();
+	const int minimum_size = streamer->get_minimum_size();
+
+	Ref<CompressedTexture2D> texture;
+	texture.instantiate();
+	REQUIRE(texture->load(save_streamed_texture("streamed_texture_load.ctex", minimum_size * 4)) == OK);
+
+	CHECK(texture->get_width() == minimum_size * 4);
+	CHECK(texture->get_height() == minimum_size * 4);
+	CHECK(get_resident_width(texture) == minimum_size);
+	CHECK(streamer->get_texture_count() == 1);
+
+	draw_frames();
+	CHECK(streamer->get_memory_used() == get_mipmap_bytes(minimum_size));
+	CHECK(streamer->get_memory_requested() == get_mipmap_bytes(minimum_size));
+
+	texture.unref();
+	CHECK(streamer->get_texture_count() == 0);
+}
+
+TEST_CASE("[SceneTree][TextureStreamer] Mipmaps follow the requested screen size") {
+	TextureStreamer *streamer = TextureStreamer::get_singleton();
+	const int minimum_size = streamer->get_minimum_size();
+
+	Ref<CompressedTexture2D> texture;
+	texture.instantiate();
+	REQUIRE(texture->load(save_streamed_texture("streamed_texture_request.ctex", minimum_size * 4)) == OK);
+
+	request(texture, minimum_size * 2);
+	draw_frames();
+	CHECK(get_resident_width(texture) == minimum_size * 2);
+	CHECK(streamer->get_memory_used() == get_mipmap_bytes(minimum_size * 2));
+
+	request(texture, minimum_size * 8);
+	draw_frames();
+	CHECK(get_resident_width(texture) == minimum_size * 4);
+	CHECK(texture->get_width() == minimum_size * 4);
+
+	// Textures which are no longer seen fall back to their smallest mipmaps.
+	draw_frames(200);
+	CHECK(get_resident_width(texture) == minimum_size);
+	CHECK(streamer->get_memory_used() == get_mipmap_bytes(minimum_size));
+}
+
+TEST_CASE("[SceneTree][TextureStreamer] The memory budget is spent on the largest textures on screen") {
+	TextureStreamer *streamer = TextureStreamer::get_singleton();
+	const int minimum_size = streamer->get_minimum_size();
+	const int64_t memory_budget = streamer->get_memory_budget();
+
+	Ref<CompressedTexture2D> near_texture;
+	near_texture.instantiate();
+	REQUIRE(near_texture->load(save_streamed_texture("streamed_texture_near.ctex", minimum_size * 4)) == OK);
+	Ref<CompressedTexture2D> far_texture;
+	far_texture.instantiate();
+	REQUIRE(far_texture->load(save_streamed_texture("streamed_texture_far.ctex", minimum_size * 4)) == OK);
+
+	streamer->set_memory_budget(get_mipmap_bytes(minimum_size * 4) + get_mipmap_bytes(minimum_size * 2));
+
+	request(near_texture, minimum_size * 6);
+	request(far_texture, minimum_size * 5);
+	draw_frames();
+
+	CHECK(get_resident_width(near_texture) == minimum_size * 4);
+	CHECK(get_resident_width(far_texture) == minimum_size * 2);
+	CHECK(streamer->get_memory_used() == get_mipmap_bytes(minimum_size * 4) + get_mipmap_bytes(minimum_size * 2));
+	CHECK(streamer->get_memory_requested() == 2 * get_mipmap_bytes(minimum_size * 4));
+
+	streamer->set_memory_budget(memory_budget);
+}
+
+} // namespace TestTextureStreamer
+
+#endif // TEST_TEXTURE_STREAMER_H
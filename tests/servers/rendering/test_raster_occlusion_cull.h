@@ -0,0 +1,324 @@
+/**************************************************************************/
+/*  test_raster_occlusion_cull.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RASTER_OCCLUSION_CULL_H
+#define TEST_RASTER_OCCLUSION_CULL_H
+
+#include "core/io/json.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "servers/rendering/raster_occlusion_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRasterOcclusionCull {
+
+// A single scenario seen by a single occlusion buffer.
+class OcclusionScene {
+	RasterOcclusionCull cull;
+	RID scenario = RID::from_uint64(1);
+	RID buffer = RID::from_uint64(2);
+	uint64_t last_instance_id = 100;
+	LocalVector<RID> occluders;
+
+	Transform3D cam_transform;
+	Projection cam_projection;
+
+public:
+	static void make_box(const AABB &p_box, PackedVector3Array &r_vertices, PackedInt32Array &r_indices) {
+		for (int i = 0; i < 8; i++) {
+			r_vertices.push_back(p_box.get_endpoint(i));
+		}
+		// Endpoint bits are X (4), Y (2) and Z (1).
+		const int faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+		for (int i = 0; i < 6; i++) {
+			const int quad[6] = { faces[i][0], faces[i][1], faces[i][2], faces[i][0], faces[i][2], faces[i][3] };
+			for (int j = 0; j < 6; j++) {
+				r_indices.push_back(quad[j]);
+			}
+		}
+	}
+
+	RID add_occluder(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, const Transform3D &p_xform = Transform3D()) {
+		RID occluder = cull.occluder_allocate();
+		cull.occluder_initialize(occluder);
+		cull.occluder_set_mesh(occluder, p_vertices, p_indices);
+		occluders.push_back(occluder);
+		set_instance(RID::from_uint64(++last_instance_id), occluder, p_xform);
+		return occluder;
+	}
+
+	// Returns the instance of the occluder, so it can be changed afterwards.
+	RID add_quad(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c, const Vector3 &p_d) {
+		PackedVector3Array vertices = { p_a, p_b, p_c, p_d };
+		PackedInt32Array indices = { 0, 1, 2, 0, 2, 3 };
+		add_occluder(vertices, indices);
+		return get_last_instance();
+	}
+
+	RID get_last_instance() const { return RID::from_uint64(last_instance_id); }
+
+	void set_occluder_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+		cull.occluder_set_mesh(p_occluder, p_vertices, p_indices);
+	}
+
+	void set_instance(RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled = true) {
+		cull.scenario_set_instance(scenario, p_instance, p_occluder, p_xform, p_enabled);
+	}
+
+	void set_camera(const Transform3D &p_transform, const Projection &p_projection) {
+		cam_transform = p_transform;
+		cam_projection = p_projection;
+		cull.buffer_update(buffer, cam_transform, cam_projection, cam_projection.is_orthogonal());
+	}
+
+	bool is_occluded(const AABB &p_aabb) const {
+		const real_t bounds[6] = { p_aabb.position.x, p_aabb.position.y, p_aabb.position.z, p_aabb.get_end().x, p_aabb.get_end().y, p_aabb.get_end().z };
+		uint64_t occlusion_timeout = 0;
+		const RendererSceneOcclusionCull::HZBuffer *hz_buffer = const_cast<RasterOcclusionCull &>(cull).buffer_get_ptr(buffer);
+		return hz_buffer->is_occluded(bounds, cam_transform.origin, cam_transform.affine_inverse(), cam_projection, cam_projection.get_z_near(), occlusion_timeout);
+	}
+
+	explicit OcclusionScene(const Size2i &p_buffer_size) {
+		cull.add_scenario(scenario);
+		cull.add_buffer(buffer);
+		cull.buffer_set_scenario(buffer, scenario);
+		cull.buffer_set_size(buffer, p_buffer_size);
+	}
+
+	~OcclusionScene() {
+		cull.remove_buffer(buffer);
+		cull.remove_scenario(scenario);
+		for (const RID &occluder : occluders) {
+			cull.free_occluder(occluder);
+		}
+	}
+};
+
+static Projection make_perspective() {
+	Projection projection;
+	projection.set_perspective(70.0, 16.0 / 9.0, 0.05, 100.0);
+	return projection;
+}
+
+static AABB make_cube(const Vector3 &p_center, real_t p_size = 1.0) {
+	return AABB(p_center - Vector3(p_size, p_size, p_size) * 0.5, Vector3(p_size, p_size, p_size));
+}
+
+TEST_CASE("[RasterOcclusionCull] Occluders hide the instances behind them") {
+	OcclusionScene scene(Size2i(128, 72));
+	// A wall facing the camera, 10 units away.
+	RID wall = scene.add_quad(Vector3(-10, -10, -10), Vector3(10, -10, -10), Vector3(10, 10, -10), Vector3(-10, 10, -10));
+
+	SUBCASE("Perspective camera") {
+		scene.set_camera(Transform3D(), make_perspective());
+		CHECK(scene.is_occluded(make_cube(Vector3(0, 0, -20))));
+		CHECK(scene.is_occluded(make_cube(Vector3(15, 5, -30))));
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(0, 0, -5))));
+		CHECK_FALSE_MESSAGE(scene.is_occluded(make_cube(Vector3(22, 0, -20))), "Instances beside the wall should be visible.");
+		CHECK_FALSE_MESSAGE(scene.is_occluded(AABB(Vector3(-1, -1, -12), Vector3(2, 2, 4))), "Instances crossing the wall should be visible.");
+	}
+
+	SUBCASE("Orthogonal camera") {
+		Projection projection;
+		projection.set_orthogonal(30.0, 16.0 / 9.0, 0.05, 100.0);
+		scene.set_camera(Transform3D(), projection);
+		CHECK(scene.is_occluded(make_cube(Vector3(5, 5, -20))));
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(12, 0, -20))));
+	}
+
+	SUBCASE("Occluders should be double sided") {
+		scene.set_camera(Transform3D(Basis(Vector3(0, 1, 0), Math_PI), Vector3(0, 0, -30)), make_perspective());
+		CHECK(scene.is_occluded(make_cube(Vector3(0, 0, 0))));
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(0, 0, -20))));
+	}
+
+	SUBCASE("Disabled occluders should be ignored") {
+		scene.set_instance(wall, RID(), Transform3D(), false);
+		scene.set_camera(Transform3D(), make_perspective());
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(0, 0, -20))));
+	}
+
+	SUBCASE("Occluder instances should follow their transform and mesh") {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		OcclusionScene::make_box(AABB(Vector3(-2, -2, -0.5), Vector3(4, 4, 1)), vertices, indices);
+		RID box = scene.add_occluder(vertices, indices, Transform3D(Basis(), Vector3(0, 0, -5)));
+		RID box_instance = scene.get_last_instance();
+		scene.set_instance(wall, RID(), Transform3D(), false);
+		scene.set_camera(Transform3D(), make_perspective());
+		CHECK(scene.is_occluded(make_cube(Vector3(0, 0, -20))));
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(10, 0, -20))));
+
+		scene.set_instance(box_instance, box, Transform3D(Basis(), Vector3(5, 0, -5)));
+		scene.set_camera(Transform3D(), make_perspective());
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(0, 0, -20))));
+		CHECK(scene.is_occluded(make_cube(Vector3(10, 0, -10))));
+
+		vertices.clear();
+		indices.clear();
+		OcclusionScene::make_box(AABB(Vector3(-0.1, -0.1, -0.1), Vector3(0.2, 0.2, 0.2)), vertices, indices);
+		scene.set_occluder_mesh(box, vertices, indices);
+		scene.set_camera(Transform3D(), make_perspective());
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(10, 0, -10))));
+	}
+
+	SUBCASE("Occluders crossing the near plane should be clipped") {
+		scene.set_instance(wall, RID(), Transform3D(), false);
+		// A floor going from behind the camera to far in front of it.
+		scene.add_quad(Vector3(-100, -1, 50), Vector3(100, -1, 50), Vector3(100, -1, -100), Vector3(-100, -1, -100));
+		scene.set_camera(Transform3D(), make_perspective());
+		CHECK(scene.is_occluded(make_cube(Vector3(0, -5, -20))));
+		CHECK_FALSE(scene.is_occluded(make_cube(Vector3(0, 1, -20))));
+	}
+}
+
+// Casts rays to a few points of each box, a box is visible when any of them isn't blocked by an occluder.
+static bool is_any_point_visible(const Vector3 &p_from, const AABB &p_box, const PackedVector3Array &p_triangles) {
+	const AABB inner = p_box.grow(-p_box.get_shortest_axis_size() * 0.05);
+	Vector3 points[9];
+	for (int i = 0; i < 8; i++) {
+		points[i] = inner.get_endpoint(i);
+	}
+	points[8] = p_box.get_center();
+
+	for (const Vector3 &point : points) {
+		const Vector3 dir = point - p_from;
+		bool blocked = false;
+		for (int i = 0; i < p_triangles.size() && !blocked; i += 3) {
+			Vector3 intersection;
+			blocked = Geometry3D::ray_intersects_triangle(p_from, dir, p_triangles[i], p_triangles[i + 1], p_triangles[i + 2], &intersection) && p_from.distance_squared_to(intersection) < dir.length_squared();
+		}
+		if (!blocked) {
+			return true;
+		}
+	}
+	return false;
+}
+
+TEST_CASE_BENCHMARK("[RasterOcclusionCull] Culling efficiency and timing in a city") {
+	const int block_count = 16;
+	const real_t block_pitch = 12.0;
+	const int object_count = 4096;
+	const int frame_count = 32;
+	const Size2i buffer_size(128, 72);
+
+	OcclusionScene scene(buffer_size);
+	RandomPCG rng(44);
+
+	// Buildings on a grid, with 4 unit wide streets between them.
+	PackedVector3Array triangles;
+	for (int z = 0; z < block_count; z++) {
+		for (int x = 0; x < block_count; x++) {
+			const real_t height = rng.random(10.0, 30.0);
+			PackedVector3Array vertices;
+			PackedInt32Array indices;
+			OcclusionScene::make_box(AABB(Vector3(-4, 0, -4), Vector3(8, height, 8)), vertices, indices);
+			const Transform3D xform(Basis(), Vector3(x * block_pitch, 0, z * block_pitch));
+			scene.add_occluder(vertices, indices, xform);
+			for (int index : indices) {
+				triangles.push_back(xform.xform(vertices[index]));
+			}
+		}
+	}
+
+	// Small objects spread over the streets and on the roofs.
+	LocalVector<AABB> objects;
+	const real_t city_size = block_count * block_pitch;
+	while ((int)objects.size() < object_count) {
+		const Vector3 position(rng.random(-6.0, city_size - 6.0), rng.random(0.0, 2.0), rng.random(-6.0, city_size - 6.0));
+		objects.push_back(make_cube(position + Vector3(0, 0.5, 0)));
+	}
+
+	uint64_t update_usec = 0;
+	uint64_t test_usec = 0;
+	int frustum_count = 0;
+	int culled_count = 0;
+	int hidden_count = 0;
+	int false_culled_count = 0;
+
+	const Projection projection = make_perspective();
+	for (int frame = 0; frame < frame_count; frame++) {
+		// Walk along a street while looking around.
+		const Vector3 eye(block_pitch * 0.5 + frame * 3.0, 1.7, block_pitch * 0.5);
+		const Transform3D cam_transform = Transform3D(Basis(Vector3(0, 1, 0), -Math_PI * 0.25 - frame * 0.1), eye);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		scene.set_camera(cam_transform, projection);
+		update_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		const Vector<Plane> planes = projection.get_projection_planes(cam_transform);
+		LocalVector<AABB> in_frustum;
+		for (const AABB &object : objects) {
+			Vector3 points[8];
+			for (int i = 0; i < 8; i++) {
+				points[i] = object.get_endpoint(i);
+			}
+			if (object.intersects_convex_shape(planes.ptr(), planes.size(), points, 8)) {
+				in_frustum.push_back(object);
+			}
+		}
+		frustum_count += in_frustum.size();
+
+		LocalVector<bool> occluded;
+		occluded.resize(in_frustum.size());
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < in_frustum.size(); i++) {
+			occluded[i] = scene.is_occluded(in_frustum[i]);
+		}
+		test_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		for (uint32_t i = 0; i < in_frustum.size(); i++) {
+			const bool visible = is_any_point_visible(eye, in_frustum[i], triangles);
+			hidden_count += visible ? 0 : 1;
+			culled_count += occluded[i] ? 1 : 0;
+			false_culled_count += (occluded[i] && visible) ? 1 : 0;
+		}
+	}
+
+	// Efficiency is the part of the hidden instances that were culled.
+	Dictionary results;
+	results["buffer_size"] = buffer_size;
+	results["occluder_triangles"] = triangles.size() / 3;
+	results["update_usec_per_frame"] = double(update_usec) / frame_count;
+	results["test_nsec_per_instance"] = double(test_usec) * 1000.0 / MAX(frustum_count, 1);
+	results["instances_in_frustum"] = frustum_count;
+	results["instances_hidden"] = hidden_count;
+	results["instances_culled"] = culled_count;
+	results["instances_culled_while_visible"] = false_culled_count;
+	results["culling_efficiency"] = double(culled_count - false_culled_count) / MAX(hidden_count, 1);
+	print_line(JSON::stringify(results));
+
+	CHECK(culled_count > 0);
+}
+
+} // namespace TestRasterOcclusionCull
+
+#endif // TEST_RASTER_OCCLUSION_CULL_H
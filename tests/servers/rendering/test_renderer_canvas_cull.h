@@ -0,0 +1,210 @@
+/**************************************************************************/
+/*  test_renderer_canvas_cull.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_CANVAS_CULL_H
+#define TEST_RENDERER_CANVAS_CULL_H
+
+#include "core/math/random_pcg.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+class TestRendererCanvasCullInternalsAccessor {
+public:
+	// Culls a canvas like render_canvas() does, and returns the items to draw in draw order.
+	static Vector<RendererCanvasRender::Item *> cull(RID p_canvas, const Rect2 &p_clip_rect, bool p_threaded, bool p_use_subtree_rects) {
+		RendererCanvasCull *canvas_cull = RSG::canvas;
+		RendererCanvasCull::Canvas *canvas = canvas_cull->canvas_owner.get_or_null(p_canvas);
+		if (canvas->children_order_dirty) {
+			canvas->child_items.sort();
+			canvas->children_order_dirty = false;
+		}
+
+		canvas_cull->snapping_2d_transforms_to_pixel = false;
+		canvas_cull->use_subtree_rects = p_use_subtree_rects;
+		memset(canvas_cull->z_list, 0, RendererCanvasCull::z_range * sizeof(RendererCanvasRender::Item *));
+		memset(canvas_cull->z_last_list, 0, RendererCanvasCull::z_range * sizeof(RendererCanvasRender::Item *));
+
+		if (p_threaded) {
+			canvas_cull->_cull_canvas_item_tree_threaded(canvas->child_items.ptrw(), canvas->child_items.size(), Transform2D(), p_clip_rect, 0xFFFFFFFF);
+		} else {
+			for (int i = 0; i < canvas->child_items.size(); i++) {
+				canvas_cull->_cull_canvas_item(canvas->child_items[i].item, Transform2D(), p_clip_rect, Color(1, 1, 1, 1), 0, canvas_cull->z_list, canvas_cull->z_last_list, nullptr, nullptr, true, 0xFFFFFFFF, Point2(), 1, nullptr);
+			}
+		}
+
+		Vector<RendererCanvasRender::Item *> items;
+		for (int i = 0; i < RendererCanvasCull::z_range; i++) {
+			for (RendererCanvasRender::Item *item = canvas_cull->z_list[i]; item; item = item->next) {
+				items.push_back(item);
+				if (item == canvas_cull->z_last_list[i]) {
+					break;
+				}
+			}
+		}
+		return items;
+	}
+
+	static RendererCanvasRender::Item *get_item(RID p_item) {
+		return RSG::canvas->canvas_item_owner.get_or_null(p_item);
+	}
+
+	static Rect2 get_subtree_rect(RID p_item) {
+		return RSG::canvas->canvas_item_owner.get_or_null(p_item)->subtree_rect;
+	}
+
+	// Y sorted items count their children the first time they are culled.
+	static bool was_y_sort_culled(RID p_item) {
+		return RSG::canvas->canvas_item_owner.get_or_null(p_item)->ysort_children_count != -1;
+	}
+};
+
+namespace TestRendererCanvasCull {
+
+// Builds a random canvas item tree, using the options which change how items are culled and ordered.
+static void add_random_items(RID p_parent, RandomPCG &p_rng, int p_depth, LocalVector<RID> &r_items) {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const int count = p_depth == 0 ? 6 : (p_depth < 4 ? p_rng.random(1, 8) : 0);
+	for (int i = 0; i < count; i++) {
+		RID item = rs->canvas_item_create();
+		r_items.push_back(item);
+		rs->canvas_item_set_parent(item, p_parent);
+
+		const real_t spread = p_depth == 0 ? 600.0 : 100.0;
+		const Vector2 offset = p_depth == 0 ? Vector2(500, 300) : Vector2();
+		rs->canvas_item_set_transform(item, Transform2D(p_rng.randf() * 3.0, offset + Vector2(p_rng.random(-spread, spread), p_rng.random(-spread, spread))));
+		rs->canvas_item_add_rect(item, Rect2(-10, -10, 20 + p_rng.randf() * 30, 20), Color(1, 1, 1));
+
+		switch (p_rng.rand() % 40) {
+			case 0: {
+				rs->canvas_item_set_z_index(item, p_rng.random(-3, 3));
+			} break;
+			case 1: {
+				rs->canvas_item_set_draw_behind_parent(item, true);
+			} break;
+			case 2: {
+				rs->canvas_item_set_sort_children_by_y(item, true);
+			} break;
+			case 3: {
+				rs->canvas_item_set_visible(item, false);
+			} break;
+			case 4: {
+				rs->canvas_item_set_clip(item, true);
+			} break;
+			case 5: {
+				rs->canvas_item_set_canvas_group_mode(item, RS::CANVAS_GROUP_MODE_CLIP_AND_DRAW, 5.0, true, 5.0, false);
+			} break;
+			case 6: {
+				rs->canvas_item_set_z_as_relative_to_parent(item, false);
+				rs->canvas_item_set_z_index(item, 2);
+			} break;
+			case 7: {
+				rs->canvas_item_set_modulate(item, Color(1, 1, 1, 0));
+			} break;
+			case 8: {
+				rs->canvas_item_set_update_when_visible(item, true);
+			} break;
+		}
+
+		add_random_items(item, p_rng, p_depth + 1, r_items);
+	}
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Culling on threads and with subtree bounds keeps the draw order") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID canvas = rs->canvas_create();
+	RandomPCG rng(1234);
+	LocalVector<RID> items;
+	add_random_items(canvas, rng, 0, items);
+
+	const Rect2 clip_rects[] = { Rect2(0, 0, 1000, 600), Rect2(0, 0, 600, 400) };
+	for (const Rect2 &clip_rect : clip_rects) {
+		const Vector<RendererCanvasRender::Item *> expected = TestRendererCanvasCullInternalsAccessor::cull(canvas, clip_rect, false, false);
+		REQUIRE_FALSE(expected.is_empty());
+		CHECK(expected.size() < int(items.size()));
+
+		CHECK(TestRendererCanvasCullInternalsAccessor::cull(canvas, clip_rect, false, true) == expected);
+		CHECK(TestRendererCanvasCullInternalsAccessor::cull(canvas, clip_rect, true, false) == expected);
+		CHECK(TestRendererCanvasCullInternalsAccessor::cull(canvas, clip_rect, true, true) == expected);
+	}
+
+	for (const RID &item : items) {
+		rs->free(item);
+	}
+	rs->free(canvas);
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Subtrees out of the clip rect are skipped") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID canvas = rs->canvas_create();
+	const Rect2 clip_rect(0, 0, 1000, 600);
+
+	RID visible_item = rs->canvas_item_create();
+	rs->canvas_item_set_parent(visible_item, canvas);
+	rs->canvas_item_add_rect(visible_item, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+
+	// The root is off screen, and so are its descendants, sorted or not.
+	RID off_screen_item = rs->canvas_item_create();
+	rs->canvas_item_set_parent(off_screen_item, canvas);
+	rs->canvas_item_set_transform(off_screen_item, Transform2D(0.0, Vector2(2000, 0)));
+	rs->canvas_item_add_rect(off_screen_item, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+
+	RID y_sort_item = rs->canvas_item_create();
+	rs->canvas_item_set_parent(y_sort_item, off_screen_item);
+	rs->canvas_item_set_sort_children_by_y(y_sort_item, true);
+	rs->canvas_item_set_transform(y_sort_item, Transform2D(0.0, Vector2(20, 0)));
+
+	RID sorted_item = rs->canvas_item_create();
+	rs->canvas_item_set_parent(sorted_item, y_sort_item);
+	rs->canvas_item_set_transform(sorted_item, Transform2D(0.0, Vector2(0, 20)));
+	rs->canvas_item_add_rect(sorted_item, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+
+	Vector<RendererCanvasRender::Item *> expected;
+	expected.push_back(TestRendererCanvasCullInternalsAccessor::get_item(visible_item));
+
+	CHECK(TestRendererCanvasCullInternalsAccessor::cull(canvas, clip_rect, false, true) == expected);
+	CHECK(TestRendererCanvasCullInternalsAccessor::get_subtree_rect(off_screen_item).is_equal_approx(Rect2(0, 0, 30, 30)));
+	CHECK_FALSE(TestRendererCanvasCullInternalsAccessor::was_y_sort_culled(y_sort_item));
+
+	// Without subtree bounds, the same items are drawn, but the off-screen subtree is visited.
+	CHECK(TestRendererCanvasCullInternalsAccessor::cull(canvas, clip_rect, false, false) == expected);
+	CHECK(TestRendererCanvasCullInternalsAccessor::was_y_sort_culled(y_sort_item));
+
+	rs->free(sorted_item);
+	rs->free(y_sort_item);
+	rs->free(off_screen_item);
+	rs->free(visible_item);
+	rs->free(canvas);
+}
+
+} // namespace TestRendererCanvasCull
+
+#endif // TEST_RENDERER_CANVAS_CULL_H
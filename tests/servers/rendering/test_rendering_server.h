@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*  test_rendering_server.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERING_SERVER_H
+#define TEST_RENDERING_SERVER_H
+
+#include "core/io/json.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingServer {
+
+// A scenario with a row of unit-sized mesh instances, spaced along the X axis.
+class InstanceRow {
+	RenderingServer *rs = nullptr;
+	RID scenario;
+	RID mesh;
+	Vector<RID> instances;
+
+public:
+	static Transform3D get_row_transform(int p_index, real_t p_offset = 0.0) {
+		return Transform3D(Basis(), Vector3(p_index * 4.0, 0.0, p_offset));
+	}
+
+	static AABB get_row_aabb(int p_index, real_t p_offset = 0.0) {
+		return AABB(Vector3(p_index * 4.0 - 1.0, -1.0, p_offset - 1.0), Vector3(2.0, 2.0, 2.0));
+	}
+
+	RID get_scenario() const { return scenario; }
+	const Vector<RID> &get_instances() const { return instances; }
+
+	// Queries the indexer, which also flushes the dirty instances.
+	Vector<ObjectID> cull(const AABB &p_aabb) const {
+		return rs->instances_cull_aabb(p_aabb, scenario);
+	}
+
+	explicit InstanceRow(int p_count) {
+		rs = RenderingServer::get_singleton();
+		scenario = rs->scenario_create();
+		mesh = rs->mesh_create();
+		instances.resize(p_count);
+		for (int i = 0; i < p_count; i++) {
+			RID instance = rs->instance_create2(mesh, scenario);
+			rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1.0, 1.0, 1.0)));
+			rs->instance_attach_object_instance_id(instance, ObjectID(uint64_t(i + 1)));
+			rs->instance_set_transform(instance, get_row_transform(i));
+			instances.write[i] = instance;
+		}
+	}
+
+	~InstanceRow() {
+		for (const RID &instance : instances) {
+			rs->free(instance);
+		}
+		rs->free(mesh);
+		rs->free(scenario);
+	}
+};
+
+TEST_CASE("[SceneTree][RenderingServer] Set the transforms of many instances at once") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const int count = 64;
+	InstanceRow row(count);
+	REQUIRE_EQ(row.cull(InstanceRow::get_row_aabb(5)).size(), 1);
+
+	Vector<Transform3D> transforms;
+	transforms.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms.write[i] = InstanceRow::get_row_transform(i, 100.0);
+	}
+	rs->instances_set_transforms(row.get_instances(), transforms);
+
+	SUBCASE("Instances should be found at their new positions only") {
+		bool moved = true;
+		for (int i = 0; i < count && moved; i++) {
+			const Vector<ObjectID> old_ids = row.cull(InstanceRow::get_row_aabb(i));
+			const Vector<ObjectID> new_ids = row.cull(InstanceRow::get_row_aabb(i, 100.0));
+			moved = old_ids.is_empty() && new_ids.size() == 1 && new_ids[0] == ObjectID(uint64_t(i + 1));
+			CHECK_MESSAGE(moved, vformat("Instance %d should have moved.", i));
+		}
+	}
+
+	SUBCASE("A single transform set afterwards should take precedence") {
+		rs->instance_set_transform(row.get_instances()[3], InstanceRow::get_row_transform(3, -100.0));
+		CHECK(row.cull(InstanceRow::get_row_aabb(3, 100.0)).is_empty());
+		CHECK_EQ(row.cull(InstanceRow::get_row_aabb(3, -100.0)).size(), 1);
+	}
+
+	SUBCASE("Repeated bulk updates should keep the instances in the indexer") {
+		for (int step = 1; step <= 4; step++) {
+			for (int i = 0; i < count; i++) {
+				transforms.write[i] = InstanceRow::get_row_transform(i, 100.0 + step * 0.25);
+			}
+			rs->instances_set_transforms(row.get_instances(), transforms);
+		}
+		CHECK_EQ(row.cull(AABB(Vector3(-10.0, -10.0, 90.0), Vector3(count * 4.0 + 20.0, 20.0, 20.0))).size(), count);
+	}
+
+	SUBCASE("Mismatched array sizes should be rejected") {
+		Vector<Transform3D> short_transforms;
+		short_transforms.push_back(InstanceRow::get_row_transform(0, -50.0));
+		ERR_PRINT_OFF;
+		rs->instances_set_transforms(row.get_instances(), short_transforms);
+		ERR_PRINT_ON;
+		CHECK(row.cull(InstanceRow::get_row_aabb(0, -50.0)).is_empty());
+	}
+}
+
+TEST_CASE_BENCHMARK("[SceneTree][RenderingServer] Set the transforms of a crowd of instances") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const int count = 30000;
+	const int warmup_frame_count = 8;
+	const int frame_count = 8;
+
+	// The same crowd in two scenarios, moved one instance at a time in the first one and all at once in the second one.
+	InstanceRow single_row(count);
+	InstanceRow bulk_row(count);
+	single_row.cull(AABB());
+	bulk_row.cull(AABB());
+
+	Vector<Transform3D> transforms;
+	transforms.resize(count);
+
+	// Every frame moves every instance a little, at different speeds, then flushes the dirty instances like a draw would.
+	// The first frames restructure the indexers a lot, so they aren't measured.
+	uint64_t single_set_usec = 0;
+	uint64_t single_flush_usec = 0;
+	uint64_t bulk_set_usec = 0;
+	uint64_t bulk_flush_usec = 0;
+	for (int frame = 1; frame <= warmup_frame_count + frame_count; frame++) {
+		for (int i = 0; i < count; i++) {
+			transforms.write[i] = InstanceRow::get_row_transform(i, frame * (0.1 + (i % 7) * 0.05));
+		}
+		const bool measured = frame > warmup_frame_count;
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			rs->instance_set_transform(single_row.get_instances()[i], transforms[i]);
+		}
+		single_set_usec += measured ? OS::get_singleton()->get_ticks_usec() - begin : 0;
+		begin = OS::get_singleton()->get_ticks_usec();
+		single_row.cull(AABB());
+		single_flush_usec += measured ? OS::get_singleton()->get_ticks_usec() - begin : 0;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		rs->instances_set_transforms(bulk_row.get_instances(), transforms);
+		bulk_set_usec += measured ? OS::get_singleton()->get_ticks_usec() - begin : 0;
+		begin = OS::get_singleton()->get_ticks_usec();
+		bulk_row.cull(AABB());
+		bulk_flush_usec += measured ? OS::get_singleton()->get_ticks_usec() - begin : 0;
+	}
+
+	const double instance_frames = double(count) * frame_count;
+	Dictionary results;
+	results["benchmark"] = "rendering_server/instance_transforms";
+	results["instances"] = count;
+	results["single_set_nsec_per_instance"] = single_set_usec * 1000.0 / instance_frames;
+	results["single_flush_nsec_per_instance"] = single_flush_usec * 1000.0 / instance_frames;
+	results["bulk_set_nsec_per_instance"] = bulk_set_usec * 1000.0 / instance_frames;
+	results["bulk_flush_nsec_per_instance"] = bulk_flush_usec * 1000.0 / instance_frames;
+	print_line(JSON::stringify(results));
+
+	const AABB crowd_aabb(Vector3(-10.0, -10.0, -10.0), Vector3(count * 4.0 + 20.0, 20.0, (warmup_frame_count + frame_count) * 0.4 + 20.0));
+	CHECK_EQ(single_row.cull(crowd_aabb).size(), count);
+	CHECK_EQ(bulk_row.cull(crowd_aabb).size(), count);
+}
+
+} // namespace TestRenderingServer
+
+#endif // TEST_RENDERING_SERVER_H
@@ -0,0 +1,204 @@
+/**************************************************************************/
+/*  test_shader_compiler.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SHADER_COMPILER_H
+#define TEST_SHADER_COMPILER_H
+
+#include "servers/rendering/shader_compiler.h"
+
+#include "tests/test_macros.h"
+
+namespace TestShaderCompiler {
+
+// Everything a compile() call hands back, either generated or from the code cache.
+struct CompileResult {
+	ShaderCompiler::GeneratedCode gen_code;
+	bool unshaded = false;
+	int blend_mode = 0;
+	bool uses_alpha = false;
+	bool uses_time = false;
+	bool writes_albedo = false;
+	bool writes_vertex = false;
+	HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+};
+
+static Error compile_spatial(ShaderCompiler &p_compiler, const String &p_code, CompileResult &r_result) {
+	ShaderCompiler::IdentifierActions actions;
+	actions.entry_point_stages["vertex"] = ShaderCompiler::STAGE_VERTEX;
+	actions.entry_point_stages["fragment"] = ShaderCompiler::STAGE_FRAGMENT;
+	actions.render_mode_flags["unshaded"] = &r_result.unshaded;
+	actions.render_mode_values["blend_add"] = Pair<int *, int>(&r_result.blend_mode, 1);
+	actions.usage_flag_pointers["ALPHA"] = &r_result.uses_alpha;
+	actions.usage_flag_pointers["TIME"] = &r_result.uses_time;
+	actions.write_flag_pointers["ALBEDO"] = &r_result.writes_albedo;
+	actions.write_flag_pointers["VERTEX"] = &r_result.writes_vertex;
+	actions.uniforms = &r_result.uniforms;
+	return p_compiler.compile(RS::SHADER_SPATIAL, p_code, &actions, "", r_result.gen_code);
+}
+
+static bool is_same_code(const ShaderCompiler::GeneratedCode &p_a, const ShaderCompiler::GeneratedCode &p_b) {
+	if (p_a.defines != p_b.defines || p_a.uniforms != p_b.uniforms || p_a.uniform_offsets != p_b.uniform_offsets || p_a.uniform_total_size != p_b.uniform_total_size) {
+		return false;
+	}
+	for (int i = 0; i < ShaderCompiler::STAGE_MAX; i++) {
+		if (p_a.stage_globals[i] != p_b.stage_globals[i]) {
+			return false;
+		}
+	}
+	if (p_a.code.size() != p_b.code.size()) {
+		return false;
+	}
+	for (const KeyValue<String, String> &E : p_a.code) {
+		if (!p_b.code.has(E.key) || p_b.code[E.key] != E.value) {
+			return false;
+		}
+	}
+	if (p_a.texture_uniforms.size() != p_b.texture_uniforms.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.texture_uniforms.size(); i++) {
+		if (p_a.texture_uniforms[i].name != p_b.texture_uniforms[i].name || p_a.texture_uniforms[i].type != p_b.texture_uniforms[i].type || p_a.texture_uniforms[i].hint != p_b.texture_uniforms[i].hint) {
+			return false;
+		}
+	}
+	return p_a.uses_global_textures == p_b.uses_global_textures && p_a.uses_fragment_time == p_b.uses_fragment_time && p_a.uses_vertex_time == p_b.uses_vertex_time && p_a.uses_screen_texture == p_b.uses_screen_texture && p_a.uses_depth_texture == p_b.uses_depth_texture;
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Compiling the same code again uses the code cache") {
+	ShaderCompiler compiler;
+	compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+
+	const String code = R"(
+shader_type spatial;
+render_mode unshaded, blend_add;
+
+uniform vec4 albedo : source_color;
+uniform sampler2D albedo_texture : hint_default_white;
+
+void vertex() {
+	VERTEX.y += sin(TIME);
+}
+
+void fragment() {
+	ALBEDO = albedo.rgb * texture(albedo_texture, UV).rgb;
+}
+)";
+
+	CompileResult first;
+	const uint64_t hits = ShaderCompiler::get_cache_hits();
+	const uint64_t misses = ShaderCompiler::get_cache_misses();
+	REQUIRE_EQ(compile_spatial(compiler, code, first), OK);
+	CHECK_EQ(ShaderCompiler::get_cache_hits(), hits);
+	CHECK_EQ(ShaderCompiler::get_cache_misses(), misses + 1);
+
+	CompileResult second;
+	REQUIRE_EQ(compile_spatial(compiler, code, second), OK);
+	CHECK_EQ(ShaderCompiler::get_cache_hits(), hits + 1);
+	CHECK_EQ(ShaderCompiler::get_cache_misses(), misses + 1);
+
+	CHECK(is_same_code(first.gen_code, second.gen_code));
+
+	CHECK(first.unshaded);
+	CHECK_EQ(first.blend_mode, 1);
+	CHECK(first.uses_time);
+	CHECK_FALSE(first.uses_alpha);
+	CHECK(first.writes_albedo);
+	CHECK(first.writes_vertex);
+	CHECK_EQ(second.unshaded, first.unshaded);
+	CHECK_EQ(second.blend_mode, first.blend_mode);
+	CHECK_EQ(second.uses_time, first.uses_time);
+	CHECK_EQ(second.uses_alpha, first.uses_alpha);
+	CHECK_EQ(second.writes_albedo, first.writes_albedo);
+	CHECK_EQ(second.writes_vertex, first.writes_vertex);
+
+	REQUIRE_EQ(first.uniforms.size(), 2);
+	REQUIRE_EQ(second.uniforms.size(), first.uniforms.size());
+	for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &E : first.uniforms) {
+		REQUIRE(second.uniforms.has(E.key));
+		const ShaderLanguage::ShaderNode::Uniform &uniform = second.uniforms[E.key];
+		CHECK_EQ(uniform.type, E.value.type);
+		CHECK_EQ(uniform.hint, E.value.hint);
+		CHECK_EQ(uniform.order, E.value.order);
+		CHECK_EQ(uniform.texture_order, E.value.texture_order);
+	}
+
+	SUBCASE("Different code should not use the cache") {
+		CompileResult other;
+		REQUIRE_EQ(compile_spatial(compiler, code + "\n", other), OK);
+		CHECK_EQ(ShaderCompiler::get_cache_hits(), hits + 1);
+		CHECK_EQ(ShaderCompiler::get_cache_misses(), misses + 2);
+	}
+}
+
+#ifdef TOOLS_ENABLED
+TEST_CASE("[SceneTree][ShaderCompiler] Changing the type of a global uniform invalidates the cached code in the editor") {
+	// Global uniforms are only type checked in the editor.
+	Engine::get_singleton()->set_editor_hint(true);
+	RenderingServer::get_singleton()->global_shader_parameter_add("tint", RS::GLOBAL_VAR_TYPE_COLOR, Color(1, 1, 1));
+
+	ShaderCompiler compiler;
+	compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+
+	const String code = R"(
+shader_type spatial;
+
+global uniform vec4 tint;
+
+void fragment() {
+	ALBEDO = tint.rgb;
+}
+)";
+
+	CompileResult result;
+	const uint64_t hits = ShaderCompiler::get_cache_hits();
+	const uint64_t misses = ShaderCompiler::get_cache_misses();
+	REQUIRE_EQ(compile_spatial(compiler, code, result), OK);
+	REQUIRE_EQ(compile_spatial(compiler, code, result), OK);
+	CHECK_EQ(ShaderCompiler::get_cache_hits(), hits + 1);
+	CHECK_EQ(ShaderCompiler::get_cache_misses(), misses + 1);
+
+	RenderingServer::get_singleton()->global_shader_parameter_remove("tint");
+	RenderingServer::get_singleton()->global_shader_parameter_add("tint", RS::GLOBAL_VAR_TYPE_FLOAT, 1.0);
+
+	// The shader no longer matches the global uniform, so it has to be compiled again, and fail.
+	ERR_PRINT_OFF;
+	CHECK_NE(compile_spatial(compiler, code, result), OK);
+	ERR_PRINT_ON;
+	CHECK_EQ(ShaderCompiler::get_cache_hits(), hits + 1);
+	CHECK_EQ(ShaderCompiler::get_cache_misses(), misses + 2);
+
+	RenderingServer::get_singleton()->global_shader_parameter_remove("tint");
+	Engine::get_singleton()->set_editor_hint(false);
+}
+#endif // TOOLS_ENABLED
+
+} // namespace TestShaderCompiler
+
+#endif // TEST_SHADER_COMPILER_H
@@ -31,6 +31,9 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/math/random_pcg.h"
+#include "core/templates/hash_set.h"
+#include "modules/navigation/nav_polygon_index.h"
 #include "modules/navigation/nav_utils.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
@@ -62,6 +65,45 @@ static inline Array build_array(Variant item, Targs... Fargs) {
 	return a;
 }
 
+// Builds a square grid of quads crossed by walls, so that long paths have to go around them.
+static Ref<NavigationMesh> build_maze_navigation_mesh(int p_size) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+	navigation_mesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			// Every sixteenth row is a wall, with gaps at shifting positions.
+			const bool wall_row = z % 16 == 15;
+			const bool gap = (x + z * 7) % 64 < 2;
+			if (wall_row && !gap) {
+				continue;
+			}
+			const int corner = z * (p_size + 1) + x;
+			Vector<int> polygon;
+			polygon.push_back(corner);
+			polygon.push_back(corner + p_size + 1);
+			polygon.push_back(corner + p_size + 2);
+			polygon.push_back(corner + 1);
+			navigation_mesh->add_polygon(polygon);
+		}
+	}
+	return navigation_mesh;
+}
+
+static real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
 struct GreaterThan {
 	bool operator()(int p_a, int p_b) const { return p_a > p_b; }
 };
@@ -185,6 +227,8 @@ TEST_SUITE("[Navigation]") {
 			navigation_server->map_set_up(map, Vector3(1, 0, 0));
 			bool initial_use_edge_connections = navigation_server->map_get_use_edge_connections(map);
 			navigation_server->map_set_use_edge_connections(map, !initial_use_edge_connections);
+			bool initial_use_hierarchical_pathfinding = navigation_server->map_get_use_hierarchical_pathfinding(map);
+			navigation_server->map_set_use_hierarchical_pathfinding(map, !initial_use_hierarchical_pathfinding);
 			navigation_server->process(0.0); // Give server some cycles to commit.
 
 			CHECK_EQ(navigation_server->map_get_cell_size(map), doctest::Approx(0.55));
@@ -192,6 +236,7 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(navigation_server->map_get_link_connection_radius(map), doctest::Approx(0.77));
 			CHECK_EQ(navigation_server->map_get_up(map), Vector3(1, 0, 0));
 			CHECK_EQ(navigation_server->map_get_use_edge_connections(map), !initial_use_edge_connections);
+			CHECK_EQ(navigation_server->map_get_use_hierarchical_pathfinding(map), !initial_use_hierarchical_pathfinding);
 		}
 
 		SUBCASE("'ProcessInfo' should report map iff active") {
@@ -774,6 +819,32 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(query_result->get_path_types().size(), 0);
 			CHECK_EQ(query_result->get_path_rids().size(), 0);
 			CHECK_EQ(query_result->get_path_owner_ids().size(), 0);
+			CHECK_EQ(query_result->get_explored_polygon_count(), 0);
+			CHECK_EQ(query_result->get_path_length(), 0.0);
+		}
+
+		SUBCASE("Elaborate query should report statistics") {
+			Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+			query_parameters->set_map(map);
+			query_parameters->set_start_position(Vector3(0, 0, 0));
+			query_parameters->set_target_position(Vector3(10, 0, 10));
+			Ref<NavigationPathQueryResult3D> query_result = memnew(NavigationPathQueryResult3D);
+			navigation_server->query_path(query_parameters, query_result);
+			const Vector<Vector3> path = query_result->get_path();
+			REQUIRE_GE(path.size(), 2);
+			real_t path_length = 0.0;
+			for (int i = 1; i < path.size(); i++) {
+				path_length += path[i - 1].distance_to(path[i]);
+			}
+			CHECK(query_result->get_path_length() == doctest::Approx(path_length));
+			CHECK_GE(query_result->get_path_length(), path[0].distance_to(path[path.size() - 1]));
+			CHECK_GE(query_result->get_explored_polygon_count(), 1);
+			CHECK_LE(query_result->get_explored_polygon_count(), navigation_mesh->get_polygon_count());
+
+			query_result->reset();
+			CHECK_EQ(query_result->get_path_length(), 0.0);
+			CHECK_EQ(query_result->get_explored_polygon_count(), 0);
+			CHECK_EQ(query_result->get_query_time_usec(), 0);
 		}
 
 		SUBCASE("Elaborate query without metadata flags should yield path only") {
@@ -795,6 +866,579 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should find paths with hierarchical pathfinding") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(64);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 start(1.5, 0, 1.5);
+		const Vector3 end(62.5, 0, 62.5);
+		const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_NE(path.size(), 0);
+
+		navigation_server->map_set_use_hierarchical_pathfinding(map, true);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector<Vector3> hierarchical_path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_NE(hierarchical_path.size(), 0);
+		CHECK(hierarchical_path[0].is_equal_approx(path[0]));
+		CHECK(hierarchical_path[hierarchical_path.size() - 1].is_equal_approx(path[path.size() - 1]));
+		// The coarse route may miss the shortest path, but should stay close to it.
+		CHECK(get_path_length(hierarchical_path) <= get_path_length(path) * 1.1);
+
+		SUBCASE("Queries with incompatible navigation layers should yield empty result") {
+			const Vector<Vector3> layer_path = navigation_server->map_get_path(map, start, end, true, 2);
+			CHECK_EQ(layer_path.size(), 0);
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationServer3D] Hierarchical pathfinding on a large maze") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int size = 400;
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(size);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		RandomPCG rng(1);
+		LocalVector<Vector3> starts;
+		LocalVector<Vector3> ends;
+		for (int i = 0; i < 20; i++) {
+			starts.push_back(Vector3(rng.random(0.0f, float(size)), 0, rng.random(0.0f, size / 8.0f)));
+			ends.push_back(Vector3(rng.random(0.0f, float(size)), 0, rng.random(size * 7.0f / 8.0f, float(size))));
+		}
+
+		real_t lengths[2] = {};
+		uint64_t query_usec[2] = {};
+		uint64_t sync_usec[2] = {};
+		for (int hierarchical = 0; hierarchical < 2; hierarchical++) {
+			navigation_server->map_set_use_hierarchical_pathfinding(map, hierarchical == 1);
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			sync_usec[hierarchical] = OS::get_singleton()->get_ticks_usec() - begin;
+
+			begin = OS::get_singleton()->get_ticks_usec();
+			for (uint32_t i = 0; i < starts.size(); i++) {
+				lengths[hierarchical] += get_path_length(navigation_server->map_get_path(map, starts[i], ends[i], true));
+			}
+			query_usec[hierarchical] = OS::get_singleton()->get_ticks_usec() - begin;
+		}
+
+		MESSAGE(vformat("Polygons: %d, queries: %d", navigation_mesh->get_polygon_count(), starts.size()));
+		MESSAGE(vformat("Full search: sync %d us, queries %d us", sync_usec[0], query_usec[0]));
+		MESSAGE(vformat("Hierarchical search: sync %d us, queries %d us, path length ratio %.3f", sync_usec[1], query_usec[1], lengths[1] / lengths[0]));
+		CHECK(lengths[1] <= lengths[0] * 1.1);
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find paths with flow fields") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(64);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		Ref<NavigationPathQueryParameters3D> query_parameters;
+		query_parameters.instantiate();
+		query_parameters->set_map(map);
+		query_parameters->set_target_position(Vector3(32.3, 0, 62.5));
+		Ref<NavigationPathQueryResult3D> query_result;
+		query_result.instantiate();
+
+		// Several queries heading to the same target share one flow field.
+		for (int i = 0; i < 4; i++) {
+			query_parameters->set_start_position(Vector3(1.5 + i * 20, 0, 1.5 + i * 3));
+			query_parameters->set_pathfinding_algorithm(NavigationPathQueryParameters3D::PATHFINDING_ALGORITHM_ASTAR);
+			navigation_server->query_path(query_parameters, query_result);
+			const Vector<Vector3> path = query_result->get_path();
+			REQUIRE_NE(path.size(), 0);
+
+			query_parameters->set_pathfinding_algorithm(NavigationPathQueryParameters3D::PATHFINDING_ALGORITHM_FLOW_FIELD);
+			navigation_server->query_path(query_parameters, query_result);
+			const Vector<Vector3> flow_field_path = query_result->get_path();
+			REQUIRE_NE(flow_field_path.size(), 0);
+			CHECK(flow_field_path[0].is_equal_approx(path[0]));
+			CHECK(flow_field_path[flow_field_path.size() - 1].is_equal_approx(path[path.size() - 1]));
+			CHECK_EQ(query_result->get_path_types().size(), flow_field_path.size());
+			CHECK_EQ(query_result->get_path_rids().size(), flow_field_path.size());
+			CHECK_EQ(query_result->get_path_owner_ids().size(), flow_field_path.size());
+			CHECK(get_path_length(flow_field_path) <= get_path_length(path) * 1.1);
+		}
+
+		SUBCASE("Queries with incompatible navigation layers should yield empty result") {
+			query_parameters->set_navigation_layers(2);
+			navigation_server->query_path(query_parameters, query_result);
+			CHECK_EQ(query_result->get_path().size(), 0);
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find flow field paths towards more targets than it caches flow fields for") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(64);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		Ref<NavigationPathQueryParameters3D> query_parameters;
+		query_parameters.instantiate();
+		query_parameters->set_map(map);
+		query_parameters->set_start_position(Vector3(1.5, 0, 1.5));
+		Ref<NavigationPathQueryResult3D> query_result;
+		query_result.instantiate();
+
+		// Queries cycling through the targets keep finding paths, whether a flow field is cached for their target or not.
+		for (int round = 0; round < 3; round++) {
+			for (int i = 0; i < 12; i++) {
+				query_parameters->set_target_position(Vector3(4.5 + i * 5, 0, 62.5));
+				query_parameters->set_pathfinding_algorithm(NavigationPathQueryParameters3D::PATHFINDING_ALGORITHM_ASTAR);
+				navigation_server->query_path(query_parameters, query_result);
+				const Vector<Vector3> path = query_result->get_path();
+				REQUIRE_NE(path.size(), 0);
+
+				query_parameters->set_pathfinding_algorithm(NavigationPathQueryParameters3D::PATHFINDING_ALGORITHM_FLOW_FIELD);
+				navigation_server->query_path(query_parameters, query_result);
+				const Vector<Vector3> flow_field_path = query_result->get_path();
+				REQUIRE_NE(flow_field_path.size(), 0);
+				CHECK(flow_field_path[flow_field_path.size() - 1].is_equal_approx(path[path.size() - 1]));
+				CHECK(get_path_length(flow_field_path) <= get_path_length(path) * 1.1);
+			}
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationServer3D] Flow field path queries towards a shared target") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int size = 200;
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(size);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		RandomPCG rng(1);
+		LocalVector<Vector3> starts;
+		for (int i = 0; i < 500; i++) {
+			starts.push_back(Vector3(rng.random(0.0f, float(size)), 0, rng.random(0.0f, float(size))));
+		}
+
+		Ref<NavigationPathQueryParameters3D> query_parameters;
+		query_parameters.instantiate();
+		query_parameters->set_map(map);
+		query_parameters->set_target_position(Vector3(size / 2.0, 0, size - 1.5));
+		Ref<NavigationPathQueryResult3D> query_result;
+		query_result.instantiate();
+
+		real_t lengths[2] = {};
+		uint64_t query_usec[2] = {};
+		const NavigationPathQueryParameters3D::PathfindingAlgorithm algorithms[2] = { NavigationPathQueryParameters3D::PATHFINDING_ALGORITHM_ASTAR, NavigationPathQueryParameters3D::PATHFINDING_ALGORITHM_FLOW_FIELD };
+		for (int i = 0; i < 2; i++) {
+			query_parameters->set_pathfinding_algorithm(algorithms[i]);
+			const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (const Vector3 &start : starts) {
+				query_parameters->set_start_position(start);
+				navigation_server->query_path(query_parameters, query_result);
+				lengths[i] += get_path_length(query_result->get_path());
+			}
+			query_usec[i] = OS::get_singleton()->get_ticks_usec() - begin;
+		}
+
+		MESSAGE(vformat("Polygons: %d, queries: %d", navigation_mesh->get_polygon_count(), starts.size()));
+		MESSAGE(vformat("A*: %d us, flow field: %d us, path length ratio %.3f", query_usec[0], query_usec[1], lengths[1] / lengths[0]));
+		CHECK(lengths[1] <= lengths[0] * 1.1);
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should run batched path queries asynchronously") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(64);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		TypedArray<NavigationPathQueryParameters3D> query_parameters;
+		TypedArray<NavigationPathQueryResult3D> query_results;
+		for (int i = 0; i < 8; i++) {
+			Ref<NavigationPathQueryParameters3D> parameters;
+			parameters.instantiate();
+			parameters->set_map(map);
+			parameters->set_start_position(Vector3(1.5 + i * 7, 0, 1.5));
+			parameters->set_target_position(Vector3(62.5 - i * 7, 0, 62.5));
+			query_parameters.push_back(parameters);
+			Ref<NavigationPathQueryResult3D> result;
+			result.instantiate();
+			query_results.push_back(result);
+		}
+
+		CallableMock callback_mock;
+		const int64_t batch_id = navigation_server->query_paths_async(query_parameters, query_results, callable_mp(&callback_mock, &CallableMock::function1));
+		CHECK_GT(batch_id, 0);
+		CHECK_FALSE(navigation_server->is_path_query_batch_completed(batch_id));
+
+		navigation_server->process(0.0); // Dispatches the queries.
+		CHECK_EQ(callback_mock.function1_calls, 0);
+		navigation_server->process(0.0); // Delivers the results.
+		CHECK_EQ(callback_mock.function1_calls, 1);
+		CHECK_EQ(callback_mock.function1_latest_arg0, Variant(batch_id));
+		CHECK(navigation_server->is_path_query_batch_completed(batch_id));
+
+		for (int i = 0; i < query_parameters.size(); i++) {
+			Ref<NavigationPathQueryParameters3D> parameters = query_parameters[i];
+			Ref<NavigationPathQueryResult3D> sync_result;
+			sync_result.instantiate();
+			navigation_server->query_path(parameters, sync_result);
+			const Ref<NavigationPathQueryResult3D> async_result = query_results[i];
+			CHECK_NE(async_result->get_path().size(), 0);
+			CHECK_EQ(async_result->get_path(), sync_result->get_path());
+		}
+
+		SUBCASE("Mismatched parameters and results should be rejected") {
+			ERR_PRINT_OFF;
+			query_results.remove_at(0);
+			CHECK_EQ(navigation_server->query_paths_async(query_parameters, query_results), 0);
+			ERR_PRINT_ON;
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should run batched path queries while inactive") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(16);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		TypedArray<NavigationPathQueryParameters3D> query_parameters;
+		TypedArray<NavigationPathQueryResult3D> query_results;
+		Ref<NavigationPathQueryParameters3D> parameters;
+		parameters.instantiate();
+		parameters->set_map(map);
+		parameters->set_start_position(Vector3(1.5, 0, 1.5));
+		parameters->set_target_position(Vector3(14.5, 0, 14.5));
+		query_parameters.push_back(parameters);
+		Ref<NavigationPathQueryResult3D> result;
+		result.instantiate();
+		query_results.push_back(result);
+
+		navigation_server->set_active(false);
+		CallableMock callback_mock;
+		const int64_t batch_id = navigation_server->query_paths_async(query_parameters, query_results, callable_mp(&callback_mock, &CallableMock::function1));
+		navigation_server->process(0.0); // Dispatches the queries.
+		navigation_server->process(0.0); // Delivers the results.
+		CHECK_EQ(callback_mock.function1_calls, 1);
+		CHECK(navigation_server->is_path_query_batch_completed(batch_id));
+		CHECK_NE(result->get_path().size(), 0);
+		navigation_server->set_active(true);
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should finish async path queries before a forced map update") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(64);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		TypedArray<NavigationPathQueryParameters3D> query_parameters;
+		TypedArray<NavigationPathQueryResult3D> query_results;
+		for (int i = 0; i < 32; i++) {
+			Ref<NavigationPathQueryParameters3D> parameters;
+			parameters.instantiate();
+			parameters->set_map(map);
+			parameters->set_start_position(Vector3(1.5 + (i % 8) * 7, 0, 1.5));
+			parameters->set_target_position(Vector3(62.5 - (i % 8) * 7, 0, 62.5));
+			query_parameters.push_back(parameters);
+			Ref<NavigationPathQueryResult3D> result;
+			result.instantiate();
+			query_results.push_back(result);
+		}
+
+		CallableMock callback_mock;
+		const int64_t batch_id = navigation_server->query_paths_async(query_parameters, query_results, callable_mp(&callback_mock, &CallableMock::function1));
+		navigation_server->process(0.0); // Dispatches the queries.
+
+		// The queued free of the region only runs once the queries reading it are done.
+		navigation_server->free(region);
+		navigation_server->map_force_update(map);
+		CHECK_EQ(callback_mock.function1_calls, 1);
+		CHECK(navigation_server->is_path_query_batch_completed(batch_id));
+		for (int i = 0; i < query_results.size(); i++) {
+			const Ref<NavigationPathQueryResult3D> async_result = query_results[i];
+			CHECK_NE(async_result->get_path().size(), 0);
+		}
+		CHECK(navigation_server->map_get_regions(map).is_empty());
+
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should connect regions through shared and nearby edges") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(16);
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_edge_connection_margin(map, 0.5);
+		// The second region shares its edges with the first, the third is separated by a gap within the edge connection margin.
+		RID regions[3];
+		const real_t offsets[3] = { 0.0, 16.0, 32.3 };
+		for (int i = 0; i < 3; i++) {
+			regions[i] = navigation_server->region_create();
+			navigation_server->region_set_map(regions[i], map);
+			navigation_server->region_set_transform(regions[i], Transform3D(Basis(), Vector3(offsets[i], 0, 0)));
+			navigation_server->region_set_navigation_mesh(regions[i], navigation_mesh);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		CHECK_EQ(navigation_server->region_get_connections_count(regions[0]), 0);
+		CHECK_GT(navigation_server->region_get_connections_count(regions[1]), 0);
+		CHECK_GT(navigation_server->region_get_connections_count(regions[2]), 0);
+
+		const Vector3 start(1.5, 0, 1.5);
+		const Vector3 end(47.5, 0, 1.5);
+		const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_NE(path.size(), 0);
+		CHECK(path[path.size() - 1].is_equal_approx(end));
+
+		SUBCASE("Moving a region away should disconnect it") {
+			navigation_server->region_set_transform(regions[2], Transform3D(Basis(), Vector3(40.0, 0, 0)));
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(regions[2]), 0);
+			const Vector<Vector3> disconnected_path = navigation_server->map_get_path(map, start, Vector3(55.5, 0, 1.5), true);
+			REQUIRE_NE(disconnected_path.size(), 0);
+			CHECK_LT(disconnected_path[disconnected_path.size() - 1].x, 40.0);
+		}
+
+		for (int i = 0; i < 3; i++) {
+			navigation_server->free(regions[i]);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should build map iterations asynchronously") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(64);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->map_force_update(map); // Unlike the server process, this waits for the iteration.
+		CHECK(navigation_server->map_get_use_async_iterations(map));
+
+		const uint32_t iteration_id = navigation_server->map_get_iteration_id(map);
+		CHECK_NE(iteration_id, 0u);
+
+		const Vector3 start(1.5, 0, 1.5);
+		const Vector3 end(62.5, 0, 62.5);
+		const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_NE(path.size(), 0);
+
+		// The queries keep using the previous iteration until the next one is ready.
+		navigation_server->region_set_transform(region, Transform3D(Basis(), Vector3(0, 0, 100)));
+		navigation_server->process(0.0);
+		for (int i = 0; i < 1000 && navigation_server->map_get_iteration_id(map) == iteration_id; i++) {
+			CHECK_EQ(navigation_server->map_get_path(map, start, end, true), path);
+			OS::get_singleton()->delay_usec(1000);
+			navigation_server->process(0.0);
+		}
+		REQUIRE_NE(navigation_server->map_get_iteration_id(map), iteration_id);
+		CHECK_GE(navigation_server->map_get_closest_point(map, start).z, 100.0);
+
+		SUBCASE("Iterations should match the ones built during the sync") {
+			RID sync_map = navigation_server->map_create();
+			RID sync_region = navigation_server->region_create();
+			navigation_server->map_set_active(sync_map, true);
+			navigation_server->region_set_map(sync_region, sync_map);
+			navigation_server->region_set_transform(sync_region, Transform3D(Basis(), Vector3(0, 0, 100)));
+			navigation_server->region_set_navigation_mesh(sync_region, navigation_mesh);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector3 moved_start = start + Vector3(0, 0, 100);
+			const Vector3 moved_end = end + Vector3(0, 0, 100);
+			CHECK_EQ(navigation_server->map_get_path(map, moved_start, moved_end, true), navigation_server->map_get_path(sync_map, moved_start, moved_end, true));
+
+			navigation_server->free(sync_region);
+			navigation_server->free(sync_map);
+		}
+
+		SUBCASE("Removing a region should update the map within the next process") {
+			navigation_server->free(region);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			ERR_PRINT_OFF;
+			CHECK_EQ(navigation_server->map_get_closest_point(map, start), Vector3());
+			ERR_PRINT_ON;
+			region = navigation_server->region_create();
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationServer3D] Map synchronization when a small region moves on a large map") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = build_maze_navigation_mesh(256);
+		Ref<NavigationMesh> door_navigation_mesh = build_maze_navigation_mesh(2);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		RID door_region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_edge_connection_margin(map, 0.5);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->region_set_map(door_region, map);
+		navigation_server->region_set_navigation_mesh(door_region, door_navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const int sync_count = 20;
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < sync_count; i++) {
+			navigation_server->region_set_transform(door_region, Transform3D(Basis(), Vector3(256.3, 0, i * 2)));
+			navigation_server->map_force_update(map);
+		}
+		const uint64_t sync_usec = (OS::get_singleton()->get_ticks_usec() - begin) / sync_count;
+
+		MESSAGE("Polygons: ", navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), ", sync: ", sync_usec, " us");
+		CHECK_GT(navigation_server->region_get_connections_count(door_region), 0);
+
+		navigation_server->free(door_region);
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should bake navigation mesh tiles") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+		PackedVector3Array faces;
+		faces.push_back(Vector3(0, 0, 0));
+		faces.push_back(Vector3(64, 0, 0));
+		faces.push_back(Vector3(0, 0, 64));
+		faces.push_back(Vector3(64, 0, 0));
+		faces.push_back(Vector3(64, 0, 64));
+		faces.push_back(Vector3(0, 0, 64));
+		source_geometry->add_faces(faces, Transform3D());
+
+		Ref<NavigationMeshTiles3D> navigation_mesh_tiles = memnew(NavigationMeshTiles3D);
+		navigation_mesh_tiles->set_tile_size(16.0);
+		navigation_server->bake_tiles_from_source_geometry_data(navigation_mesh, source_geometry, navigation_mesh_tiles);
+		CHECK_EQ(navigation_mesh_tiles->get_tiles().size(), 16);
+		CHECK_EQ(navigation_mesh_tiles->get_changed_tiles().size(), 16);
+		for (int i = 0; i < 16; i++) {
+			Ref<NavigationMesh> tile_navigation_mesh = navigation_mesh_tiles->get_tile_navigation_mesh(Vector2i(i % 4, i / 4));
+			REQUIRE(tile_navigation_mesh.is_valid());
+			CHECK_NE(tile_navigation_mesh->get_polygon_count(), 0);
+		}
+
+		SUBCASE("Baking the same source geometry again should not change any tile") {
+			navigation_server->bake_tiles_from_source_geometry_data(navigation_mesh, source_geometry, navigation_mesh_tiles);
+			CHECK_EQ(navigation_mesh_tiles->get_tiles().size(), 16);
+			CHECK_EQ(navigation_mesh_tiles->get_changed_tiles().size(), 0);
+		}
+
+		SUBCASE("Only the tiles around a change should be baked again") {
+			Ref<NavigationMesh> unchanged_navigation_mesh = navigation_mesh_tiles->get_tile_navigation_mesh(Vector2i(0, 0));
+			PackedVector3Array obstruction;
+			obstruction.push_back(Vector3(22, 0, 22));
+			obstruction.push_back(Vector3(26, 0, 22));
+			obstruction.push_back(Vector3(26, 0, 26));
+			obstruction.push_back(Vector3(22, 0, 26));
+			source_geometry->add_projected_obstruction(obstruction, 0.0, 2.0, false);
+			navigation_server->bake_tiles_from_source_geometry_data(navigation_mesh, source_geometry, navigation_mesh_tiles);
+			const TypedArray<Vector2i> changed_tiles = navigation_mesh_tiles->get_changed_tiles();
+			REQUIRE_EQ(changed_tiles.size(), 1);
+			CHECK_EQ(Vector2i(changed_tiles[0]), Vector2i(1, 1));
+			CHECK_EQ(navigation_mesh_tiles->get_tile_navigation_mesh(Vector2i(0, 0)), unchanged_navigation_mesh);
+		}
+
+		SUBCASE("Tiles should connect on the navigation map") {
+			RID map = navigation_server->map_create();
+			navigation_server->map_set_active(map, true);
+			LocalVector<RID> regions;
+			const TypedArray<Vector2i> tiles = navigation_mesh_tiles->get_tiles();
+			for (int i = 0; i < tiles.size(); i++) {
+				RID region = navigation_server->region_create();
+				navigation_server->region_set_map(region, map);
+				navigation_server->region_set_navigation_mesh(region, navigation_mesh_tiles->get_tile_navigation_mesh(tiles[i]));
+				regions.push_back(region);
+			}
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(2, 0, 2), Vector3(62, 0, 62), true);
+			REQUIRE_NE(path.size(), 0);
+			const Vector3 path_end = path[path.size() - 1];
+			CHECK_LT(Vector2(path_end.x, path_end.z).distance_to(Vector2(62, 62)), 0.1);
+
+			for (const RID &region : regions) {
+				navigation_server->free(region);
+			}
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+	}
+
 	// FIXME: The race condition mentioned below is actually a problem and fails on CI (GH-90613).
 	/*
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {
@@ -948,6 +1592,125 @@ TEST_SUITE("[Navigation]") {
 		CHECK(heap_indexes[2] == UINT32_MAX);
 		CHECK(heap_indexes[3] == UINT32_MAX);
 	}
+
+	static LocalVector<gd::Polygon> build_random_polygons(uint32_t p_count, RandomPCG &p_rng) {
+		LocalVector<gd::Polygon> polygons;
+		polygons.resize(p_count);
+		for (gd::Polygon &polygon : polygons) {
+			const Vector3 origin(p_rng.random(-100.0f, 100.0f), p_rng.random(-5.0f, 5.0f), p_rng.random(-100.0f, 100.0f));
+			polygon.points.resize(3);
+			polygon.points[0].pos = origin;
+			polygon.points[1].pos = origin + Vector3(p_rng.random(0.5f, 2.0f), 0, 0);
+			polygon.points[2].pos = origin + Vector3(0, 0, p_rng.random(0.5f, 2.0f));
+		}
+		return polygons;
+	}
+
+	static real_t polygon_distance_squared(const gd::Polygon &p_polygon, const Vector3 &p_point) {
+		const Face3 face(p_polygon.points[0].pos, p_polygon.points[1].pos, p_polygon.points[2].pos);
+		return face.get_closest_point_to(p_point).distance_squared_to(p_point);
+	}
+
+	TEST_CASE("[NavPolygonIndex] Nearest query should match a linear scan") {
+		RandomPCG rng(42);
+		const LocalVector<gd::Polygon> polygons = build_random_polygons(1000, rng);
+		NavPolygonIndex index;
+		index.build(polygons);
+
+		for (int query = 0; query < 100; query++) {
+			const Vector3 point(rng.random(-120.0f, 120.0f), rng.random(-10.0f, 10.0f), rng.random(-120.0f, 120.0f));
+
+			uint32_t expected = UINT32_MAX;
+			real_t expected_distance_squared = FLT_MAX;
+			for (uint32_t i = 0; i < polygons.size(); i++) {
+				const real_t distance_squared = polygon_distance_squared(polygons[i], point);
+				if (distance_squared < expected_distance_squared) {
+					expected = i;
+					expected_distance_squared = distance_squared;
+				}
+			}
+
+			uint32_t closest = UINT32_MAX;
+			real_t closest_distance_squared = FLT_MAX;
+			uint32_t visited = 0;
+			auto callback = [&](uint32_t p_polygon) -> real_t {
+				visited++;
+				const real_t distance_squared = polygon_distance_squared(polygons[p_polygon], point);
+				if (distance_squared < closest_distance_squared) {
+					closest = p_polygon;
+					closest_distance_squared = distance_squared;
+				}
+				return closest_distance_squared;
+			};
+			index.query_nearest(AABB(point, Vector3()), FLT_MAX, callback);
+
+			CHECK_EQ(closest, expected);
+			CHECK(visited < polygons.size());
+		}
+	}
+
+	TEST_CASE("[NavPolygonIndex] AABB query should report every overlapping polygon") {
+		RandomPCG rng(7);
+		const LocalVector<gd::Polygon> polygons = build_random_polygons(500, rng);
+		NavPolygonIndex index;
+		index.build(polygons);
+
+		for (int query = 0; query < 50; query++) {
+			const AABB query_aabb(Vector3(rng.random(-100.0f, 100.0f), -10.0f, rng.random(-100.0f, 100.0f)), Vector3(rng.random(1.0f, 30.0f), 20.0f, rng.random(1.0f, 30.0f)));
+
+			HashSet<uint32_t> expected;
+			for (uint32_t i = 0; i < polygons.size(); i++) {
+				if (NavPolygonIndex::get_polygon_aabb(polygons[i]).intersects_inclusive(query_aabb)) {
+					expected.insert(i);
+				}
+			}
+
+			HashSet<uint32_t> found;
+			auto callback = [&](uint32_t p_polygon) {
+				found.insert(p_polygon);
+			};
+			index.query_aabb(query_aabb, callback);
+
+			CHECK_EQ(found.size(), expected.size());
+			for (const uint32_t &polygon : expected) {
+				CHECK(found.has(polygon));
+			}
+		}
+	}
+
+	TEST_CASE("[NavPolygonIndex] Combined region indices should report map polygon indices") {
+		RandomPCG rng(3);
+		const LocalVector<gd::Polygon> region_a = build_random_polygons(40, rng);
+		const LocalVector<gd::Polygon> region_b = build_random_polygons(60, rng);
+		NavPolygonIndex index_a;
+		index_a.build(region_a);
+		NavPolygonIndex index_b;
+		index_b.build(region_b);
+
+		NavPolygonIndex map_index;
+		map_index.add_index(index_a, 0);
+		map_index.add_index(index_b, region_a.size());
+		map_index.update();
+
+		HashSet<uint32_t> found;
+		auto callback = [&](uint32_t p_polygon) {
+			found.insert(p_polygon);
+		};
+		map_index.query_aabb(AABB(Vector3(-1000, -1000, -1000), Vector3(2000, 2000, 2000)), callback);
+		CHECK_EQ(found.size(), region_a.size() + region_b.size());
+
+		const Vector3 point = region_b[10].points[0].pos;
+		uint32_t closest = UINT32_MAX;
+		auto nearest_callback = [&](uint32_t p_polygon) -> real_t {
+			const gd::Polygon &polygon = p_polygon < region_a.size() ? region_a[p_polygon] : region_b[p_polygon - region_a.size()];
+			if (polygon_distance_squared(polygon, point) == 0.0) {
+				closest = p_polygon;
+			}
+			return closest == UINT32_MAX ? FLT_MAX : 0.0;
+		};
+		map_index.query_nearest(AABB(point, Vector3()), FLT_MAX, nearest_callback);
+		CHECK_EQ(closest, region_a.size() + 10);
+	}
 }
 } //namespace TestNavigationServer3D
 
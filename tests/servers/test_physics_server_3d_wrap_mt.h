@@ -0,0 +1,176 @@
+/**************************************************************************/
+/*  test_physics_server_3d_wrap_mt.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_WRAP_MT_H
+#define TEST_PHYSICS_SERVER_3D_WRAP_MT_H
+
+#include "core/os/thread.h"
+#include "modules/godot_physics_3d/godot_physics_server_3d.h"
+#include "servers/physics_server_3d_wrap_mt.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3DWrapMT {
+
+struct ThreadData {
+	PhysicsServer3D *server = nullptr;
+	RID body;
+};
+
+static void set_body_transform_thread(void *p_userdata) {
+	ThreadData *data = (ThreadData *)p_userdata;
+	data->server->body_set_state(data->body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 30, 0)));
+}
+
+TEST_CASE("[Physics][PhysicsServer3DWrapMT] Body states are published after each step") {
+	GodotPhysicsServer3D *physics_server = memnew(GodotPhysicsServer3D(true));
+	PhysicsServer3DWrapMT *server = memnew(PhysicsServer3DWrapMT(physics_server, true));
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID shape = server->box_shape_create();
+	server->shape_set_data(shape, Vector3(0.5, 0.5, 0.5));
+	RID body = server->body_create();
+	server->body_add_shape(body, shape, Transform3D(), false);
+	server->body_set_space(body, space);
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 10, 0)));
+
+	// Same order as `Main::iteration()`.
+	Transform3D previous_transform;
+	Transform3D running_transform;
+	for (int i = 0; i < 10; i++) {
+		server->sync();
+		server->flush_queries();
+
+		// The physics thread is waiting, the published state must match the server's.
+		const Transform3D transform = server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		CHECK(transform == Transform3D(physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)));
+		CHECK(server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY) == physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY));
+
+		// While a step runs, reads return the state published by the previous step, or by that one if it's done.
+		if (i > 0) {
+			CHECK((running_transform == previous_transform || running_transform == transform));
+		}
+
+		server->end_sync();
+		server->step(1.0 / 60.0);
+		running_transform = server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		previous_transform = transform;
+	}
+
+	server->sync();
+	const Transform3D transform = server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK(transform.origin.y < 10);
+	CHECK(Vector3(server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY)).y < 0);
+
+	// Changes are visible right away, before the next step publishes them.
+	server->end_sync();
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 20, 0)));
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin == Vector3(0, 20, 0));
+	server->step(1.0 / 60.0);
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin.y > 19);
+	server->sync();
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin.y > 19);
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin.y < 20);
+	server->end_sync();
+
+	// Changes made from other threads are visible right away too.
+	server->step(1.0 / 60.0);
+	server->sync();
+	server->end_sync();
+	ThreadData thread_data;
+	thread_data.server = server;
+	thread_data.body = body;
+	Thread thread;
+	thread.start(set_body_transform_thread, &thread_data);
+	thread.wait_to_finish();
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin == Vector3(0, 30, 0));
+	server->step(1.0 / 60.0);
+	server->sync();
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin.y > 29);
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin.y < 30);
+	server->end_sync();
+
+	server->free(body);
+	server->free(shape);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+TEST_CASE("[Physics][PhysicsServer3DWrapMT] Restoring a snapshot invalidates the published body states") {
+	GodotPhysicsServer3D *physics_server = memnew(GodotPhysicsServer3D(true));
+	PhysicsServer3DWrapMT *server = memnew(PhysicsServer3DWrapMT(physics_server, true));
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID shape = server->box_shape_create();
+	server->shape_set_data(shape, Vector3(0.5, 0.5, 0.5));
+	RID body = server->body_create();
+	server->body_add_shape(body, shape, Transform3D(), false);
+	server->body_set_space(body, space);
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 10, 0)));
+
+	server->step(1.0 / 60.0);
+	server->sync();
+	const PackedByteArray snapshot = server->space_get_snapshot(space);
+	const Transform3D snapshot_transform = server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	const Vector3 snapshot_velocity = server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+	REQUIRE_FALSE(snapshot.is_empty());
+	server->end_sync();
+
+	for (int i = 0; i < 4; i++) {
+		server->step(1.0 / 60.0);
+		server->sync();
+		server->end_sync();
+	}
+	server->sync();
+	REQUIRE(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin.y < snapshot_transform.origin.y);
+
+	// Read right away, without a step publishing the restored states.
+	REQUIRE(server->space_restore_snapshot(space, snapshot));
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)) == snapshot_transform);
+	CHECK(Vector3(server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY)) == snapshot_velocity);
+	server->end_sync();
+
+	server->free(body);
+	server->free(shape);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestPhysicsServer3DWrapMT
+
+#endif // TEST_PHYSICS_SERVER_3D_WRAP_MT_H
@@ -48,6 +48,10 @@
 // The test case is marked as failed, but does not fail the entire test run.
 #define TEST_CASE_MAY_FAIL(name) TEST_CASE(name *doctest::may_fail())
 
+// Benchmarks are skipped by default, run them with `--test --test-case="[Benchmark]*" --no-skip`.
+// They report their timings with `print_line()` rather than checking them.
+#define TEST_CASE_BENCHMARK(name) TEST_CASE("[Benchmark]" name *doctest::skip())
+
 // Provide aliases to conform with Godot naming conventions (see error macros).
 #define TEST_COND(cond, ...) DOCTEST_CHECK_FALSE_MESSAGE(cond, __VA_ARGS__)
 #define TEST_FAIL(cond, ...) DOCTEST_FAIL(cond, __VA_ARGS__)
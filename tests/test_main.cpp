@@ -94,6 +94,7 @@
 #include "tests/core/templates/test_lru.h"
 #include "tests/core/templates/test_oa_hash_map.h"
 #include "tests/core/templates/test_paged_array.h"
+#include "tests/core/templates/test_radix_sort.h"
 #include "tests/core/templates/test_rid.h"
 #include "tests/core/templates/test_vector.h"
 #include "tests/core/test_crypto.h"
@@ -127,11 +128,16 @@
 #include "tests/scene/test_path_follow_2d.h"
 #include "tests/scene/test_sprite_frames.h"
 #include "tests/scene/test_style_box_texture.h"
+#include "tests/scene/test_texture_streamer.h"
 #include "tests/scene/test_theme.h"
 #include "tests/scene/test_timer.h"
 #include "tests/scene/test_viewport.h"
 #include "tests/scene/test_visual_shader.h"
 #include "tests/scene/test_window.h"
+#include "tests/servers/rendering/test_raster_occlusion_cull.h"
+#include "tests/servers/rendering/test_renderer_canvas_cull.h"
+#include "tests/servers/rendering/test_rendering_server.h"
+#include "tests/servers/rendering/test_shader_compiler.h"
 #include "tests/servers/rendering/test_shader_preprocessor.h"
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
@@ -157,6 +163,10 @@
 #include "tests/servers/test_navigation_server_3d.h"
 #endif // MODULE_NAVIGATION_ENABLED
 
+#ifdef MODULE_GODOT_PHYSICS_3D_ENABLED
+#include "tests/servers/test_physics_server_3d_wrap_mt.h"
+#endif // MODULE_GODOT_PHYSICS_3D_ENABLED
+
 #include "tests/scene/test_arraymesh.h"
 #include "tests/scene/test_camera_3d.h"
 #include "tests/scene/test_height_map_shape_3d.h"
@@ -165,6 +175,7 @@
 #include "tests/scene/test_primitives.h"
 #include "tests/scene/test_skeleton_3d.h"
 #include "tests/scene/test_sky.h"
+#include "tests/scene/test_static_mesh_batch_3d.h"
 #endif // _3D_DISABLED
 
 #include "modules/modules_tests.gen.h"